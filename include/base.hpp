@@ -4,4 +4,21 @@
 #define ALIGN(x) alignas(x)
 #else
 #define ALIGN(x)
+#endif
+
+// ENMA_INLINE pulls every definition into the headers: small operators are force-inlined, everything else is inline
+#ifdef ENMA_INLINE
+    #ifndef ENMA_IMPLEMENTATION
+    #define ENMA_IMPLEMENTATION
+    #endif
+
+    #define ENMA_FN inline
+    #if defined(_MSC_VER)
+    #define ENMA_HOT_FN __forceinline
+    #else
+    #define ENMA_HOT_FN inline __attribute__((always_inline))
+    #endif
+#else
+    #define ENMA_FN
+    #define ENMA_HOT_FN
 #endif
\ No newline at end of file
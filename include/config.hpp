@@ -7,6 +7,8 @@
  *   USE_DEG             -  Use degrees in functions in which angle is a parameter
  *   USE_LH_YU           -  Use to invoke projection functions that uses Left-Handed Y-up Cartesian Coordinates; Used by Default; 
  *                          Note - Support for other Coordinates yet to be planned
+ *   ENMA_INLINE         -  Use to define every function in the headers so hot operators inline across translation units;
+ *                          Note - Without it, the definitions are compiled once in the TU that defines ENMA_IMPLEMENTATION (maths.cpp), which keeps code size down
  */
 
 /**
@@ -17,6 +19,7 @@
 //#define USE_MEM_ALIGNED
 #define USE_DEG
 #define USE_LH_YU
+//#define ENMA_INLINE
 
 /**
  * Configuration Ends Here
@@ -0,0 +1,164 @@
+/* CPU Feature Detection
+ *
+ * This header file is part of Enmatica library
+ *
+ * Copyright (c) 202X Villainous Softworks
+ *
+ */
+
+#pragma once
+#include "../base.hpp"
+#include "../empch.hpp"
+
+#if defined(__GNUC__) || defined(__clang__)
+#include <cpuid.h>
+#endif
+
+/**
+ * Instruction set tiers the dispatched kernels are compiled for, ordered from the slowest to the fastest.
+ *
+ *   Scalar     -  No usable SIMD extension
+ *   SSE2       -  Detected only; the library baseline is SSE4.1
+ *   SSE41      -  Baseline, the level the headers are compiled for without any -m flags beyond -msse4.1
+ *   AVX2       -  AVX2 and FMA3 with OS support for the YMM state
+ *   AVX512     -  AVX-512 F, DQ and VL with OS support for the ZMM state
+ */
+enum class SimdLevel : uin32
+{
+	Scalar,
+	SSE2,
+	SSE41,
+	AVX2,
+	AVX512
+};
+
+/**
+ * Instruction set extensions of the host CPU, detected once with cpuid.
+ *
+ * The AVX, AVX2, FMA and AVX-512 flags are only set when the operating system also saves the matching register state.
+ */
+struct CpuFeatures
+{
+	bln8 sse2;
+	bln8 sse41;
+	bln8 avx;
+	bln8 avx2;
+	bln8 fma;
+	bln8 avx512f;
+	bln8 avx512dq;
+	bln8 avx512vl;
+
+	SimdLevel level;
+};
+
+/**
+ * Returns the features of the host CPU. Detection runs on the first call only.
+ *
+ * \return Reference to the detected CpuFeatures.
+ */
+const CpuFeatures& GetCpuFeatures();
+/**
+ * Returns the fastest kernel tier the host CPU supports.
+ *
+ * \return The detected SimdLevel.
+ */
+SimdLevel GetSimdLevel();
+
+// Kernels of a higher tier are compiled with their own target so that one binary, built for the SSE4.1 baseline,
+// carries every tier. MSVC emits any intrinsic regardless of /arch and needs no attribute
+#if defined(__GNUC__) || defined(__clang__)
+#define ENMA_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define ENMA_TARGET_AVX512 __attribute__((target("avx512f,avx512dq,avx512vl,avx2,fma")))
+#else
+#define ENMA_TARGET_AVX2
+#define ENMA_TARGET_AVX512
+#endif
+
+#ifdef ENMA_IMPLEMENTATION
+inline void CpuId(uin32 (&regs)[4], uin32 leaf, uin32 subleaf)
+{
+	#if defined(_MSC_VER) && !defined(__clang__)
+	int32 r[4];
+	__cpuidex(r, static_cast<int32>(leaf), static_cast<int32>(subleaf));
+
+	for(uin32 i = 0; i < 4; i++)
+		regs[i] = static_cast<uin32>(r[i]);
+	#else
+	__cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+	#endif
+}
+
+// Register state enabled by the operating system (XCR0)
+inline uin64 XGetBv()
+{
+	#if defined(_MSC_VER) && !defined(__clang__)
+	return _xgetbv(0);
+	#else
+	uin32 lo, hi;
+	__asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+
+	return (static_cast<uin64>(hi) << 32) | lo;
+	#endif
+}
+
+inline CpuFeatures DetectCpuFeatures()
+{
+	CpuFeatures f = {};
+	uin32 regs[4];
+
+	CpuId(regs, 0, 0);
+	const uin32 maxLeaf = regs[0];
+
+	if(maxLeaf >= 1)
+	{
+		CpuId(regs, 1, 0);
+
+		f.sse2 = (regs[3] >> 26) & 1;
+		f.sse41 = (regs[2] >> 19) & 1;
+
+		const bln8 osxsave = (regs[2] >> 27) & 1;
+		const uin64 xcr0 = osxsave ? XGetBv() : 0;
+
+		const bln8 ymm = (xcr0 & 0x06) == 0x06;
+		const bln8 zmm = (xcr0 & 0xE6) == 0xE6;
+
+		f.avx = ymm && ((regs[2] >> 28) & 1);
+		f.fma = f.avx && ((regs[2] >> 12) & 1);
+
+		if(maxLeaf >= 7)
+		{
+			CpuId(regs, 7, 0);
+
+			f.avx2 = f.avx && ((regs[1] >> 5) & 1);
+			f.avx512f = zmm && ((regs[1] >> 16) & 1);
+			f.avx512dq = f.avx512f && ((regs[1] >> 17) & 1);
+			f.avx512vl = f.avx512f && ((regs[1] >> 31) & 1);
+		}
+	}
+
+	if(f.avx512f && f.avx512dq && f.avx512vl && f.avx2 && f.fma)
+		f.level = SimdLevel::AVX512;
+	else if(f.avx2 && f.fma)
+		f.level = SimdLevel::AVX2;
+	else if(f.sse41)
+		f.level = SimdLevel::SSE41;
+	else if(f.sse2)
+		f.level = SimdLevel::SSE2;
+	else
+		f.level = SimdLevel::Scalar;
+
+	return f;
+}
+
+ENMA_FN const CpuFeatures& GetCpuFeatures()
+{
+	static const CpuFeatures features = DetectCpuFeatures();
+
+	return features;
+}
+
+ENMA_FN SimdLevel GetSimdLevel()
+{
+	return GetCpuFeatures().level;
+}
+#endif
@@ -24,13 +24,13 @@ struct ALIGN(16) fmat2x2
         vec2 rows[2];
     };
 
-    fmat2x2(const fmat2x2& mat);
-    fmat2x2(const flt32 val = 0.0f);
-    fmat2x2(const flt32 x0, const flt32 y0, const flt32 x1, const flt32 y1);
+    constexpr fmat2x2(const flt32 val = 0.0f);
+    constexpr fmat2x2(const flt32 x0, const flt32 y0, const flt32 x1, const flt32 y1);
+    fmat2x2(const simd::float4& vals);
     #ifdef USE_SIMD
     fmat2x2(const __m128& vals);
     #endif
-    fmat2x2(const vec2& row1, const vec2& row2);
+    constexpr fmat2x2(const vec2& row1, const vec2& row2);
 
     fmat2x2 operator+(const fmat2x2 other);
     fmat2x2 operator+=(const fmat2x2 other);
@@ -66,177 +66,112 @@ fmat2x2 Transpose(const fmat2x2& m);
 //fmat2x2 operator*(const fmat2x3 m1, const mat3x2 m2);
 //fmat2x2 operator*(const fmat2x4 m1, const mat4x2 m2);
 
+constexpr fmat2x2::fmat2x2(const flt32 val) : m11(val), m12(0.0f), m21(0.0f), m22(val) {}
+
+constexpr fmat2x2::fmat2x2(const flt32 x0, const flt32 y0, const flt32 x1, const flt32 y1) : m11(x0), m12(y0), m21(x1), m22(y1) {}
+
+constexpr fmat2x2::fmat2x2(const vec2& row1, const vec2& row2) : m11(row1.x), m12(row1.y), m21(row2.x), m22(row2.y) {}
+
 #ifdef ENMA_IMPLEMENTATION
-fmat2x2::fmat2x2(const fmat2x2& m)
+inline simd::float4 LoadMat(const fmat2x2& m)
 {
-    this->m11 = m.m11;
-    this->m12 = m.m12;
-    this->m21 = m.m21;
-    this->m22 = m.m22;
+    return simd::float4::LoadU(m.arr);
 }
-        
-fmat2x2::fmat2x2(const flt32 val)
+
+inline void StoreMat(fmat2x2& m, const simd::float4& v)
 {
-    this->arr[0] = val;
-    this->arr[1] = 0.0f;
-    this->arr[2] = 0.0f;
-    this->arr[3] = val;
+    v.StoreU(m.arr);
 }
-        
-fmat2x2::fmat2x2(const flt32 x0, const flt32 y0, const flt32 x1, const flt32 y1) : m11(x0), m12(y0), m21(x1), m22(y1) {}
 
-fmat2x2::fmat2x2(const vec2& row1, const vec2& row2)
+ENMA_HOT_FN fmat2x2::fmat2x2(const simd::float4& vals)
 {
-    this->m11 = row1.x;
-    this->m12 = row1.y;
-    this->m21 = row2.x;
-    this->m22 = row2.y;
+    StoreMat(*this, vals);
 }
 
 #ifdef USE_SIMD
-fmat2x2::fmat2x2(const __m128& vals)
-{
-    this->arr[0] = vals[0];
-    this->arr[1] = vals[1];
-    this->arr[2] = vals[2];
-    this->arr[3] = vals[3];
-}
+ENMA_HOT_FN fmat2x2::fmat2x2(const __m128& vals) : fmat2x2(simd::float4(vals)) {}
+#endif
 
-fmat2x2 fmat2x2::operator+(const fmat2x2 other)
+ENMA_HOT_FN fmat2x2 fmat2x2::operator+(const fmat2x2 other)
 {
-    __m128 m1 = _mm_load_ps(this->arr);
-    __m128 m2 = _mm_load_ps(other.arr);
-
-    return _mm_add_ps(m1, m2);
+    return fmat2x2(LoadMat(*this) + LoadMat(other));
 }
 
-fmat2x2 fmat2x2::operator+=(const fmat2x2 other)
+ENMA_HOT_FN fmat2x2 fmat2x2::operator+=(const fmat2x2 other)
 {
-    __m128 m1 = _mm_load_ps(this->arr);
-    __m128 m2 = _mm_load_ps(other.arr);
-
-    _mm_store_ps(this->arr, _mm_add_ps(m1, m2));
+    StoreMat(*this, LoadMat(*this) + LoadMat(other));
 
     return *this;
 }
 
-fmat2x2 fmat2x2::operator-(const fmat2x2 other)
+ENMA_HOT_FN fmat2x2 fmat2x2::operator-(const fmat2x2 other)
 {
-    __m128 m1 = _mm_load_ps(this->arr);
-    __m128 m2 = _mm_load_ps(other.arr);
-
-    return _mm_sub_ps(m1, m2);
+    return fmat2x2(LoadMat(*this) - LoadMat(other));
 }
 
-fmat2x2 fmat2x2::operator-=(const fmat2x2 other)
+ENMA_HOT_FN fmat2x2 fmat2x2::operator-=(const fmat2x2 other)
 {
-    __m128 m1 = _mm_load_ps(this->arr);
-    __m128 m2 = _mm_load_ps(other.arr);
-
-    _mm_store_ps(this->arr, _mm_sub_ps(m1, m2));
+    StoreMat(*this, LoadMat(*this) - LoadMat(other));
 
     return *this;
 }
 
-fmat2x2 fmat2x2::operator*(const fmat2x2 other)
+// (a11 b11 + a12 b21, a11 b12 + a12 b22, a21 b11 + a22 b21, a21 b12 + a22 b22)
+inline simd::float4 Mat2x2Multiply(const simd::float4& a, const simd::float4& b)
 {
-    // Need a better way
-    __m128 r1 = _mm_load_ps(this->arr);     // First Matrix
-    __m128 r3 = _mm_load_ps(other.arr);     // Second Matrix
-
-    __m128 r2 = _mm_shuffle_ps(r1, r1, 0xEE);
-    r1 = _mm_shuffle_ps(r1, r1, 0x44);
-    r3 = _mm_shuffle_ps(r3, r3, 0xD8);
-
-    r1 = _mm_dp_ps(r1, r3, 0xFF);
-    r2 = _mm_dp_ps(r2, r3, 0xFF);
-
-    /*r1 = _mm_hadd_ps(r1, r1);
-    r2 = _mm_hadd_ps(r2, r2);*/
+    using namespace simd;
 
-    r2 = _mm_shuffle_ps(r1, r2, 0xE4);
-
-    return fmat2x2(r2);
+    return Fmadd(Shuffle<1, 1, 3, 3>(a), Shuffle<2, 3, 2, 3>(b), Shuffle<0, 0, 2, 2>(a) * Shuffle<0, 1, 0, 1>(b));
 }
 
-fmat2x2 fmat2x2::operator*=(const fmat2x2 other)
+ENMA_HOT_FN fmat2x2 fmat2x2::operator*(const fmat2x2 other)
 {
-    // Same as above, right?
-    __m128 r1 = _mm_load_ps(this->arr);   // First Matrix
-    __m128 r3 = _mm_load_ps(other.arr);       // Second Matrix
-
-    __m128 r2 = _mm_shuffle_ps(r1, r1, 0xEE);
-    r1 = _mm_shuffle_ps(r1, r1, 0x44);
-    r3 = _mm_shuffle_ps(r3, r3, 0xD8);
-
-    r1 = _mm_dp_ps(r1, r3, 0XFF);
-    r2 = _mm_dp_ps(r2, r3, 0xFF);
-
-    /*r1 = _mm_hadd_ps(r1, r1);
-    r2 = _mm_hadd_ps(r2, r2);*/
-
-    r2 = _mm_shuffle_ps(r1, r2, 0xE4);
+    return fmat2x2(Mat2x2Multiply(LoadMat(*this), LoadMat(other)));
+}
 
-    *this = r2;
+ENMA_HOT_FN fmat2x2 fmat2x2::operator*=(const fmat2x2 other)
+{
+    StoreMat(*this, Mat2x2Multiply(LoadMat(*this), LoadMat(other)));
 
     return *this;
 }
 
-fmat2x2 fmat2x2::operator*(const flt32 val)
+ENMA_HOT_FN fmat2x2 fmat2x2::operator*(const flt32 val)
 {
-    __m128 m = _mm_load_ps(this->arr);
-    __m128 fl = _mm_load1_ps(&val);
-
-    return fmat2x2(_mm_mul_ps(m, fl));
+    return fmat2x2(LoadMat(*this) * val);
 }
 
-fmat2x2 fmat2x2::operator*=(const flt32 val)
+ENMA_HOT_FN fmat2x2 fmat2x2::operator*=(const flt32 val)
 {
-    __m128 m = _mm_load_ps(this->arr);
-    __m128 fl = _mm_load1_ps(&val);
-
-    _mm_store_ps(this->arr, _mm_mul_ps(m, fl));
+    StoreMat(*this, LoadMat(*this) * val);
 
     return *this;
 }
 
-fmat2x2 fmat2x2::operator/(const flt32 val)
+ENMA_HOT_FN fmat2x2 fmat2x2::operator/(const flt32 val)
 {
-    __m128 m = _mm_load_ps(this->arr);
-    __m128 fl = _mm_load1_ps(&val);
-
-    return fmat2x2(_mm_div_ps(m, fl));
+    return fmat2x2(LoadMat(*this) / val);
 }
 
-fmat2x2 fmat2x2::operator/=(const flt32 val)
+ENMA_HOT_FN fmat2x2 fmat2x2::operator/=(const flt32 val)
 {
-    __m128 m = _mm_load_ps(this->arr);
-    __m128 fl = _mm_load1_ps(&val);
+    StoreMat(*this, LoadMat(*this) / val);
 
-    _mm_store_ps(this->arr, _mm_div_ps(m, fl));
-        
     return *this;
 }
 
-flt32 fmat2x2::Determinant() const
+ENMA_HOT_FN flt32 fmat2x2::Determinant() const
 {
-    __m128 m = _mm_load_ps(this->arr);
-    __m128 n = _mm_shuffle_ps(m, m, 0xBB);
-
-    m = _mm_mul_ps(m, n);
+    const simd::float4 m = LoadMat(*this);
+    const simd::float4 d = m * simd::Shuffle<3, 2, 3, 2>(m);
 
-    return m[0] - m[1];
+    return d.X() - d.Get<1>();
 }
 
-fmat2x2 Transpose(const fmat2x2 m)
+ENMA_HOT_FN fmat2x2 Transpose(const fmat2x2& m)
 {
-    __m128 r = _mm_load_ps(m.arr);
-
-    r = _mm_shuffle_ps(r, r, _MM_SHUFFLE(3, 1, 2, 0));
-
-    return fmat2x2(r);
+    return fmat2x2(simd::Shuffle<0, 2, 1, 3>(LoadMat(m)));
 }
-#endif
 
 #include "fmat2x3.hpp"
 #include "fmat3x2.hpp"
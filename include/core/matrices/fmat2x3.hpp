@@ -28,12 +28,14 @@ private:
     flt32 x_pad[2] = { 0.0f, 0.0f };    // Just the padding, don't mess it up. Leave it be
 
 public:
-    fmat2x3(const fmat2x3 &mat);
-    fmat2x3(const flt32 val = 0.0f);
-    fmat2x3(const flt32 x0, const flt32 y0, const flt32 z0, const flt32 x1, const flt32 y1, const flt32 z1);
+    constexpr fmat2x3(const flt32 val = 0.0f);
+    constexpr fmat2x3(const flt32 x0, const flt32 y0, const flt32 z0, const flt32 x1, const flt32 y1, const flt32 z1);
     fmat2x3(const flt32 *arr);
+    fmat2x3(const simd::float4& v1, const simd::float4& v2);
+    #ifdef USE_SIMD
     fmat2x3(const __m128 v1, const __m128 v2);
-    fmat2x3(const vec3 row1, const vec3 row2);
+    #endif
+    constexpr fmat2x3(const vec3 row1, const vec3 row2);
 
     fmat2x3 operator+(const fmat2x3 other);
     fmat2x3 operator+=(const fmat2x3 other);
@@ -143,103 +145,88 @@ public:
 
 fmat2x3 Transpose(const fmat3x2 mat);
 
+constexpr fmat2x3::fmat2x3(const flt32 val) : m11(val), m12(0.0f), m13(0.0f), m21(0.0f), m22(val), m23(0.0f) {}
+
+constexpr fmat2x3::fmat2x3(const flt32 x0, const flt32 y0, const flt32 z0, const flt32 x1, const flt32 y1, const flt32 z1) : m11(x0), m12(y0), m13(z0), m21(x1), m22(y1), m23(z1) {}
+
+constexpr fmat2x3::fmat2x3(const vec3 row1, const vec3 row2) : m11(row1.x), m12(row1.y), m13(row1.z), m21(row2.x), m22(row2.y), m23(row2.z) {}
+
 #ifdef ENMA_IMPLEMENTATION
-fmat2x3::fmat2x3(const fmat2x3 &mat)
+// Rows of the matrix as SIMD registers, w is zero
+inline simd::float4 LoadRow(const fmat2x3& m, uin32 row)
 {
-    *this = mat;
+    return simd::float4::LoadXYZ(m.arr + 3 * row);
 }
-    
-fmat2x3::fmat2x3(const flt32 val)
+
+inline void StoreRow(fmat2x3& m, uin32 row, const simd::float4& r)
 {
-    this->arr[0] = val;
-    this->arr[1] = 0.0f;
-    this->arr[2] = 0.0f;
-    this->arr[3] = 0.0f;
-    this->arr[4] = val;
-    this->arr[5] = 0.0f;
+    r.StoreXYZ(m.arr + 3 * row);
 }
-    
-fmat2x3::fmat2x3(const flt32 x0, const flt32 y0, const flt32 z0, const flt32 x1, const flt32 y1, const flt32 z1) : m11(x0), m12(y0), m13(z0), m21(x1), m22(y1), m23(z1) {}
 
-fmat2x3::fmat2x3(const __m128 v1, const __m128 v2)
+ENMA_HOT_FN fmat2x3::fmat2x3(const simd::float4& v1, const simd::float4& v2)
 {
-    this->arr[0] = v1[0];
-    this->arr[1] = v1[1];
-    this->arr[2] = v1[2];
-    this->arr[3] = v2[0];
-    this->arr[4] = v2[1];
-    this->arr[5] = v2[2];
+    StoreRow(*this, 0, v1);
+    StoreRow(*this, 1, v2);
 }
 
-fmat2x3::fmat2x3(const vec3 row1, const vec3 row2)
+#ifdef USE_SIMD
+ENMA_HOT_FN fmat2x3::fmat2x3(const __m128 v1, const __m128 v2) : fmat2x3(simd::float4(v1), simd::float4(v2)) {}
+#endif
+
+ENMA_HOT_FN fmat2x3 fmat2x3::operator+(const fmat2x3 other)
 {
-    this->rows[0] = row1;
-    this->rows[1] = row2;
+    return fmat2x3(LoadRow(*this, 0) + LoadRow(other, 0), LoadRow(*this, 1) + LoadRow(other, 1));
 }
 
-fmat2x3 fmat2x3::operator+(const fmat2x3 other)
+ENMA_HOT_FN fmat2x3 fmat2x3::operator+=(const fmat2x3 other)
 {
-    vec3 r11 = this->rows[0];
-    vec3 r12 = this->rows[1];
-
-    vec3 r21 = other.rows[0];
-    vec3 r22 = other.rows[1];
-
-
-    return fmat2x3(r11 + r12, r21 + r22);
+    return *this = *this + other;
 }
 
-fmat2x3 fmat2x3::operator+=(const fmat2x3 other)
+ENMA_HOT_FN fmat2x3 fmat2x3::operator-(const fmat2x3 other)
 {
-    __m128 m1 = _mm_loadu_ps(this->arr);
-    __m128 m2 = _mm_loadu_ps(other.arr);
-
-    _mm_store_ps(this->arr, _mm_add_ps(m1, m2));
-
-    return *this;
+    return fmat2x3(LoadRow(*this, 0) - LoadRow(other, 0), LoadRow(*this, 1) - LoadRow(other, 1));
 }
 
-fmat2x3 fmat2x3::operator-(const fmat2x3 other)
+ENMA_HOT_FN fmat2x3 fmat2x3::operator-=(const fmat2x3 other)
 {
-    vec3 r11 = this->rows[0];
-    vec3 r12 = this->rows[1];
-
-    vec3 r21 = other.rows[0];
-    vec3 r22 = other.rows[1];
-
-
-    return fmat2x3(r11 - r12, r21 - r22);
+    return *this = *this - other;
 }
 
-fmat2x3 fmat2x3::operator-=(const fmat2x3 other)
+ENMA_HOT_FN fmat2x3 fmat2x3::operator*(const flt32 val)
 {
-    __m128 m1 = _mm_loadu_ps(this->arr);
-    __m128 m2 = _mm_loadu_ps(other.arr);
+    return fmat2x3(LoadRow(*this, 0) * val, LoadRow(*this, 1) * val);
+}
 
-    _mm_store_ps(this->arr, _mm_sub_ps(m1, m2));
+ENMA_HOT_FN fmat2x3 fmat2x3::operator*=(const flt32 val)
+{
+    return *this = *this * val;
+}
 
-    return *this;
+ENMA_HOT_FN fmat2x3 fmat2x3::operator/(const flt32 val)
+{
+    return fmat2x3(LoadRow(*this, 0) / val, LoadRow(*this, 1) / val);
 }
 
-flt32 fmat2x3::Determinant()
+ENMA_HOT_FN fmat2x3 fmat2x3::operator/=(const flt32 val)
 {
-    __m128 m = _mm_load_ps(this->arr);
-    __m128 n = _mm_shuffle_ps(m, m, 0xBB);
+    return *this = *this / val;
+}
 
-    m = _mm_mul_ps(m, n);
+// Determinant of the leading 2x2 block
+ENMA_HOT_FN flt32 fmat2x3::Determinant()
+{
+    const simd::float4 d = LoadRow(*this, 0) * simd::Shuffle<1, 0, 1, 0>(LoadRow(*this, 1));
 
-    return m[0] - m[1];
+    return d.X() - d.Get<1>();
 }
 
 #include "fmat3x2.hpp"
-fmat2x3 Transpose(const fmat3x2 mat)
+ENMA_HOT_FN fmat2x3 Transpose(const fmat3x2 mat)
 {
-    __m128 r1 = _mm_loadu_ps(&mat.arr[0]);
-    __m128 r2 = _mm_loadu_ps(&mat.arr[2]);
-
-    __m128 s1 = _mm_shuffle_ps(r1, r2, _MM_SHUFFLE(3, 2, 2, 0));
-    __m128 s2 = _mm_shuffle_ps(r1, r2, _MM_SHUFFLE(3, 3, 3, 1));
+    const simd::float4 r1 = simd::float4::LoadU(&mat.arr[0]);
+    const simd::float4 r2 = simd::float4::LoadU(&mat.arr[2]);
 
-    return fmat2x3(s1, s2);
+    return fmat2x3(simd::Shuffle<0, 2, 2, 3>(r1, r2), simd::Shuffle<1, 3, 3, 3>(r1, r2));
 }
 #endif
\ No newline at end of file
@@ -24,13 +24,15 @@ struct ALIGN(32) fmat2x4
         vec4 rows[2];
     };
 
-    fmat2x4(const fmat2x4 &mat);
-    fmat2x4(const flt32 val = 0.0f);
-    fmat2x4(const flt32 x0, const flt32 y0, const flt32 z0, const flt32 w0, const flt32 x1, const flt32 y1, const flt32 z1, const flt32 w1);
+    constexpr fmat2x4(const flt32 val = 0.0f);
+    constexpr fmat2x4(const flt32 x0, const flt32 y0, const flt32 z0, const flt32 w0, const flt32 x1, const flt32 y1, const flt32 z1, const flt32 w1);
     fmat2x4(const flt32 *arr);
-    fmat2x4(const __m256 mat);
+    fmat2x4(const simd::float8& mat);
+    #if defined(USE_SIMD) && defined(__AVX__)
+    fmat2x4(const __m256& mat);
+    #endif
     fmat2x4(const vec2 hrow11, const vec2 hrow12, const vec2 hrow21, const vec2 hrow22);
-    fmat2x4(const vec4 row1, const vec4 row2);
+    constexpr fmat2x4(const vec4 row1, const vec4 row2);
 
     fmat2x4 operator+(const fmat2x4 other);
     fmat2x4 operator+=(const fmat2x4 other);
@@ -59,113 +61,80 @@ struct ALIGN(32) fmat2x4
 
 fmat2x4 Transpose(const fmat4x2 mat);
 
+constexpr fmat2x4::fmat2x4(const flt32 val) : m11(val), m12(0.0f), m13(0.0f), m14(0.0f), m21(0.0f), m22(val), m23(0.0f), m24(0.0f) {}
+    
+constexpr fmat2x4::fmat2x4(const flt32 x0, const flt32 y0, const flt32 z0, const flt32 w0, const flt32 x1, const flt32 y1, const flt32 z1, const flt32 w1) 
+    : m11(x0), m12(y0), m13(z0), m14(w0), m21(x1), m22(y1), m23(z1), m24(w1) {}
+
+constexpr fmat2x4::fmat2x4(const vec4 row1, const vec4 row2) 
+    : m11(row1.x), m12(row1.y), m13(row1.z), m14(row1.w), m21(row2.x), m22(row2.y), m23(row2.z), m24(row2.w) {}
+
 #ifdef ENMA_IMPLEMENTATION
-fmat2x4::fmat2x4(const fmat2x4 &mat)
+// Both rows in one simd::float8
+inline simd::float8 LoadMat(const fmat2x4& m)
 {
-    *this = mat;
+    return simd::float8::LoadU(m.arr);
 }
 
-fmat2x4::fmat2x4(const flt32 val)
+inline void StoreMat(fmat2x4& m, const simd::float8& v)
 {
-    this->arr[0] = this->arr[5] = val;
-    this->arr[1] = this->arr[2] = this->arr[3] = this->arr[4] = this->arr[6] = this->arr[7] = 0.0f;
+    v.StoreU(m.arr);
 }
-    
-fmat2x4::fmat2x4(const flt32 x0, const flt32 y0, const flt32 z0, const flt32 w0, const flt32 x1, const flt32 y1, const flt32 z1, const flt32 w1) 
-    : m11(x0), m12(y0), m13(z0), m14(w0), m21(x1), m22(y1), m23(z1), m24(w1) {}
 
-fmat2x4::fmat2x4(const vec4 row1, const vec4 row2)
+ENMA_HOT_FN fmat2x4::fmat2x4(const simd::float8& mat)
 {
-    this->rows[0] = row1;
-    this->rows[1] = row2;
+    StoreMat(*this, mat);
 }
 
-#ifdef USE_SIMD
-fmat2x4::fmat2x4(const __m256 mat)
-{
-    this->arr[0] = mat[0];
-    this->arr[1] = mat[1];
-    this->arr[2] = mat[2];
-    this->arr[3] = mat[3];
-    this->arr[4] = mat[4];
-    this->arr[5] = mat[5];
-    this->arr[6] = mat[6];
-    this->arr[7] = mat[7];
-}
+#if defined(USE_SIMD) && defined(__AVX__)
+ENMA_HOT_FN fmat2x4::fmat2x4(const __m256& mat) : fmat2x4(simd::float8(mat)) {}
+#endif
 
-fmat2x4 fmat2x4::operator+(const fmat2x4 other)
+ENMA_HOT_FN fmat2x4 fmat2x4::operator+(const fmat2x4 other)
 {
-    __m256 m1 = _mm256_load_ps(this->arr);
-    __m256 m2 = _mm256_load_ps(other.arr);
-
-    return fmat2x4(_mm256_add_ps(m1, m2));
+    return fmat2x4(LoadMat(*this) + LoadMat(other));
 }
 
-fmat2x4 fmat2x4::operator+=(const fmat2x4 other)
+ENMA_HOT_FN fmat2x4 fmat2x4::operator+=(const fmat2x4 other)
 {
-    __m256 m1 = _mm256_load_ps(this->arr);
-    __m256 m2 = _mm256_load_ps(other.arr);
-
-    *this = _mm256_add_ps(m1, m2);
+    StoreMat(*this, LoadMat(*this) + LoadMat(other));
 
-	return *this;
+    return *this;
 }
 
-fmat2x4 fmat2x4::operator-(const fmat2x4 other)
+ENMA_HOT_FN fmat2x4 fmat2x4::operator-(const fmat2x4 other)
 {
-    __m256 m1 = _mm256_load_ps(this->arr);
-    __m256 m2 = _mm256_load_ps(other.arr);
-
-    m1 = _mm256_sub_ps(m1, m2);
-
-    return fmat2x4(m1);
+    return fmat2x4(LoadMat(*this) - LoadMat(other));
 }
 
-fmat2x4 fmat2x4::operator-=(const fmat2x4 other)
+ENMA_HOT_FN fmat2x4 fmat2x4::operator-=(const fmat2x4 other)
 {
-	__m256 m1 = _mm256_load_ps(this->arr);
-    __m256 m2 = _mm256_load_ps(other.arr);
+    StoreMat(*this, LoadMat(*this) - LoadMat(other));
 
-    *this = _mm256_sub_ps(m1, m2);
-
-	return *this;
+    return *this;
 }
 
-
-fmat2x4 fmat2x4::operator*(const flt32 val)
+ENMA_HOT_FN fmat2x4 fmat2x4::operator*(const flt32 val)
 {
-    __m256 fl = _mm256_set1_ps(val);
-    __m256 m1 = _mm256_load_ps(this->arr);
-
-    return _mm256_mul_ps(m1, fl);
+    return fmat2x4(LoadMat(*this) * val);
 }
 
-fmat2x4 fmat2x4::operator*=(const flt32 val)
+ENMA_HOT_FN fmat2x4 fmat2x4::operator*=(const flt32 val)
 {
-    __m256 fl = _mm256_set1_ps(val);
-    __m256 m1 = _mm256_load_ps(this->arr);
-
-    *this = _mm256_mul_ps(m1, fl);
+    StoreMat(*this, LoadMat(*this) * val);
 
     return *this;
 }
 
-fmat2x4 fmat2x4::operator/(const flt32 val)
+ENMA_HOT_FN fmat2x4 fmat2x4::operator/(const flt32 val)
 {
-    __m256 fl = _mm256_set1_ps(val);
-    __m256 m1 = _mm256_load_ps(this->arr);
-
-    return _mm256_div_ps(m1, fl);
+    return fmat2x4(LoadMat(*this) / val);
 }
 
-fmat2x4 fmat2x4::operator/=(const flt32 val)
+ENMA_HOT_FN fmat2x4 fmat2x4::operator/=(const flt32 val)
 {
-    __m256 fl = _mm256_set1_ps(val);
-    __m256 m1 = _mm256_load_ps(this->arr);
+    StoreMat(*this, LoadMat(*this) / val);
 
-    *this = _mm256_div_ps(m1, fl);
-    
     return *this;
 }
-#endif // USE_SIMD
 #endif
\ No newline at end of file
@@ -28,14 +28,14 @@ private:
     flt32 x_pad[2] = { 0.0f, 0.0f };
 
 public:
-    fmat3x2(const fmat3x2 &mat);
-    fmat3x2(const flt32 val = 0.0f);
-    fmat3x2(const flt32 x0, const flt32 y0, const flt32 x1, const flt32 y1, const flt32 x2, const flt32 y2);
-    fmat3x2(const flt32 *arr);
+    constexpr fmat3x2(const flt32 val = 0.0f);
+    constexpr fmat3x2(const flt32 x0, const flt32 y0, const flt32 x1, const flt32 y1, const flt32 x2, const flt32 y2);
+    constexpr fmat3x2(const flt32 *arr);
+    fmat3x2(const simd::float4& hr1, const simd::float4& hr2);
     #ifdef USE_SIMD
     fmat3x2(const __m128 hr1, const __m128 hr2);
     #endif
-    fmat3x2(const vec2 v1, const vec2 v2, const vec2 v3);
+    constexpr fmat3x2(const vec2 v1, const vec2 v2, const vec2 v3);
 
     #ifdef DEBUG
 	friend std::ostream &operator<<(std::ostream &os, fmat3x2 mat)
@@ -56,53 +56,25 @@ public:
 
 //fmat3x2 Transpose(const fmat2x3 mat);
 
-#ifdef ENMA_IMPLEMENTATION
-fmat3x2::fmat3x2(const fmat3x2 &mat)
-{
-    *this = mat;
-}
+constexpr fmat3x2::fmat3x2(const flt32 val) : m11(val), m12(0.0f), m21(0.0f), m22(val), m31(0.0f), m32(0.0f) {}
 
-fmat3x2::fmat3x2(const flt32 val)
-{
-    this->arr[0] = val;
-    this->arr[1] = 0.0f;
-    this->arr[2] = 0.0f;
-    this->arr[3] = val;
-    this->arr[4] = 0.0f;
-    this->arr[5] = 0.0f;
-}
+constexpr fmat3x2::fmat3x2(const flt32 x0, const flt32 y0, const flt32 x1, const flt32 y1, const flt32 x2, const flt32 y2) : m11(x0), m12(y0), m21(x1), m22(y1), m31(x2), m32(y2) {}
+
+constexpr fmat3x2::fmat3x2(const flt32 *arr) : m11(arr[0]), m12(arr[1]), m21(arr[2]), m22(arr[3]), m31(arr[4]), m32(arr[5]) {}
 
-fmat3x2::fmat3x2(const flt32 x0, const flt32 y0, const flt32 x1, const flt32 y1, const flt32 x2, const flt32 y2) : m11(x0), m12(y0), m21(x1), m22(y1), m31(x2), m32(y2) {}
+constexpr fmat3x2::fmat3x2(const vec2 v1, const vec2 v2, const vec2 v3) : m11(v1.x), m12(v1.y), m21(v2.x), m22(v2.y), m31(v3.x), m32(v3.y) {}
 
-fmat3x2::fmat3x2(const flt32 *arr)
+#ifdef ENMA_IMPLEMENTATION
+ENMA_HOT_FN fmat3x2::fmat3x2(const simd::float4& hr1, const simd::float4& hr2)
 {
-    this->arr[0] = arr[0];
-    this->arr[1] = arr[1];
-    this->arr[2] = arr[2];
-    this->arr[3] = arr[3];
-    this->arr[4] = arr[4];
-    this->arr[5] = arr[5];
+    hr1.StoreXYZ(this->arr);
+    hr2.StoreXYZ(this->arr + 3);
 }
 
 #ifdef USE_SIMD
-fmat3x2::fmat3x2(const __m128 hr1, const __m128 hr2)
-{
-    this->arr[0] = hr1[0];
-    this->arr[1] = hr1[1];
-    this->arr[2] = hr1[2];
-    this->arr[3] = hr2[0];
-    this->arr[4] = hr2[1];
-    this->arr[5] = hr2[2];
-}
+ENMA_HOT_FN fmat3x2::fmat3x2(const __m128 hr1, const __m128 hr2) : fmat3x2(simd::float4(hr1), simd::float4(hr2)) {}
 #endif
 
-fmat3x2::fmat3x2(const vec2 v1, const vec2 v2, const vec2 v3)
-{
-    this->rows[0] = v1;
-    this->rows[1] = v2;
-    this->rows[2] = v3;
-}
-
 #include "fmat2x3.hpp"
 /*fmat3x2 Transpose(const fmat2x3 mat)
 {
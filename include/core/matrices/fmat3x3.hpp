@@ -25,12 +25,17 @@ struct fmat3x3
     };
     flt32 x_pad[3] = { 0.0f, 0.0f, 0.0f };
 
-    fmat3x3(const fmat3x3 &mat);
-    fmat3x3(const flt32 val = 0.0f);
-    fmat3x3(const flt32 x0, const flt32 y0, const flt32 z0, const flt32 x1, const flt32 y1, const flt32 z1, const flt32 x2, const flt32 y2, const flt32 z2);
+    constexpr fmat3x3(const flt32 val = 0.0f);
+    constexpr fmat3x3(const flt32 x0, const flt32 y0, const flt32 z0, const flt32 x1, const flt32 y1, const flt32 z1, const flt32 x2, const flt32 y2, const flt32 z2);
+    fmat3x3(const simd::float4 &r1, const simd::float4 &r2, const simd::float4 &r3);
+    fmat3x3(const simd::float8 &t1, const flt32 &f);
+    #ifdef USE_SIMD
     fmat3x3(const __m128 &r1, const __m128 &r2, const __m128 &r3);
+    #endif
+    #if defined(USE_SIMD) && defined(__AVX__)
     fmat3x3(const __m256 &t1, const flt32 &f);
-    fmat3x3(const vec3 &row1, const vec3 &row2, const vec3 &row3);
+    #endif
+    constexpr fmat3x3(const vec3 &row1, const vec3 &row2, const vec3 &row3);
     
     fmat3x3 operator+(const fmat3x3 other);
     fmat3x3 operator+=(const fmat3x3 other);
@@ -61,198 +66,117 @@ struct fmat3x3
 fmat3x3 Transpose(fmat3x3 mat);
 fmat3x3 Inverse(fmat3x3 mat);
 
+constexpr fmat3x3::fmat3x3(const flt32 val) 
+	: m11(val), m12(0.0f), m13(0.0f), m21(0.0f), m22(val), m23(0.0f), m31(0.0f), m32(0.0f), m33(val) {}
+
+constexpr fmat3x3::fmat3x3(const flt32 x0, const flt32 y0, const flt32 z0, const flt32 x1, const flt32 y1, const flt32 z1, const flt32 x2, const flt32 y2, const flt32 z2)
+	: m11(x0), m12(y0), m13(z0), m21(x1), m22(y1), m23(z1), m31(x2), m32(y2), m33(z2) {}
+
+constexpr fmat3x3::fmat3x3(const vec3 &row1, const vec3 &row2, const vec3 &row3)
+	: m11(row1.x), m12(row1.y), m13(row1.z), m21(row2.x), m22(row2.y), m23(row2.z), m31(row3.x), m32(row3.y), m33(row3.z) {}
+
 #ifdef ENMA_IMPLEMENTATION
-fmat3x3::fmat3x3(const fmat3x3 &mat)
+// Rows of the matrix as SIMD registers, w is zero
+inline simd::float4 LoadRow(const fmat3x3& m, uin32 row)
 {
-    *this = mat;
+    return simd::float4::LoadXYZ(m.arr + 3 * row);
 }
 
-fmat3x3::fmat3x3(const flt32 val)
+inline void StoreRow(fmat3x3& m, uin32 row, const simd::float4& r)
 {
-    this->arr[0] = this->arr[4] = this->arr[8] = val;
-    this->arr[1] = this->arr[2] = this->arr[3] = this->arr[5] = this->arr[6] = this->arr[7] = 0.0f;
+    r.StoreXYZ(m.arr + 3 * row);
 }
 
-fmat3x3::fmat3x3(const flt32 x0, const flt32 y0, const flt32 z0, const flt32 x1, const flt32 y1, const flt32 z1, const flt32 x2, const flt32 y2, const flt32 z2)
-	: m11(x0), m12(y0), m13(z0), m21(x1), m22(y1), m23(z1), m31(x2), m32(y2), m33(z2) {}
-
-fmat3x3::fmat3x3(const __m128 &r1, const __m128 &r2, const __m128 &r3)
+ENMA_HOT_FN fmat3x3::fmat3x3(const simd::float4 &r1, const simd::float4 &r2, const simd::float4 &r3)
 {
-    this->arr[0] = r1[0];
-    this->arr[1] = r1[1];
-    this->arr[2] = r1[2];
-    this->arr[3] = r2[0];
-    this->arr[4] = r2[1];
-    this->arr[5] = r2[2];
-    this->arr[6] = r3[0];
-    this->arr[7] = r3[1];
-    this->arr[8] = r3[2];
+    StoreRow(*this, 0, r1);
+    StoreRow(*this, 1, r2);
+    StoreRow(*this, 2, r3);
 }
 
-fmat3x3::fmat3x3(const __m256 &f8vals, const flt32 &val)
+// The first eight elements in one simd::float8, the ninth separately
+ENMA_HOT_FN fmat3x3::fmat3x3(const simd::float8 &f8vals, const flt32 &val)
 {
-    this->arr[0] = f8vals[0];
-    this->arr[1] = f8vals[1];
-    this->arr[2] = f8vals[2];
-    this->arr[3] = f8vals[3];
-    this->arr[4] = f8vals[4];
-    this->arr[5] = f8vals[5];
-    this->arr[6] = f8vals[6];
-    this->arr[7] = f8vals[7];
+    f8vals.StoreU(this->arr);
     this->arr[8] = val;
 }
 
-fmat3x3::fmat3x3(const vec3 &row1, const vec3 &row2, const vec3 &row3)
+#ifdef USE_SIMD
+ENMA_HOT_FN fmat3x3::fmat3x3(const __m128 &r1, const __m128 &r2, const __m128 &r3)
+    : fmat3x3(simd::float4(r1), simd::float4(r2), simd::float4(r3)) {}
+#endif
+
+#if defined(USE_SIMD) && defined(__AVX__)
+ENMA_HOT_FN fmat3x3::fmat3x3(const __m256 &f8vals, const flt32 &val) : fmat3x3(simd::float8(f8vals), val) {}
+#endif
+
+
+ENMA_HOT_FN fmat3x3 fmat3x3::operator+(const fmat3x3 m)
 {
-    this->arr[0] = row1.x;
-    this->arr[1] = row1.y;
-    this->arr[2] = row1.z;
-    this->arr[3] = row2.x;
-    this->arr[4] = row2.y;
-    this->arr[5] = row2.z;
-    this->arr[6] = row3.x;
-    this->arr[7] = row3.y;
-    this->arr[8] = row3.z;
+    return fmat3x3(simd::float8::LoadU(this->arr) + simd::float8::LoadU(m.arr), this->m33 + m.m33);
 }
 
-fmat3x3 fmat3x3::operator+(const fmat3x3 m)
+ENMA_HOT_FN fmat3x3 fmat3x3::operator+=(const fmat3x3 m)
 {
-    __m256 t1 = _mm256_loadu_ps(this->arr);
-    __m256 t2 = _mm256_loadu_ps(m.arr);
-    flt32 l = this->m33 + m.m33;
-
-    t1 = _mm256_add_ps(t1, t2);
-    
-    return fmat3x3(t1, l);
+    return *this = *this + m;
 }
 
-fmat3x3 fmat3x3::operator+=(const fmat3x3 m)
+ENMA_HOT_FN fmat3x3 fmat3x3::operator-(const fmat3x3 m)
 {
-    __m256 t1 = _mm256_loadu_ps(this->arr);
-    __m256 t2 = _mm256_loadu_ps(m.arr);
-    this->m33 += m.m33;
-
-    t1 = _mm256_add_ps(t1, t2);
-
-    _mm256_storeu_ps(this->arr, t1);
-
-    return *this;
+    return fmat3x3(simd::float8::LoadU(this->arr) - simd::float8::LoadU(m.arr), this->m33 - m.m33);
 }
 
-fmat3x3 fmat3x3::operator-(const fmat3x3 m)
+ENMA_HOT_FN fmat3x3 fmat3x3::operator-=(const fmat3x3 m)
 {
-    __m256 t1 = _mm256_loadu_ps(this->arr);
-    __m256 t2 = _mm256_loadu_ps(m.arr);
-    flt32 l = this->m33 - m.m33;
-
-    t1 = _mm256_sub_ps(t1, t2);
-    
-    return fmat3x3(t1, l);
+    return *this = *this - m;
 }
 
-fmat3x3 fmat3x3::operator-=(const fmat3x3 m)
+// Row `r` of the left-hand matrix times the right-hand matrix `b`
+inline simd::float4 MultiplyRow(const simd::float4& r, const fmat3x3& b)
 {
-    __m256 t1 = _mm256_loadu_ps(this->arr);
-    __m256 t2 = _mm256_loadu_ps(m.arr);
-    this->m33 -= m.m33;
+    using namespace simd;
 
-    t1 = _mm256_sub_ps(t1, t2);
+    float4 res = Shuffle<0, 0, 0, 0>(r) * LoadRow(b, 0);
+    res = Fmadd(Shuffle<1, 1, 1, 1>(r), LoadRow(b, 1), res);
 
-    _mm256_storeu_ps(this->arr, t1);
-
-    return *this;
+    return Fmadd(Shuffle<2, 2, 2, 2>(r), LoadRow(b, 2), res);
 }
 
-fmat3x3 fmat3x3::operator*(const fmat3x3 other)
+ENMA_HOT_FN fmat3x3 fmat3x3::operator*(const fmat3x3 other)
 {
-    flt32 m1 = m11 * other.m11 + m12 * other.m21 + m13 * other.m31;
-    flt32 m2 = m11 * other.m12 + m12 * other.m22 + m13 * other.m32;
-    flt32 m3 = m11 * other.m13 + m12 * other.m23 + m13 * other.m33;
-
-    flt32 m4 = m21 * other.m11 + m22 * other.m21 + m23 * other.m31;
-    flt32 m5 = m21 * other.m12 + m22 * other.m22 + m23 * other.m32;
-    flt32 m6 = m21 * other.m13 + m22 * other.m23 + m23 * other.m33;
-
-    flt32 m7 = m31 * other.m11 + m32 * other.m21 + m33 * other.m31;
-    flt32 m8 = m31 * other.m12 + m32 * other.m22 + m33 * other.m32;
-    flt32 m9 = m31 * other.m13 + m32 * other.m23 + m33 * other.m33;
-
-    return fmat3x3(m1, m2, m3, m4, m5, m6, m7, m8, m9);
+    return fmat3x3(
+        MultiplyRow(LoadRow(*this, 0), other),
+        MultiplyRow(LoadRow(*this, 1), other),
+        MultiplyRow(LoadRow(*this, 2), other)
+    );
 }
 
-fmat3x3 fmat3x3::operator*=(const fmat3x3 other)
+ENMA_HOT_FN fmat3x3 fmat3x3::operator*=(const fmat3x3 other)
 {
-    flt32 m1 = m11 * other.m11 + m12 * other.m21 + m13 * other.m31;
-    flt32 m2 = m11 * other.m12 + m12 * other.m22 + m13 * other.m32;
-    flt32 m3 = m11 * other.m13 + m12 * other.m23 + m13 * other.m33;
-
-    flt32 m4 = m21 * other.m11 + m22 * other.m21 + m23 * other.m31;
-    flt32 m5 = m21 * other.m12 + m22 * other.m22 + m23 * other.m32;
-    flt32 m6 = m21 * other.m13 + m22 * other.m23 + m23 * other.m33;
-
-    flt32 m7 = m31 * other.m11 + m32 * other.m21 + m33 * other.m31;
-    flt32 m8 = m31 * other.m12 + m32 * other.m22 + m33 * other.m32;
-    flt32 m9 = m31 * other.m13 + m32 * other.m23 + m33 * other.m33;
-
-    *this = fmat3x3(m1, m2, m3, m4, m5, m6, m7, m8, m9);
-
-    return *this;
+    return *this = *this * other;
 }
 
-fmat3x3 fmat3x3::operator*(const flt32 val)
+ENMA_HOT_FN fmat3x3 fmat3x3::operator*(const flt32 val)
 {
-    __m256 t1 = _mm256_loadu_ps(this->arr);
-    __m256 t2 = _mm256_set1_ps(val);
-    flt32 l = this->m33 * val;
-
-    t1 = _mm256_mul_ps(t1, t2);
-    
-    return fmat3x3(t1, l);
+    return fmat3x3(simd::float8::LoadU(this->arr) * val, this->m33 * val);
 }
 
-fmat3x3 fmat3x3::operator*=(const flt32 val)
+ENMA_HOT_FN fmat3x3 fmat3x3::operator*=(const flt32 val)
 {
-    __m256 t1 = _mm256_loadu_ps(this->arr);
-    __m256 t2 = _mm256_set1_ps(val);
-    this->m33 *= val;
-
-    t1 = _mm256_mul_ps(t1, t2);
-
-    _mm256_storeu_ps(this->arr, t1);
-
-    return *this;
+    return *this = *this * val;
 }
 
-fmat3x3 fmat3x3::operator/(const flt32 f)
+ENMA_HOT_FN fmat3x3 fmat3x3::operator/(const flt32 f)
 {
-    const flt32 rec = 1.0f / f;
-
-    __m256 t1 = _mm256_loadu_ps(this->arr);
-    __m256 t2 = _mm256_set1_ps(rec);
-
-    flt32 l = this->m33 * rec;
-
-    t1 = _mm256_mul_ps(t1, t2);
-    
-    return fmat3x3(t1, l);
+    return *this * (1.0f / f);
 }
 
-fmat3x3 fmat3x3::operator/=(const flt32 f)
+ENMA_HOT_FN fmat3x3 fmat3x3::operator/=(const flt32 f)
 {
-    const flt32 rec = 1.0f / f;
-
-    __m256 t1 = _mm256_loadu_ps(this->arr);
-    __m256 t2 = _mm256_set1_ps(rec);
-    this->m33 *= rec;
-
-    t1 = _mm256_mul_ps(t1, t2);
-
-    _mm256_storeu_ps(this->arr, t1);
-
-    return *this;
+    return *this = *this / f;
 }
 
-fmat3x3 Transpose(fmat3x3 mat)
+ENMA_HOT_FN fmat3x3 Transpose(fmat3x3 mat)
 {
     flt32 m12 = mat.m21;
     flt32 m13 = mat.m31;
@@ -261,7 +185,7 @@ fmat3x3 Transpose(fmat3x3 mat)
     return fmat3x3(mat.m11, m12, m13, mat.m12, mat.m22, m23, mat.m13, mat.m23, mat.m33);
 }
 
-flt32 Determinant(fmat3x3 mat)
+ENMA_HOT_FN flt32 Determinant(fmat3x3 mat)
 {
     flt32 d1 = mat.m11 * (mat.m22 * mat.m33 - mat.m23 * mat.m32);
     flt32 d2 = mat.m12 * (mat.m23 * mat.m31 - mat.m21 * mat.m33);
@@ -270,7 +194,7 @@ flt32 Determinant(fmat3x3 mat)
     return d1 + d2 + d3;
 }
 
-fmat3x3 Inverse(fmat3x3 mat)
+ENMA_FN fmat3x3 Inverse(fmat3x3 mat)
 {
     flt32 m1 = mat.m22 * mat.m33 - mat.m23 * mat.m32;
     flt32 m2 = mat.m23 * mat.m31 - mat.m21 * mat.m33;
@@ -1,29 +1,343 @@
 /* Single Precision Floating-Point 3x4 Matrix
- * 
+ *
  * This header file is part of Enmatica library
  *
  * Copyright (c) 202X Villainous Softworks
- * 
+ *
  */
 
 #pragma once
+#include "fmat4x4.hpp"
 #include "../../vector.hpp"
 #include "../../base.hpp"
 #include "../../empch.hpp"
 
-struct fmat3x4
+/**
+ * Compact affine transform.
+ *
+ * Holds the three meaningful columns of an affine fmat4x4 (whose last column is always (0, 0, 0, 1)),
+ * each column stored as one row of four floats. Row i is column i of the equivalent fmat4x4, so the
+ * translation lives in m14, m24 and m34. This is 48 bytes instead of 64 and every row is one __m128.
+ *
+ * Products follow the fmat4x4 convention: a * b applies `a` first, then `b`.
+ */
+struct ALIGN(16) fmat3x4
 {
     union
     {
+        flt32 _arr[12];
         struct
         {
             flt32 m11, m12, m13, m14;
             flt32 m21, m22, m23, m24;
             flt32 m31, m32, m33, m34;
         };
+        #ifdef USE_SIMD
+        __m128 _vals[3];
+        #endif
     };
+
+    /**
+     * Diagonal constructor.
+     *
+     * \param val Value of the diagonal of the linear part. Defaults to 0.0f; 1.0f gives the identity transform.
+     */
+    constexpr fmat3x4(flt32 val = 0.0f);
+    constexpr fmat3x4(flt32 x0, flt32 y0, flt32 z0, flt32 w0, flt32 x1, flt32 y1, flt32 z1, flt32 w1, flt32 x2, flt32 y2, flt32 z2, flt32 w2);
+    /**
+     * Conversion from an affine fmat4x4.
+     *
+     * \param m An fmat4x4 whose last column is (0, 0, 0, 1). The last column is discarded.
+     */
+    explicit fmat3x4(const fmat4x4& m);
+
+    /**
+     * Conversion operator to fmat4x4.
+     *
+     * \return The equivalent fmat4x4 with the last column set to (0, 0, 0, 1).
+     */
+    explicit operator fmat4x4() const;
+
+    /**
+     * Concatenation operator.
+     *
+     * \param other The fmat3x4 applied after this transform.
+     * \return The transform equivalent to applying this transform and then `other`.
+     */
+    fmat3x4 operator*(const fmat3x4& other) const;
+    /**
+     * Concatenation assignment operator.
+     *
+     * \param other The fmat3x4 applied after this transform.
+     * \return Reference to the modified fmat3x4.
+     */
+    fmat3x4& operator*=(const fmat3x4& other);
+
+    fmat3x4(const simd::float4& r1, const simd::float4& r2, const simd::float4& r3);
+
+    #ifdef USE_SIMD
+    fmat3x4(const __m128& r1, const __m128& r2, const __m128& r3);
+    #endif
+
+    #ifdef DEBUG
+    friend std::ostream& operator<<(std::ostream& os, const fmat3x4& m)
+    {
+        os
+        << "\n{\t\t\t\t\t\t\t\t\t}\n"
+        << "|\t" << std::setw(8) << m.m11 << "\t" << std::setw(8) << m.m12 << "\t" << std::setw(8) << m.m13 << "\t" << std::setw(8) << m.m14 << "\t|\n"
+        << "|\t" << std::setw(8) << m.m21 << "\t" << std::setw(8) << m.m22 << "\t" << std::setw(8) << m.m23 << "\t" << std::setw(8) << m.m24 << "\t|\n"
+        << "|\t" << std::setw(8) << m.m31 << "\t" << std::setw(8) << m.m32 << "\t" << std::setw(8) << m.m33 << "\t" << std::setw(8) << m.m34 << "\t|\n{\t\t\t\t\t\t\t\t\t}";
+
+        return os;
+    }
+    #endif
+
+    const static fmat3x4 identity;
 };
 
+/**
+ * Transforms a point (w = 1) by the affine transform.
+ *
+ * \param m The affine transform.
+ * \param p The point to transform.
+ * \return The transformed point.
+ */
+fvec3 TransformPoint(const fmat3x4& m, const fvec3& p);
+/**
+ * Transforms a direction (w = 0) by the affine transform, ignoring the translation.
+ *
+ * \param m The affine transform.
+ * \param v The direction to transform.
+ * \return The transformed direction.
+ */
+fvec3 TransformVector(const fmat3x4& m, const fvec3& v);
+/**
+ * Transforms an array of points (w = 1) by the affine transform. `in` and `out` may point to the same array.
+ *
+ * \param m The affine transform.
+ * \param in Pointer to an array of at least `count` fvec3 elements.
+ * \param out Pointer to an array of at least `count` fvec3 elements.
+ * \param count Number of points to transform.
+ */
+void TransformPoints(const fmat3x4& m, const fvec3* in, fvec3* out, uin32 count);
+/**
+ * Transforms an array of directions (w = 0) by the affine transform. `in` and `out` may point to the same array.
+ *
+ * \param m The affine transform.
+ * \param in Pointer to an array of at least `count` fvec3 elements.
+ * \param out Pointer to an array of at least `count` fvec3 elements.
+ * \param count Number of directions to transform.
+ */
+void TransformVectors(const fmat3x4& m, const fvec3* in, fvec3* out, uin32 count);
+/**
+ * Calculates the inverse of an affine transform with rotation, scale and shear.
+ *
+ * \param m The input fmat3x4.
+ * \return The inverse of `m`.
+ */
+fmat3x4 AffineInverse(const fmat3x4& m);
+/**
+ * Calculates the inverse of a rigid transform (rotation and translation only).
+ *
+ * \param m The input fmat3x4. Its linear part must be orthonormal.
+ * \return The inverse of `m`.
+ */
+fmat3x4 RigidInverse(const fmat3x4& m);
+
+constexpr fmat3x4::fmat3x4(flt32 val)
+    : m11(val), m12(0.0f), m13(0.0f), m14(0.0f),
+      m21(0.0f), m22(val), m23(0.0f), m24(0.0f),
+      m31(0.0f), m32(0.0f), m33(val), m34(0.0f) {}
+
+constexpr fmat3x4::fmat3x4(flt32 x0, flt32 y0, flt32 z0, flt32 w0, flt32 x1, flt32 y1, flt32 z1, flt32 w1, flt32 x2, flt32 y2, flt32 z2, flt32 w2)
+    : m11(x0), m12(y0), m13(z0), m14(w0),
+      m21(x1), m22(y1), m23(z1), m24(w1),
+      m31(x2), m32(y2), m33(z2), m34(w2) {}
+
+inline constexpr fmat3x4 fmat3x4::identity = fmat3x4(1.0f);
+
 #ifdef ENMA_IMPLEMENTATION
+// Rows of the transform as SIMD registers
+inline simd::float4 LoadRow(const fmat3x4& m, uin32 row)
+{
+    #ifdef USE_SIMD
+    return m._vals[row];
+    #else
+    return simd::float4::LoadU(m._arr + 4 * row);
+    #endif
+}
+
+inline void StoreRow(fmat3x4& m, uin32 row, const simd::float4& r)
+{
+    #ifdef USE_SIMD
+    m._vals[row] = r;
+    #else
+    r.StoreU(m._arr + 4 * row);
+    #endif
+}
+
+ENMA_HOT_FN fmat3x4::fmat3x4(const simd::float4& r1, const simd::float4& r2, const simd::float4& r3)
+{
+    StoreRow(*this, 0, r1);
+    StoreRow(*this, 1, r2);
+    StoreRow(*this, 2, r3);
+}
+
+#ifdef USE_SIMD
+ENMA_HOT_FN fmat3x4::fmat3x4(const __m128& r1, const __m128& r2, const __m128& r3)
+    : fmat3x4(simd::float4(r1), simd::float4(r2), simd::float4(r3)) {}
+#endif
+
+ENMA_FN fmat3x4::fmat3x4(const fmat4x4& m)
+{
+    simd::float4 r1 = LoadRow(m, 0);
+    simd::float4 r2 = LoadRow(m, 1);
+    simd::float4 r3 = LoadRow(m, 2);
+    simd::float4 r4 = LoadRow(m, 3);
+
+    simd::Transpose(r1, r2, r3, r4);
+
+    StoreRow(*this, 0, r1);
+    StoreRow(*this, 1, r2);
+    StoreRow(*this, 2, r3);
+}
+
+ENMA_HOT_FN fmat3x4::operator fmat4x4() const
+{
+    simd::float4 r1 = LoadRow(*this, 0);
+    simd::float4 r2 = LoadRow(*this, 1);
+    simd::float4 r3 = LoadRow(*this, 2);
+    simd::float4 r4 = simd::float4::Set(0.0f, 0.0f, 0.0f, 1.0f);
+
+    simd::Transpose(r1, r2, r3, r4);
+
+    return fmat4x4(r1, r2, r3, r4);
+}
+
+// Row `b` of the right-hand transform combined with the rows of the left-hand transform `a`;
+// the translation lane of `b` is carried over since the implicit last row of `a` is (0, 0, 0, 1)
+inline simd::float4 ConcatenateRow(const fmat3x4& a, const simd::float4& b)
+{
+    using namespace simd;
+
+    float4 r = Blend<1, 1, 1, 0>(b, float4::Zero());
+    r = Fmadd(Shuffle<0, 0, 0, 0>(b), LoadRow(a, 0), r);
+    r = Fmadd(Shuffle<1, 1, 1, 1>(b), LoadRow(a, 1), r);
+
+    return Fmadd(Shuffle<2, 2, 2, 2>(b), LoadRow(a, 2), r);
+}
+
+ENMA_HOT_FN fmat3x4 fmat3x4::operator*(const fmat3x4& other) const
+{
+    return fmat3x4(
+        ConcatenateRow(*this, LoadRow(other, 0)),
+        ConcatenateRow(*this, LoadRow(other, 1)),
+        ConcatenateRow(*this, LoadRow(other, 2))
+    );
+}
+
+ENMA_HOT_FN fmat3x4& fmat3x4::operator*=(const fmat3x4& other)
+{
+    // Copy the left-hand side first, every result row reads all three of its rows
+    const fmat3x4 lhs = *this;
+
+    StoreRow(*this, 0, ConcatenateRow(lhs, LoadRow(other, 0)));
+    StoreRow(*this, 1, ConcatenateRow(lhs, LoadRow(other, 1)));
+    StoreRow(*this, 2, ConcatenateRow(lhs, LoadRow(other, 2)));
+
+    return *this;
+}
+
+// Dot products of the three rows with `v`, packed as (r1.v, r2.v, r3.v, r3.v)
+inline simd::float4 DotRows(const fmat3x4& m, const simd::float4& v)
+{
+    using namespace simd;
+
+    const float4 d1 = LoadRow(m, 0) * v;
+    const float4 d2 = LoadRow(m, 1) * v;
+    const float4 d3 = LoadRow(m, 2) * v;
+
+    return HAdd(HAdd(d1, d2), HAdd(d3, d3));
+}
+
+ENMA_HOT_FN fvec3 TransformPoint(const fmat3x4& m, const fvec3& p)
+{
+    return fvec3(DotRows(m, simd::float4::Set(p.x, p.y, p.z, 1.0f)));
+}
+
+ENMA_HOT_FN fvec3 TransformVector(const fmat3x4& m, const fvec3& v)
+{
+    return fvec3(DotRows(m, simd::float4::Set(v.x, v.y, v.z, 0.0f)));
+}
+
+ENMA_FN void TransformPoints(const fmat3x4& m, const fvec3* in, fvec3* out, uin32 count)
+{
+    // Broadcast + FMA over the columns is cheaper per point than three horizontal dot products
+    TransformPoints(static_cast<fmat4x4>(m), in, out, count);
+}
+
+ENMA_FN void TransformVectors(const fmat3x4& m, const fvec3* in, fvec3* out, uin32 count)
+{
+    TransformVectors(static_cast<fmat4x4>(m), in, out, count);
+}
+
+// Translation column of the transform, (m14, m24, m34, m34)
+inline simd::float4 TranslationColumn(const fmat3x4& m)
+{
+    using namespace simd;
+
+    const float4 t = Shuffle<3, 3, 3, 3>(LoadRow(m, 0), LoadRow(m, 1));      // (m14, m14, m24, m24)
+
+    return Shuffle<0, 2, 3, 3>(t, LoadRow(m, 2));
+}
+
+// Assembles the inverse from the columns `c` of its linear part and the translation `t` of the original transform
+inline fmat3x4 AffineFromInverseColumns(simd::float4 c0, simd::float4 c1, simd::float4 c2, const simd::float4& t)
+{
+    using namespace simd;
+
+    float4 w = Shuffle<0, 0, 0, 0>(t) * c0;
+    w = Fmadd(Shuffle<1, 1, 1, 1>(t), c1, w);
+    w = Fmadd(Shuffle<2, 2, 2, 2>(t), c2, w);
+    w = -w;
+
+    Transpose(c0, c1, c2, w);
+
+    return fmat3x4(c0, c1, c2);
+}
+
+ENMA_FN fmat3x4 AffineInverse(const fmat3x4& m)
+{
+    using namespace simd;
+
+    const float4 r0 = Blend<0, 0, 0, 1>(LoadRow(m, 0), float4::Zero());
+    const float4 r1 = Blend<0, 0, 0, 1>(LoadRow(m, 1), float4::Zero());
+    const float4 r2 = Blend<0, 0, 0, 1>(LoadRow(m, 2), float4::Zero());
+
+    // Columns of the adjugate of the linear part
+    float4 c0 = CrossRows(r1, r2);
+    float4 c1 = CrossRows(r2, r0);
+    float4 c2 = CrossRows(r0, r1);
+
+    const float4 rdet = float4::Set1(1.0f) / Dot3(r0, c0);
+
+    c0 = c0 * rdet;
+    c1 = c1 * rdet;
+    c2 = c2 * rdet;
+
+    return AffineFromInverseColumns(c0, c1, c2, TranslationColumn(m));
+}
+
+ENMA_FN fmat3x4 RigidInverse(const fmat3x4& m)
+{
+    using namespace simd;
 
-#endif
\ No newline at end of file
+    // The inverse rotation is the transpose, whose columns are the rows of `m`
+    return AffineFromInverseColumns(
+        Blend<0, 0, 0, 1>(LoadRow(m, 0), float4::Zero()),
+        Blend<0, 0, 0, 1>(LoadRow(m, 1), float4::Zero()),
+        Blend<0, 0, 0, 1>(LoadRow(m, 2), float4::Zero()),
+        TranslationColumn(m)
+    );
+}
+#endif
@@ -26,8 +26,7 @@ struct ALIGN(32) fmat4x2
         vec2 rows[4];
     };
     
-    fmat4x2(const fmat4x2 &m);
-    fmat4x2(const flt32 x0, const flt32 y0, const flt32 x1, const flt32 y1, const flt32 x2, const flt32 y2, const flt32 x3, const flt32 y3);
+    constexpr fmat4x2(const flt32 x0, const flt32 y0, const flt32 x1, const flt32 y1, const flt32 x2, const flt32 y2, const flt32 x3, const flt32 y3);
 
     #ifdef DEBUG
 	friend std::ostream& operator<<(std::ostream& os, fmat4x2 m)
@@ -43,19 +42,5 @@ struct ALIGN(32) fmat4x2
 	#endif
 };
 
-#ifdef ENMA_IMPLEMENTATION
-fmat4x2::fmat4x2(const fmat4x2& m)
-{
-    this->m11 = m.m11;
-    this->m12 = m.m12;
-    this->m21 = m.m21;
-    this->m22 = m.m22;
-    this->m31 = m.m31;
-    this->m32 = m.m32;
-    this->m41 = m.m41;
-    this->m42 = m.m42;
-}
-
-fmat4x2::fmat4x2(const flt32 x0, const flt32 y0, const flt32 x1, const flt32 y1, const flt32 x2, const flt32 y2, const flt32 x3, const flt32 y3)
-    : m11(x0), m12(y0), m21(x1), m22(y1), m31(x2), m32(y2), m41(x3), m42(y3) {};
-#endif
\ No newline at end of file
+constexpr fmat4x2::fmat4x2(const flt32 x0, const flt32 y0, const flt32 x1, const flt32 y1, const flt32 x2, const flt32 y2, const flt32 x3, const flt32 y3)
+    : m11(x0), m12(y0), m21(x1), m22(y1), m31(x2), m32(y2), m41(x3), m42(y3) {}
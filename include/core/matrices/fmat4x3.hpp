@@ -13,7 +13,6 @@
 
 struct ALIGN(64) fmat4x3
 {
-private:
 	union
 	{
 		struct
@@ -28,27 +27,19 @@ private:
 	};
 
 private:
-    flt32 x_pad[4];
+    flt32 x_pad[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
 
 public:	
-	fmat4x3(const fmat4x3 &m)
-	{
-			*this = m;
-	}
-
-	fmat4x3(const flt32 x0 = 0.0f, const flt32 y0 = 0.0f, const flt32 z0 = 0.0f, const flt32 x1 = 0.0f, const flt32 y1 = 0.0f, const flt32 z1 = 0.0f, const flt32 x2 = 0.0f, const flt32 y2 = 0.0f, const flt32 z2 = 0.0f, const flt32 x3 = 0.0f, const flt32 y3 = 0.0f, const flt32 z3 = 0.0f)
+	constexpr fmat4x3(const flt32 x0 = 0.0f, const flt32 y0 = 0.0f, const flt32 z0 = 0.0f, const flt32 x1 = 0.0f, const flt32 y1 = 0.0f, const flt32 z1 = 0.0f, const flt32 x2 = 0.0f, const flt32 y2 = 0.0f, const flt32 z2 = 0.0f, const flt32 x3 = 0.0f, const flt32 y3 = 0.0f, const flt32 z3 = 0.0f)
 			: m11(x0), m12(y0), m13(z0), m21(x1), m22(y1), m23(z1), m31(x2), m32(y2), m33(z2), m41(x3), m42(y3), m43(z3) {}
 
-	fmat4x3(const vec3 &v0, const vec3 &v1, const vec3 &v2)
-	{
-			this->rows[0] = v0;
-			this->rows[1] = v1;
-			this->rows[2] = v2;
-	}
+	constexpr fmat4x3(const vec3 &v0, const vec3 &v1, const vec3 &v2)
+			: m11(v0.x), m12(v0.y), m13(v0.z), m21(v1.x), m22(v1.y), m23(v1.z), m31(v2.x), m32(v2.y), m33(v2.z), m41(0.0f), m42(0.0f), m43(0.0f) {}
 
 	fmat4x3 operator+(const fmat4x3 m)
 	{
-		return fmat4x3(this->rows[0] + m.rows[0], this->rows[1] + m.rows[1], this->rows[2] + m.rows[2]);
+		fmat4x3 res = *this;
+		return res += m;
 	}
 	
 	fmat4x3 operator+=(const fmat4x3 m)
@@ -63,7 +54,8 @@ public:
 
 	fmat4x3 operator-(const fmat4x3 m)
 	{
-		return fmat4x3(this->rows[0] - m.rows[0], this->rows[1] - m.rows[1], this->rows[2] - m.rows[2]);
+		fmat4x3 res = *this;
+		return res -= m;
 	}
 	
 	fmat4x3 operator-=(const fmat4x3 m)
@@ -76,85 +68,40 @@ public:
 		return *this;
 	}
 
-	#ifdef USE_SIMD
-	fmat4x3(const __m128 &r0, const __m128 &r1, const __m128 &r2, const __m128 &r3)
+	fmat4x3(const simd::float4 &r0, const simd::float4 &r1, const simd::float4 &r2, const simd::float4 &r3)
 	{
-			this->rows[0] = r0;
-			this->rows[1] = r1;
-			this->rows[2] = r2;
-			this->rows[3] = r3;
+			r0.StoreXYZ(this->arr);
+			r1.StoreXYZ(this->arr + 3);
+			r2.StoreXYZ(this->arr + 6);
+			r3.StoreXYZ(this->arr + 9);
 	}
 
+	#ifdef USE_SIMD
+	fmat4x3(const __m128 &r0, const __m128 &r1, const __m128 &r2, const __m128 &r3)
+			: fmat4x3(simd::float4(r0), simd::float4(r1), simd::float4(r2), simd::float4(r3)) {}
+	#endif
+
+	// Both operands are treated as 4x4 matrices with a zero last column, so row i of the product
+	// combines the first three rows of `m` with the weights of row i of this matrix
 	fmat4x3 operator*(const fmat4x3 m)
 	{
-		flt32 	a[4] = { 0, 0, 0, 0 }, 
-				b[4] = { 0, 0, 0, 0 }, 
-				c[4] = { 0, 0, 0, 0 }, 
-				d[4] = { 0, 0, 0, 0 }; 
-
-		__m128 r00, r01, r02, r03;
-		__m128 r10, r11, r12, r13;
-		__m128 i1, i2, i3, i4;
-
-		r00 = set(this->rows[0]);
-		r01 = set(this->rows[1]);
-		r02 = set(this->rows[2]);
-		r03 = set(this->rows[3]);
-
-		r10 = set(m.rows[0]);
-		r11 = set(m.rows[1]);
-		r12 = set(m.rows[2]);
-		r13 = set(m.rows[3]);
-
-		_MM_TRANSPOSE4_PS(r10, r11, r12, r13);
-	
-		i1 = _mm_dp_ps(r00, r10, 0xFF);
-		i2 = _mm_dp_ps(r00, r11, 0xFF);
-		i3 = _mm_dp_ps(r00, r12, 0xFF);
-		i4 = _mm_dp_ps(r00, r13, 0xFF);
-
-		a[0] = i1[0];
-		a[1] = i2[0];
-		a[2] = i3[0];
-		a[3] = i4[0];
-
-
-		i1 = _mm_dp_ps(r01, r10, 0xFF);
-		i2 = _mm_dp_ps(r01, r11, 0xFF);
-		i3 = _mm_dp_ps(r01, r12, 0xFF);
-		i4 = _mm_dp_ps(r01, r13, 0xFF);
-
-		b[0] = i1[0];
-		b[1] = i2[0];
-		b[2] = i3[0];
-		b[3] = i4[0];
+		using namespace simd;
 
+		const float4 b0 = float4::LoadXYZ(m.arr);
+		const float4 b1 = float4::LoadXYZ(m.arr + 3);
+		const float4 b2 = float4::LoadXYZ(m.arr + 6);
 
-		i1 = _mm_dp_ps(r02, r10, 0xFF);
-		i2 = _mm_dp_ps(r02, r11, 0xFF);
-		i3 = _mm_dp_ps(r02, r12, 0xFF);
-		i4 = _mm_dp_ps(r02, r13, 0xFF);
+		float4 r[4];
 
-		c[0] = i1[0];
-		c[1] = i2[0];
-		c[2] = i3[0];
-		c[3] = i4[0];
-
-
-		i1 = _mm_dp_ps(r03, r10, 0xFF);
-		i2 = _mm_dp_ps(r03, r11, 0xFF);
-		i3 = _mm_dp_ps(r03, r12, 0xFF);
-		i4 = _mm_dp_ps(r03, r13, 0xFF);
-
-		d[0] = i1[0];
-		d[1] = i2[0];
-		d[2] = i3[0];
-		d[3] = i4[0];
+		for(uin32 i = 0; i < 4; i++)
+		{
+			const float4 a = float4::LoadXYZ(this->arr + 3 * i);
 
+			r[i] = Fmadd(Shuffle<2, 2, 2, 2>(a), b2, Fmadd(Shuffle<1, 1, 1, 1>(a), b1, Shuffle<0, 0, 0, 0>(a) * b0));
+		}
 
-		return fmat4x3(vec3(a), vec3(b), vec3(c));
+		return fmat4x3(r[0], r[1], r[2], r[3]);
 	}
-	#endif
 
 	#ifdef DEBUG
 	friend std::ostream &operator<<(std::ostream &os, fmat4x3 m)
@@ -10,7 +10,7 @@
 #include "../../vector.hpp"
 #include "../../base.hpp"
 #include "../../empch.hpp"
-#include <smmintrin.h>
+#include "../simd.hpp"
 
 struct ALIGN(64) fmat4x4
 {
@@ -30,9 +30,8 @@ struct ALIGN(64) fmat4x4
 		#endif
 	};
 
-	fmat4x4(const fmat4x4& m);
-	fmat4x4(flt32 val = 0.0f);
-	fmat4x4(flt32 x0, flt32 y0, flt32 z0, flt32 w0, flt32 x1, flt32 y1 = 0.0f, flt32 z1 = 0.0f, flt32 w1 = 0.0f, flt32 x2 = 0.0f, flt32 y2 = 0.0f, flt32 z2 = 0.0f, flt32 w2 = 0.0f, flt32 x3 = 0.0f, flt32 y3 = 0.0f, flt32 z3 = 0.0f, flt32 w3 = 0.0f);
+	constexpr fmat4x4(flt32 val = 0.0f);
+	constexpr fmat4x4(flt32 x0, flt32 y0, flt32 z0, flt32 w0, flt32 x1, flt32 y1 = 0.0f, flt32 z1 = 0.0f, flt32 w1 = 0.0f, flt32 x2 = 0.0f, flt32 y2 = 0.0f, flt32 z2 = 0.0f, flt32 w2 = 0.0f, flt32 x3 = 0.0f, flt32 y3 = 0.0f, flt32 z3 = 0.0f, flt32 w3 = 0.0f);
 	fmat4x4(const vec4& row1, const vec4& row2, const vec4& row3, const vec4& row4);
 
 	fvec4 operator[](uin32 rowIndex) const;
@@ -50,6 +49,8 @@ struct ALIGN(64) fmat4x4
 
 	fvec4 operator*(const fvec4 &other) const;
 
+	fmat4x4(const simd::float4& r1, const simd::float4& r2, const simd::float4& r3, const simd::float4& r4);
+
 	#ifdef USE_SIMD
 	fmat4x4(const __m128& r1, const __m128& r2, const __m128& r3, const __m128& r4);
 	fmat4x4(const __m256& r12, const __m256& r34);
@@ -74,41 +75,163 @@ struct ALIGN(64) fmat4x4
 };
 
 fmat4x4 Transpose(const fmat4x4& m);
+/**
+ * Calculates the determinant of the matrix.
+ * 
+ * \param m The input fmat4x4.
+ * \return The determinant of `m`.
+ */
+flt32 Determinant(const fmat4x4& m);
+/**
+ * Calculates the inverse of a general matrix.
+ * 
+ * The result is undefined (contains inf or NaN) when `m` is singular; use InverseWithDeterminant to detect that case.
+ * 
+ * \param m The input fmat4x4.
+ * \return The inverse of `m`.
+ */
+fmat4x4 Inverse(const fmat4x4& m);
+/**
+ * Calculates the inverse of a general matrix and reports its determinant.
+ * 
+ * Singular input is handled without branching: the returned matrix is zero and `determinant` is 0.
+ * 
+ * \param m The input fmat4x4.
+ * \param determinant Receives the determinant of `m`.
+ * \return The inverse of `m`, or a zero matrix if `m` is singular.
+ */
+fmat4x4 InverseWithDeterminant(const fmat4x4& m, flt32& determinant);
+/**
+ * Calculates the inverse of an affine matrix whose upper 3x3 block may contain rotation, scale and shear.
+ * 
+ * The last column must be (0, 0, 0, 1). The 3x3 block is inverted through cross products and the
+ * translation row is transformed by that inverse.
+ * 
+ * \param m The input affine fmat4x4.
+ * \return The inverse of `m`.
+ */
 fmat4x4 AffineInverse(const fmat4x4& m);
+/**
+ * Calculates the inverse of a rigid transform (rotation and translation only).
+ * 
+ * The upper 3x3 block must be orthonormal and the last column (0, 0, 0, 1); the inverse
+ * is the transposed rotation with the translation rotated back and negated.
+ * 
+ * \param m The input rigid fmat4x4.
+ * \return The inverse of `m`.
+ */
+fmat4x4 RigidInverse(const fmat4x4& m);
+/**
+ * Calculates the inverse of an orthonormal matrix, such as a pure rotation or change of basis.
+ * 
+ * The inverse of an orthonormal matrix is its transpose.
+ * 
+ * \param m The input orthonormal fmat4x4.
+ * \return The inverse of `m`.
+ */
+fmat4x4 OrthonormalInverse(const fmat4x4& m);
+
+/**
+ * Transforms an array of points (w = 1) by the matrix, discarding the resulting w.
+ * 
+ * Uses the row-vector convention of the library, out[i] = in[i] * m, so the translation row is applied.
+ * `in` and `out` may point to the same array.
+ * 
+ * \param m The transformation matrix.
+ * \param in Pointer to an array of at least `count` fvec3 elements.
+ * \param out Pointer to an array of at least `count` fvec3 elements.
+ * \param count Number of points to transform.
+ */
+void TransformPoints(const fmat4x4& m, const fvec3* in, fvec3* out, uin32 count);
+/**
+ * Transforms an array of homogeneous vectors by the matrix, out[i] = in[i] * m.
+ * 
+ * \param m The transformation matrix.
+ * \param in Pointer to an array of at least `count` fvec4 elements.
+ * \param out Pointer to an array of at least `count` fvec4 elements.
+ * \param count Number of vectors to transform.
+ */
+void TransformPoints(const fmat4x4& m, const fvec4* in, fvec4* out, uin32 count);
+/**
+ * Transforms an array of directions (w = 0) by the matrix, ignoring the translation row.
+ * 
+ * \param m The transformation matrix.
+ * \param in Pointer to an array of at least `count` fvec3 elements.
+ * \param out Pointer to an array of at least `count` fvec3 elements.
+ * \param count Number of vectors to transform.
+ */
+void TransformVectors(const fmat4x4& m, const fvec3* in, fvec3* out, uin32 count);
+/**
+ * Transforms an array of points (w = 1) by the matrix and divides each result by its w.
+ * 
+ * \param m The transformation matrix, typically a view-projection matrix.
+ * \param in Pointer to an array of at least `count` fvec3 elements.
+ * \param out Pointer to an array of at least `count` fvec3 elements.
+ * \param count Number of points to transform.
+ */
+void TransformPointsProjective(const fmat4x4& m, const fvec3* in, fvec3* out, uin32 count);
+
+constexpr fmat4x4::fmat4x4(flt32 val) 
+	: m11(val), m12(0.0f), m13(0.0f), m14(0.0f), m21(0.0f), m22(val), m23(0.0f), m24(0.0f), 
+	  m31(0.0f), m32(0.0f), m33(val), m34(0.0f), m41(0.0f), m42(0.0f), m43(0.0f), m44(val) {}
+
+constexpr fmat4x4::fmat4x4(flt32 x0, flt32 y0, flt32 z0, flt32 w0, flt32 x1, flt32 y1, flt32 z1, flt32 w1, flt32 x2, flt32 y2, flt32 z2, flt32 w2, flt32 x3, flt32 y3, flt32 z3, flt32 w3) : m11(x0), m12(y0), m13(z0), m14(w0), m21(x1), m22(y1), m23(z1), m24(w1), m31(x2), m32(y2), m33(z2), m34(w2), m41(x3), m42(y3), m43(z3), m44(w3) {}
+
+inline constexpr fmat4x4 fmat4x4::zero = fmat4x4();
+inline constexpr fmat4x4 fmat4x4::identity = fmat4x4(1.0f);
 
 #ifdef ENMA_IMPLEMENTATION
-fmat4x4::fmat4x4(const fmat4x4& m) 
-	: m11(m.m11), m12(m.m12), m13(m.m13), m14(m.m14), m21(m.m21), m22(m.m22), m23(m.m23), m24(m.m24), 
-	  m31(m.m31), m32(m.m32), m33(m.m33), m34(m.m34), m41(m.m41), m42(m.m42), m43(m.m43), m44(m.m44) {}
+// Rows of the matrix as SIMD registers. Under USE_SIMD the union members keep the matrix 32-byte aligned
+inline simd::float4 LoadRow(const fmat4x4& m, uin32 row)
+{
+	#ifdef USE_SIMD
+	return m._vals[row];
+	#else
+	return simd::float4::LoadU(m._arr + 4 * row);
+	#endif
+}
 
-fmat4x4::fmat4x4(flt32 val)
+inline void StoreRow(fmat4x4& m, uin32 row, const simd::float4& r)
 {
-	_arr[0] = _arr[5] = _arr[10] = _arr[15] = val;
-	_arr[1] = _arr[2] = _arr[3] = _arr[4] = _arr[6] = _arr[7] = _arr[8] = _arr[9] = _arr[11] = _arr[12] = _arr[13] = _arr[14] = 0.0f;
+	#ifdef USE_SIMD
+	m._vals[row] = r;
+	#else
+	r.StoreU(m._arr + 4 * row);
+	#endif
 }
 
-fmat4x4::fmat4x4(flt32 x0, flt32 y0, flt32 z0, flt32 w0, flt32 x1, flt32 y1, flt32 z1, flt32 w1, flt32 x2, flt32 y2, flt32 z2, flt32 w2, flt32 x3, flt32 y3, flt32 z3, flt32 w3) : m11(x0), m12(y0), m13(z0), m14(w0), m21(x1), m22(y1), m23(z1), m24(w1), m31(x2), m32(y2), m33(z2), m34(w2), m41(x3), m42(y3), m43(z3), m44(w3) {}
+// Rows 2 * pair and 2 * pair + 1 in one simd::float8
+inline simd::float8 LoadRowPair(const fmat4x4& m, uin32 pair)
+{
+	#ifdef USE_SIMD
+	return simd::float8::Load(m._arr + 8 * pair);
+	#else
+	return simd::float8::LoadU(m._arr + 8 * pair);
+	#endif
+}
 
-fmat4x4::fmat4x4(const vec4& row1, const vec4& row2, const vec4& row3, const vec4& row4)
+inline void StoreRowPair(fmat4x4& m, uin32 pair, const simd::float8& r)
 {
-	this->_vals[0] = row1;
-	this->_vals[1] = row2;
-	this->_vals[2] = row3;
-	this->_vals[3] = row4;
+	#ifdef USE_SIMD
+	r.Store(m._arr + 8 * pair);
+	#else
+	r.StoreU(m._arr + 8 * pair);
+	#endif
 }
 
-fmat4x4 fmat4x4::operator-() const
+ENMA_HOT_FN fmat4x4::fmat4x4(const vec4& row1, const vec4& row2, const vec4& row3, const vec4& row4)
+	: fmat4x4(LoadXYZW(row1), LoadXYZW(row2), LoadXYZW(row3), LoadXYZW(row4)) {}
+
+ENMA_HOT_FN fmat4x4::fmat4x4(const simd::float4& r1, const simd::float4& r2, const simd::float4& r3, const simd::float4& r4)
 {
-	return mat4x4(
-		-m11, -m12, -m13, -m14, 
-		-m21, -m22, -m23, -m24, 
-		-m31, -m32, -m33, -m34, 
-		-m41, -m42, -m43, -m44
-	);
+	StoreRow(*this, 0, r1);
+	StoreRow(*this, 1, r2);
+	StoreRow(*this, 2, r3);
+	StoreRow(*this, 3, r4);
 }
 
 #ifdef USE_SIMD
-fmat4x4::fmat4x4(const __m128& r1, const __m128& r2, const __m128& r3, const __m128& r4)
+ENMA_HOT_FN fmat4x4::fmat4x4(const __m128& r1, const __m128& r2, const __m128& r3, const __m128& r4)
 {
 	this->_vals[0] = r1;
 	this->_vals[1] = r2;
@@ -116,325 +239,995 @@ fmat4x4::fmat4x4(const __m128& r1, const __m128& r2, const __m128& r3, const __m
 	this->_vals[3] = r4;
 }
 
-fmat4x4::fmat4x4(const __m256& r12, const __m256& r34)
+ENMA_HOT_FN fmat4x4::fmat4x4(const __m256& r12, const __m256& r34)
 {
 	this->_vals2[0] = r12;
 	this->_vals2[1] = r34;
 }
 
-fvec4 fmat4x4::operator[](uin32 rowIndex) const
+/**
+ * Four-row variant of LinearCombine. `a` holds four rows, one per 128-bit lane, and `m` holds
+ * the rows of the right-hand matrix broadcast into every lane.
+ */
+ENMA_TARGET_AVX512 inline __m512 LinearCombine4(const __m512& a, const __m512 (&m)[4])
+{
+	__m512 r = _mm512_mul_ps(_mm512_shuffle_ps(a, a, 0x00), m[0]);
+	r = _mm512_fmadd_ps(_mm512_shuffle_ps(a, a, 0x55), m[1], r);
+	r = _mm512_fmadd_ps(_mm512_shuffle_ps(a, a, 0xAA), m[2], r);
+
+	return _mm512_fmadd_ps(_mm512_shuffle_ps(a, a, 0xFF), m[3], r);
+}
+
+ENMA_TARGET_AVX512 inline void BroadcastRows(const fmat4x4& m, __m512 (&r)[4])
+{
+	r[0] = _mm512_broadcast_f32x4(m._vals[0]);
+	r[1] = _mm512_broadcast_f32x4(m._vals[1]);
+	r[2] = _mm512_broadcast_f32x4(m._vals[2]);
+	r[3] = _mm512_broadcast_f32x4(m._vals[3]);
+}
+#endif
+
+ENMA_HOT_FN fvec4 fmat4x4::operator[](uin32 rowIndex) const
 {
 	//assert(rowIndex > 0 && rowIndex < 4);
 	return fvec4(this->_arr + (4 * rowIndex));
 }
 
-fmat4x4 fmat4x4::operator+(const fmat4x4& other) const
+ENMA_HOT_FN fmat4x4 fmat4x4::operator-() const
+{
+	return mat4x4(
+		-m11, -m12, -m13, -m14, 
+		-m21, -m22, -m23, -m24, 
+		-m31, -m32, -m33, -m34, 
+		-m41, -m42, -m43, -m44
+	);
+}
+
+ENMA_HOT_FN fmat4x4 fmat4x4::operator+(const fmat4x4& other) const
 {
-	__m256 r11 = this->_vals2[0];
-	__m256 r12 = this->_vals2[1];
+	fmat4x4 res;
 
-	__m256 r21 = other._vals2[0];
-	__m256 r22 = other._vals2[1];
+	#if defined(USE_SIMD) && defined(__AVX512F__)
+	_mm512_storeu_ps(res._arr, _mm512_add_ps(_mm512_loadu_ps(this->_arr), _mm512_loadu_ps(other._arr)));
+	#else
+	StoreRowPair(res, 0, LoadRowPair(*this, 0) + LoadRowPair(other, 0));
+	StoreRowPair(res, 1, LoadRowPair(*this, 1) + LoadRowPair(other, 1));
+	#endif
 
+	return res;
+}
 
-	r11 = _mm256_add_ps(r11, r21);
-	r12 = _mm256_add_ps(r12, r22);
+ENMA_HOT_FN fmat4x4& fmat4x4::operator+=(const fmat4x4& other)
+{
+	#if defined(USE_SIMD) && defined(__AVX512F__)
+	_mm512_storeu_ps(this->_arr, _mm512_add_ps(_mm512_loadu_ps(this->_arr), _mm512_loadu_ps(other._arr)));
+	#else
+	StoreRowPair(*this, 0, LoadRowPair(*this, 0) + LoadRowPair(other, 0));
+	StoreRowPair(*this, 1, LoadRowPair(*this, 1) + LoadRowPair(other, 1));
+	#endif
 
-	return fmat4x4(r11, r12);
+	return *this;
 }
 
-fmat4x4& fmat4x4::operator+=(const fmat4x4& other)
+ENMA_HOT_FN fmat4x4 fmat4x4::operator+(flt32 val) const
 {
-	__m256 r11 = this->_vals2[0];
-	__m256 r12 = this->_vals2[1];
+	fmat4x4 res;
+
+	#if defined(USE_SIMD) && defined(__AVX512F__)
+	_mm512_storeu_ps(res._arr, _mm512_add_ps(_mm512_loadu_ps(this->_arr), _mm512_set1_ps(val)));
+	#else
+	const simd::float8 addv = simd::float8::Set1(val);
+
+	StoreRowPair(res, 0, LoadRowPair(*this, 0) + addv);
+	StoreRowPair(res, 1, LoadRowPair(*this, 1) + addv);
+	#endif
+
+	return res;
+}
 
-	__m256 r21 = other._vals2[0];
-	__m256 r22 = other._vals2[1];
+ENMA_HOT_FN fmat4x4 fmat4x4::operator-(const fmat4x4& other) const
+{
+	fmat4x4 res;
 
-	r11 = _mm256_add_ps(r11, r21);
-	r12 = _mm256_add_ps(r12, r22);
+	#if defined(USE_SIMD) && defined(__AVX512F__)
+	_mm512_storeu_ps(res._arr, _mm512_sub_ps(_mm512_loadu_ps(this->_arr), _mm512_loadu_ps(other._arr)));
+	#else
+	StoreRowPair(res, 0, LoadRowPair(*this, 0) - LoadRowPair(other, 0));
+	StoreRowPair(res, 1, LoadRowPair(*this, 1) - LoadRowPair(other, 1));
+	#endif
 
-	*this = fmat4x4(r11, r12);
+	return res;
+}
+	
+ENMA_HOT_FN fmat4x4& fmat4x4::operator-=(const fmat4x4& other)
+{
+	#if defined(USE_SIMD) && defined(__AVX512F__)
+	_mm512_storeu_ps(this->_arr, _mm512_sub_ps(_mm512_loadu_ps(this->_arr), _mm512_loadu_ps(other._arr)));
+	#else
+	StoreRowPair(*this, 0, LoadRowPair(*this, 0) - LoadRowPair(other, 0));
+	StoreRowPair(*this, 1, LoadRowPair(*this, 1) - LoadRowPair(other, 1));
+	#endif
 
 	return *this;
 }
 
-fmat4x4 fmat4x4::operator+(flt32 val) const
+/**
+ * Computes one row of a matrix product as a linear combination of the rows of `m`:
+ * r = a.x * m[0] + a.y * m[1] + a.z * m[2] + a.w * m[3]
+ */
+inline simd::float4 LinearCombine(const simd::float4& a, const fmat4x4& m)
 {
-	__m256 addv = _mm256_set1_ps(val);
+	using namespace simd;
+
+	float4 r = Shuffle<0, 0, 0, 0>(a) * LoadRow(m, 0);
+	r = Fmadd(Shuffle<1, 1, 1, 1>(a), LoadRow(m, 1), r);
+	r = Fmadd(Shuffle<2, 2, 2, 2>(a), LoadRow(m, 2), r);
+
+	return Fmadd(Shuffle<3, 3, 3, 3>(a), LoadRow(m, 3), r);
+}
 
-	__m256 r1 = this->_vals2[0];
-	__m256 r2 = this->_vals2[1];
+/**
+ * Two-row variant of LinearCombine. `a` holds two rows, one per 128-bit half, and `m` holds
+ * the rows of the right-hand matrix duplicated into both halves.
+ */
+inline simd::float8 LinearCombine2(const simd::float8& a, const simd::float8 (&m)[4])
+{
+	using namespace simd;
 
-	r1 = _mm256_add_ps(r1, addv);
-	r2 = _mm256_add_ps(r2, addv);
+	float8 r = Shuffle<0, 0, 0, 0>(a) * m[0];
+	r = Fmadd(Shuffle<1, 1, 1, 1>(a), m[1], r);
+	r = Fmadd(Shuffle<2, 2, 2, 2>(a), m[2], r);
 
-	return fmat4x4(r1, r2);
+	return Fmadd(Shuffle<3, 3, 3, 3>(a), m[3], r);
 }
 
+inline void BroadcastRows(const fmat4x4& m, simd::float8 (&r)[4])
+{
+	r[0] = simd::float8::Broadcast(LoadRow(m, 0));
+	r[1] = simd::float8::Broadcast(LoadRow(m, 1));
+	r[2] = simd::float8::Broadcast(LoadRow(m, 2));
+	r[3] = simd::float8::Broadcast(LoadRow(m, 3));
+}
 
-fmat4x4 fmat4x4::operator-(const fmat4x4& other) const
+ENMA_HOT_FN fmat4x4 fmat4x4::operator*(const fmat4x4& other) const
 {
-	__m256 r11 = this->_vals2[0];
-	__m256 r12 = this->_vals2[1];
+	fmat4x4 res;
 
-	__m256 r21 = other._vals2[0];
-	__m256 r22 = other._vals2[1];
+	#if defined(USE_SIMD) && defined(__AVX512F__)
+	__m512 m[4];
+	BroadcastRows(other, m);
 
-	r11 = _mm256_sub_ps(r11, r21);
-	r12 = _mm256_sub_ps(r12, r22);
+	_mm512_storeu_ps(res._arr, LinearCombine4(_mm512_loadu_ps(this->_arr), m));
+	#else
+	simd::float8 m[4];
+	BroadcastRows(other, m);
 
-	return fmat4x4(r11, r12);
+	StoreRowPair(res, 0, LinearCombine2(LoadRowPair(*this, 0), m));
+	StoreRowPair(res, 1, LinearCombine2(LoadRowPair(*this, 1), m));
+	#endif
+
+	return res;
 }
-	
-fmat4x4& fmat4x4::operator-=(const fmat4x4& other)
+
+ENMA_HOT_FN fvec4 fmat4x4::operator*(const fvec4& other) const
 {
-	__m256 r11 = this->_vals2[0];
-	__m256 r12 = this->_vals2[1];
+	using namespace simd;
+
+	// Row i times the vector, then two rounds of pairwise sums leave dot(row i, v) in lane i
+	const float4 v = LoadXYZW(other);
 
-	__m256 r21 = other._vals2[0];
-	__m256 r22 = other._vals2[1];
+	const float4 d01 = HAdd(LoadRow(*this, 0) * v, LoadRow(*this, 1) * v);
+	const float4 d23 = HAdd(LoadRow(*this, 2) * v, LoadRow(*this, 3) * v);
 
-	r11 = _mm256_sub_ps(r11, r21);
-	r12 = _mm256_sub_ps(r12, r22);
+	return fvec4(HAdd(d01, d23));
+}
 
-	*this = fmat4x4(r11, r12);
+ENMA_HOT_FN fmat4x4& fmat4x4::operator*=(const fmat4x4& other)
+{
+	// The right-hand rows are read before anything is stored, so m *= m is safe
+	#if defined(USE_SIMD) && defined(__AVX512F__)
+	__m512 m[4];
+	BroadcastRows(other, m);
+
+	_mm512_storeu_ps(this->_arr, LinearCombine4(_mm512_loadu_ps(this->_arr), m));
+	#else
+	simd::float8 m[4];
+	BroadcastRows(other, m);
+
+	StoreRowPair(*this, 0, LinearCombine2(LoadRowPair(*this, 0), m));
+	StoreRowPair(*this, 1, LinearCombine2(LoadRowPair(*this, 1), m));
+	#endif
 
 	return *this;
 }
 
-fmat4x4 fmat4x4::operator*(const fmat4x4& other) const
+ENMA_HOT_FN fmat4x4 fmat4x4::operator*(flt32 val) const
 {
-	flt32 	a[4] = { 0, 0, 0, 0 }, 
-			b[4] = { 0, 0, 0, 0 }, 
-			c[4] = { 0, 0, 0, 0 }, 
-			d[4] = { 0, 0, 0, 0 }; 
+	fmat4x4 res;
+
+	#if defined(USE_SIMD) && defined(__AVX512F__)
+	_mm512_storeu_ps(res._arr, _mm512_mul_ps(_mm512_loadu_ps(this->_arr), _mm512_set1_ps(val)));
+	#else
+	const simd::float8 rfl = simd::float8::Set1(val);
 
-	__m128 r00, r01, r02, r03;
-	__m128 r10, r11, r12, r13;
-	__m128 i1, i2, i3, i4;
+	StoreRowPair(res, 0, LoadRowPair(*this, 0) * rfl);
+	StoreRowPair(res, 1, LoadRowPair(*this, 1) * rfl);
+	#endif
 
-	r00 = this->_vals[0];
-	r01 = this->_vals[1];
-	r02 = this->_vals[2];
-	r03 = this->_vals[3];
+	return res;
+}
 
-	r10 = other._vals[0];
-	r11 = other._vals[1];
-	r12 = other._vals[2];
-	r13 = other._vals[3];
+ENMA_HOT_FN fmat4x4 fmat4x4::operator/(flt32 val) const
+{
+	return *this * (1.0f / val);
+}
 
-	_MM_TRANSPOSE4_PS(r10, r11, r12, r13);
-	
-	i1 = _mm_dp_ps(r00, r10, 0xFF);
-	i2 = _mm_dp_ps(r00, r11, 0xFF);
-	i3 = _mm_dp_ps(r00, r12, 0xFF);
-	i4 = _mm_dp_ps(r00, r13, 0xFF);
+ENMA_FN fmat4x4 Transpose(const fmat4x4& m)
+{
+	#if defined(USE_SIMD) && defined(__AVX512F__)
+	const __m512i order = _mm512_setr_epi32(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
 
-	a[0] = i1[0];
-	a[1] = i2[0];
-	a[2] = i3[0];
-	a[3] = i4[0];
+	fmat4x4 res;
+	_mm512_storeu_ps(res._arr, _mm512_permutexvar_ps(order, _mm512_loadu_ps(m._arr)));
 
+	return res;
+	#else
+	simd::float4 r1 = LoadRow(m, 0);
+	simd::float4 r2 = LoadRow(m, 1);
+	simd::float4 r3 = LoadRow(m, 2);
+	simd::float4 r4 = LoadRow(m, 3);
 
-	i1 = _mm_dp_ps(r01, r10, 0xFF);
-	i2 = _mm_dp_ps(r01, r11, 0xFF);
-	i3 = _mm_dp_ps(r01, r12, 0xFF);
-	i4 = _mm_dp_ps(r01, r13, 0xFF);
+	simd::Transpose(r1, r2, r3, r4);
 
-	b[0] = i1[0];
-	b[1] = i2[0];
-	b[2] = i3[0];
-	b[3] = i4[0];
+	return fmat4x4(r1, r2, r3, r4);
+	#endif
+}
 
+// Distance in elements at which the batch transforms prefetch their input
+constexpr uin32 TRANSFORM_PREFETCH = 16;
 
-	i1 = _mm_dp_ps(r02, r10, 0xFF);
-	i2 = _mm_dp_ps(r02, r11, 0xFF);
-	i3 = _mm_dp_ps(r02, r12, 0xFF);
-	i4 = _mm_dp_ps(r02, r13, 0xFF);
+inline simd::float4 TransformPoint(const simd::float4 (&r)[4], const fvec3& p)
+{
+	using namespace simd;
 
-	c[0] = i1[0];
-	c[1] = i2[0];
-	c[2] = i3[0];
-	c[3] = i4[0];
+	float4 res = Fmadd(float4::Set1(p.x), r[0], r[3]);
+	res = Fmadd(float4::Set1(p.y), r[1], res);
 
+	return Fmadd(float4::Set1(p.z), r[2], res);
+}
 
-	i1 = _mm_dp_ps(r03, r10, 0xFF);
-	i2 = _mm_dp_ps(r03, r11, 0xFF);
-	i3 = _mm_dp_ps(r03, r12, 0xFF);
-	i4 = _mm_dp_ps(r03, r13, 0xFF);
+inline simd::float4 TransformVector(const simd::float4 (&r)[4], const fvec3& v)
+{
+	using namespace simd;
 
-	d[0] = i1[0];
-	d[1] = i2[0];
-	d[2] = i3[0];
-	d[3] = i4[0];
+	float4 res = float4::Set1(v.x) * r[0];
+	res = Fmadd(float4::Set1(v.y), r[1], res);
 
+	return Fmadd(float4::Set1(v.z), r[2], res);
+}
 
-	return fmat4x4(vec4(a), vec4(b), vec4(c), vec4(d));
+// Divides by the w lane
+inline simd::float4 ProjectPoint(const simd::float4& p)
+{
+	return p / simd::Shuffle<3, 3, 3, 3>(p);
 }
 
-fvec4 fmat4x4::operator*(const fvec4& other) const
+// The baseline kernels are written on the SIMD layer; without USE_SIMD they run on its scalar fallback
+ENMA_FN void TransformPointsSSE41(const fmat4x4& m, const fvec3* in, fvec3* out, uin32 count)
 {
-	__m128 r00, r01, r02, r03;
-	__m128 v41;
+	const simd::float4 r[4] = { LoadRow(m, 0), LoadRow(m, 1), LoadRow(m, 2), LoadRow(m, 3) };
+
+	uin32 i = 0;
 
-	r00 = this->_vals[0];
-	r01 = this->_vals[1];
-	r02 = this->_vals[2];
-	r03 = this->_vals[3];
+	for(; i + 4 <= count; i += 4)
+	{
+		simd::Prefetch(in + i + TRANSFORM_PREFETCH);
 
-	v41 = other;
+		const simd::float4 p0 = TransformPoint(r, in[i]);
+		const simd::float4 p1 = TransformPoint(r, in[i + 1]);
+		const simd::float4 p2 = TransformPoint(r, in[i + 2]);
+		const simd::float4 p3 = TransformPoint(r, in[i + 3]);
 
-	r00 = _mm_dp_ps(r00, v41, 0xFF);
-	r01 = _mm_dp_ps(r01, v41, 0xFF);
-	r02 = _mm_dp_ps(r02, v41, 0xFF);
-	r03 = _mm_dp_ps(r03, v41, 0xFF);
+		StoreXYZ(out[i], p0);
+		StoreXYZ(out[i + 1], p1);
+		StoreXYZ(out[i + 2], p2);
+		StoreXYZ(out[i + 3], p3);
+	}
 
-	return { r00[0], r01[0], r02[0], r03[0] };
+	for(; i < count; i++)
+	{
+		StoreXYZ(out[i], TransformPoint(r, in[i]));
+	}
 }
 
-fmat4x4& fmat4x4::operator*=(const fmat4x4& other)
+ENMA_FN void TransformPointsSSE41(const fmat4x4& m, const fvec4* in, fvec4* out, uin32 count)
 {
-	flt32 	a[4] = { 0, 0, 0, 0 }, 
-			b[4] = { 0, 0, 0, 0 }, 
-			c[4] = { 0, 0, 0, 0 }, 
-			d[4] = { 0, 0, 0, 0 }; 
+	uin32 i = 0;
 
-	__m128 r00, r01, r02, r03;
-	__m128 r10, r11, r12, r13;
-	__m128 i1, i2, i3, i4;
+	for(; i + 4 <= count; i += 4)
+	{
+		simd::Prefetch(in + i + TRANSFORM_PREFETCH);
 
-	r00 = this->_vals[0];
-	r01 = this->_vals[1];
-	r02 = this->_vals[2];
-	r03 = this->_vals[3];
+		const simd::float4 v0 = LinearCombine(LoadXYZW(in[i]), m);
+		const simd::float4 v1 = LinearCombine(LoadXYZW(in[i + 1]), m);
+		const simd::float4 v2 = LinearCombine(LoadXYZW(in[i + 2]), m);
+		const simd::float4 v3 = LinearCombine(LoadXYZW(in[i + 3]), m);
 
-	r10 = other._vals[0];
-	r11 = other._vals[1];
-	r12 = other._vals[2];
-	r13 = other._vals[3];
+		StoreXYZW(out[i], v0);
+		StoreXYZW(out[i + 1], v1);
+		StoreXYZW(out[i + 2], v2);
+		StoreXYZW(out[i + 3], v3);
+	}
 
-	_MM_TRANSPOSE4_PS(r10, r11, r12, r13);
-	
-	i1 = _mm_dp_ps(r00, r10, 0xFF);
-	i2 = _mm_dp_ps(r00, r11, 0xFF);
-	i3 = _mm_dp_ps(r00, r12, 0xFF);
-	i4 = _mm_dp_ps(r00, r13, 0xFF);
+	for(; i < count; i++)
+	{
+		StoreXYZW(out[i], LinearCombine(LoadXYZW(in[i]), m));
+	}
+}
 
-	this->_arr[0] = i1[0];
-	this->_arr[1] = i2[0];
-	this->_arr[2] = i3[0];
-	this->_arr[3] = i4[0];
+ENMA_FN void TransformVectorsSSE41(const fmat4x4& m, const fvec3* in, fvec3* out, uin32 count)
+{
+	const simd::float4 r[4] = { LoadRow(m, 0), LoadRow(m, 1), LoadRow(m, 2), LoadRow(m, 3) };
 
-	i1 = _mm_dp_ps(r01, r10, 0xFF);
-	i2 = _mm_dp_ps(r01, r11, 0xFF);
-	i3 = _mm_dp_ps(r01, r12, 0xFF);
-	i4 = _mm_dp_ps(r01, r13, 0xFF);
+	uin32 i = 0;
 
-	this->_arr[4] = i1[0];
-	this->_arr[5] = i2[0];
-	this->_arr[6] = i3[0];
-	this->_arr[7] = i4[0];
+	for(; i + 4 <= count; i += 4)
+	{
+		simd::Prefetch(in + i + TRANSFORM_PREFETCH);
 
-	i1 = _mm_dp_ps(r02, r10, 0xFF);
-	i2 = _mm_dp_ps(r02, r11, 0xFF);
-	i3 = _mm_dp_ps(r02, r12, 0xFF);
-	i4 = _mm_dp_ps(r02, r13, 0xFF);
+		const simd::float4 v0 = TransformVector(r, in[i]);
+		const simd::float4 v1 = TransformVector(r, in[i + 1]);
+		const simd::float4 v2 = TransformVector(r, in[i + 2]);
+		const simd::float4 v3 = TransformVector(r, in[i + 3]);
 
-	/*c[0] = i1[0];
-	c[1] = i2[0];
-	c[2] = i3[0];
-	c[3] = i4[0];*/
+		StoreXYZ(out[i], v0);
+		StoreXYZ(out[i + 1], v1);
+		StoreXYZ(out[i + 2], v2);
+		StoreXYZ(out[i + 3], v3);
+	}
 
-	this->_arr[8] = i1[0];
-	this->_arr[9] = i2[0];
-	this->_arr[10] = i3[0];
-	this->_arr[11] = i4[0];
+	for(; i < count; i++)
+	{
+		StoreXYZ(out[i], TransformVector(r, in[i]));
+	}
+}
 
+ENMA_FN void TransformPointsProjectiveSSE41(const fmat4x4& m, const fvec3* in, fvec3* out, uin32 count)
+{
+	const simd::float4 r[4] = { LoadRow(m, 0), LoadRow(m, 1), LoadRow(m, 2), LoadRow(m, 3) };
 
-	i1 = _mm_dp_ps(r03, r10, 0xFF);
-	i2 = _mm_dp_ps(r03, r11, 0xFF);
-	i3 = _mm_dp_ps(r03, r12, 0xFF);
-	i4 = _mm_dp_ps(r03, r13, 0xFF);
+	uin32 i = 0;
 
-	this->_arr[12] = i1[0];
-	this->_arr[13] = i2[0];
-	this->_arr[14] = i3[0];
-	this->_arr[15] = i4[0];
+	for(; i + 4 <= count; i += 4)
+	{
+		simd::Prefetch(in + i + TRANSFORM_PREFETCH);
 
+		const simd::float4 p0 = TransformPoint(r, in[i]);
+		const simd::float4 p1 = TransformPoint(r, in[i + 1]);
+		const simd::float4 p2 = TransformPoint(r, in[i + 2]);
+		const simd::float4 p3 = TransformPoint(r, in[i + 3]);
 
-	//*this = fmat4x4(vec4(a), vec4(b), vec4(c), vec4(d));
+		StoreXYZ(out[i], ProjectPoint(p0));
+		StoreXYZ(out[i + 1], ProjectPoint(p1));
+		StoreXYZ(out[i + 2], ProjectPoint(p2));
+		StoreXYZ(out[i + 3], ProjectPoint(p3));
+	}
 
-	return *this;
+	for(; i < count; i++)
+	{
+		StoreXYZ(out[i], ProjectPoint(TransformPoint(r, in[i])));
+	}
 }
 
-fmat4x4 fmat4x4::operator*(flt32 val) const
+#ifdef USE_SIMD
+ENMA_TARGET_AVX2 inline __m128 TransformPointAVX2(const __m128 (&r)[4], const fvec3& p)
 {
-	__m256 rfl = _mm256_set1_ps(val);
+	__m128 res = _mm_fmadd_ps(_mm_broadcast_ss(&p.x), r[0], r[3]);
+	res = _mm_fmadd_ps(_mm_broadcast_ss(&p.y), r[1], res);
 
-	__m256 r12 = this->_vals2[0];
-	__m256 r34 = this->_vals2[1];
+	return _mm_fmadd_ps(_mm_broadcast_ss(&p.z), r[2], res);
+}
 
-	return fmat4x4(_mm256_mul_ps(r12, rfl), _mm256_mul_ps(r34, rfl));
+ENMA_TARGET_AVX2 inline __m128 TransformVectorAVX2(const __m128 (&r)[4], const fvec3& v)
+{
+	__m128 res = _mm_mul_ps(_mm_broadcast_ss(&v.x), r[0]);
+	res = _mm_fmadd_ps(_mm_broadcast_ss(&v.y), r[1], res);
+
+	return _mm_fmadd_ps(_mm_broadcast_ss(&v.z), r[2], res);
 }
 
-fmat4x4 fmat4x4::operator/(flt32 val) const
+ENMA_FN ENMA_TARGET_AVX2 void TransformPointsAVX2(const fmat4x4& m, const fvec3* in, fvec3* out, uin32 count)
 {
-	__m256 rfl = _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_set1_ps(val));
+	const __m128 r[4] = { m._vals[0], m._vals[1], m._vals[2], m._vals[3] };
+
+	uin32 i = 0;
 
-	__m256 r12 = this->_vals2[0];
-	__m256 r34 = this->_vals2[1];
+	for(; i + 4 <= count; i += 4)
+	{
+		_mm_prefetch(reinterpret_cast<const char*>(in + i + TRANSFORM_PREFETCH), _MM_HINT_T0);
+
+		const __m128 p0 = TransformPointAVX2(r, in[i]);
+		const __m128 p1 = TransformPointAVX2(r, in[i + 1]);
+		const __m128 p2 = TransformPointAVX2(r, in[i + 2]);
+		const __m128 p3 = TransformPointAVX2(r, in[i + 3]);
+
+		StoreXYZ(out[i], p0);
+		StoreXYZ(out[i + 1], p1);
+		StoreXYZ(out[i + 2], p2);
+		StoreXYZ(out[i + 3], p3);
+	}
 
-	return fmat4x4(_mm256_mul_ps(r12, rfl), _mm256_mul_ps(r34, rfl));
+	for(; i < count; i++)
+	{
+		StoreXYZ(out[i], TransformPointAVX2(r, in[i]));
+	}
 }
 
-fmat4x4 Transpose(const fmat4x4& m)
+ENMA_FN ENMA_TARGET_AVX2 void TransformPointsAVX2(const fmat4x4& m, const fvec4* in, fvec4* out, uin32 count)
 {
-    __m128 r1 = m._vals[0];
-    __m128 r2 = m._vals[1];
-    __m128 r3 = m._vals[2];
-    __m128 r4 = m._vals[3];
+	// Two vectors per __m256; every row is duplicated in both 128-bit lanes so an in-lane permute
+	// broadcasts x, y, z and w of each vector without crossing lanes
+	const __m256 r0 = _mm256_broadcast_ps(&m._vals[0]);
+	const __m256 r1 = _mm256_broadcast_ps(&m._vals[1]);
+	const __m256 r2 = _mm256_broadcast_ps(&m._vals[2]);
+	const __m256 r3 = _mm256_broadcast_ps(&m._vals[3]);
 
-    _MM_TRANSPOSE4_PS(r1, r2, r3, r4);
+	uin32 i = 0;
 
-    return fmat4x4(r1, r2, r3, r4);
+	for(; i + 4 <= count; i += 4)
+	{
+		_mm_prefetch(reinterpret_cast<const char*>(in + i + TRANSFORM_PREFETCH), _MM_HINT_T0);
+
+		const __m256 v01 = _mm256_loadu_ps(in[i]._arr);
+		const __m256 v23 = _mm256_loadu_ps(in[i + 2]._arr);
+
+		__m256 a = _mm256_mul_ps(_mm256_permute_ps(v01, 0x00), r0);
+		__m256 b = _mm256_mul_ps(_mm256_permute_ps(v23, 0x00), r0);
+		a = _mm256_fmadd_ps(_mm256_permute_ps(v01, 0x55), r1, a);
+		b = _mm256_fmadd_ps(_mm256_permute_ps(v23, 0x55), r1, b);
+		a = _mm256_fmadd_ps(_mm256_permute_ps(v01, 0xAA), r2, a);
+		b = _mm256_fmadd_ps(_mm256_permute_ps(v23, 0xAA), r2, b);
+		a = _mm256_fmadd_ps(_mm256_permute_ps(v01, 0xFF), r3, a);
+		b = _mm256_fmadd_ps(_mm256_permute_ps(v23, 0xFF), r3, b);
+
+		_mm256_storeu_ps(out[i]._arr, a);
+		_mm256_storeu_ps(out[i + 2]._arr, b);
+	}
+
+	for(; i < count; i++)
+	{
+		__m128 v = _mm_mul_ps(_mm_broadcast_ss(&in[i].x), m._vals[0]);
+		v = _mm_fmadd_ps(_mm_broadcast_ss(&in[i].y), m._vals[1], v);
+		v = _mm_fmadd_ps(_mm_broadcast_ss(&in[i].z), m._vals[2], v);
+
+		out[i]._vals = _mm_fmadd_ps(_mm_broadcast_ss(&in[i].w), m._vals[3], v);
+	}
 }
-#endif
 
-fmat4x4 Inverse(const fmat4x4& m)
+ENMA_FN ENMA_TARGET_AVX2 void TransformVectorsAVX2(const fmat4x4& m, const fvec3* in, fvec3* out, uin32 count)
 {
-	// TODO: Implementation
-	return m;
+	const __m128 r[4] = { m._vals[0], m._vals[1], m._vals[2], m._vals[3] };
+
+	uin32 i = 0;
+
+	for(; i + 4 <= count; i += 4)
+	{
+		_mm_prefetch(reinterpret_cast<const char*>(in + i + TRANSFORM_PREFETCH), _MM_HINT_T0);
+
+		const __m128 v0 = TransformVectorAVX2(r, in[i]);
+		const __m128 v1 = TransformVectorAVX2(r, in[i + 1]);
+		const __m128 v2 = TransformVectorAVX2(r, in[i + 2]);
+		const __m128 v3 = TransformVectorAVX2(r, in[i + 3]);
+
+		StoreXYZ(out[i], v0);
+		StoreXYZ(out[i + 1], v1);
+		StoreXYZ(out[i + 2], v2);
+		StoreXYZ(out[i + 3], v3);
+	}
+
+	for(; i < count; i++)
+	{
+		StoreXYZ(out[i], TransformVectorAVX2(r, in[i]));
+	}
 }
 
-fmat4x4 AffineInverse(const fmat4x4& m)
+ENMA_FN ENMA_TARGET_AVX2 void TransformPointsProjectiveAVX2(const fmat4x4& m, const fvec3* in, fvec3* out, uin32 count)
 {
-    flt32 m12 = m.m21;
-    flt32 m13 = m.m31;
-    flt32 m23 = m.m32;
+	const __m128 r[4] = { m._vals[0], m._vals[1], m._vals[2], m._vals[3] };
+
+	uin32 i = 0;
 
-	return fmat4x4
+	for(; i + 4 <= count; i += 4)
 	{
-		m.m11, m12, m13, 0.0f,
-		m.m12, m.m22, m23, 0.0f,
-		m.m13, m.m23, m.m33, 0.0f,
-		-m.m41, -m.m42, -m.m43, 1.0f
-	};
+		_mm_prefetch(reinterpret_cast<const char*>(in + i + TRANSFORM_PREFETCH), _MM_HINT_T0);
+
+		const __m128 p0 = TransformPointAVX2(r, in[i]);
+		const __m128 p1 = TransformPointAVX2(r, in[i + 1]);
+		const __m128 p2 = TransformPointAVX2(r, in[i + 2]);
+		const __m128 p3 = TransformPointAVX2(r, in[i + 3]);
+
+		StoreXYZ(out[i], _mm_div_ps(p0, _mm_shuffle_ps(p0, p0, 0xFF)));
+		StoreXYZ(out[i + 1], _mm_div_ps(p1, _mm_shuffle_ps(p1, p1, 0xFF)));
+		StoreXYZ(out[i + 2], _mm_div_ps(p2, _mm_shuffle_ps(p2, p2, 0xFF)));
+		StoreXYZ(out[i + 3], _mm_div_ps(p3, _mm_shuffle_ps(p3, p3, 0xFF)));
+	}
+
+	for(; i < count; i++)
+	{
+		const __m128 p = TransformPointAVX2(r, in[i]);
+
+		StoreXYZ(out[i], _mm_div_ps(p, _mm_shuffle_ps(p, p, 0xFF)));
+	}
+}
+
+// Sixteen packed fvec3 (48 floats in three registers) to and from one register per component
+ENMA_TARGET_AVX512 inline void LoadXYZ16(const fvec3* in, __m512& x, __m512& y, __m512& z)
+{
+	const flt32* p = &in->x;
+
+	const __m512 v0 = _mm512_loadu_ps(p);
+	const __m512 v1 = _mm512_loadu_ps(p + 16);
+	const __m512 v2 = _mm512_loadu_ps(p + 32);
+
+	x = _mm512_permutex2var_ps(v0, _mm512_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21, 24, 27, 30, 0, 0, 0, 0, 0), v1);
+	y = _mm512_permutex2var_ps(v0, _mm512_setr_epi32(1, 4, 7, 10, 13, 16, 19, 22, 25, 28, 31, 0, 0, 0, 0, 0), v1);
+	z = _mm512_permutex2var_ps(v0, _mm512_setr_epi32(2, 5, 8, 11, 14, 17, 20, 23, 26, 29, 0, 0, 0, 0, 0, 0), v1);
+
+	x = _mm512_permutex2var_ps(x, _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 17, 20, 23, 26, 29), v2);
+	y = _mm512_permutex2var_ps(y, _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 18, 21, 24, 27, 30), v2);
+	z = _mm512_permutex2var_ps(z, _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 16, 19, 22, 25, 28, 31), v2);
+}
+
+ENMA_TARGET_AVX512 inline void StoreXYZ16(fvec3* out, const __m512& x, const __m512& y, const __m512& z)
+{
+	flt32* p = &out->x;
+
+	const __m512 xy0 = _mm512_permutex2var_ps(x, _mm512_setr_epi32(0, 16, 0, 1, 17, 0, 2, 18, 0, 3, 19, 0, 4, 20, 0, 5), y);
+	const __m512 xy1 = _mm512_permutex2var_ps(x, _mm512_setr_epi32(21, 0, 6, 22, 0, 7, 23, 0, 8, 24, 0, 9, 25, 0, 10, 26), y);
+	const __m512 xy2 = _mm512_permutex2var_ps(x, _mm512_setr_epi32(0, 11, 27, 0, 12, 28, 0, 13, 29, 0, 14, 30, 0, 15, 31, 0), y);
+
+	_mm512_storeu_ps(p, _mm512_permutex2var_ps(xy0, _mm512_setr_epi32(0, 1, 16, 3, 4, 17, 6, 7, 18, 9, 10, 19, 12, 13, 20, 15), z));
+	_mm512_storeu_ps(p + 16, _mm512_permutex2var_ps(xy1, _mm512_setr_epi32(0, 21, 2, 3, 22, 5, 6, 23, 8, 9, 24, 11, 12, 25, 14, 15), z));
+	_mm512_storeu_ps(p + 32, _mm512_permutex2var_ps(xy2, _mm512_setr_epi32(26, 1, 2, 27, 4, 5, 28, 7, 8, 29, 10, 11, 30, 13, 14, 31), z));
+}
+
+// Column `c` of sixteen transformed vectors: x * m[0][c] + y * m[1][c] + z * m[2][c] + t
+ENMA_TARGET_AVX512 inline __m512 TransformColumn16(const __m512 (&e)[16], uin32 c, const __m512& x, const __m512& y, const __m512& z, const __m512& t)
+{
+	__m512 r = _mm512_fmadd_ps(x, e[c], t);
+	r = _mm512_fmadd_ps(y, e[4 + c], r);
+
+	return _mm512_fmadd_ps(z, e[8 + c], r);
+}
+
+ENMA_TARGET_AVX512 inline void BroadcastElements(const fmat4x4& m, __m512 (&e)[16])
+{
+	for(uin32 k = 0; k < 16; k++)
+	{
+		e[k] = _mm512_set1_ps(m._arr[k]);
+	}
+}
+
+// The fvec3 kernels work on sixteen vectors at a time in SoA form, which needs them tightly packed
+ENMA_FN ENMA_TARGET_AVX512 void TransformPointsAVX512(const fmat4x4& m, const fvec3* in, fvec3* out, uin32 count)
+{
+	#ifdef USE_MEM_ALIGNED
+	TransformPointsAVX2(m, in, out, count);
+	#else
+	__m512 e[16];
+	BroadcastElements(m, e);
+
+	uin32 i = 0;
+
+	for(; i + 16 <= count; i += 16)
+	{
+		_mm_prefetch(reinterpret_cast<const char*>(in + i + 2 * TRANSFORM_PREFETCH), _MM_HINT_T0);
+
+		__m512 x, y, z;
+		LoadXYZ16(in + i, x, y, z);
+
+		StoreXYZ16(out + i, TransformColumn16(e, 0, x, y, z, e[12]), TransformColumn16(e, 1, x, y, z, e[13]), TransformColumn16(e, 2, x, y, z, e[14]));
+	}
+
+	const __m128 r[4] = { m._vals[0], m._vals[1], m._vals[2], m._vals[3] };
+
+	for(; i < count; i++)
+	{
+		StoreXYZ(out[i], TransformPointAVX2(r, in[i]));
+	}
+	#endif
+}
+
+ENMA_FN ENMA_TARGET_AVX512 void TransformPointsAVX512(const fmat4x4& m, const fvec4* in, fvec4* out, uin32 count)
+{
+	// Four vectors per __m512, one per 128-bit lane
+	__m512 r[4];
+	BroadcastRows(m, r);
+
+	uin32 i = 0;
+
+	for(; i + 8 <= count; i += 8)
+	{
+		_mm_prefetch(reinterpret_cast<const char*>(in + i + TRANSFORM_PREFETCH), _MM_HINT_T0);
+
+		const __m512 a = LinearCombine4(_mm512_loadu_ps(in[i]._arr), r);
+		const __m512 b = LinearCombine4(_mm512_loadu_ps(in[i + 4]._arr), r);
+
+		_mm512_storeu_ps(out[i]._arr, a);
+		_mm512_storeu_ps(out[i + 4]._arr, b);
+	}
+
+	for(; i < count; i += 4)
+	{
+		const uin32 n = std::min(count - i, 4u);
+		const __mmask16 mask = static_cast<__mmask16>((1u << (4 * n)) - 1);
+
+		const __m512 v = _mm512_maskz_loadu_ps(mask, in[i]._arr);
+		_mm512_mask_storeu_ps(out[i]._arr, mask, LinearCombine4(v, r));
+	}
 }
 
-fvec4 fvec4::operator*(const fmat4x4& other)
+ENMA_FN ENMA_TARGET_AVX512 void TransformVectorsAVX512(const fmat4x4& m, const fvec3* in, fvec3* out, uin32 count)
 {
-	vec4 v = this->_vals;
-	mat4 m = Transpose(other);
+	#ifdef USE_MEM_ALIGNED
+	TransformVectorsAVX2(m, in, out, count);
+	#else
+	__m512 e[16];
+	BroadcastElements(m, e);
+
+	const __m512 zero = _mm512_setzero_ps();
+
+	uin32 i = 0;
+
+	for(; i + 16 <= count; i += 16)
+	{
+		_mm_prefetch(reinterpret_cast<const char*>(in + i + 2 * TRANSFORM_PREFETCH), _MM_HINT_T0);
+
+		__m512 x, y, z;
+		LoadXYZ16(in + i, x, y, z);
 
-	flt32 x = _mm_dp_ps(v, m._vals[0], 0xFF)[0];
-	flt32 y = _mm_dp_ps(v, m._vals[1], 0xFF)[0];
-	flt32 z = _mm_dp_ps(v, m._vals[2], 0xFF)[0];
-	flt32 w = _mm_dp_ps(v, m._vals[3], 0xFF)[0];
+		StoreXYZ16(out + i, TransformColumn16(e, 0, x, y, z, zero), TransformColumn16(e, 1, x, y, z, zero), TransformColumn16(e, 2, x, y, z, zero));
+	}
+
+	const __m128 r[4] = { m._vals[0], m._vals[1], m._vals[2], m._vals[3] };
 
-	return fvec4(x, y, z, w);
+	for(; i < count; i++)
+	{
+		StoreXYZ(out[i], TransformVectorAVX2(r, in[i]));
+	}
+	#endif
 }
 
-const fmat4x4 fmat4x4::zero = mat4();
-const fmat4x4 fmat4x4::identity = mat4(1.0f);
-#endif
\ No newline at end of file
+ENMA_FN ENMA_TARGET_AVX512 void TransformPointsProjectiveAVX512(const fmat4x4& m, const fvec3* in, fvec3* out, uin32 count)
+{
+	#ifdef USE_MEM_ALIGNED
+	TransformPointsProjectiveAVX2(m, in, out, count);
+	#else
+	__m512 e[16];
+	BroadcastElements(m, e);
+
+	uin32 i = 0;
+
+	for(; i + 16 <= count; i += 16)
+	{
+		_mm_prefetch(reinterpret_cast<const char*>(in + i + 2 * TRANSFORM_PREFETCH), _MM_HINT_T0);
+
+		__m512 x, y, z;
+		LoadXYZ16(in + i, x, y, z);
+
+		const __m512 w = TransformColumn16(e, 3, x, y, z, e[15]);
+
+		StoreXYZ16(out + i,
+			_mm512_div_ps(TransformColumn16(e, 0, x, y, z, e[12]), w),
+			_mm512_div_ps(TransformColumn16(e, 1, x, y, z, e[13]), w),
+			_mm512_div_ps(TransformColumn16(e, 2, x, y, z, e[14]), w));
+	}
+
+	const __m128 r[4] = { m._vals[0], m._vals[1], m._vals[2], m._vals[3] };
+
+	for(; i < count; i++)
+	{
+		const __m128 p = TransformPointAVX2(r, in[i]);
+
+		StoreXYZ(out[i], _mm_div_ps(p, _mm_shuffle_ps(p, p, 0xFF)));
+	}
+	#endif
+}
+
+// Batch transform kernels of the fastest tier the host supports, selected once on first use
+struct Mat4BatchKernels
+{
+	void (*transformPoints3)(const fmat4x4&, const fvec3*, fvec3*, uin32);
+	void (*transformPoints4)(const fmat4x4&, const fvec4*, fvec4*, uin32);
+	void (*transformVectors)(const fmat4x4&, const fvec3*, fvec3*, uin32);
+	void (*transformPointsProjective)(const fmat4x4&, const fvec3*, fvec3*, uin32);
+};
+
+inline Mat4BatchKernels SelectMat4BatchKernels()
+{
+	if(GetSimdLevel() >= SimdLevel::AVX512)
+		return { TransformPointsAVX512, TransformPointsAVX512, TransformVectorsAVX512, TransformPointsProjectiveAVX512 };
+
+	if(GetSimdLevel() >= SimdLevel::AVX2)
+		return { TransformPointsAVX2, TransformPointsAVX2, TransformVectorsAVX2, TransformPointsProjectiveAVX2 };
+
+	return { TransformPointsSSE41, TransformPointsSSE41, TransformVectorsSSE41, TransformPointsProjectiveSSE41 };
+}
+
+inline const Mat4BatchKernels& GetMat4BatchKernels()
+{
+	static const Mat4BatchKernels kernels = SelectMat4BatchKernels();
+
+	return kernels;
+}
+
+ENMA_FN void TransformPoints(const fmat4x4& m, const fvec3* in, fvec3* out, uin32 count)
+{
+	GetMat4BatchKernels().transformPoints3(m, in, out, count);
+}
+
+ENMA_FN void TransformPoints(const fmat4x4& m, const fvec4* in, fvec4* out, uin32 count)
+{
+	GetMat4BatchKernels().transformPoints4(m, in, out, count);
+}
+
+ENMA_FN void TransformVectors(const fmat4x4& m, const fvec3* in, fvec3* out, uin32 count)
+{
+	GetMat4BatchKernels().transformVectors(m, in, out, count);
+}
+
+ENMA_FN void TransformPointsProjective(const fmat4x4& m, const fvec3* in, fvec3* out, uin32 count)
+{
+	GetMat4BatchKernels().transformPointsProjective(m, in, out, count);
+}
+
+#else // ! USE_SIMD
+
+ENMA_FN void TransformPoints(const fmat4x4& m, const fvec3* in, fvec3* out, uin32 count)
+{
+	TransformPointsSSE41(m, in, out, count);
+}
+
+ENMA_FN void TransformPoints(const fmat4x4& m, const fvec4* in, fvec4* out, uin32 count)
+{
+	TransformPointsSSE41(m, in, out, count);
+}
+
+ENMA_FN void TransformVectors(const fmat4x4& m, const fvec3* in, fvec3* out, uin32 count)
+{
+	TransformVectorsSSE41(m, in, out, count);
+}
+
+ENMA_FN void TransformPointsProjective(const fmat4x4& m, const fvec3* in, fvec3* out, uin32 count)
+{
+	TransformPointsProjectiveSSE41(m, in, out, count);
+}
+
+#endif // USE_SIMD
+
+// Inverse and determinant by blockwise (2x2 sub-matrix) cofactor expansion. The matrix is split into
+//
+//		| A B |
+//		| C D |
+//
+// with every 2x2 block held row-major in one simd::float4, so the adjugate is assembled from 2x2 products.
+
+// 2x2 matrix product: a * b
+inline simd::float4 Mat2Mul(const simd::float4& a, const simd::float4& b)
+{
+	using namespace simd;
+
+	return Fmadd(a, Shuffle<0, 3, 0, 3>(b), Shuffle<1, 0, 3, 2>(a) * Shuffle<2, 1, 2, 1>(b));
+}
+
+// 2x2 adjugate product: adj(a) * b
+inline simd::float4 Mat2AdjMul(const simd::float4& a, const simd::float4& b)
+{
+	using namespace simd;
+
+	return Fmsub(Shuffle<3, 3, 0, 0>(a), b, Shuffle<1, 1, 2, 2>(a) * Shuffle<2, 3, 0, 1>(b));
+}
+
+// 2x2 product with adjugate: a * adj(b)
+inline simd::float4 Mat2MulAdj(const simd::float4& a, const simd::float4& b)
+{
+	using namespace simd;
+
+	return Fmsub(a, Shuffle<3, 0, 3, 0>(b), Shuffle<1, 0, 3, 2>(a) * Shuffle<2, 1, 2, 1>(b));
+}
+
+// Determinants of the four 2x2 blocks, (det A, det B, det C, det D)
+inline simd::float4 BlockDeterminants(const simd::float4 (&r)[4])
+{
+	using namespace simd;
+
+	return Fmsub(
+		Shuffle<0, 2, 0, 2>(r[0], r[2]), Shuffle<1, 3, 1, 3>(r[1], r[3]),
+		Shuffle<1, 3, 1, 3>(r[0], r[2]) * Shuffle<0, 2, 0, 2>(r[1], r[3])
+	);
+}
+
+// det(M) = det(A) det(D) + det(B) det(C) - tr(adj(A) B adj(D) C), broadcast to all lanes
+inline simd::float4 BlockDeterminant(const simd::float4& detSub, const simd::float4& aB, const simd::float4& dC)
+{
+	using namespace simd;
+
+	const float4 detA = Shuffle<0, 0, 0, 0>(detSub);
+	const float4 detB = Shuffle<1, 1, 1, 1>(detSub);
+	const float4 detC = Shuffle<2, 2, 2, 2>(detSub);
+	const float4 detD = Shuffle<3, 3, 3, 3>(detSub);
+
+	const float4 tr = HSum(aB * Shuffle<0, 2, 1, 3>(dC));
+
+	return Fmadd(detA, detD, detB * detC) - tr;
+}
+
+// The four 2x2 blocks of `m`
+inline void SplitBlocks(const simd::float4 (&r)[4], simd::float4& A, simd::float4& B, simd::float4& C, simd::float4& D)
+{
+	A = simd::MoveLH(r[0], r[1]);
+	B = simd::MoveHL(r[1], r[0]);
+	C = simd::MoveLH(r[2], r[3]);
+	D = simd::MoveHL(r[3], r[2]);
+}
+
+ENMA_HOT_FN flt32 Determinant(const fmat4x4& m)
+{
+	const simd::float4 r[4] = { LoadRow(m, 0), LoadRow(m, 1), LoadRow(m, 2), LoadRow(m, 3) };
+
+	simd::float4 A, B, C, D;
+	SplitBlocks(r, A, B, C, D);
+
+	return BlockDeterminant(BlockDeterminants(r), Mat2AdjMul(A, B), Mat2AdjMul(D, C)).X();
+}
+
+/**
+ * Computes the inverse scaled by det(M), together with det(M) broadcast to all lanes.
+ * The result rows still have to be multiplied by 1 / det(M).
+ */
+inline void ScaledInverse(const fmat4x4& m, simd::float4 (&rows)[4], simd::float4& det)
+{
+	using namespace simd;
+
+	const float4 r[4] = { LoadRow(m, 0), LoadRow(m, 1), LoadRow(m, 2), LoadRow(m, 3) };
+
+	float4 A, B, C, D;
+	SplitBlocks(r, A, B, C, D);
+
+	const float4 detSub = BlockDeterminants(r);
+	const float4 detA = Shuffle<0, 0, 0, 0>(detSub);
+	const float4 detB = Shuffle<1, 1, 1, 1>(detSub);
+	const float4 detC = Shuffle<2, 2, 2, 2>(detSub);
+	const float4 detD = Shuffle<3, 3, 3, 3>(detSub);
+
+	const float4 dC = Mat2AdjMul(D, C);
+	const float4 aB = Mat2AdjMul(A, B);
+
+	const float4 X = Fmsub(detD, A, Mat2Mul(B, dC));
+	const float4 W = Fmsub(detA, D, Mat2Mul(C, aB));
+	const float4 Y = Fmsub(detB, C, Mat2MulAdj(D, aB));
+	const float4 Z = Fmsub(detC, B, Mat2MulAdj(A, dC));
+
+	det = BlockDeterminant(detSub, aB, dC);
+
+	// The shuffles here and the sign pattern applied by the caller take the adjugate of each
+	// block while interleaving the blocks back into rows
+	rows[0] = Shuffle<3, 1, 3, 1>(X, Y);
+	rows[1] = Shuffle<2, 0, 2, 0>(X, Y);
+	rows[2] = Shuffle<3, 1, 3, 1>(Z, W);
+	rows[3] = Shuffle<2, 0, 2, 0>(Z, W);
+}
+
+ENMA_FN fmat4x4 Inverse(const fmat4x4& m)
+{
+	using namespace simd;
+
+	float4 rows[4];
+	float4 det;
+
+	ScaledInverse(m, rows, det);
+
+	const float4 rdet = float4::Set(1.0f, -1.0f, 1.0f, -1.0f) / det;
+	const float4 rdetSwap = Shuffle<1, 0, 3, 2>(rdet);
+
+	return fmat4x4(rows[0] * rdet, rows[1] * rdetSwap, rows[2] * rdet, rows[3] * rdetSwap);
+}
+
+ENMA_FN fmat4x4 InverseWithDeterminant(const fmat4x4& m, flt32& determinant)
+{
+	using namespace simd;
+
+	float4 rows[4];
+	float4 det;
+
+	ScaledInverse(m, rows, det);
+
+	// Singular input yields a zero reciprocal instead of inf, so the result collapses to zero
+	const float4 nonSingular = CmpNeq(det, float4::Zero());
+	const float4 rdet = And(float4::Set(1.0f, -1.0f, 1.0f, -1.0f) / det, nonSingular);
+	const float4 rdetSwap = Shuffle<1, 0, 3, 2>(rdet);
+
+	determinant = det.X();
+
+	return fmat4x4(rows[0] * rdet, rows[1] * rdetSwap, rows[2] * rdet, rows[3] * rdetSwap);
+}
+
+// Cross product of two rows with their w lanes cancelling to 0
+inline simd::float4 CrossRows(const simd::float4& a, const simd::float4& b)
+{
+	using namespace simd;
+
+	const float4 c = Fmsub(a, Shuffle<1, 2, 0, 3>(b), Shuffle<1, 2, 0, 3>(a) * b);
+
+	return Shuffle<1, 2, 0, 3>(c);
+}
+
+// Applies the inverse linear part `l` (rows with w = 0) to the translation row `t` and negates it, keeping w = 1
+inline simd::float4 InverseTranslation(const simd::float4 (&l)[3], const simd::float4& t)
+{
+	using namespace simd;
+
+	float4 res = Fnmadd(Shuffle<0, 0, 0, 0>(t), l[0], float4::Set(0.0f, 0.0f, 0.0f, 1.0f));
+	res = Fnmadd(Shuffle<1, 1, 1, 1>(t), l[1], res);
+
+	return Fnmadd(Shuffle<2, 2, 2, 2>(t), l[2], res);
+}
+
+// Rows 0 to 2 of `m` with w cleared, so a transpose leaves (0, 0, 0, 1) in the last column
+inline void LinearRows(const fmat4x4& m, simd::float4 (&r)[3])
+{
+	r[0] = simd::Blend<0, 0, 0, 1>(LoadRow(m, 0), simd::float4::Zero());
+	r[1] = simd::Blend<0, 0, 0, 1>(LoadRow(m, 1), simd::float4::Zero());
+	r[2] = simd::Blend<0, 0, 0, 1>(LoadRow(m, 2), simd::float4::Zero());
+}
+
+ENMA_FN fmat4x4 AffineInverse(const fmat4x4& m)
+{
+	using namespace simd;
+
+	float4 r[3];
+	LinearRows(m, r);
+
+	// Columns of the adjugate of the 3x3 block
+	float4 c0 = CrossRows(r[1], r[2]);
+	float4 c1 = CrossRows(r[2], r[0]);
+	float4 c2 = CrossRows(r[0], r[1]);
+	float4 c3 = float4::Zero();
+
+	const float4 rdet = float4::Set1(1.0f) / Dot3(r[0], c0);
+
+	c0 *= rdet;
+	c1 *= rdet;
+	c2 *= rdet;
+
+	Transpose(c0, c1, c2, c3);
+
+	const float4 l[3] = { c0, c1, c2 };
+
+	return fmat4x4(c0, c1, c2, InverseTranslation(l, LoadRow(m, 3)));
+}
+
+ENMA_FN fmat4x4 RigidInverse(const fmat4x4& m)
+{
+	using namespace simd;
+
+	float4 r[3];
+	LinearRows(m, r);
+
+	float4 r3 = float4::Zero();
+	Transpose(r[0], r[1], r[2], r3);
+
+	return fmat4x4(r[0], r[1], r[2], InverseTranslation(r, LoadRow(m, 3)));
+}
+
+ENMA_HOT_FN fmat4x4 OrthonormalInverse(const fmat4x4& m)
+{
+	return Transpose(m);
+}
+
+ENMA_HOT_FN fvec4 fvec4::operator*(const fmat4x4& other)
+{
+	return fvec4(LinearCombine(LoadXYZW(*this), other));
+}
+
+#endif
@@ -0,0 +1,157 @@
+/* Parallel Loops
+ *
+ * This header file is part of Enmatica library
+ *
+ * Copyright (c) 202X Villainous Softworks
+ *
+ */
+
+#pragma once
+#include "../base.hpp"
+#include "../empch.hpp"
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+/**
+ * Number of threads the parallel kernels split their work across, at least 1.
+ *
+ * \return The count set with SetThreadCount, otherwise the hardware concurrency of the host, detected on the first call only.
+ */
+uin32 GetThreadCount();
+
+/**
+ * Overrides the thread count of the parallel kernels, e.g. to force the multi-threaded paths on a single-core host.
+ * Must not be changed while a parallel kernel is running.
+ *
+ * \param threads Number of threads, 0 restores the hardware concurrency.
+ */
+void SetThreadCount(uin32 threads);
+
+/**
+ * Number of tasks to split `count` items into so that every task gets at least `grain` items.
+ *
+ * \param count Number of items.
+ * \param grain Minimum number of items worth a thread of their own.
+ * \return A task count in [1, GetThreadCount()].
+ */
+uin32 TaskCount(uin32 count, uin32 grain);
+
+/**
+ * First item of task `task` when `count` items are split evenly into `tasks` contiguous ranges.
+ * Task t covers [TaskBegin(t), TaskBegin(t + 1)).
+ */
+inline uin32 TaskBegin(uin32 task, uin32 tasks, uin32 count)
+{
+	return static_cast<uin32>((static_cast<uin64>(count) * task) / tasks);
+}
+
+/**
+ * Runs fn(task) for every task in [0, tasks), each on its own thread, and waits for all of them.
+ *
+ * Task 0 runs on the calling thread, so a single task never spawns a thread. If a task throws, the
+ * other tasks still run to completion and every worker is joined before the first exception is rethrown.
+ * Tasks that cannot get a thread of their own run on the calling thread.
+ *
+ * \param tasks Number of tasks, usually from TaskCount.
+ * \param fn Callable taking the task index as uin32.
+ */
+template <typename Fn>
+inline void ParallelFor(uin32 tasks, Fn&& fn)
+{
+	if(tasks <= 1)
+	{
+		if(tasks == 1)
+		{
+			fn(0u);
+		}
+
+		return;
+	}
+
+	std::exception_ptr error;
+	std::mutex errorLock;
+
+	// An exception escaping a worker would terminate the program, so it is kept for the calling thread
+	const auto run = [&fn, &error, &errorLock](uin32 t)
+	{
+		try
+		{
+			fn(t);
+		}
+		catch(...)
+		{
+			std::lock_guard<std::mutex> lock(errorLock);
+
+			if(!error)
+			{
+				error = std::current_exception();
+			}
+		}
+	};
+
+	std::vector<std::thread> workers;
+	workers.reserve(tasks - 1);
+
+	uin32 spawned = 1;
+
+	try
+	{
+		for(; spawned < tasks; spawned++)
+		{
+			workers.emplace_back(run, spawned);
+		}
+	}
+	catch(const std::system_error&)
+	{
+		// Out of threads, the remaining tasks run below
+	}
+
+	for(uin32 t = spawned; t < tasks; t++)
+	{
+		run(t);
+	}
+
+	run(0u);
+
+	for(std::thread& worker : workers)
+	{
+		worker.join();
+	}
+
+	if(error)
+	{
+		std::rethrow_exception(error);
+	}
+}
+
+#ifdef ENMA_IMPLEMENTATION
+// 0 while no count has been forced
+inline std::atomic<uin32>& ThreadCountOverride()
+{
+	static std::atomic<uin32> threads(0);
+
+	return threads;
+}
+
+ENMA_FN uin32 GetThreadCount()
+{
+	static const uin32 hardware = std::max(1u, std::thread::hardware_concurrency());
+	const uin32 forced = ThreadCountOverride().load(std::memory_order_relaxed);
+
+	return forced != 0 ? forced : hardware;
+}
+
+ENMA_FN void SetThreadCount(uin32 threads)
+{
+	ThreadCountOverride().store(threads, std::memory_order_relaxed);
+}
+
+ENMA_FN uin32 TaskCount(uin32 count, uin32 grain)
+{
+	return std::max(1u, std::min(GetThreadCount(), count / std::max(1u, grain)));
+}
+#endif // ENMA_IMPLEMENTATION
@@ -25,10 +25,9 @@ struct ALIGN(32) dquat
 	};
 
 public:
-	dquat(const dquat &qt);
-	dquat(const flt64 val = 0.0f);
-	dquat(const flt64 fw, const flt64 fx, const flt64 fy = 0.0f, const flt64 fz = 0.0f);
-	dquat(const flt64 w, const vec3 xyz);
+	constexpr dquat(const flt64 val = 0.0f);
+	constexpr dquat(const flt64 fw, const flt64 fx, const flt64 fy = 0.0f, const flt64 fz = 0.0f);
+	constexpr dquat(const flt64 w, const vec3 xyz);
 	
 	dquat operator+(const dquat other);
 	dquat operator+=(const dquat other);
@@ -58,32 +57,19 @@ public:
 	#endif
 };
 
-#ifdef ENMA_IMPLEMENTATION
-	dquat::dquat(const dquat &qt)
-	{
-		*this = qt;
-	}
-
-	dquat::dquat(const flt64 val) : x(val), y(val), z(val) {
-		w = 1.0f;
-	}
+constexpr dquat::dquat(const flt64 val) : w(1.0), x(val), y(val), z(val) {}
 
-	dquat::dquat(const flt64 fw, const flt64 fx, const flt64 fy, const flt64 fz) : w(fw), x(fx), y(fy), z(fz) {}
+constexpr dquat::dquat(const flt64 fw, const flt64 fx, const flt64 fy, const flt64 fz) : w(fw), x(fx), y(fy), z(fz) {}
 
-	dquat::dquat(const flt64 w, const vec3 xyz)
-	{
-		this->w = w;
-		this->x = xyz.x;
-		this->y = xyz.y;
-		this->z = xyz.z;
-	}
+constexpr dquat::dquat(const flt64 w, const vec3 xyz) : w(w), x(xyz.x), y(xyz.y), z(xyz.z) {}
 
-	dquat dquat::operator+(const dquat other)
+#ifdef ENMA_IMPLEMENTATION
+	ENMA_HOT_FN dquat dquat::operator+(const dquat other)
 	{
 		return { this->w + other.w, this->x + other.x, this->y + other.y, this->z + other.z };
 	}
 
-	dquat dquat::operator+=(const dquat other)
+	ENMA_HOT_FN dquat dquat::operator+=(const dquat other)
 	{
 		this->w += other.w;
 		this->x += other.x;
@@ -93,12 +79,12 @@ public:
 		return *this;
 	}
 
-	dquat dquat::operator-(const dquat other)
+	ENMA_HOT_FN dquat dquat::operator-(const dquat other)
 	{
 		return { this->w - other.w, this->x - other.x, this->y - other.y, this->z - other.z };
 	}
 
-	dquat dquat::operator-=(const dquat other)
+	ENMA_HOT_FN dquat dquat::operator-=(const dquat other)
 	{
 		this->w -= other.w;
 		this->x -= other.x;
@@ -108,7 +94,7 @@ public:
 		return *this;
 	}
 
-	dquat dquat::operator*(const dquat &other)
+	ENMA_HOT_FN dquat dquat::operator*(const dquat &other)
 	{
 		return 
 		{
@@ -119,12 +105,12 @@ public:
 		};
 	}
 
-	dquat dquat::operator*(const flt64 val)
+	ENMA_HOT_FN dquat dquat::operator*(const flt64 val)
 	{
 		return { w * val, x * val, y * val, z * val };
 	}
 
-	dquat dquat::operator*=(const flt64 val)
+	ENMA_HOT_FN dquat dquat::operator*=(const flt64 val)
 	{
 		this->w *= val;
 		this->x *= val;
@@ -134,14 +120,14 @@ public:
 		return *this;
 	}
 
-	dquat dquat::operator/(const flt64 val)
+	ENMA_HOT_FN dquat dquat::operator/(const flt64 val)
 	{
 		const flt64 div = 1.0f / val;
 
 		return { w * div, x * div, y * div, z * div };
 	}
 
-	dquat dquat::operator/=(const flt64 val)
+	ENMA_HOT_FN dquat dquat::operator/=(const flt64 val)
 	{
 		const flt64 div = 1.0f / val;
 
@@ -153,19 +139,19 @@ public:
 		return *this;
 	}
 
-	dquat dquat::Conjugate(const dquat &q)
+	ENMA_HOT_FN dquat dquat::Conjugate(const dquat &q)
 	{
 		return { q.w, -q.x, -q.y, -q.z };
 	}
 
-	dquat dquat::Normalise(dquat q)
+	ENMA_HOT_FN dquat dquat::Normalise(dquat q)
 	{
 		const flt64 mag = std::sqrt(q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z);
 
 		return q / mag;
 	}
 
-	dquat dquat::Inverse(const dquat &q)
+	ENMA_HOT_FN dquat dquat::Inverse(const dquat &q)
 	{
 		const flt64 mag2 = q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z;
 
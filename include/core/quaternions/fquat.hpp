@@ -12,6 +12,8 @@
 #include "../../base.hpp"
 #include "../../empch.hpp"
 #include "../../trignometry.hpp"
+#include "../../sincos.hpp"
+#include "../simd.hpp"
 
 struct ALIGN(16) fquat
 {
@@ -22,13 +24,16 @@ struct ALIGN(16) fquat
 			flt32 w, x, y, z;
 		};
 		flt32 arr[4];
+
+		#ifdef USE_SIMD
+		__m128 _vals;
+		#endif
 	};
 
 public:
-	fquat(const fquat& q);
-	fquat(const flt32 val = 0.0f);
-	fquat(const flt32 fw, const flt32 fx, const flt32 fy = 0.0f, const flt32 fz = 0.0f);
-	fquat(const flt32 w, const vec3& xyz);
+	constexpr fquat(const flt32 val = 0.0f);
+	constexpr fquat(const flt32 fw, const flt32 fx, const flt32 fy = 0.0f, const flt32 fz = 0.0f);
+	constexpr fquat(const flt32 w, const vec3& xyz);
 	
 	fquat operator+(const fquat& other) const;
 	fquat& operator+=(const fquat& other);
@@ -49,6 +54,28 @@ public:
 	vec3 ToEulerAngles() const;
 	mat4x4 ToRotationMatrix() const;
 
+	/**
+	 * Constructor from simd::float4.
+	 *
+	 * \param vals A simd::float4 holding the w, x, y and z components in that order.
+	 */
+	fquat(const simd::float4& vals);
+
+	#ifdef USE_SIMD
+	/**
+	 * Conversion operator to __m128.
+	 *
+	 * \return A SIMD __m128 holding the w, x, y and z components in that order.
+	 */
+	operator __m128() const;
+	/**
+	 * Constructor from __m128.
+	 *
+	 * \param vals A SIMD __m128 holding the w, x, y and z components in that order.
+	 */
+	fquat(const __m128& vals);
+	#endif
+
 	#ifdef DEBUG
 	friend std::ostream& operator<<(std::ostream& os, const fquat& q)
 	{
@@ -65,159 +92,749 @@ fquat Normalise(const fquat& q);
 fquat Inverse(const fquat& q);
 //fquat Rotate(const flt32 angle, const vec3& axis);
 
+/**
+ * Rotates a vector by a unit quaternion.
+ *
+ * Evaluates q * v * q^-1 as v + 2w(q x v) + 2q x (q x v), which avoids building a rotation matrix.
+ *
+ * \param q The unit quaternion.
+ * \param v The fvec3 to rotate.
+ * \return The rotated fvec3.
+ */
+fvec3 Rotate(const fquat& q, const fvec3& v);
+/**
+ * Rotates an array of vectors by the same unit quaternion.
+ *
+ * The quaternion is converted to a rotation matrix once, so each vector costs three FMAs.
+ *
+ * \param q The unit quaternion.
+ * \param in Pointer to an array of at least `count` fvec3 elements.
+ * \param out Pointer to an array of at least `count` fvec3 elements.
+ * \param count Number of vectors to rotate.
+ */
+void RotateVectors(const fquat& q, const fvec3* in, fvec3* out, uin32 count);
+/**
+ * Rotates each vector by its own unit quaternion, out[i] = Rotate(q[i], in[i]).
+ *
+ * \param q Pointer to an array of at least `count` unit quaternions.
+ * \param in Pointer to an array of at least `count` fvec3 elements.
+ * \param out Pointer to an array of at least `count` fvec3 elements.
+ * \param count Number of vectors to rotate.
+ */
+void RotateVectors(const fquat* q, const fvec3* in, fvec3* out, uin32 count);
+
+/**
+ * Normalised linear interpolation between two unit quaternions along the shortest path.
+ *
+ * \param a The quaternion to interpolate from.
+ * \param b The quaternion to interpolate towards.
+ * \param t Interpolation parameter in the range [0, 1].
+ * \return The interpolated unit quaternion.
+ */
+fquat Nlerp(const fquat& a, const fquat& b, flt32 t);
+/**
+ * Spherical linear interpolation between two unit quaternions along the shortest path.
+ *
+ * Falls back to Nlerp when the quaternions are nearly parallel.
+ *
+ * \param a The quaternion to interpolate from.
+ * \param b The quaternion to interpolate towards.
+ * \param t Interpolation parameter in the range [0, 1].
+ * \return The interpolated unit quaternion.
+ */
+fquat Slerp(const fquat& a, const fquat& b, flt32 t);
+/**
+ * Spherical quadrangle interpolation between `q1` and `q2`.
+ *
+ * \param q1 The quaternion to interpolate from.
+ * \param q2 The quaternion to interpolate towards.
+ * \param s1 The control point of `q1`, see SquadControlPoint.
+ * \param s2 The control point of `q2`, see SquadControlPoint.
+ * \param t Interpolation parameter in the range [0, 1].
+ * \return The interpolated unit quaternion.
+ */
+fquat Squad(const fquat& q1, const fquat& q2, const fquat& s1, const fquat& s2, flt32 t);
+/**
+ * Calculates the Squad control point of a key from its neighbours.
+ *
+ * The three keys are expected to lie in the same hemisphere, i.e. Dot(prev, q) >= 0 and Dot(q, next) >= 0.
+ *
+ * \param prev The previous key.
+ * \param q The key to calculate the control point for.
+ * \param next The next key.
+ * \return The control point of `q`.
+ */
+fquat SquadControlPoint(const fquat& prev, const fquat& q, const fquat& next);
+/**
+ * Blends arrays of quaternion pairs, out[i] = Nlerp(a[i], b[i], t[i]).
+ *
+ * \param a Pointer to an array of at least `count` unit quaternions to interpolate from.
+ * \param b Pointer to an array of at least `count` unit quaternions to interpolate towards.
+ * \param t Pointer to an array of at least `count` interpolation parameters.
+ * \param out Pointer to an array of at least `count` quaternions.
+ * \param count Number of quaternion pairs to blend.
+ */
+void NlerpQuaternions(const fquat* a, const fquat* b, const flt32* t, fquat* out, uin32 count);
+/**
+ * Blends arrays of quaternion pairs, out[i] = Slerp(a[i], b[i], t[i]).
+ *
+ * \param a Pointer to an array of at least `count` unit quaternions to interpolate from.
+ * \param b Pointer to an array of at least `count` unit quaternions to interpolate towards.
+ * \param t Pointer to an array of at least `count` interpolation parameters.
+ * \param out Pointer to an array of at least `count` quaternions.
+ * \param count Number of quaternion pairs to blend.
+ */
+void SlerpQuaternions(const fquat* a, const fquat* b, const flt32* t, fquat* out, uin32 count);
+
 vec3 ToEulerAngles(const fquat& q);
 mat4x4 ToRotationMatrix(const fquat& q);
 fquat ToQuaternion(const vec3& eulerAngles);
 
+constexpr fquat::fquat(const flt32 val) : w(1.0f), x(val), y(val), z(val) {}
+
+constexpr fquat::fquat(const flt32 fw, const flt32 fx, const flt32 fy, const flt32 fz) : w(fw), x(fx), y(fy), z(fz) {}
+
+constexpr fquat::fquat(const flt32 w, const vec3& xyz) : w(w), x(xyz.x), y(xyz.y), z(xyz.z) {}
+
 #ifdef ENMA_IMPLEMENTATION
-fquat::fquat(const fquat& q)
+// acos(x) = sqrt(1 - x) * P(x) on [0, 1], Abramowitz & Stegun 4.4.46 with |error| <= 2e-8
+constexpr flt32 SLERP_ACOS_0	=  1.5707963050f;
+constexpr flt32 SLERP_ACOS_1	= -0.2145988016f;
+constexpr flt32 SLERP_ACOS_2	=  0.0889789874f;
+constexpr flt32 SLERP_ACOS_3	= -0.0501743046f;
+constexpr flt32 SLERP_ACOS_4	=  0.0308918810f;
+constexpr flt32 SLERP_ACOS_5	= -0.0170881256f;
+constexpr flt32 SLERP_ACOS_6	=  0.0066700901f;
+constexpr flt32 SLERP_ACOS_7	= -0.0012624911f;
+
+// Above this cosine the quaternions are nearly parallel and Slerp falls back to Nlerp
+constexpr flt32 SLERP_THRESHOLD	= 0.9995f;
+
+inline flt32 SlerpAcos(const flt32 x)
+{
+	flt32 p = SLERP_ACOS_7;
+	p = p * x + SLERP_ACOS_6;
+	p = p * x + SLERP_ACOS_5;
+	p = p * x + SLERP_ACOS_4;
+	p = p * x + SLERP_ACOS_3;
+	p = p * x + SLERP_ACOS_2;
+	p = p * x + SLERP_ACOS_1;
+	p = p * x + SLERP_ACOS_0;
+
+	return std::sqrt(1.0f - x) * p;
+}
+
+inline simd::float4 LoadQuat(const fquat& q)
+{
+	#ifdef USE_SIMD
+	return q._vals;
+	#else
+	return simd::float4::LoadU(q.arr);
+	#endif
+}
+
+inline void StoreQuat(fquat& q, const simd::float4& v)
+{
+	#ifdef USE_SIMD
+	q._vals = v;
+	#else
+	v.StoreU(q.arr);
+	#endif
+}
+
+ENMA_HOT_FN fquat::fquat(const simd::float4& vals)
+{
+	StoreQuat(*this, vals);
+}
+
+#ifdef USE_SIMD
+ENMA_HOT_FN fquat::operator __m128() const
+{
+	return this->_vals;
+}
+
+ENMA_HOT_FN fquat::fquat(const __m128& vals)
+{
+	this->_vals = vals;
+}
+#endif
+
+// Sign masks for the Hamilton product, lanes are ( w, x, y, z )
+inline simd::float4 QuatSignMask(const flt32 w, const flt32 x, const flt32 y, const flt32 z)
+{
+	return simd::float4::Set(w, x, y, z);
+}
+
+inline simd::float4 QuatMultiply(const simd::float4& a, const simd::float4& b)
+{
+	using namespace simd;
+
+	// r = a.w * b + a.x * (b.x, b.w, b.z, b.y) * (-, +, -, +)
+	//             + a.y * (b.y, b.z, b.w, b.x) * (-, +, +, -)
+	//             + a.z * (b.z, b.y, b.x, b.w) * (-, -, +, +)
+	const float4 signX = QuatSignMask(-0.0f, 0.0f, -0.0f, 0.0f);
+	const float4 signY = QuatSignMask(-0.0f, 0.0f, 0.0f, -0.0f);
+	const float4 signZ = QuatSignMask(-0.0f, -0.0f, 0.0f, 0.0f);
+
+	float4 r = Shuffle<0, 0, 0, 0>(a) * b;
+	r = Fmadd(Xor(Shuffle<1, 1, 1, 1>(a), signX), Shuffle<1, 0, 3, 2>(b), r);
+	r = Fmadd(Xor(Shuffle<2, 2, 2, 2>(a), signY), Shuffle<2, 3, 0, 1>(b), r);
+	r = Fmadd(Xor(Shuffle<3, 3, 3, 3>(a), signZ), Shuffle<3, 2, 1, 0>(b), r);
+
+	return r;
+}
+
+// 1 / sqrt(q . q) in every lane
+inline simd::float4 QuatInvLength(const simd::float4& q)
+{
+	return simd::Rsqrt(simd::Dot4(q, q));
+}
+
+inline simd::float4 QuatConjugate(const simd::float4& q)
+{
+	return simd::Xor(q, QuatSignMask(0.0f, -0.0f, -0.0f, -0.0f));
+}
+
+ENMA_HOT_FN fquat fquat::operator+(const fquat& other) const
+{
+	return fquat(LoadQuat(*this) + LoadQuat(other));
+}
+
+ENMA_HOT_FN fquat& fquat::operator+=(const fquat& other)
+{
+	return *this = *this + other;
+}
+
+ENMA_HOT_FN fquat fquat::operator-() const
+{
+	return fquat(-LoadQuat(*this));
+}
+
+ENMA_HOT_FN fquat fquat::operator-(const fquat& other) const
+{
+	return fquat(LoadQuat(*this) - LoadQuat(other));
+}
+
+ENMA_HOT_FN fquat& fquat::operator-=(const fquat& other)
+{
+	return *this = *this - other;
+}
+
+ENMA_HOT_FN fquat fquat::operator*(const fquat& other) const
+{
+	return fquat(QuatMultiply(LoadQuat(*this), LoadQuat(other)));
+}
+
+ENMA_HOT_FN fquat fquat::operator*(const flt32 val) const
 {
-	this->w = q.w;
-	this->x = q.x;
-	this->y = q.y;
-	this->z = q.z;
+	return fquat(LoadQuat(*this) * val);
 }
 
-fquat::fquat(const flt32 val) : w(1.0f), x(val), y(val), z(val) {}
+ENMA_HOT_FN fquat& fquat::operator*=(const flt32 val)
+{
+	return *this = *this * val;
+}
 
-fquat::fquat(const flt32 fw, const flt32 fx, const flt32 fy, const flt32 fz) : w(fw), x(fx), y(fy), z(fz) {}
+ENMA_HOT_FN fquat fquat::operator/(const flt32 val) const
+{
+	return fquat(LoadQuat(*this) / val);
+}
 
-fquat::fquat(const flt32 w, const vec3& xyz)
+ENMA_HOT_FN fquat& fquat::operator/=(const flt32 val)
 {
-	this->w = w;
-	this->x = xyz.x;
-	this->y = xyz.y;
-	this->z = xyz.z;
+	return *this = *this / val;
 }
 
-fquat fquat::operator+(const fquat& other) const
+ENMA_HOT_FN flt32 fquat::Dot(const fquat& other) const
 {
-	return { this->w + other.w, this->x + other.x, this->y + other.y, this->z + other.z };
+	return ::Dot(*this, other);
 }
 
-fquat& fquat::operator+=(const fquat& other)
+ENMA_HOT_FN flt32 Dot(const fquat& q1, const fquat& q2)
 {
-	this->w += other.w;
-	this->x += other.x;
-	this->y += other.y;
-	this->z += other.z;
+	return simd::Dot4(LoadQuat(q1), LoadQuat(q2)).X();
+}
 
-	return *this;
+ENMA_HOT_FN fquat fquat::Conjugate() const
+{
+	return ::Conjugate(*this);
+}
+
+ENMA_HOT_FN fquat Conjugate(const fquat& q)
+{
+	return fquat(QuatConjugate(LoadQuat(q)));
 }
 
-fquat fquat::operator-() const
+ENMA_HOT_FN fquat fquat::Normalise() const
 {
-	return { -this->w, -this->x, -this->y, -this->z };
+	return ::Normalise(*this);
 }
 
-fquat fquat::operator-(const fquat& other) const
+ENMA_HOT_FN fquat Normalise(const fquat& q)
 {
-	return { this->w - other.w, this->x - other.x, this->y - other.y, this->z - other.z };
+	const simd::float4 v = LoadQuat(q);
+
+	return fquat(v * QuatInvLength(v));
+}
+
+ENMA_HOT_FN fquat fquat::Inverse() const
+{
+	return ::Inverse(*this);
+}
+
+ENMA_HOT_FN fquat Inverse(const fquat& q)
+{
+	const simd::float4 v = LoadQuat(q);
+
+	return fquat(QuatConjugate(v) / simd::Dot4(v, v));
 }
 
-fquat& fquat::operator-=(const fquat& other)
+// v + w * t + u x t with u = q.xyz and t = 2 * (u x v); the w lane of the result is 0
+inline simd::float4 QuatRotate(const simd::float4& q, const simd::float4& v)
 {
-	this->w -= other.w;
-	this->x -= other.x;
-	this->y -= other.y;
-	this->z -= other.z;
+	using namespace simd;
 
-	return *this;
+	const float4 u = Shuffle<1, 2, 3, 0>(q);
+
+	float4 t = CrossRows(u, v);
+	t = t + t;
+
+	const float4 r = Fmadd(Shuffle<0, 0, 0, 0>(q), t, v);
+
+	return r + CrossRows(u, t);
 }
 
-fquat fquat::operator*(const fquat& other) const
+ENMA_HOT_FN fvec3 Rotate(const fquat& q, const fvec3& v)
 {
-	return 
+	return fvec3(QuatRotate(LoadQuat(q), LoadXYZ(v)));
+}
+
+// The baseline kernels are written on the SIMD layer; without USE_SIMD they run on its scalar fallback
+ENMA_FN void RotateVectorsSSE41(const fquat* q, const fvec3* in, fvec3* out, uin32 count)
+{
+	uin32 i = 0;
+
+	for(; i + 4 <= count; i += 4)
 	{
-		this->w * other.w - this->x * other.x - this->y * other.y - this->z * other.z,
-		this->w * other.x + this->x * other.w + this->y * other.z - this->z * other.y,
-		this->w * other.y - this->x * other.z + this->y * other.w + this->z * other.x,
-		this->w * other.z + this->x * other.y - this->y * other.x + this->z * other.w
-	};
+		simd::Prefetch(q + i + TRANSFORM_PREFETCH);
+		simd::Prefetch(in + i + TRANSFORM_PREFETCH);
+
+		const simd::float4 r0 = QuatRotate(LoadQuat(q[i]), LoadXYZ(in[i]));
+		const simd::float4 r1 = QuatRotate(LoadQuat(q[i + 1]), LoadXYZ(in[i + 1]));
+		const simd::float4 r2 = QuatRotate(LoadQuat(q[i + 2]), LoadXYZ(in[i + 2]));
+		const simd::float4 r3 = QuatRotate(LoadQuat(q[i + 3]), LoadXYZ(in[i + 3]));
+
+		StoreXYZ(out[i], r0);
+		StoreXYZ(out[i + 1], r1);
+		StoreXYZ(out[i + 2], r2);
+		StoreXYZ(out[i + 3], r3);
+	}
+
+	for(; i < count; i++)
+	{
+		StoreXYZ(out[i], QuatRotate(LoadQuat(q[i]), LoadXYZ(in[i])));
+	}
+}
+
+inline simd::float4 SlerpAcos(const simd::float4& x)
+{
+	using namespace simd;
+
+	float4 p = Fmadd(x, float4::Set1(SLERP_ACOS_7), float4::Set1(SLERP_ACOS_6));
+	p = Fmadd(x, p, float4::Set1(SLERP_ACOS_5));
+	p = Fmadd(x, p, float4::Set1(SLERP_ACOS_4));
+	p = Fmadd(x, p, float4::Set1(SLERP_ACOS_3));
+	p = Fmadd(x, p, float4::Set1(SLERP_ACOS_2));
+	p = Fmadd(x, p, float4::Set1(SLERP_ACOS_1));
+	p = Fmadd(x, p, float4::Set1(SLERP_ACOS_0));
+
+	return Sqrt(float4::Set1(1.0f) - x) * p;
 }
 
-fquat fquat::operator*(const flt32 val) const
+// Loads four quaternions transposed so that r[k] holds component k (w, x, y, z) of each
+inline void LoadQuat4(const fquat* q, simd::float4 (&r)[4])
 {
-	return { w * val, x * val, y * val, z * val };
+	r[0] = LoadQuat(q[0]);
+	r[1] = LoadQuat(q[1]);
+	r[2] = LoadQuat(q[2]);
+	r[3] = LoadQuat(q[3]);
+
+	simd::Transpose(r[0], r[1], r[2], r[3]);
 }
 
-fquat& fquat::operator*=(const flt32 val)
+inline void StoreQuat4(fquat* q, simd::float4 (&r)[4])
 {
-	this->w *= val;
-	this->x *= val;
-	this->y *= val;
-	this->z *= val;
+	simd::Transpose(r[0], r[1], r[2], r[3]);
 
-	return *this;
+	StoreQuat(q[0], r[0]);
+	StoreQuat(q[1], r[1]);
+	StoreQuat(q[2], r[2]);
+	StoreQuat(q[3], r[3]);
 }
 
-fquat fquat::operator/(const flt32 val) const
+inline simd::float4 QuatDot4(const simd::float4 (&a)[4], const simd::float4 (&b)[4])
 {
-	const flt32 div = 1.0f / val;
+	simd::float4 d = a[0] * b[0];
+	d = simd::Fmadd(a[1], b[1], d);
+	d = simd::Fmadd(a[2], b[2], d);
 
-	return { w * div, x * div, y * div, z * div };
+	return simd::Fmadd(a[3], b[3], d);
 }
 
-fquat& fquat::operator/=(const flt32 val)
+// r = wa * a + wb * b, normalised
+inline void QuatCombine4(const simd::float4 (&a)[4], const simd::float4 (&b)[4], const simd::float4& wa, const simd::float4& wb, simd::float4 (&r)[4])
 {
-	const flt32 div = 1.0f / val;
+	for(uin32 k = 0; k < 4; k++)
+	{
+		r[k] = simd::Fmadd(wb, b[k], wa * a[k]);
+	}
 
-	this->w *= div;
-	this->x *= div;
-	this->y *= div;
-	this->z *= div;
+	const simd::float4 inv = simd::Rsqrt(QuatDot4(r, r));
 
-	return *this;
+	for(uin32 k = 0; k < 4; k++)
+	{
+		r[k] = r[k] * inv;
+	}
 }
 
-flt32 fquat::Dot(const fquat& other) const
+// Four quaternions per iteration in component arrays, the layout of the AVX2 kernels at half the width
+ENMA_FN void NlerpQuaternionsSSE41(const fquat* a, const fquat* b, const flt32* t, fquat* out, uin32 count)
 {
-	return this->w * other.w + this->x * other.x + this->y * other.y + this->z * other.z;
+	using namespace simd;
+
+	const float4 signMask = float4::Set1(-0.0f);
+	const float4 one = float4::Set1(1.0f);
+
+	uin32 i = 0;
+
+	for(; i + 4 <= count; i += 4)
+	{
+		float4 qa[4], qb[4], qr[4];
+		LoadQuat4(a + i, qa);
+		LoadQuat4(b + i, qb);
+
+		const float4 lt = float4::LoadU(t + i);
+		const float4 sign = And(QuatDot4(qa, qb), signMask);
+
+		QuatCombine4(qa, qb, one - lt, Xor(lt, sign), qr);
+		StoreQuat4(out + i, qr);
+	}
+
+	for(; i < count; i++)
+	{
+		out[i] = Nlerp(a[i], b[i], t[i]);
+	}
 }
 
-flt32 Dot(const fquat& q1, const fquat& q2)
+ENMA_FN void SlerpQuaternionsSSE41(const fquat* a, const fquat* b, const flt32* t, fquat* out, uin32 count)
 {
-	return q1.w * q2.w + q1.x * q2.x + q1.y * q2.y + q1.z * q2.z;
+	using namespace simd;
+
+	const float4 signMask = float4::Set1(-0.0f);
+	const float4 one = float4::Set1(1.0f);
+	const float4 threshold = float4::Set1(SLERP_THRESHOLD);
+
+	uin32 i = 0;
+
+	for(; i + 4 <= count; i += 4)
+	{
+		float4 qa[4], qb[4], qr[4];
+		LoadQuat4(a + i, qa);
+		LoadQuat4(b + i, qb);
+
+		const float4 lt = float4::LoadU(t + i);
+
+		// Shortest path: take |cos(theta)| and flip b's weight where the dot product is negative
+		float4 d = QuatDot4(qa, qb);
+		const float4 sign = And(d, signMask);
+		d = Min(Abs(d), one);
+
+		const float4 theta = SlerpAcos(d);
+		const float4 sinTheta = Sqrt(Fnmadd(d, d, one));
+
+		// sin((1 - t) * theta) = sin(theta) * cos(t * theta) - cos(theta) * sin(t * theta)
+		float4 s, c;
+		SinCosKernel(lt * theta, s, c, SinCosPrecision::Accurate);
+
+		float4 wb = s / sinTheta;
+		float4 wa = Fnmadd(d, wb, c);
+
+		const float4 parallel = CmpGt(d, threshold);
+		wa = Select(parallel, one - lt, wa);
+		wb = Select(parallel, lt, wb);
+
+		QuatCombine4(qa, qb, wa, Xor(wb, sign), qr);
+		StoreQuat4(out + i, qr);
+	}
+
+	for(; i < count; i++)
+	{
+		out[i] = Slerp(a[i], b[i], t[i]);
+	}
+}
+
+#ifdef USE_SIMD
+ENMA_TARGET_AVX2 inline __m128 CrossRowsAVX2(const __m128& a, const __m128& b)
+{
+	const __m128 aYZX = _mm_shuffle_ps(a, a, 0xC9);
+	const __m128 bYZX = _mm_shuffle_ps(b, b, 0xC9);
+
+	const __m128 c = _mm_fmsub_ps(a, bYZX, _mm_mul_ps(aYZX, b));
+
+	return _mm_shuffle_ps(c, c, 0xC9);
+}
+
+ENMA_TARGET_AVX2 inline __m128 QuatRotateAVX2(const __m128 q, const __m128 v)
+{
+	const __m128 u = _mm_shuffle_ps(q, q, 0x39);
+
+	__m128 t = CrossRowsAVX2(u, v);
+	t = _mm_add_ps(t, t);
+
+	const __m128 r = _mm_fmadd_ps(_mm_shuffle_ps(q, q, 0x00), t, v);
+
+	return _mm_add_ps(r, CrossRowsAVX2(u, t));
+}
+
+ENMA_FN ENMA_TARGET_AVX2 void RotateVectorsAVX2(const fquat* q, const fvec3* in, fvec3* out, uin32 count)
+{
+	uin32 i = 0;
+
+	for(; i + 4 <= count; i += 4)
+	{
+		_mm_prefetch(reinterpret_cast<const char*>(q + i + TRANSFORM_PREFETCH), _MM_HINT_T0);
+		_mm_prefetch(reinterpret_cast<const char*>(in + i + TRANSFORM_PREFETCH), _MM_HINT_T0);
+
+		const __m128 r0 = QuatRotateAVX2(q[i]._vals, LoadXYZ(in[i]));
+		const __m128 r1 = QuatRotateAVX2(q[i + 1]._vals, LoadXYZ(in[i + 1]));
+		const __m128 r2 = QuatRotateAVX2(q[i + 2]._vals, LoadXYZ(in[i + 2]));
+		const __m128 r3 = QuatRotateAVX2(q[i + 3]._vals, LoadXYZ(in[i + 3]));
+
+		StoreXYZ(out[i], r0);
+		StoreXYZ(out[i + 1], r1);
+		StoreXYZ(out[i + 2], r2);
+		StoreXYZ(out[i + 3], r3);
+	}
+
+	for(; i < count; i++)
+	{
+		StoreXYZ(out[i], QuatRotateAVX2(q[i]._vals, LoadXYZ(in[i])));
+	}
+}
+
+ENMA_TARGET_AVX2 inline __m256 SlerpAcos(const __m256 x)
+{
+	__m256 p = _mm256_fmadd_ps(x, _mm256_set1_ps(SLERP_ACOS_7), _mm256_set1_ps(SLERP_ACOS_6));
+	p = _mm256_fmadd_ps(x, p, _mm256_set1_ps(SLERP_ACOS_5));
+	p = _mm256_fmadd_ps(x, p, _mm256_set1_ps(SLERP_ACOS_4));
+	p = _mm256_fmadd_ps(x, p, _mm256_set1_ps(SLERP_ACOS_3));
+	p = _mm256_fmadd_ps(x, p, _mm256_set1_ps(SLERP_ACOS_2));
+	p = _mm256_fmadd_ps(x, p, _mm256_set1_ps(SLERP_ACOS_1));
+	p = _mm256_fmadd_ps(x, p, _mm256_set1_ps(SLERP_ACOS_0));
+
+	return _mm256_mul_ps(_mm256_sqrt_ps(_mm256_sub_ps(_mm256_set1_ps(1.0f), x)), p);
 }
 
-fquat fquat::Conjugate() const
+// Transposes eight quaternions between AoS and SoA in place. The lanes come out in the order
+// 0, 2, 4, 6, 1, 3, 5, 7, which LoadQuat8Weights applies to the per-quaternion weights
+ENMA_TARGET_AVX2 inline void QuatTranspose8(__m256 (&q)[4])
 {
-	return fquat(this->w, -this->x, -this->y, -this->z);
+	const __m256 t0 = _mm256_unpacklo_ps(q[0], q[1]);
+	const __m256 t1 = _mm256_unpacklo_ps(q[2], q[3]);
+	const __m256 t2 = _mm256_unpackhi_ps(q[0], q[1]);
+	const __m256 t3 = _mm256_unpackhi_ps(q[2], q[3]);
+
+	q[0] = _mm256_shuffle_ps(t0, t1, 0x44);
+	q[1] = _mm256_shuffle_ps(t0, t1, 0xEE);
+	q[2] = _mm256_shuffle_ps(t2, t3, 0x44);
+	q[3] = _mm256_shuffle_ps(t2, t3, 0xEE);
 }
 
-fquat Conjugate(const fquat& q)
+ENMA_TARGET_AVX2 inline void LoadQuat8(const fquat* q, __m256 (&r)[4])
 {
-	return fquat(q.w, -q.x, -q.y, -q.z);
+	const flt32* p = q->arr;
+
+	r[0] = _mm256_loadu_ps(p);
+	r[1] = _mm256_loadu_ps(p + 8);
+	r[2] = _mm256_loadu_ps(p + 16);
+	r[3] = _mm256_loadu_ps(p + 24);
+
+	QuatTranspose8(r);
 }
 
-fquat fquat::Normalise() const
+ENMA_TARGET_AVX2 inline void StoreQuat8(fquat* q, __m256 (&r)[4])
 {
-	const flt32 mag = std::sqrt(this->w * this->w + this->x * this->x + this->y * this->y + this->z * this->z);
+	flt32* p = q->arr;
+
+	QuatTranspose8(r);
 
-	return *this / mag;
+	_mm256_storeu_ps(p, r[0]);
+	_mm256_storeu_ps(p + 8, r[1]);
+	_mm256_storeu_ps(p + 16, r[2]);
+	_mm256_storeu_ps(p + 24, r[3]);
 }
 
-fquat Normalise(const fquat& q)
+ENMA_TARGET_AVX2 inline __m256 LoadQuat8Weights(const flt32* t)
 {
-	const flt32 mag = std::sqrt(q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z);
+	return _mm256_permutevar8x32_ps(_mm256_loadu_ps(t), _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7));
+}
+
+ENMA_TARGET_AVX2 inline __m256 QuatDot8(const __m256 (&a)[4], const __m256 (&b)[4])
+{
+	__m256 d = _mm256_mul_ps(a[0], b[0]);
+	d = _mm256_fmadd_ps(a[1], b[1], d);
+	d = _mm256_fmadd_ps(a[2], b[2], d);
 
-	return q / mag;
+	return _mm256_fmadd_ps(a[3], b[3], d);
 }
 
-fquat fquat::Inverse() const
+// r = wa * a + wb * b, normalised with an rsqrt estimate and one Newton-Raphson step
+ENMA_TARGET_AVX2 inline void QuatCombine8(const __m256 (&a)[4], const __m256 (&b)[4], const __m256 wa, const __m256 wb, __m256 (&r)[4])
 {
-	const flt32 mag = std::sqrt(this->w * this->w + this->x * this->x + this->y * this->y + this->z * this->z);
+	for(uin32 k = 0; k < 4; k++)
+	{
+		r[k] = _mm256_fmadd_ps(wb, b[k], _mm256_mul_ps(wa, a[k]));
+	}
+
+	const __m256 dp = QuatDot8(r, r);
+	const __m256 y = _mm256_rsqrt_ps(dp);
+	const __m256 hdp = _mm256_mul_ps(dp, _mm256_set1_ps(0.5f));
+	const __m256 inv = _mm256_mul_ps(y, _mm256_fnmadd_ps(_mm256_mul_ps(hdp, y), y, _mm256_set1_ps(1.5f)));
 
-	return Conjugate() / mag;
+	for(uin32 k = 0; k < 4; k++)
+	{
+		r[k] = _mm256_mul_ps(r[k], inv);
+	}
 }
 
-fquat Inverse(const fquat& q)
+ENMA_FN ENMA_TARGET_AVX2 void NlerpQuaternionsAVX2(const fquat* a, const fquat* b, const flt32* t, fquat* out, uin32 count)
 {
-	const flt32 mag = std::sqrt(q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z);
+	const __m256 signMask = _mm256_set1_ps(-0.0f);
+	const __m256 one = _mm256_set1_ps(1.0f);
+
+	uin32 i = 0;
+
+	for(; i + 8 <= count; i += 8)
+	{
+		__m256 qa[4], qb[4], qr[4];
+		LoadQuat8(a + i, qa);
+		LoadQuat8(b + i, qb);
+
+		const __m256 lt = LoadQuat8Weights(t + i);
+		const __m256 sign = _mm256_and_ps(QuatDot8(qa, qb), signMask);
 
-	return Conjugate(q) / mag;
+		QuatCombine8(qa, qb, _mm256_sub_ps(one, lt), _mm256_xor_ps(lt, sign), qr);
+		StoreQuat8(out + i, qr);
+	}
+
+	for(; i < count; i++)
+	{
+		out[i] = Nlerp(a[i], b[i], t[i]);
+	}
 }
 
+ENMA_FN ENMA_TARGET_AVX2 void SlerpQuaternionsAVX2(const fquat* a, const fquat* b, const flt32* t, fquat* out, uin32 count)
+{
+	const __m256 signMask = _mm256_set1_ps(-0.0f);
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 threshold = _mm256_set1_ps(SLERP_THRESHOLD);
+
+	uin32 i = 0;
+
+	for(; i + 8 <= count; i += 8)
+	{
+		__m256 qa[4], qb[4], qr[4];
+		LoadQuat8(a + i, qa);
+		LoadQuat8(b + i, qb);
+
+		const __m256 lt = LoadQuat8Weights(t + i);
+
+		// Shortest path: take |cos(theta)| and flip b's weight where the dot product is negative
+		__m256 d = QuatDot8(qa, qb);
+		const __m256 sign = _mm256_and_ps(d, signMask);
+		d = _mm256_min_ps(_mm256_andnot_ps(signMask, d), one);
+
+		const __m256 theta = SlerpAcos(d);
+		const __m256 sinTheta = _mm256_sqrt_ps(_mm256_fnmadd_ps(d, d, one));
+
+		// sin((1 - t) * theta) = sin(theta) * cos(t * theta) - cos(theta) * sin(t * theta)
+		__m256 s, c;
+		SinCosKernel(_mm256_mul_ps(lt, theta), s, c, SinCosPrecision::Accurate);
+
+		__m256 wb = _mm256_div_ps(s, sinTheta);
+		__m256 wa = _mm256_fnmadd_ps(d, wb, c);
+
+		const __m256 parallel = _mm256_cmp_ps(d, threshold, _CMP_GT_OQ);
+		wa = _mm256_blendv_ps(wa, _mm256_sub_ps(one, lt), parallel);
+		wb = _mm256_blendv_ps(wb, lt, parallel);
+
+		QuatCombine8(qa, qb, wa, _mm256_xor_ps(wb, sign), qr);
+		StoreQuat8(out + i, qr);
+	}
+
+	for(; i < count; i++)
+	{
+		out[i] = Slerp(a[i], b[i], t[i]);
+	}
+}
+
+// Batch kernels of the fastest tier the host supports, selected once on first use
+struct QuatBatchKernels
+{
+	void (*rotateVectors)(const fquat*, const fvec3*, fvec3*, uin32);
+	void (*nlerpQuaternions)(const fquat*, const fquat*, const flt32*, fquat*, uin32);
+	void (*slerpQuaternions)(const fquat*, const fquat*, const flt32*, fquat*, uin32);
+};
+
+inline QuatBatchKernels SelectQuatBatchKernels()
+{
+	if(GetSimdLevel() >= SimdLevel::AVX2)
+		return { RotateVectorsAVX2, NlerpQuaternionsAVX2, SlerpQuaternionsAVX2 };
+
+	return { RotateVectorsSSE41, NlerpQuaternionsSSE41, SlerpQuaternionsSSE41 };
+}
+
+inline const QuatBatchKernels& GetQuatBatchKernels()
+{
+	static const QuatBatchKernels kernels = SelectQuatBatchKernels();
+
+	return kernels;
+}
+
+ENMA_FN void RotateVectors(const fquat* q, const fvec3* in, fvec3* out, uin32 count)
+{
+	GetQuatBatchKernels().rotateVectors(q, in, out, count);
+}
+
+ENMA_FN void NlerpQuaternions(const fquat* a, const fquat* b, const flt32* t, fquat* out, uin32 count)
+{
+	GetQuatBatchKernels().nlerpQuaternions(a, b, t, out, count);
+}
+
+ENMA_FN void SlerpQuaternions(const fquat* a, const fquat* b, const flt32* t, fquat* out, uin32 count)
+{
+	GetQuatBatchKernels().slerpQuaternions(a, b, t, out, count);
+}
+
+#else // ! USE_SIMD
+
+ENMA_FN void RotateVectors(const fquat* q, const fvec3* in, fvec3* out, uin32 count)
+{
+	RotateVectorsSSE41(q, in, out, count);
+}
+
+ENMA_FN void NlerpQuaternions(const fquat* a, const fquat* b, const flt32* t, fquat* out, uin32 count)
+{
+	NlerpQuaternionsSSE41(a, b, t, out, count);
+}
+
+ENMA_FN void SlerpQuaternions(const fquat* a, const fquat* b, const flt32* t, fquat* out, uin32 count)
+{
+	SlerpQuaternionsSSE41(a, b, t, out, count);
+}
+
+#endif // USE_SIMD
+
 /*fquat Rotate(const flt32 angle, const vec3& axis)
 {
 	#ifdef USE_AUTO_DEG
@@ -231,7 +848,7 @@ fquat Inverse(const fquat& q)
 	return fquat(cosha, sinha * axis.x, sinha * axis.y, sinha * axis.z);
 }*/
 
-fquat ToQuaternion(const vec3& eulerAngles)
+ENMA_FN fquat ToQuaternion(const vec3& eulerAngles)
 {
 	#if defined(USE_AUTO_DEG)
 	const vec3 heuler = ToRadians(eulerAngles) * 0.5f; 	// A little optimisation, not much
@@ -239,13 +856,16 @@ fquat ToQuaternion(const vec3& eulerAngles)
 	const vec3 heuler = eulerAngles * 0.5f;
 	#endif
 
-	const flt32 cX = cos(heuler.x);
-	const flt32 cY = cos(heuler.y);
-	const flt32 cZ = cos(heuler.z);
+	fvec4 sines, cosines;
+	SinCos(fvec4(heuler, 0.0f), sines, cosines);
+
+	const flt32 cX = cosines.x;
+	const flt32 cY = cosines.y;
+	const flt32 cZ = cosines.z;
 
-	const flt32 sX = sin(heuler.x);
-	const flt32 sY = sin(heuler.y);
-	const flt32 sZ = sin(heuler.z);
+	const flt32 sX = sines.x;
+	const flt32 sY = sines.y;
+	const flt32 sZ = sines.z;
 
 	return
 	{
@@ -256,7 +876,7 @@ fquat ToQuaternion(const vec3& eulerAngles)
 	};
 }
 
-vec3 fquat::ToEulerAngles() const
+ENMA_FN vec3 fquat::ToEulerAngles() const
 {
 	flt32 heading, pitch, bank;
 	const flt32 sX = -2.0f * (this->y * this->z - this->w * this->x);
@@ -282,7 +902,7 @@ vec3 fquat::ToEulerAngles() const
 	return vec3(pitch, heading, bank);
 }
 
-vec3 ToEulerAngles(const fquat& q)
+ENMA_FN vec3 ToEulerAngles(const fquat& q)
 {
 	flt32 heading, pitch, bank;
 	const flt32 sX = -2.0f * (q.y * q.z - q.w * q.x);
@@ -308,7 +928,7 @@ vec3 ToEulerAngles(const fquat& q)
 	return { pitch, heading, bank };
 }
 
-mat4x4 fquat::ToRotationMatrix() const
+ENMA_FN mat4x4 fquat::ToRotationMatrix() const
 {
 	const flt32 x2 = this->x * this->x;
 	const flt32 y2 = this->y * this->y;
@@ -332,7 +952,7 @@ mat4x4 fquat::ToRotationMatrix() const
 	};
 }
 
-mat4x4 ToRotationMatrix(const fquat& q)
+ENMA_FN mat4x4 ToRotationMatrix(const fquat& q)
 {
 	const flt32 x2 = q.x * q.x;
 	const flt32 y2 = q.y * q.y;
@@ -355,4 +975,74 @@ mat4x4 ToRotationMatrix(const fquat& q)
 		0.0f, 				0.0f, 				0.0f, 				1.0f
 	};
 }
+ENMA_FN void RotateVectors(const fquat& q, const fvec3* in, fvec3* out, uin32 count)
+{
+	TransformVectors(ToRotationMatrix(q), in, out, count);
+}
+
+ENMA_HOT_FN fquat Nlerp(const fquat& a, const fquat& b, flt32 t)
+{
+	const flt32 tb = Dot(a, b) < 0.0f ? -t : t;
+
+	return Normalise(a * (1.0f - t) + b * tb);
+}
+
+ENMA_FN fquat Slerp(const fquat& a, const fquat& b, flt32 t)
+{
+	flt32 d = Dot(a, b);
+	const flt32 sign = d < 0.0f ? -1.0f : 1.0f;
+	d = std::min(std::abs(d), 1.0f);
+
+	if(d > SLERP_THRESHOLD)
+		return Normalise(a * (1.0f - t) + b * (t * sign));
+
+	const flt32 theta = SlerpAcos(d);
+	const flt32 sinTheta = std::sqrt(1.0f - d * d);
+
+	// sin((1 - t) * theta) = sin(theta) * cos(t * theta) - cos(theta) * sin(t * theta)
+	flt32 s, c;
+	SinCos(t * theta, s, c);
+
+	const flt32 wb = s / sinTheta;
+	const flt32 wa = c - d * wb;
+
+	return a * wa + b * (wb * sign);
+}
+
+ENMA_HOT_FN fquat Squad(const fquat& q1, const fquat& q2, const fquat& s1, const fquat& s2, flt32 t)
+{
+	return Slerp(Slerp(q1, q2, t), Slerp(s1, s2, t), 2.0f * t * (1.0f - t));
+}
+
+// Logarithm of a unit quaternion, a pure quaternion (0, theta * axis)
+inline fquat QuatLog(const fquat& q)
+{
+	const flt32 w = std::min(std::max(q.w, -1.0f), 1.0f);
+	const flt32 theta = std::acos(w);
+	const flt32 sinTheta = std::sin(theta);
+	const flt32 k = sinTheta > 1e-6f ? theta / sinTheta : 1.0f;
+
+	return fquat(0.0f, q.x * k, q.y * k, q.z * k);
+}
+
+// Exponential of a pure quaternion, the inverse of QuatLog
+inline fquat QuatExp(const fquat& q)
+{
+	const flt32 theta = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z);
+
+	flt32 s, c;
+	SinCos(theta, s, c);
+
+	const flt32 k = theta > 1e-6f ? s / theta : 1.0f;
+
+	return fquat(c, q.x * k, q.y * k, q.z * k);
+}
+
+ENMA_HOT_FN fquat SquadControlPoint(const fquat& prev, const fquat& q, const fquat& next)
+{
+	const fquat inv = Conjugate(q);
+	const fquat sum = QuatLog(inv * next) + QuatLog(inv * prev);
+
+	return q * QuatExp(sum * -0.25f);
+}
 #endif
\ No newline at end of file
@@ -0,0 +1,2017 @@
+/* SIMD Abstraction Layer
+ *
+ * This header file is part of Enmatica library
+ *
+ * Copyright (c) 202X Villainous Softworks
+ *
+ */
+
+#pragma once
+#include "../base.hpp"
+#include "../empch.hpp"
+#include "cpu.hpp"
+#include <cstring>
+
+/**
+ * Register wrappers the vector, matrix and quaternion types are implemented on.
+ *
+ *   float4 / int4   -  Four flt32 / int32 lanes in an __m128 / __m128i
+ *   float8 / int8   -  Eight lanes in an __m256 / __m256i when the translation unit is compiled with AVX
+ *                      (AVX2 for int8), otherwise a pair of float4 / int4
+ *
+ * Without USE_SIMD the wrappers hold plain arrays and every operation is a per-lane loop, so the types
+ * built on top need no scalar code path of their own. Comparisons return masks with every bit set in
+ * the true lanes, the same as the hardware compares.
+ *
+ * Everything here is inline and follows the instruction set of the including translation unit; the
+ * runtime-dispatched AVX2 and AVX-512 kernels are compiled for another target and use intrinsics directly.
+ */
+
+#if defined(USE_SIMD) && defined(__AVX__)
+#define ENMA_SIMD_FLOAT8
+#endif
+
+#if defined(USE_SIMD) && defined(__AVX2__)
+#define ENMA_SIMD_INT8
+#endif
+
+namespace simd
+{
+
+#ifndef USE_SIMD
+inline uin32 Bits(const flt32 f)
+{
+	uin32 u;
+	std::memcpy(&u, &f, sizeof(u));
+
+	return u;
+}
+
+inline flt32 FromBits(const uin32 u)
+{
+	flt32 f;
+	std::memcpy(&f, &u, sizeof(f));
+
+	return f;
+}
+
+inline flt32 MaskLane(const bln8 b)
+{
+	return FromBits(b ? 0xFFFFFFFFu : 0u);
+}
+#endif
+
+/**
+ * Hints the cache to fetch the line holding `p` ahead of use. Never faults, so `p` may point past the end of an array.
+ */
+inline void Prefetch(const void* p)
+{
+	#ifdef USE_SIMD
+	_mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+	#else
+	static_cast<void>(p);
+	#endif
+}
+
+/*------------------------------------------------------------------------------------------------*/
+/*											  float4											  */
+/*------------------------------------------------------------------------------------------------*/
+
+struct float4
+{
+	#ifdef USE_SIMD
+	__m128 v;
+
+	float4() = default;
+	float4(const __m128& v) : v(v) {}
+
+	operator __m128() const { return v; }
+	#else
+	flt32 v[4];
+	#endif
+
+	static float4 Zero();
+	static float4 Set1(flt32 val);
+	static float4 Set(flt32 x, flt32 y, flt32 z, flt32 w);
+
+	/**
+	 * Loads four lanes from 16-byte aligned memory.
+	 */
+	static float4 Load(const flt32* p);
+	/**
+	 * Loads four lanes from unaligned memory.
+	 */
+	static float4 LoadU(const flt32* p);
+	/**
+	 * Loads two lanes, z and w are zero. Reads exactly 8 bytes.
+	 */
+	static float4 LoadXY(const flt32* p);
+	/**
+	 * Loads three lanes, w is zero. Reads exactly 12 bytes.
+	 */
+	static float4 LoadXYZ(const flt32* p);
+
+	void Store(flt32* p) const;
+	void StoreU(flt32* p) const;
+	void StoreXY(flt32* p) const;
+	void StoreXYZ(flt32* p) const;
+
+	/**
+	 * Returns lane 0 without going through memory.
+	 */
+	flt32 X() const;
+	/**
+	 * Returns lane `I`.
+	 */
+	template <uin32 I>
+	flt32 Get() const;
+};
+
+inline float4 float4::Zero()
+{
+	#ifdef USE_SIMD
+	return _mm_setzero_ps();
+	#else
+	return { 0.0f, 0.0f, 0.0f, 0.0f };
+	#endif
+}
+
+inline float4 float4::Set1(const flt32 val)
+{
+	#ifdef USE_SIMD
+	return _mm_set1_ps(val);
+	#else
+	return { val, val, val, val };
+	#endif
+}
+
+inline float4 float4::Set(const flt32 x, const flt32 y, const flt32 z, const flt32 w)
+{
+	#ifdef USE_SIMD
+	return _mm_setr_ps(x, y, z, w);
+	#else
+	return { x, y, z, w };
+	#endif
+}
+
+inline float4 float4::Load(const flt32* p)
+{
+	#ifdef USE_SIMD
+	return _mm_load_ps(p);
+	#else
+	return { p[0], p[1], p[2], p[3] };
+	#endif
+}
+
+inline float4 float4::LoadU(const flt32* p)
+{
+	#ifdef USE_SIMD
+	return _mm_loadu_ps(p);
+	#else
+	return { p[0], p[1], p[2], p[3] };
+	#endif
+}
+
+inline float4 float4::LoadXY(const flt32* p)
+{
+	#ifdef USE_SIMD
+	return _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(p));
+	#else
+	return { p[0], p[1], 0.0f, 0.0f };
+	#endif
+}
+
+inline float4 float4::LoadXYZ(const flt32* p)
+{
+	#ifdef USE_SIMD
+	return _mm_movelh_ps(_mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(p)), _mm_load_ss(p + 2));
+	#else
+	return { p[0], p[1], p[2], 0.0f };
+	#endif
+}
+
+inline void float4::Store(flt32* p) const
+{
+	#ifdef USE_SIMD
+	_mm_store_ps(p, v);
+	#else
+	p[0] = v[0]; p[1] = v[1]; p[2] = v[2]; p[3] = v[3];
+	#endif
+}
+
+inline void float4::StoreU(flt32* p) const
+{
+	#ifdef USE_SIMD
+	_mm_storeu_ps(p, v);
+	#else
+	p[0] = v[0]; p[1] = v[1]; p[2] = v[2]; p[3] = v[3];
+	#endif
+}
+
+inline void float4::StoreXY(flt32* p) const
+{
+	#ifdef USE_SIMD
+	_mm_storel_pi(reinterpret_cast<__m64*>(p), v);
+	#else
+	p[0] = v[0]; p[1] = v[1];
+	#endif
+}
+
+inline void float4::StoreXYZ(flt32* p) const
+{
+	#ifdef USE_SIMD
+	_mm_storel_pi(reinterpret_cast<__m64*>(p), v);
+	_mm_store_ss(p + 2, _mm_movehl_ps(v, v));
+	#else
+	p[0] = v[0]; p[1] = v[1]; p[2] = v[2];
+	#endif
+}
+
+inline flt32 float4::X() const
+{
+	#ifdef USE_SIMD
+	return _mm_cvtss_f32(v);
+	#else
+	return v[0];
+	#endif
+}
+
+template <uin32 I>
+inline flt32 float4::Get() const
+{
+	static_assert(I < 4, "float4 has four lanes");
+
+	#ifdef USE_SIMD
+	return _mm_cvtss_f32(_mm_shuffle_ps(v, v, _MM_SHUFFLE(I, I, I, I)));
+	#else
+	return v[I];
+	#endif
+}
+
+inline float4 operator+(const float4& a, const float4& b)
+{
+	#ifdef USE_SIMD
+	return _mm_add_ps(a, b);
+	#else
+	return { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] };
+	#endif
+}
+
+inline float4 operator-(const float4& a, const float4& b)
+{
+	#ifdef USE_SIMD
+	return _mm_sub_ps(a, b);
+	#else
+	return { a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3] };
+	#endif
+}
+
+inline float4 operator*(const float4& a, const float4& b)
+{
+	#ifdef USE_SIMD
+	return _mm_mul_ps(a, b);
+	#else
+	return { a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] };
+	#endif
+}
+
+inline float4 operator/(const float4& a, const float4& b)
+{
+	#ifdef USE_SIMD
+	return _mm_div_ps(a, b);
+	#else
+	return { a.v[0] / b.v[0], a.v[1] / b.v[1], a.v[2] / b.v[2], a.v[3] / b.v[3] };
+	#endif
+}
+
+inline float4 operator+(const float4& a, const flt32 b) { return a + float4::Set1(b); }
+inline float4 operator-(const float4& a, const flt32 b) { return a - float4::Set1(b); }
+inline float4 operator*(const float4& a, const flt32 b) { return a * float4::Set1(b); }
+inline float4 operator/(const float4& a, const flt32 b) { return a / float4::Set1(b); }
+
+inline float4& operator+=(float4& a, const float4& b) { return a = a + b; }
+inline float4& operator-=(float4& a, const float4& b) { return a = a - b; }
+inline float4& operator*=(float4& a, const float4& b) { return a = a * b; }
+inline float4& operator/=(float4& a, const float4& b) { return a = a / b; }
+
+inline float4 And(const float4& a, const float4& b)
+{
+	#ifdef USE_SIMD
+	return _mm_and_ps(a, b);
+	#else
+	return { FromBits(Bits(a.v[0]) & Bits(b.v[0])), FromBits(Bits(a.v[1]) & Bits(b.v[1])), FromBits(Bits(a.v[2]) & Bits(b.v[2])), FromBits(Bits(a.v[3]) & Bits(b.v[3])) };
+	#endif
+}
+
+inline float4 Or(const float4& a, const float4& b)
+{
+	#ifdef USE_SIMD
+	return _mm_or_ps(a, b);
+	#else
+	return { FromBits(Bits(a.v[0]) | Bits(b.v[0])), FromBits(Bits(a.v[1]) | Bits(b.v[1])), FromBits(Bits(a.v[2]) | Bits(b.v[2])), FromBits(Bits(a.v[3]) | Bits(b.v[3])) };
+	#endif
+}
+
+inline float4 Xor(const float4& a, const float4& b)
+{
+	#ifdef USE_SIMD
+	return _mm_xor_ps(a, b);
+	#else
+	return { FromBits(Bits(a.v[0]) ^ Bits(b.v[0])), FromBits(Bits(a.v[1]) ^ Bits(b.v[1])), FromBits(Bits(a.v[2]) ^ Bits(b.v[2])), FromBits(Bits(a.v[3]) ^ Bits(b.v[3])) };
+	#endif
+}
+
+/**
+ * ~a & b
+ */
+inline float4 AndNot(const float4& a, const float4& b)
+{
+	#ifdef USE_SIMD
+	return _mm_andnot_ps(a, b);
+	#else
+	return { FromBits(~Bits(a.v[0]) & Bits(b.v[0])), FromBits(~Bits(a.v[1]) & Bits(b.v[1])), FromBits(~Bits(a.v[2]) & Bits(b.v[2])), FromBits(~Bits(a.v[3]) & Bits(b.v[3])) };
+	#endif
+}
+
+inline float4 operator-(const float4& a)
+{
+	return Xor(a, float4::Set1(-0.0f));
+}
+
+inline float4 Abs(const float4& a)
+{
+	return AndNot(float4::Set1(-0.0f), a);
+}
+
+// Like minps/maxps, `b` is returned when either lane is NaN, the scalar fallback follows the same rule
+inline float4 Min(const float4& a, const float4& b)
+{
+	#ifdef USE_SIMD
+	return _mm_min_ps(a, b);
+	#else
+	return { a.v[0] < b.v[0] ? a.v[0] : b.v[0], a.v[1] < b.v[1] ? a.v[1] : b.v[1], a.v[2] < b.v[2] ? a.v[2] : b.v[2], a.v[3] < b.v[3] ? a.v[3] : b.v[3] };
+	#endif
+}
+
+inline float4 Max(const float4& a, const float4& b)
+{
+	#ifdef USE_SIMD
+	return _mm_max_ps(a, b);
+	#else
+	return { a.v[0] > b.v[0] ? a.v[0] : b.v[0], a.v[1] > b.v[1] ? a.v[1] : b.v[1], a.v[2] > b.v[2] ? a.v[2] : b.v[2], a.v[3] > b.v[3] ? a.v[3] : b.v[3] };
+	#endif
+}
+
+inline float4 Sqrt(const float4& a)
+{
+	#ifdef USE_SIMD
+	return _mm_sqrt_ps(a);
+	#else
+	return { std::sqrt(a.v[0]), std::sqrt(a.v[1]), std::sqrt(a.v[2]), std::sqrt(a.v[3]) };
+	#endif
+}
+
+/**
+ * Reciprocal estimate, 12 bits of precision.
+ */
+inline float4 RcpEst(const float4& a)
+{
+	#ifdef USE_SIMD
+	return _mm_rcp_ps(a);
+	#else
+	return { 1.0f / a.v[0], 1.0f / a.v[1], 1.0f / a.v[2], 1.0f / a.v[3] };
+	#endif
+}
+
+/**
+ * Reciprocal square root estimate, 12 bits of precision.
+ */
+inline float4 RsqrtEst(const float4& a)
+{
+	#ifdef USE_SIMD
+	return _mm_rsqrt_ps(a);
+	#else
+	return { 1.0f / std::sqrt(a.v[0]), 1.0f / std::sqrt(a.v[1]), 1.0f / std::sqrt(a.v[2]), 1.0f / std::sqrt(a.v[3]) };
+	#endif
+}
+
+/**
+ * a * b + c, fused when the translation unit is compiled with FMA.
+ */
+inline float4 Fmadd(const float4& a, const float4& b, const float4& c)
+{
+	#if defined(USE_SIMD) && defined(__FMA__)
+	return _mm_fmadd_ps(a, b, c);
+	#else
+	return a * b + c;
+	#endif
+}
+
+/**
+ * a * b - c
+ */
+inline float4 Fmsub(const float4& a, const float4& b, const float4& c)
+{
+	#if defined(USE_SIMD) && defined(__FMA__)
+	return _mm_fmsub_ps(a, b, c);
+	#else
+	return a * b - c;
+	#endif
+}
+
+/**
+ * c - a * b
+ */
+inline float4 Fnmadd(const float4& a, const float4& b, const float4& c)
+{
+	#if defined(USE_SIMD) && defined(__FMA__)
+	return _mm_fnmadd_ps(a, b, c);
+	#else
+	return c - a * b;
+	#endif
+}
+
+/**
+ * Reciprocal square root: the estimate refined by one Newton-Raphson step, about 22 bits of precision.
+ */
+inline float4 Rsqrt(const float4& a)
+{
+	#ifdef USE_SIMD
+	const float4 y = RsqrtEst(a);
+	const float4 ha = a * 0.5f;
+
+	return y * Fnmadd(ha * y, y, float4::Set1(1.5f));
+	#else
+	return RsqrtEst(a);
+	#endif
+}
+
+/**
+ * Rounds to the nearest integer, ties to even.
+ */
+inline float4 Round(const float4& a)
+{
+	#ifdef USE_SIMD
+	return _mm_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+	#else
+	return { std::nearbyint(a.v[0]), std::nearbyint(a.v[1]), std::nearbyint(a.v[2]), std::nearbyint(a.v[3]) };
+	#endif
+}
+
+inline float4 Floor(const float4& a)
+{
+	#ifdef USE_SIMD
+	return _mm_floor_ps(a);
+	#else
+	return { std::floor(a.v[0]), std::floor(a.v[1]), std::floor(a.v[2]), std::floor(a.v[3]) };
+	#endif
+}
+
+inline float4 Ceil(const float4& a)
+{
+	#ifdef USE_SIMD
+	return _mm_ceil_ps(a);
+	#else
+	return { std::ceil(a.v[0]), std::ceil(a.v[1]), std::ceil(a.v[2]), std::ceil(a.v[3]) };
+	#endif
+}
+
+/**
+ * Lane permutation: (a[X], a[Y], a[Z], a[W]).
+ */
+template <uin32 X, uin32 Y, uin32 Z, uin32 W>
+inline float4 Shuffle(const float4& a)
+{
+	#ifdef USE_SIMD
+	return _mm_shuffle_ps(a, a, _MM_SHUFFLE(W, Z, Y, X));
+	#else
+	return { a.v[X], a.v[Y], a.v[Z], a.v[W] };
+	#endif
+}
+
+/**
+ * Two-source lane permutation: (a[X], a[Y], b[Z], b[W]).
+ */
+template <uin32 X, uin32 Y, uin32 Z, uin32 W>
+inline float4 Shuffle(const float4& a, const float4& b)
+{
+	#ifdef USE_SIMD
+	return _mm_shuffle_ps(a, b, _MM_SHUFFLE(W, Z, Y, X));
+	#else
+	return { a.v[X], a.v[Y], b.v[Z], b.v[W] };
+	#endif
+}
+
+/**
+ * (a[0], a[1], b[0], b[1])
+ */
+inline float4 MoveLH(const float4& a, const float4& b)
+{
+	#ifdef USE_SIMD
+	return _mm_movelh_ps(a, b);
+	#else
+	return { a.v[0], a.v[1], b.v[0], b.v[1] };
+	#endif
+}
+
+/**
+ * (b[2], b[3], a[2], a[3])
+ */
+inline float4 MoveHL(const float4& a, const float4& b)
+{
+	#ifdef USE_SIMD
+	return _mm_movehl_ps(a, b);
+	#else
+	return { b.v[2], b.v[3], a.v[2], a.v[3] };
+	#endif
+}
+
+/**
+ * Compile-time blend: lane i comes from `b` where the i-th template argument is 1, otherwise from `a`.
+ */
+template <uin32 X, uin32 Y, uin32 Z, uin32 W>
+inline float4 Blend(const float4& a, const float4& b)
+{
+	#ifdef USE_SIMD
+	return _mm_blend_ps(a, b, X | (Y << 1) | (Z << 2) | (W << 3));
+	#else
+	return { X ? b.v[0] : a.v[0], Y ? b.v[1] : a.v[1], Z ? b.v[2] : a.v[2], W ? b.v[3] : a.v[3] };
+	#endif
+}
+
+/**
+ * Per-lane select: `t` where `mask` is set, otherwise `f`.
+ */
+inline float4 Select(const float4& mask, const float4& t, const float4& f)
+{
+	#ifdef USE_SIMD
+	return _mm_blendv_ps(f, t, mask);
+	#else
+	return Or(And(mask, t), AndNot(mask, f));
+	#endif
+}
+
+/**
+ * Pairwise horizontal add: (a[0] + a[1], a[2] + a[3], b[0] + b[1], b[2] + b[3]).
+ */
+inline float4 HAdd(const float4& a, const float4& b)
+{
+	#ifdef USE_SIMD
+	return _mm_hadd_ps(a, b);
+	#else
+	return { a.v[0] + a.v[1], a.v[2] + a.v[3], b.v[0] + b.v[1], b.v[2] + b.v[3] };
+	#endif
+}
+
+/**
+ * Sum of all four lanes, broadcast to every lane.
+ */
+inline float4 HSum(const float4& a)
+{
+	const float4 s = a + Shuffle<1, 0, 3, 2>(a);
+
+	return s + Shuffle<2, 3, 0, 1>(s);
+}
+
+/**
+ * Sum of all four lanes.
+ */
+inline flt32 ReduceAdd(const float4& a)
+{
+	return HSum(a).X();
+}
+
+/**
+ * Smallest of all four lanes.
+ */
+inline flt32 ReduceMin(const float4& a)
+{
+	const float4 m = Min(a, Shuffle<1, 0, 3, 2>(a));
+
+	return Min(m, Shuffle<2, 3, 0, 1>(m)).X();
+}
+
+/**
+ * Largest of all four lanes.
+ */
+inline flt32 ReduceMax(const float4& a)
+{
+	const float4 m = Max(a, Shuffle<1, 0, 3, 2>(a));
+
+	return Max(m, Shuffle<2, 3, 0, 1>(m)).X();
+}
+
+/**
+ * Dot products over the first 2, 3 or 4 lanes, broadcast to every lane.
+ */
+inline float4 Dot2(const float4& a, const float4& b)
+{
+	#ifdef USE_SIMD
+	return _mm_dp_ps(a, b, 0x3F);
+	#else
+	return float4::Set1(a.v[0] * b.v[0] + a.v[1] * b.v[1]);
+	#endif
+}
+
+inline float4 Dot3(const float4& a, const float4& b)
+{
+	#ifdef USE_SIMD
+	return _mm_dp_ps(a, b, 0x7F);
+	#else
+	return float4::Set1(a.v[0] * b.v[0] + a.v[1] * b.v[1] + a.v[2] * b.v[2]);
+	#endif
+}
+
+inline float4 Dot4(const float4& a, const float4& b)
+{
+	#ifdef USE_SIMD
+	return _mm_dp_ps(a, b, 0xFF);
+	#else
+	return float4::Set1(a.v[0] * b.v[0] + a.v[1] * b.v[1] + a.v[2] * b.v[2] + a.v[3] * b.v[3]);
+	#endif
+}
+
+#ifdef USE_SIMD
+#define ENMA_SIMD_CMP4(name, intrinsic, op)																\
+inline float4 name(const float4& a, const float4& b)													\
+{																										\
+	return intrinsic(a, b);																				\
+}
+#else
+#define ENMA_SIMD_CMP4(name, intrinsic, op)																\
+inline float4 name(const float4& a, const float4& b)													\
+{																										\
+	return { MaskLane(a.v[0] op b.v[0]), MaskLane(a.v[1] op b.v[1]), MaskLane(a.v[2] op b.v[2]), MaskLane(a.v[3] op b.v[3]) };	\
+}
+#endif
+
+ENMA_SIMD_CMP4(CmpEq, _mm_cmpeq_ps, ==)
+ENMA_SIMD_CMP4(CmpNeq, _mm_cmpneq_ps, !=)
+ENMA_SIMD_CMP4(CmpLt, _mm_cmplt_ps, <)
+ENMA_SIMD_CMP4(CmpLe, _mm_cmple_ps, <=)
+ENMA_SIMD_CMP4(CmpGt, _mm_cmpgt_ps, >)
+ENMA_SIMD_CMP4(CmpGe, _mm_cmpge_ps, >=)
+
+#undef ENMA_SIMD_CMP4
+
+/**
+ * Sign bit of every lane packed into the low 4 bits.
+ */
+inline int32 MoveMask(const float4& a)
+{
+	#ifdef USE_SIMD
+	return _mm_movemask_ps(a);
+	#else
+	return static_cast<int32>((Bits(a.v[0]) >> 31) | ((Bits(a.v[1]) >> 31) << 1) | ((Bits(a.v[2]) >> 31) << 2) | ((Bits(a.v[3]) >> 31) << 3));
+	#endif
+}
+
+inline bln8 Any(const float4& mask)
+{
+	return MoveMask(mask) != 0;
+}
+
+inline bln8 All(const float4& mask)
+{
+	return MoveMask(mask) == 0xF;
+}
+
+inline void Transpose(float4& r0, float4& r1, float4& r2, float4& r3)
+{
+	const float4 a = Shuffle<0, 1, 0, 1>(r0, r1);		// r0.x r0.y r1.x r1.y
+	const float4 b = Shuffle<2, 3, 2, 3>(r0, r1);		// r0.z r0.w r1.z r1.w
+	const float4 c = Shuffle<0, 1, 0, 1>(r2, r3);		// r2.x r2.y r3.x r3.y
+	const float4 d = Shuffle<2, 3, 2, 3>(r2, r3);		// r2.z r2.w r3.z r3.w
+
+	r0 = Shuffle<0, 2, 0, 2>(a, c);
+	r1 = Shuffle<1, 3, 1, 3>(a, c);
+	r2 = Shuffle<0, 2, 0, 2>(b, d);
+	r3 = Shuffle<1, 3, 1, 3>(b, d);
+}
+
+/*------------------------------------------------------------------------------------------------*/
+/*											   int4												  */
+/*------------------------------------------------------------------------------------------------*/
+
+struct int4
+{
+	#ifdef USE_SIMD
+	__m128i v;
+
+	int4() = default;
+	int4(const __m128i& v) : v(v) {}
+
+	operator __m128i() const { return v; }
+	#else
+	int32 v[4];
+	#endif
+
+	static int4 Zero();
+	static int4 Set1(int32 val);
+	static int4 Set(int32 x, int32 y, int32 z, int32 w);
+
+	static int4 Load(const int32* p);
+	static int4 LoadU(const int32* p);
+	/**
+	 * Loads two lanes, z and w are zero. Reads exactly 8 bytes.
+	 */
+	static int4 LoadXY(const int32* p);
+	/**
+	 * Loads three lanes, w is zero. Reads exactly 12 bytes.
+	 */
+	static int4 LoadXYZ(const int32* p);
+
+	void Store(int32* p) const;
+	void StoreU(int32* p) const;
+	void StoreXY(int32* p) const;
+	void StoreXYZ(int32* p) const;
+
+	int32 X() const;
+	template <uin32 I>
+	int32 Get() const;
+};
+
+inline int4 int4::Zero()
+{
+	#ifdef USE_SIMD
+	return _mm_setzero_si128();
+	#else
+	return { 0, 0, 0, 0 };
+	#endif
+}
+
+inline int4 int4::Set1(const int32 val)
+{
+	#ifdef USE_SIMD
+	return _mm_set1_epi32(val);
+	#else
+	return { val, val, val, val };
+	#endif
+}
+
+inline int4 int4::Set(const int32 x, const int32 y, const int32 z, const int32 w)
+{
+	#ifdef USE_SIMD
+	return _mm_setr_epi32(x, y, z, w);
+	#else
+	return { x, y, z, w };
+	#endif
+}
+
+inline int4 int4::Load(const int32* p)
+{
+	#ifdef USE_SIMD
+	return _mm_load_si128(reinterpret_cast<const __m128i*>(p));
+	#else
+	return { p[0], p[1], p[2], p[3] };
+	#endif
+}
+
+inline int4 int4::LoadU(const int32* p)
+{
+	#ifdef USE_SIMD
+	return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+	#else
+	return { p[0], p[1], p[2], p[3] };
+	#endif
+}
+
+inline int4 int4::LoadXY(const int32* p)
+{
+	#ifdef USE_SIMD
+	return _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+	#else
+	return { p[0], p[1], 0, 0 };
+	#endif
+}
+
+inline int4 int4::LoadXYZ(const int32* p)
+{
+	#ifdef USE_SIMD
+	return _mm_insert_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)), p[2], 2);
+	#else
+	return { p[0], p[1], p[2], 0 };
+	#endif
+}
+
+inline void int4::Store(int32* p) const
+{
+	#ifdef USE_SIMD
+	_mm_store_si128(reinterpret_cast<__m128i*>(p), v);
+	#else
+	p[0] = v[0]; p[1] = v[1]; p[2] = v[2]; p[3] = v[3];
+	#endif
+}
+
+inline void int4::StoreU(int32* p) const
+{
+	#ifdef USE_SIMD
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+	#else
+	p[0] = v[0]; p[1] = v[1]; p[2] = v[2]; p[3] = v[3];
+	#endif
+}
+
+inline void int4::StoreXY(int32* p) const
+{
+	#ifdef USE_SIMD
+	_mm_storel_epi64(reinterpret_cast<__m128i*>(p), v);
+	#else
+	p[0] = v[0]; p[1] = v[1];
+	#endif
+}
+
+inline void int4::StoreXYZ(int32* p) const
+{
+	#ifdef USE_SIMD
+	_mm_storel_epi64(reinterpret_cast<__m128i*>(p), v);
+	p[2] = _mm_extract_epi32(v, 2);
+	#else
+	p[0] = v[0]; p[1] = v[1]; p[2] = v[2];
+	#endif
+}
+
+inline int32 int4::X() const
+{
+	#ifdef USE_SIMD
+	return _mm_cvtsi128_si32(v);
+	#else
+	return v[0];
+	#endif
+}
+
+template <uin32 I>
+inline int32 int4::Get() const
+{
+	static_assert(I < 4, "int4 has four lanes");
+
+	#ifdef USE_SIMD
+	return _mm_extract_epi32(v, I);
+	#else
+	return v[I];
+	#endif
+}
+
+// Lane arithmetic wraps around like the hardware instructions; the scalar path goes through uin32 to match
+inline int4 operator+(const int4& a, const int4& b)
+{
+	#ifdef USE_SIMD
+	return _mm_add_epi32(a, b);
+	#else
+	return
+	{
+		static_cast<int32>(static_cast<uin32>(a.v[0]) + static_cast<uin32>(b.v[0])), static_cast<int32>(static_cast<uin32>(a.v[1]) + static_cast<uin32>(b.v[1])),
+		static_cast<int32>(static_cast<uin32>(a.v[2]) + static_cast<uin32>(b.v[2])), static_cast<int32>(static_cast<uin32>(a.v[3]) + static_cast<uin32>(b.v[3]))
+	};
+	#endif
+}
+
+inline int4 operator-(const int4& a, const int4& b)
+{
+	#ifdef USE_SIMD
+	return _mm_sub_epi32(a, b);
+	#else
+	return
+	{
+		static_cast<int32>(static_cast<uin32>(a.v[0]) - static_cast<uin32>(b.v[0])), static_cast<int32>(static_cast<uin32>(a.v[1]) - static_cast<uin32>(b.v[1])),
+		static_cast<int32>(static_cast<uin32>(a.v[2]) - static_cast<uin32>(b.v[2])), static_cast<int32>(static_cast<uin32>(a.v[3]) - static_cast<uin32>(b.v[3]))
+	};
+	#endif
+}
+
+/**
+ * Low 32 bits of the lane products.
+ */
+inline int4 operator*(const int4& a, const int4& b)
+{
+	#ifdef USE_SIMD
+	return _mm_mullo_epi32(a, b);
+	#else
+	return
+	{
+		static_cast<int32>(static_cast<uin32>(a.v[0]) * static_cast<uin32>(b.v[0])), static_cast<int32>(static_cast<uin32>(a.v[1]) * static_cast<uin32>(b.v[1])),
+		static_cast<int32>(static_cast<uin32>(a.v[2]) * static_cast<uin32>(b.v[2])), static_cast<int32>(static_cast<uin32>(a.v[3]) * static_cast<uin32>(b.v[3]))
+	};
+	#endif
+}
+
+inline int4& operator+=(int4& a, const int4& b) { return a = a + b; }
+inline int4& operator-=(int4& a, const int4& b) { return a = a - b; }
+inline int4& operator*=(int4& a, const int4& b) { return a = a * b; }
+
+inline int4 And(const int4& a, const int4& b)
+{
+	#ifdef USE_SIMD
+	return _mm_and_si128(a, b);
+	#else
+	return { a.v[0] & b.v[0], a.v[1] & b.v[1], a.v[2] & b.v[2], a.v[3] & b.v[3] };
+	#endif
+}
+
+inline int4 Or(const int4& a, const int4& b)
+{
+	#ifdef USE_SIMD
+	return _mm_or_si128(a, b);
+	#else
+	return { a.v[0] | b.v[0], a.v[1] | b.v[1], a.v[2] | b.v[2], a.v[3] | b.v[3] };
+	#endif
+}
+
+inline int4 Xor(const int4& a, const int4& b)
+{
+	#ifdef USE_SIMD
+	return _mm_xor_si128(a, b);
+	#else
+	return { a.v[0] ^ b.v[0], a.v[1] ^ b.v[1], a.v[2] ^ b.v[2], a.v[3] ^ b.v[3] };
+	#endif
+}
+
+/**
+ * ~a & b
+ */
+inline int4 AndNot(const int4& a, const int4& b)
+{
+	#ifdef USE_SIMD
+	return _mm_andnot_si128(a, b);
+	#else
+	return { ~a.v[0] & b.v[0], ~a.v[1] & b.v[1], ~a.v[2] & b.v[2], ~a.v[3] & b.v[3] };
+	#endif
+}
+
+template <int32 N>
+inline int4 ShiftLeft(const int4& a)
+{
+	#ifdef USE_SIMD
+	return _mm_slli_epi32(a, N);
+	#else
+	return { static_cast<int32>(static_cast<uin32>(a.v[0]) << N), static_cast<int32>(static_cast<uin32>(a.v[1]) << N), static_cast<int32>(static_cast<uin32>(a.v[2]) << N), static_cast<int32>(static_cast<uin32>(a.v[3]) << N) };
+	#endif
+}
+
+/**
+ * Arithmetic shift, the sign bit is replicated.
+ */
+template <int32 N>
+inline int4 ShiftRight(const int4& a)
+{
+	#ifdef USE_SIMD
+	return _mm_srai_epi32(a, N);
+	#else
+	return { a.v[0] >> N, a.v[1] >> N, a.v[2] >> N, a.v[3] >> N };
+	#endif
+}
+
+/**
+ * Logical shift, zeros are shifted in.
+ */
+template <int32 N>
+inline int4 ShiftRightLogical(const int4& a)
+{
+	#ifdef USE_SIMD
+	return _mm_srli_epi32(a, N);
+	#else
+	return { static_cast<int32>(static_cast<uin32>(a.v[0]) >> N), static_cast<int32>(static_cast<uin32>(a.v[1]) >> N), static_cast<int32>(static_cast<uin32>(a.v[2]) >> N), static_cast<int32>(static_cast<uin32>(a.v[3]) >> N) };
+	#endif
+}
+
+inline int4 Min(const int4& a, const int4& b)
+{
+	#ifdef USE_SIMD
+	return _mm_min_epi32(a, b);
+	#else
+	return { std::min(a.v[0], b.v[0]), std::min(a.v[1], b.v[1]), std::min(a.v[2], b.v[2]), std::min(a.v[3], b.v[3]) };
+	#endif
+}
+
+inline int4 Max(const int4& a, const int4& b)
+{
+	#ifdef USE_SIMD
+	return _mm_max_epi32(a, b);
+	#else
+	return { std::max(a.v[0], b.v[0]), std::max(a.v[1], b.v[1]), std::max(a.v[2], b.v[2]), std::max(a.v[3], b.v[3]) };
+	#endif
+}
+
+/**
+ * Unsigned lane minimum, every lane is read as uin32.
+ */
+inline int4 MinU(const int4& a, const int4& b)
+{
+	#ifdef USE_SIMD
+	return _mm_min_epu32(a, b);
+	#else
+	return
+	{
+		static_cast<int32>(std::min(static_cast<uin32>(a.v[0]), static_cast<uin32>(b.v[0]))), static_cast<int32>(std::min(static_cast<uin32>(a.v[1]), static_cast<uin32>(b.v[1]))),
+		static_cast<int32>(std::min(static_cast<uin32>(a.v[2]), static_cast<uin32>(b.v[2]))), static_cast<int32>(std::min(static_cast<uin32>(a.v[3]), static_cast<uin32>(b.v[3])))
+	};
+	#endif
+}
+
+/**
+ * Unsigned lane maximum, every lane is read as uin32.
+ */
+inline int4 MaxU(const int4& a, const int4& b)
+{
+	#ifdef USE_SIMD
+	return _mm_max_epu32(a, b);
+	#else
+	return
+	{
+		static_cast<int32>(std::max(static_cast<uin32>(a.v[0]), static_cast<uin32>(b.v[0]))), static_cast<int32>(std::max(static_cast<uin32>(a.v[1]), static_cast<uin32>(b.v[1]))),
+		static_cast<int32>(std::max(static_cast<uin32>(a.v[2]), static_cast<uin32>(b.v[2]))), static_cast<int32>(std::max(static_cast<uin32>(a.v[3]), static_cast<uin32>(b.v[3])))
+	};
+	#endif
+}
+
+/**
+ * Lane absolute value. INT32_MIN stays INT32_MIN, like the hardware instruction.
+ */
+inline int4 Abs(const int4& a)
+{
+	#ifdef USE_SIMD
+	return _mm_abs_epi32(a);
+	#else
+	const int4 sign = ShiftRight<31>(a);
+	return Xor(a, sign) - sign;
+	#endif
+}
+
+/**
+ * Shifts every lane left by a runtime count in [0, 31].
+ */
+inline int4 ShiftLeft(const int4& a, const int32 n)
+{
+	#ifdef USE_SIMD
+	return _mm_sll_epi32(a, _mm_cvtsi32_si128(n));
+	#else
+	return { static_cast<int32>(static_cast<uin32>(a.v[0]) << n), static_cast<int32>(static_cast<uin32>(a.v[1]) << n), static_cast<int32>(static_cast<uin32>(a.v[2]) << n), static_cast<int32>(static_cast<uin32>(a.v[3]) << n) };
+	#endif
+}
+
+/**
+ * Arithmetic shift by a runtime count in [0, 31].
+ */
+inline int4 ShiftRight(const int4& a, const int32 n)
+{
+	#ifdef USE_SIMD
+	return _mm_sra_epi32(a, _mm_cvtsi32_si128(n));
+	#else
+	return { a.v[0] >> n, a.v[1] >> n, a.v[2] >> n, a.v[3] >> n };
+	#endif
+}
+
+/**
+ * Logical shift by a runtime count in [0, 31].
+ */
+inline int4 ShiftRightLogical(const int4& a, const int32 n)
+{
+	#ifdef USE_SIMD
+	return _mm_srl_epi32(a, _mm_cvtsi32_si128(n));
+	#else
+	return { static_cast<int32>(static_cast<uin32>(a.v[0]) >> n), static_cast<int32>(static_cast<uin32>(a.v[1]) >> n), static_cast<int32>(static_cast<uin32>(a.v[2]) >> n), static_cast<int32>(static_cast<uin32>(a.v[3]) >> n) };
+	#endif
+}
+
+/**
+ * Upper 32 bits of the signed 64-bit product of every lane pair.
+ */
+inline int4 MulHi(const int4& a, const int4& b)
+{
+	#ifdef USE_SIMD
+	const __m128i even = _mm_srli_epi64(_mm_mul_epi32(a, b), 32);
+	const __m128i odd = _mm_mul_epi32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+	return _mm_blend_epi16(even, odd, 0xCC);
+	#else
+	return
+	{
+		static_cast<int32>((static_cast<int64>(a.v[0]) * b.v[0]) >> 32), static_cast<int32>((static_cast<int64>(a.v[1]) * b.v[1]) >> 32),
+		static_cast<int32>((static_cast<int64>(a.v[2]) * b.v[2]) >> 32), static_cast<int32>((static_cast<int64>(a.v[3]) * b.v[3]) >> 32)
+	};
+	#endif
+}
+
+/**
+ * Upper 32 bits of the unsigned 64-bit product of every lane pair, every lane is read as uin32.
+ */
+inline int4 MulHiU(const int4& a, const int4& b)
+{
+	#ifdef USE_SIMD
+	const __m128i even = _mm_srli_epi64(_mm_mul_epu32(a, b), 32);
+	const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+	return _mm_blend_epi16(even, odd, 0xCC);
+	#else
+	return
+	{
+		static_cast<int32>((static_cast<uin64>(static_cast<uin32>(a.v[0])) * static_cast<uin32>(b.v[0])) >> 32), static_cast<int32>((static_cast<uin64>(static_cast<uin32>(a.v[1])) * static_cast<uin32>(b.v[1])) >> 32),
+		static_cast<int32>((static_cast<uin64>(static_cast<uin32>(a.v[2])) * static_cast<uin32>(b.v[2])) >> 32), static_cast<int32>((static_cast<uin64>(static_cast<uin32>(a.v[3])) * static_cast<uin32>(b.v[3])) >> 32)
+	};
+	#endif
+}
+
+inline int4 CmpEq(const int4& a, const int4& b)
+{
+	#ifdef USE_SIMD
+	return _mm_cmpeq_epi32(a, b);
+	#else
+	return { -(a.v[0] == b.v[0]), -(a.v[1] == b.v[1]), -(a.v[2] == b.v[2]), -(a.v[3] == b.v[3]) };
+	#endif
+}
+
+inline int4 CmpGt(const int4& a, const int4& b)
+{
+	#ifdef USE_SIMD
+	return _mm_cmpgt_epi32(a, b);
+	#else
+	return { -(a.v[0] > b.v[0]), -(a.v[1] > b.v[1]), -(a.v[2] > b.v[2]), -(a.v[3] > b.v[3]) };
+	#endif
+}
+
+inline int4 CmpLt(const int4& a, const int4& b)
+{
+	return CmpGt(b, a);
+}
+
+/**
+ * Unsigned lane comparison, every lane is read as uin32. Biases both sides by the sign bit.
+ */
+inline int4 CmpGtU(const int4& a, const int4& b)
+{
+	const int4 bias = int4::Set1(static_cast<int32>(0x80000000u));
+
+	return CmpGt(Xor(a, bias), Xor(b, bias));
+}
+
+inline int4 CmpLtU(const int4& a, const int4& b)
+{
+	return CmpGtU(b, a);
+}
+
+/**
+ * Per-lane select: `t` where `mask` is set, otherwise `f`.
+ */
+inline int4 Select(const int4& mask, const int4& t, const int4& f)
+{
+	#ifdef USE_SIMD
+	return _mm_blendv_epi8(f, t, mask);
+	#else
+	return Or(And(mask, t), AndNot(mask, f));
+	#endif
+}
+
+/**
+ * Sign bit of every lane packed into the low 4 bits.
+ */
+inline int32 MoveMask(const int4& a)
+{
+	#ifdef USE_SIMD
+	return _mm_movemask_ps(_mm_castsi128_ps(a));
+	#else
+	return static_cast<int32>((static_cast<uin32>(a.v[0]) >> 31) | ((static_cast<uin32>(a.v[1]) >> 31) << 1) | ((static_cast<uin32>(a.v[2]) >> 31) << 2) | ((static_cast<uin32>(a.v[3]) >> 31) << 3));
+	#endif
+}
+
+inline bln8 Any(const int4& mask)
+{
+	return MoveMask(mask) != 0;
+}
+
+inline bln8 All(const int4& mask)
+{
+	return MoveMask(mask) == 0xF;
+}
+
+/**
+ * Reinterprets the bits of every lane.
+ */
+inline float4 AsFloat(const int4& a)
+{
+	#ifdef USE_SIMD
+	return _mm_castsi128_ps(a);
+	#else
+	return { FromBits(static_cast<uin32>(a.v[0])), FromBits(static_cast<uin32>(a.v[1])), FromBits(static_cast<uin32>(a.v[2])), FromBits(static_cast<uin32>(a.v[3])) };
+	#endif
+}
+
+inline int4 AsInt(const float4& a)
+{
+	#ifdef USE_SIMD
+	return _mm_castps_si128(a);
+	#else
+	return { static_cast<int32>(Bits(a.v[0])), static_cast<int32>(Bits(a.v[1])), static_cast<int32>(Bits(a.v[2])), static_cast<int32>(Bits(a.v[3])) };
+	#endif
+}
+
+/**
+ * Converts every lane to flt32.
+ */
+inline float4 ToFloat(const int4& a)
+{
+	#ifdef USE_SIMD
+	return _mm_cvtepi32_ps(a);
+	#else
+	return { static_cast<flt32>(a.v[0]), static_cast<flt32>(a.v[1]), static_cast<flt32>(a.v[2]), static_cast<flt32>(a.v[3]) };
+	#endif
+}
+
+/**
+ * Converts every lane to int32, rounding to the nearest integer.
+ */
+inline int4 ToInt(const float4& a)
+{
+	#ifdef USE_SIMD
+	return _mm_cvtps_epi32(a);
+	#else
+	return { static_cast<int32>(std::nearbyint(a.v[0])), static_cast<int32>(std::nearbyint(a.v[1])), static_cast<int32>(std::nearbyint(a.v[2])), static_cast<int32>(std::nearbyint(a.v[3])) };
+	#endif
+}
+
+/**
+ * Converts every lane to int32, rounding towards zero.
+ */
+inline int4 ToIntTrunc(const float4& a)
+{
+	#ifdef USE_SIMD
+	return _mm_cvttps_epi32(a);
+	#else
+	return { static_cast<int32>(a.v[0]), static_cast<int32>(a.v[1]), static_cast<int32>(a.v[2]), static_cast<int32>(a.v[3]) };
+	#endif
+}
+
+/*------------------------------------------------------------------------------------------------*/
+/*											  float8											  */
+/*------------------------------------------------------------------------------------------------*/
+
+struct float8
+{
+	#ifdef ENMA_SIMD_FLOAT8
+	__m256 v;
+
+	float8() = default;
+	float8(const __m256& v) : v(v) {}
+
+	operator __m256() const { return v; }
+	#else
+	float4 lo, hi;
+
+	float8() = default;
+	float8(const float4& lo, const float4& hi) : lo(lo), hi(hi) {}
+	#endif
+
+	static float8 Zero();
+	static float8 Set1(flt32 val);
+	/**
+	 * The same float4 in both halves.
+	 */
+	static float8 Broadcast(const float4& a);
+	static float8 Combine(const float4& lo, const float4& hi);
+
+	/**
+	 * Loads eight lanes from 32-byte aligned memory.
+	 */
+	static float8 Load(const flt32* p);
+	static float8 LoadU(const flt32* p);
+
+	void Store(flt32* p) const;
+	void StoreU(flt32* p) const;
+
+	float4 Low() const;
+	float4 High() const;
+};
+
+inline float8 float8::Zero()
+{
+	#ifdef ENMA_SIMD_FLOAT8
+	return _mm256_setzero_ps();
+	#else
+	return { float4::Zero(), float4::Zero() };
+	#endif
+}
+
+inline float8 float8::Set1(const flt32 val)
+{
+	#ifdef ENMA_SIMD_FLOAT8
+	return _mm256_set1_ps(val);
+	#else
+	return { float4::Set1(val), float4::Set1(val) };
+	#endif
+}
+
+inline float8 float8::Broadcast(const float4& a)
+{
+	#ifdef ENMA_SIMD_FLOAT8
+	return _mm256_insertf128_ps(_mm256_castps128_ps256(a), a, 1);
+	#else
+	return { a, a };
+	#endif
+}
+
+inline float8 float8::Combine(const float4& lo, const float4& hi)
+{
+	#ifdef ENMA_SIMD_FLOAT8
+	return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+	#else
+	return { lo, hi };
+	#endif
+}
+
+inline float8 float8::Load(const flt32* p)
+{
+	#ifdef ENMA_SIMD_FLOAT8
+	return _mm256_load_ps(p);
+	#else
+	return { float4::Load(p), float4::Load(p + 4) };
+	#endif
+}
+
+inline float8 float8::LoadU(const flt32* p)
+{
+	#ifdef ENMA_SIMD_FLOAT8
+	return _mm256_loadu_ps(p);
+	#else
+	return { float4::LoadU(p), float4::LoadU(p + 4) };
+	#endif
+}
+
+inline void float8::Store(flt32* p) const
+{
+	#ifdef ENMA_SIMD_FLOAT8
+	_mm256_store_ps(p, v);
+	#else
+	lo.Store(p);
+	hi.Store(p + 4);
+	#endif
+}
+
+inline void float8::StoreU(flt32* p) const
+{
+	#ifdef ENMA_SIMD_FLOAT8
+	_mm256_storeu_ps(p, v);
+	#else
+	lo.StoreU(p);
+	hi.StoreU(p + 4);
+	#endif
+}
+
+inline float4 float8::Low() const
+{
+	#ifdef ENMA_SIMD_FLOAT8
+	return _mm256_castps256_ps128(v);
+	#else
+	return lo;
+	#endif
+}
+
+inline float4 float8::High() const
+{
+	#ifdef ENMA_SIMD_FLOAT8
+	return _mm256_extractf128_ps(v, 1);
+	#else
+	return hi;
+	#endif
+}
+
+#ifdef ENMA_SIMD_FLOAT8
+#define ENMA_SIMD_BINARY8(name, intrinsic)																\
+inline float8 name(const float8& a, const float8& b)													\
+{																										\
+	return intrinsic(a, b);																				\
+}
+#else
+#define ENMA_SIMD_BINARY8(name, intrinsic)																\
+inline float8 name(const float8& a, const float8& b)													\
+{																										\
+	return { name(a.lo, b.lo), name(a.hi, b.hi) };														\
+}
+#endif
+
+ENMA_SIMD_BINARY8(operator+, _mm256_add_ps)
+ENMA_SIMD_BINARY8(operator-, _mm256_sub_ps)
+ENMA_SIMD_BINARY8(operator*, _mm256_mul_ps)
+ENMA_SIMD_BINARY8(operator/, _mm256_div_ps)
+ENMA_SIMD_BINARY8(And, _mm256_and_ps)
+ENMA_SIMD_BINARY8(Or, _mm256_or_ps)
+ENMA_SIMD_BINARY8(Xor, _mm256_xor_ps)
+ENMA_SIMD_BINARY8(AndNot, _mm256_andnot_ps)
+ENMA_SIMD_BINARY8(Min, _mm256_min_ps)
+ENMA_SIMD_BINARY8(Max, _mm256_max_ps)
+ENMA_SIMD_BINARY8(HAdd, _mm256_hadd_ps)
+
+#undef ENMA_SIMD_BINARY8
+
+inline float8 operator+(const float8& a, const flt32 b) { return a + float8::Set1(b); }
+inline float8 operator-(const float8& a, const flt32 b) { return a - float8::Set1(b); }
+inline float8 operator*(const float8& a, const flt32 b) { return a * float8::Set1(b); }
+inline float8 operator/(const float8& a, const flt32 b) { return a / float8::Set1(b); }
+
+inline float8& operator+=(float8& a, const float8& b) { return a = a + b; }
+inline float8& operator-=(float8& a, const float8& b) { return a = a - b; }
+inline float8& operator*=(float8& a, const float8& b) { return a = a * b; }
+inline float8& operator/=(float8& a, const float8& b) { return a = a / b; }
+
+inline float8 operator-(const float8& a)
+{
+	return Xor(a, float8::Set1(-0.0f));
+}
+
+inline float8 Abs(const float8& a)
+{
+	return AndNot(float8::Set1(-0.0f), a);
+}
+
+inline float8 Sqrt(const float8& a)
+{
+	#ifdef ENMA_SIMD_FLOAT8
+	return _mm256_sqrt_ps(a);
+	#else
+	return { Sqrt(a.lo), Sqrt(a.hi) };
+	#endif
+}
+
+inline float8 RcpEst(const float8& a)
+{
+	#ifdef ENMA_SIMD_FLOAT8
+	return _mm256_rcp_ps(a);
+	#else
+	return { RcpEst(a.lo), RcpEst(a.hi) };
+	#endif
+}
+
+inline float8 RsqrtEst(const float8& a)
+{
+	#ifdef ENMA_SIMD_FLOAT8
+	return _mm256_rsqrt_ps(a);
+	#else
+	return { RsqrtEst(a.lo), RsqrtEst(a.hi) };
+	#endif
+}
+
+inline float8 Fmadd(const float8& a, const float8& b, const float8& c)
+{
+	#if defined(ENMA_SIMD_FLOAT8) && defined(__FMA__)
+	return _mm256_fmadd_ps(a, b, c);
+	#elif defined(ENMA_SIMD_FLOAT8)
+	return a * b + c;
+	#else
+	return { Fmadd(a.lo, b.lo, c.lo), Fmadd(a.hi, b.hi, c.hi) };
+	#endif
+}
+
+inline float8 Fmsub(const float8& a, const float8& b, const float8& c)
+{
+	#if defined(ENMA_SIMD_FLOAT8) && defined(__FMA__)
+	return _mm256_fmsub_ps(a, b, c);
+	#elif defined(ENMA_SIMD_FLOAT8)
+	return a * b - c;
+	#else
+	return { Fmsub(a.lo, b.lo, c.lo), Fmsub(a.hi, b.hi, c.hi) };
+	#endif
+}
+
+inline float8 Fnmadd(const float8& a, const float8& b, const float8& c)
+{
+	#if defined(ENMA_SIMD_FLOAT8) && defined(__FMA__)
+	return _mm256_fnmadd_ps(a, b, c);
+	#elif defined(ENMA_SIMD_FLOAT8)
+	return c - a * b;
+	#else
+	return { Fnmadd(a.lo, b.lo, c.lo), Fnmadd(a.hi, b.hi, c.hi) };
+	#endif
+}
+
+inline float8 Rsqrt(const float8& a)
+{
+	#ifdef ENMA_SIMD_FLOAT8
+	const float8 y = RsqrtEst(a);
+	const float8 ha = a * 0.5f;
+
+	return y * Fnmadd(ha * y, y, float8::Set1(1.5f));
+	#else
+	return { Rsqrt(a.lo), Rsqrt(a.hi) };
+	#endif
+}
+
+inline float8 Round(const float8& a)
+{
+	#ifdef ENMA_SIMD_FLOAT8
+	return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+	#else
+	return { Round(a.lo), Round(a.hi) };
+	#endif
+}
+
+inline float8 Floor(const float8& a)
+{
+	#ifdef ENMA_SIMD_FLOAT8
+	return _mm256_floor_ps(a);
+	#else
+	return { Floor(a.lo), Floor(a.hi) };
+	#endif
+}
+
+inline float8 Ceil(const float8& a)
+{
+	#ifdef ENMA_SIMD_FLOAT8
+	return _mm256_ceil_ps(a);
+	#else
+	return { Ceil(a.lo), Ceil(a.hi) };
+	#endif
+}
+
+/**
+ * Lane permutation within each 128-bit half.
+ */
+template <uin32 X, uin32 Y, uin32 Z, uin32 W>
+inline float8 Shuffle(const float8& a)
+{
+	#ifdef ENMA_SIMD_FLOAT8
+	return _mm256_permute_ps(a, _MM_SHUFFLE(W, Z, Y, X));
+	#else
+	return { Shuffle<X, Y, Z, W>(a.lo), Shuffle<X, Y, Z, W>(a.hi) };
+	#endif
+}
+
+/**
+ * Two-source lane permutation within each 128-bit half: (a[X], a[Y], b[Z], b[W]).
+ */
+template <uin32 X, uin32 Y, uin32 Z, uin32 W>
+inline float8 Shuffle(const float8& a, const float8& b)
+{
+	#ifdef ENMA_SIMD_FLOAT8
+	return _mm256_shuffle_ps(a, b, _MM_SHUFFLE(W, Z, Y, X));
+	#else
+	return { Shuffle<X, Y, Z, W>(a.lo, b.lo), Shuffle<X, Y, Z, W>(a.hi, b.hi) };
+	#endif
+}
+
+inline float8 Select(const float8& mask, const float8& t, const float8& f)
+{
+	#ifdef ENMA_SIMD_FLOAT8
+	return _mm256_blendv_ps(f, t, mask);
+	#else
+	return { Select(mask.lo, t.lo, f.lo), Select(mask.hi, t.hi, f.hi) };
+	#endif
+}
+
+/**
+ * Smallest of all eight lanes.
+ */
+inline flt32 ReduceMin(const float8& a)
+{
+	return ReduceMin(Min(a.Low(), a.High()));
+}
+
+/**
+ * Largest of all eight lanes.
+ */
+inline flt32 ReduceMax(const float8& a)
+{
+	return ReduceMax(Max(a.Low(), a.High()));
+}
+
+#ifdef ENMA_SIMD_FLOAT8
+#define ENMA_SIMD_CMP8(name, predicate)																	\
+inline float8 name(const float8& a, const float8& b)													\
+{																										\
+	return _mm256_cmp_ps(a, b, predicate);																\
+}
+#else
+#define ENMA_SIMD_CMP8(name, predicate)																	\
+inline float8 name(const float8& a, const float8& b)													\
+{																										\
+	return { name(a.lo, b.lo), name(a.hi, b.hi) };														\
+}
+#endif
+
+ENMA_SIMD_CMP8(CmpEq, _CMP_EQ_OQ)
+ENMA_SIMD_CMP8(CmpNeq, _CMP_NEQ_UQ)
+ENMA_SIMD_CMP8(CmpLt, _CMP_LT_OQ)
+ENMA_SIMD_CMP8(CmpLe, _CMP_LE_OQ)
+ENMA_SIMD_CMP8(CmpGt, _CMP_GT_OQ)
+ENMA_SIMD_CMP8(CmpGe, _CMP_GE_OQ)
+
+#undef ENMA_SIMD_CMP8
+
+/**
+ * Sign bit of every lane packed into the low 8 bits.
+ */
+inline int32 MoveMask(const float8& a)
+{
+	#ifdef ENMA_SIMD_FLOAT8
+	return _mm256_movemask_ps(a);
+	#else
+	return MoveMask(a.lo) | (MoveMask(a.hi) << 4);
+	#endif
+}
+
+inline bln8 Any(const float8& mask)
+{
+	return MoveMask(mask) != 0;
+}
+
+inline bln8 All(const float8& mask)
+{
+	return MoveMask(mask) == 0xFF;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+/*											   int8												  */
+/*------------------------------------------------------------------------------------------------*/
+
+struct int8
+{
+	#ifdef ENMA_SIMD_INT8
+	__m256i v;
+
+	int8() = default;
+	int8(const __m256i& v) : v(v) {}
+
+	operator __m256i() const { return v; }
+	#else
+	int4 lo, hi;
+
+	int8() = default;
+	int8(const int4& lo, const int4& hi) : lo(lo), hi(hi) {}
+	#endif
+
+	static int8 Zero();
+	static int8 Set1(int32 val);
+	static int8 Combine(const int4& lo, const int4& hi);
+
+	static int8 Load(const int32* p);
+	static int8 LoadU(const int32* p);
+
+	void Store(int32* p) const;
+	void StoreU(int32* p) const;
+
+	int4 Low() const;
+	int4 High() const;
+};
+
+inline int8 int8::Zero()
+{
+	#ifdef ENMA_SIMD_INT8
+	return _mm256_setzero_si256();
+	#else
+	return { int4::Zero(), int4::Zero() };
+	#endif
+}
+
+inline int8 int8::Set1(const int32 val)
+{
+	#ifdef ENMA_SIMD_INT8
+	return _mm256_set1_epi32(val);
+	#else
+	return { int4::Set1(val), int4::Set1(val) };
+	#endif
+}
+
+inline int8 int8::Combine(const int4& lo, const int4& hi)
+{
+	#ifdef ENMA_SIMD_INT8
+	return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+	#else
+	return { lo, hi };
+	#endif
+}
+
+inline int8 int8::Load(const int32* p)
+{
+	#ifdef ENMA_SIMD_INT8
+	return _mm256_load_si256(reinterpret_cast<const __m256i*>(p));
+	#else
+	return { int4::Load(p), int4::Load(p + 4) };
+	#endif
+}
+
+inline int8 int8::LoadU(const int32* p)
+{
+	#ifdef ENMA_SIMD_INT8
+	return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+	#else
+	return { int4::LoadU(p), int4::LoadU(p + 4) };
+	#endif
+}
+
+inline void int8::Store(int32* p) const
+{
+	#ifdef ENMA_SIMD_INT8
+	_mm256_store_si256(reinterpret_cast<__m256i*>(p), v);
+	#else
+	lo.Store(p);
+	hi.Store(p + 4);
+	#endif
+}
+
+inline void int8::StoreU(int32* p) const
+{
+	#ifdef ENMA_SIMD_INT8
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+	#else
+	lo.StoreU(p);
+	hi.StoreU(p + 4);
+	#endif
+}
+
+inline int4 int8::Low() const
+{
+	#ifdef ENMA_SIMD_INT8
+	return _mm256_castsi256_si128(v);
+	#else
+	return lo;
+	#endif
+}
+
+inline int4 int8::High() const
+{
+	#ifdef ENMA_SIMD_INT8
+	return _mm256_extracti128_si256(v, 1);
+	#else
+	return hi;
+	#endif
+}
+
+#ifdef ENMA_SIMD_INT8
+#define ENMA_SIMD_BINARY8I(name, intrinsic)																\
+inline int8 name(const int8& a, const int8& b)															\
+{																										\
+	return intrinsic(a, b);																				\
+}
+#else
+#define ENMA_SIMD_BINARY8I(name, intrinsic)																\
+inline int8 name(const int8& a, const int8& b)															\
+{																										\
+	return { name(a.lo, b.lo), name(a.hi, b.hi) };														\
+}
+#endif
+
+ENMA_SIMD_BINARY8I(operator+, _mm256_add_epi32)
+ENMA_SIMD_BINARY8I(operator-, _mm256_sub_epi32)
+ENMA_SIMD_BINARY8I(operator*, _mm256_mullo_epi32)
+ENMA_SIMD_BINARY8I(And, _mm256_and_si256)
+ENMA_SIMD_BINARY8I(Or, _mm256_or_si256)
+ENMA_SIMD_BINARY8I(Xor, _mm256_xor_si256)
+ENMA_SIMD_BINARY8I(AndNot, _mm256_andnot_si256)
+ENMA_SIMD_BINARY8I(Min, _mm256_min_epi32)
+ENMA_SIMD_BINARY8I(Max, _mm256_max_epi32)
+ENMA_SIMD_BINARY8I(MinU, _mm256_min_epu32)
+ENMA_SIMD_BINARY8I(MaxU, _mm256_max_epu32)
+ENMA_SIMD_BINARY8I(CmpEq, _mm256_cmpeq_epi32)
+ENMA_SIMD_BINARY8I(CmpGt, _mm256_cmpgt_epi32)
+
+#undef ENMA_SIMD_BINARY8I
+
+inline int8& operator+=(int8& a, const int8& b) { return a = a + b; }
+inline int8& operator-=(int8& a, const int8& b) { return a = a - b; }
+inline int8& operator*=(int8& a, const int8& b) { return a = a * b; }
+
+inline int8 CmpLt(const int8& a, const int8& b)
+{
+	return CmpGt(b, a);
+}
+
+template <int32 N>
+inline int8 ShiftLeft(const int8& a)
+{
+	#ifdef ENMA_SIMD_INT8
+	return _mm256_slli_epi32(a, N);
+	#else
+	return { ShiftLeft<N>(a.lo), ShiftLeft<N>(a.hi) };
+	#endif
+}
+
+template <int32 N>
+inline int8 ShiftRight(const int8& a)
+{
+	#ifdef ENMA_SIMD_INT8
+	return _mm256_srai_epi32(a, N);
+	#else
+	return { ShiftRight<N>(a.lo), ShiftRight<N>(a.hi) };
+	#endif
+}
+
+template <int32 N>
+inline int8 ShiftRightLogical(const int8& a)
+{
+	#ifdef ENMA_SIMD_INT8
+	return _mm256_srli_epi32(a, N);
+	#else
+	return { ShiftRightLogical<N>(a.lo), ShiftRightLogical<N>(a.hi) };
+	#endif
+}
+
+inline int8 Abs(const int8& a)
+{
+	#ifdef ENMA_SIMD_INT8
+	return _mm256_abs_epi32(a);
+	#else
+	return { Abs(a.lo), Abs(a.hi) };
+	#endif
+}
+
+inline int8 ShiftLeft(const int8& a, const int32 n)
+{
+	#ifdef ENMA_SIMD_INT8
+	return _mm256_sll_epi32(a, _mm_cvtsi32_si128(n));
+	#else
+	return { ShiftLeft(a.lo, n), ShiftLeft(a.hi, n) };
+	#endif
+}
+
+inline int8 ShiftRight(const int8& a, const int32 n)
+{
+	#ifdef ENMA_SIMD_INT8
+	return _mm256_sra_epi32(a, _mm_cvtsi32_si128(n));
+	#else
+	return { ShiftRight(a.lo, n), ShiftRight(a.hi, n) };
+	#endif
+}
+
+inline int8 ShiftRightLogical(const int8& a, const int32 n)
+{
+	#ifdef ENMA_SIMD_INT8
+	return _mm256_srl_epi32(a, _mm_cvtsi32_si128(n));
+	#else
+	return { ShiftRightLogical(a.lo, n), ShiftRightLogical(a.hi, n) };
+	#endif
+}
+
+inline int8 MulHi(const int8& a, const int8& b)
+{
+	#ifdef ENMA_SIMD_INT8
+	const __m256i even = _mm256_srli_epi64(_mm256_mul_epi32(a, b), 32);
+	const __m256i odd = _mm256_mul_epi32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+	return _mm256_blend_epi32(even, odd, 0xAA);
+	#else
+	return { MulHi(a.lo, b.lo), MulHi(a.hi, b.hi) };
+	#endif
+}
+
+inline int8 MulHiU(const int8& a, const int8& b)
+{
+	#ifdef ENMA_SIMD_INT8
+	const __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(a, b), 32);
+	const __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+	return _mm256_blend_epi32(even, odd, 0xAA);
+	#else
+	return { MulHiU(a.lo, b.lo), MulHiU(a.hi, b.hi) };
+	#endif
+}
+
+inline int8 Select(const int8& mask, const int8& t, const int8& f)
+{
+	#ifdef ENMA_SIMD_INT8
+	return _mm256_blendv_epi8(f, t, mask);
+	#else
+	return { Select(mask.lo, t.lo, f.lo), Select(mask.hi, t.hi, f.hi) };
+	#endif
+}
+
+inline int32 MoveMask(const int8& a)
+{
+	#ifdef ENMA_SIMD_INT8
+	return _mm256_movemask_ps(_mm256_castsi256_ps(a));
+	#else
+	return MoveMask(a.lo) | (MoveMask(a.hi) << 4);
+	#endif
+}
+
+inline bln8 Any(const int8& mask)
+{
+	return MoveMask(mask) != 0;
+}
+
+inline bln8 All(const int8& mask)
+{
+	return MoveMask(mask) == 0xFF;
+}
+
+/**
+ * Number of set bits in `mask`.
+ */
+inline uin32 PopCount(uin32 mask)
+{
+	#if defined(USE_SIMD) && defined(__POPCNT__)
+	return static_cast<uin32>(_mm_popcnt_u32(mask));
+	#else
+	mask = mask - ((mask >> 1) & 0x55555555u);
+	mask = (mask & 0x33333333u) + ((mask >> 2) & 0x33333333u);
+
+	return (((mask + (mask >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24;
+	#endif
+}
+
+#if defined(ENMA_SIMD_INT8) && !defined(__AVX512VL__)
+/**
+ * Lane permutation packing the set lanes of an 8-bit mask to the front, one byte per lane index.
+ */
+inline const uin64* CompressTable()
+{
+	struct Table
+	{
+		uin64 entries[256];
+
+		constexpr Table() : entries()
+		{
+			for(uin32 mask = 0; mask < 256; mask++)
+			{
+				uin32 out = 0;
+
+				for(uin32 lane = 0; lane < 8; lane++)
+				{
+					if(mask & (1u << lane))
+					{
+						entries[mask] |= static_cast<uin64>(lane) << (out++ * 8);
+					}
+				}
+			}
+		}
+	};
+
+	static constexpr Table table;
+
+	return table.entries;
+}
+#endif
+
+/**
+ * Stream compaction: writes the lanes of `a` whose bit is set in `mask` to `p`, packed in lane order.
+ *
+ * All 8 slots of `p` may be overwritten, the slots past the returned count hold garbage.
+ *
+ * \param p Destination with room for 8 int32.
+ * \param a Lanes to select from.
+ * \param mask Bit i selects lane i.
+ * \return Number of lanes written, PopCount(mask & 0xFF).
+ */
+inline uin32 CompressStoreU(int32* p, const int8& a, uin32 mask)
+{
+	mask &= 0xFFu;
+
+	#if defined(ENMA_SIMD_INT8) && defined(__AVX512VL__)
+	_mm256_mask_compressstoreu_epi32(p, static_cast<__mmask8>(mask), a);
+	#elif defined(ENMA_SIMD_INT8)
+	const __m256i permutation = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(CompressTable() + mask)));
+
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(p), _mm256_permutevar8x32_epi32(a, permutation));
+	#else
+	int32 lanes[8];
+	a.StoreU(lanes);
+
+	for(uin32 lane = 0, out = 0; lane < 8; lane++)
+	{
+		p[out] = lanes[lane];
+		out += (mask >> lane) & 1u;
+	}
+	#endif
+
+	return PopCount(mask);
+}
+
+// Conversions between float8 and int8 go through the halves whenever only one of them is a single register
+inline float8 AsFloat(const int8& a)
+{
+	#ifdef ENMA_SIMD_INT8
+	return _mm256_castsi256_ps(a);
+	#else
+	return float8::Combine(AsFloat(a.lo), AsFloat(a.hi));
+	#endif
+}
+
+inline int8 AsInt(const float8& a)
+{
+	#ifdef ENMA_SIMD_INT8
+	return _mm256_castps_si256(a);
+	#else
+	return { AsInt(a.Low()), AsInt(a.High()) };
+	#endif
+}
+
+inline float8 ToFloat(const int8& a)
+{
+	#ifdef ENMA_SIMD_INT8
+	return _mm256_cvtepi32_ps(a);
+	#else
+	return float8::Combine(ToFloat(a.lo), ToFloat(a.hi));
+	#endif
+}
+
+inline int8 ToInt(const float8& a)
+{
+	#ifdef ENMA_SIMD_INT8
+	return _mm256_cvtps_epi32(a);
+	#else
+	return { ToInt(a.Low()), ToInt(a.High()) };
+	#endif
+}
+
+inline int8 ToIntTrunc(const float8& a)
+{
+	#ifdef ENMA_SIMD_INT8
+	return _mm256_cvttps_epi32(a);
+	#else
+	return { ToIntTrunc(a.Low()), ToIntTrunc(a.High()) };
+	#endif
+}
+
+} // namespace simd
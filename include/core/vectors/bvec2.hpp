@@ -21,10 +21,9 @@ struct bvec2
         bln8 arr[2];
     };
 
-	bvec2(const bvec2& vec);
-	bvec2(const bln8 val = false);
-    bvec2(const bln8 bx, const bln8 by);
-	bvec2(const bln8* arr);
+	constexpr bvec2(const bln8 val = false);
+    constexpr bvec2(const bln8 bx, const bln8 by);
+	constexpr bvec2(const bln8* arr);
 
     bln8 operator==(const bvec2& other);
     bln8 operator!=(const bvec2& other);
@@ -41,34 +40,24 @@ struct bvec2
 	#endif
 };
 
-#ifdef ENMA_IMPLEMENTATION
-bvec2::bvec2(const bvec2& v)
-{
-    this->x = v.x;
-    this->y = v.y;
-}
+constexpr bvec2::bvec2(const bln8 val) : x(val), y(val) {}
 
-bvec2::bvec2(const bln8 val) : x(val), y(val) {}
+constexpr bvec2::bvec2(const bln8 bx, const bln8 by) : x(bx), y(by) {}
 
-bvec2::bvec2(const bln8 bx, const bln8 by) : x(bx), y(by) {}
+constexpr bvec2::bvec2(const bln8* arr) : x(arr[0]), y(arr[1]) {}
 
-bvec2::bvec2(const bln8* arr)
-{
-	this->arr[0] = arr[0];
-	this->arr[1] = arr[1];
-}
-
-bln8 bvec2::operator==(const bvec2& other)
+#ifdef ENMA_IMPLEMENTATION
+ENMA_HOT_FN bln8 bvec2::operator==(const bvec2& other)
 {
     return this->x == other.x & this->y == other.y;
 }
 
-bln8 bvec2::operator!=(const bvec2& other)
+ENMA_HOT_FN bln8 bvec2::operator!=(const bvec2& other)
 {
     return this->x != other.x & this->y != other.y;
 }
 
-bvec2 bvec2::Equals(const bvec2& other)
+ENMA_HOT_FN bvec2 bvec2::Equals(const bvec2& other)
 {
     return bvec2(this->x == other.x, this->y == other.y);
 }
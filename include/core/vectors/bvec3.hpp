@@ -22,12 +22,11 @@ struct bvec3
 		bln8 arr[3];
     };
 	
-	bvec3(const bvec3& v);
-	bvec3(const bln8 val = 0.0f);
-	bvec3(const bln8 fx, const bln8 fy, const bln8 fz = 0.0f);
-	bvec3(const bln8* arr);
-	bvec3(const bln8 x, const bvec2& yz);
-	bvec3(const bvec2& xy, const bln8 z);
+	constexpr bvec3(const bln8 val = false);
+	constexpr bvec3(const bln8 fx, const bln8 fy, const bln8 fz = false);
+	constexpr bvec3(const bln8* arr);
+	constexpr bvec3(const bln8 x, const bvec2& yz);
+	constexpr bvec3(const bvec2& xy, const bln8 z);
 
     bln8 operator==(const bvec3& other);
     bln8 operator!=(const bvec3& other);
@@ -42,45 +41,23 @@ struct bvec3
 	#endif
 };
 
-#ifdef ENMA_IMPLEMENTATION
-bvec3::bvec3(const bvec3& v)
-{
-	this->x = v.x;
-	this->y = v.y;
-	this->z = v.z;
-}
+constexpr bvec3::bvec3(const bln8 val) : x(val), y(val), z(val) {}
 
-bvec3::bvec3(const bln8 val) : x(val), y(val), z(val) {}
+constexpr bvec3::bvec3(const bln8 fx, const bln8 fy, const bln8 fz) : x(fx), y(fy), z(fz) {}
 
-bvec3::bvec3(const bln8 fx, const bln8 fy, const bln8 fz) : x(fx), y(fy), z(fz) {}
+constexpr bvec3::bvec3(const bln8* arr) : x(arr[0]), y(arr[1]), z(arr[2]) {}
 
-bvec3::bvec3(const bln8* arr)
-{
-	this->arr[0] = arr[0];
-	this->arr[1] = arr[1];
-	this->arr[2] = arr[2];
-}
+constexpr bvec3::bvec3(const bln8 x, const bvec2& yz) : x(x), y(yz.x), z(yz.y) {}
 
-bvec3::bvec3(const bln8 x, const bvec2& yz)
-{
-	this->x = x;
-	this->y = yz.x;
-	this->z = yz.y;
-}
+constexpr bvec3::bvec3(const bvec2& xy, const bln8 z) : x(xy.x), y(xy.y), z(z) {}
 
-bvec3::bvec3(const bvec2& xy, const bln8 z)
-{
-	this->x = xy.x;
-	this->y = xy.y;
-	this->z = z;
-}
-
-bln8 bvec3::operator==(const bvec3& other)
+#ifdef ENMA_IMPLEMENTATION
+ENMA_HOT_FN bln8 bvec3::operator==(const bvec3& other)
 {
     return this->x == other.x & this->y == other.y & this->z == other.z;
 }
 
-bln8 bvec3::operator!=(const bvec3& other)
+ENMA_HOT_FN bln8 bvec3::operator!=(const bvec3& other)
 {
     return this->x != other.x & this->y != other.y & this->z != other.z;
 }
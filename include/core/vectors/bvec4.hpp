@@ -23,13 +23,12 @@ struct bvec4
         bln8 arr[4];
     };
 
-	bvec4(const bvec4& v);
-	bvec4(const bln8 val = false);
-    bvec4(const bln8 bx, const bln8 by, const bln8 bz = false, const bln8 bw = false);
-    bvec4(const bln8* arr);
-	bvec4(const bvec2& xy, const bvec2& zw);
-	bvec4(const bln8 x, const bvec3& yzw);
-	bvec4(const bvec3& xyz, const bln8 w);
+	constexpr bvec4(const bln8 val = false);
+    constexpr bvec4(const bln8 bx, const bln8 by, const bln8 bz = false, const bln8 bw = false);
+    constexpr bvec4(const bln8* arr);
+	constexpr bvec4(const bvec2& xy, const bvec2& zw);
+	constexpr bvec4(const bln8 x, const bvec3& yzw);
+	constexpr bvec4(const bvec3& xyz, const bln8 w);
 
     bln8 operator==(const bvec4& other);
     bln8 operator!=(const bvec4& other);
@@ -45,58 +44,25 @@ struct bvec4
 };
 
 
-#ifdef ENMA_IMPLEMENTATION
-bvec4::bvec4(const bvec4& v)
-{
-	this->x = v.x;
-	this->y = v.y;
-	this->z = v.z;
-	this->w = v.w;
-}
-
-bvec4::bvec4(const bln8 val) : x(val), y(val), z(val), w(val) {}
+constexpr bvec4::bvec4(const bln8 val) : x(val), y(val), z(val), w(val) {}
 
-bvec4::bvec4(const bln8 bx, const bln8 by, const bln8 bz, const bln8 bw) : x(bx), y(by), z(bz), w(bw) {}
-
-bvec4::bvec4(const bln8* arr)
-{
-	this->arr[0] = arr[0];
-	this->arr[1] = arr[1];
-	this->arr[2] = arr[2];
-	this->arr[3] = arr[3];
-}
+constexpr bvec4::bvec4(const bln8 bx, const bln8 by, const bln8 bz, const bln8 bw) : x(bx), y(by), z(bz), w(bw) {}
 
+constexpr bvec4::bvec4(const bln8* arr) : x(arr[0]), y(arr[1]), z(arr[2]), w(arr[3]) {}
 
-bvec4::bvec4(const bvec2& xy, const bvec2& zw)
-{
-	this->x = xy.x;
-	this->y = xy.y;
-	this->z = zw.x;
-	this->w = zw.y;
-}
+constexpr bvec4::bvec4(const bvec2& xy, const bvec2& zw) : x(xy.x), y(xy.y), z(zw.x), w(zw.y) {}
 
-bvec4::bvec4(const bln8 x, const bvec3& yzw)
-{
-    this->x = x;
-	this->y = yzw.x;
-	this->z = yzw.y;
-	this->w = yzw.z;
-}
+constexpr bvec4::bvec4(const bln8 x, const bvec3& yzw) : x(x), y(yzw.x), z(yzw.y), w(yzw.z) {}
 
-bvec4::bvec4(const bvec3& xyz, const bln8 w)
-{
-    this->x = xyz.x;
-	this->y = xyz.y;
-	this->z = xyz.z;
-	this->w = w;
-}
+constexpr bvec4::bvec4(const bvec3& xyz, const bln8 w) : x(xyz.x), y(xyz.y), z(xyz.z), w(w) {}
 
-bln8 bvec4::operator==(const bvec4& other)
+#ifdef ENMA_IMPLEMENTATION
+ENMA_HOT_FN bln8 bvec4::operator==(const bvec4& other)
 {
     return this->x == other.x & this->y == other.y & this->z == other.z & this->w == other.w;
 }
 
-bln8 bvec4::operator!=(const bvec4& other)
+ENMA_HOT_FN bln8 bvec4::operator!=(const bvec4& other)
 {
     return this->x != other.x & this->y != other.y & this->z != other.z & this->w != other.w;
 }
@@ -0,0 +1,410 @@
+/* Precomputed Constant-Divisor Integer Division
+ *
+ * This header file is part of Enmatica library
+ *
+ * Copyright (c) 202X by Villainous Softworks
+ *
+ */
+
+#pragma once
+#include "ivec2.hpp"
+#include "ivec3.hpp"
+#include "ivec4.hpp"
+#include "uvec2.hpp"
+#include "uvec3.hpp"
+#include "uvec4.hpp"
+#include "ivec3_soa.hpp"
+#include "../../base.hpp"
+#include "../../empch.hpp"
+#include "../simd.hpp"
+
+/**
+ * A signed divisor turned into a multiply-high and shift (Granlund & Montgomery).
+ *
+ * Build one per divisor that is reused many times, e.g. a chunk or tile size, then
+ * divide with `v / divider`. Results match the built-in truncating division; FloorDiv
+ * and FloorMod round towards negative infinity instead, so negative coordinates map
+ * to the correct cell.
+ */
+struct ivec_divider
+{
+	int32 magic;		// Low 32 bits of the multiplier, the 2^32 term is applied as an add
+	int32 shift;		// Arithmetic shift applied after the multiply
+	int32 sign;			// -1 for a negative divisor, 0 otherwise
+	int32 divisor;
+
+	/**
+	 * Constructor with a divisor.
+	 *
+	 * \param divisor Any non-zero int32.
+	 */
+	explicit constexpr ivec_divider(const int32 divisor = 1);
+};
+
+/**
+ * An unsigned divisor turned into a multiply-high and two shifts (Granlund & Montgomery).
+ */
+struct uvec_divider
+{
+	uin32 magic;		// Multiplier, rounded up
+	int32 shift1;		// Shift of the correction term, 0 or 1
+	int32 shift2;		// Final shift
+	uin32 divisor;
+
+	/**
+	 * Constructor with a divisor.
+	 *
+	 * \param divisor Any non-zero uin32.
+	 */
+	explicit constexpr uvec_divider(const uin32 divisor = 1);
+};
+
+// Smallest l such that 2^l >= d
+constexpr int32 CeilLog2(const uin32 d)
+{
+	int32 l = 0;
+
+	while((uin64(1) << l) < d)
+	{
+		l++;
+	}
+
+	return l;
+}
+
+constexpr ivec_divider::ivec_divider(const int32 divisor) :
+	magic(0), shift(0), sign(divisor < 0 ? -1 : 0), divisor(divisor)
+{
+	const uin32 ad = divisor < 0 ? 0u - static_cast<uin32>(divisor) : static_cast<uin32>(divisor);
+	const int32 l = CeilLog2(ad) > 1 ? CeilLog2(ad) : 1;
+
+	magic = static_cast<int32>(static_cast<uin32>(1 + (uin64(1) << (31 + l)) / ad));
+	shift = l - 1;
+}
+
+constexpr uvec_divider::uvec_divider(const uin32 divisor) :
+	magic(0), shift1(0), shift2(0), divisor(divisor)
+{
+	const int32 l = CeilLog2(divisor);
+
+	magic = static_cast<uin32>(((uin64(1) << 32) * ((uin64(1) << l) - divisor)) / divisor + 1);
+	shift1 = l > 0 ? 1 : 0;
+	shift2 = l > 0 ? l - 1 : 0;
+}
+
+/**
+ * Truncating division by a precomputed divisor.
+ */
+int32 operator/(const int32 n, const ivec_divider& d);
+ivec2 operator/(const ivec2& v, const ivec_divider& d);
+ivec3 operator/(const ivec3& v, const ivec_divider& d);
+ivec4 operator/(const ivec4& v, const ivec_divider& d);
+
+/**
+ * Truncating remainder by a precomputed divisor, takes the sign of the dividend.
+ */
+int32 operator%(const int32 n, const ivec_divider& d);
+ivec2 operator%(const ivec2& v, const ivec_divider& d);
+ivec3 operator%(const ivec3& v, const ivec_divider& d);
+ivec4 operator%(const ivec4& v, const ivec_divider& d);
+
+/**
+ * Division rounded towards negative infinity, e.g. FloorDiv(-1, 16) == -1.
+ */
+int32 FloorDiv(const int32 n, const ivec_divider& d);
+ivec2 FloorDiv(const ivec2& v, const ivec_divider& d);
+ivec3 FloorDiv(const ivec3& v, const ivec_divider& d);
+ivec4 FloorDiv(const ivec4& v, const ivec_divider& d);
+
+/**
+ * Remainder of FloorDiv, takes the sign of the divisor, e.g. FloorMod(-1, 16) == 15.
+ */
+int32 FloorMod(const int32 n, const ivec_divider& d);
+ivec2 FloorMod(const ivec2& v, const ivec_divider& d);
+ivec3 FloorMod(const ivec3& v, const ivec_divider& d);
+ivec4 FloorMod(const ivec4& v, const ivec_divider& d);
+
+/**
+ * Division by a precomputed divisor.
+ */
+uin32 operator/(const uin32 n, const uvec_divider& d);
+uvec2 operator/(const uvec2& v, const uvec_divider& d);
+uvec3 operator/(const uvec3& v, const uvec_divider& d);
+uvec4 operator/(const uvec4& v, const uvec_divider& d);
+
+/**
+ * Remainder by a precomputed divisor.
+ */
+uin32 operator%(const uin32 n, const uvec_divider& d);
+uvec2 operator%(const uvec2& v, const uvec_divider& d);
+uvec3 operator%(const uvec3& v, const uvec_divider& d);
+uvec4 operator%(const uvec4& v, const uvec_divider& d);
+
+// The batch overloads run on simd::int8 and are not dispatched at runtime: a step is one AVX2 register
+// only when the translation unit is compiled with `-mavx2`, on the SSE4.1 baseline it is two int4 halves
+/**
+ * Divides `count` values 8 at a time: out[i] = in[i] / d. `in` and `out` may alias.
+ */
+void Divide(const int32* in, int32* out, uin32 count, const ivec_divider& d);
+void Divide(const uin32* in, uin32* out, uin32 count, const uvec_divider& d);
+/**
+ * Remainder of `count` values 8 at a time: out[i] = in[i] % d. `in` and `out` may alias.
+ */
+void Mod(const uin32* in, uin32* out, uin32 count, const uvec_divider& d);
+/**
+ * Floor-divides `count` values 8 at a time: out[i] = FloorDiv(in[i], d). `in` and `out` may alias.
+ */
+void FloorDiv(const int32* in, int32* out, uin32 count, const ivec_divider& d);
+/**
+ * Floor remainder of `count` values 8 at a time: out[i] = FloorMod(in[i], d). `in` and `out` may alias.
+ */
+void FloorMod(const int32* in, int32* out, uin32 count, const ivec_divider& d);
+/**
+ * Floor-divides every vector of a stream, e.g. world cells to chunk coordinates.
+ */
+void FloorDiv(const ivec3_soa& v, const ivec_divider& d, ivec3_soa& out);
+/**
+ * Floor remainder of every vector of a stream, e.g. world cells to chunk-local cells.
+ */
+void FloorMod(const ivec3_soa& v, const ivec_divider& d, ivec3_soa& out);
+
+#ifdef ENMA_IMPLEMENTATION
+// The register kernels are shared by simd::int4 and simd::int8, the scalar overloads follow the same steps
+template <typename R>
+inline R DivTrunc(const R& n, const ivec_divider& d)
+{
+	const R q = simd::ShiftRight(n + simd::MulHi(n, R::Set1(d.magic)), d.shift) - simd::ShiftRight<31>(n);
+	const R s = R::Set1(d.sign);
+
+	return simd::Xor(q, s) - s;
+}
+
+// Mask of the lanes whose truncated quotient lies above the floor quotient
+template <typename R>
+inline R FloorAdjust(const R& r, const ivec_divider& d)
+{
+	return simd::AndNot(simd::CmpEq(r, R::Zero()), simd::CmpLt(simd::Xor(r, R::Set1(d.divisor)), R::Zero()));
+}
+
+template <typename R>
+inline R DivFloor(const R& n, const ivec_divider& d)
+{
+	const R q = DivTrunc(n, d);
+
+	return q + FloorAdjust(n - q * R::Set1(d.divisor), d);
+}
+
+template <typename R>
+inline R ModFloor(const R& n, const ivec_divider& d)
+{
+	const R dv = R::Set1(d.divisor);
+	const R r = n - DivTrunc(n, d) * dv;
+
+	return r + simd::And(FloorAdjust(r, d), dv);
+}
+
+template <typename R>
+inline R DivU(const R& n, const uvec_divider& d)
+{
+	const R q = simd::MulHiU(n, R::Set1(static_cast<int32>(d.magic)));
+
+	return simd::ShiftRightLogical(simd::ShiftRightLogical(n - q, d.shift1) + q, d.shift2);
+}
+
+template <typename R>
+inline R ModU(const R& n, const uvec_divider& d)
+{
+	return n - DivU(n, d) * R::Set1(static_cast<int32>(d.divisor));
+}
+
+ENMA_HOT_FN int32 operator/(const int32 n, const ivec_divider& d)
+{
+	// Exact in 64 bits, the 32-bit sum only wraps for |divisor| == 1 where the shift is 0
+	const int64 q = ((n + ((static_cast<int64>(d.magic) * n) >> 32)) >> d.shift) - (n >> 31);
+
+	return (static_cast<int32>(q) ^ d.sign) - d.sign;
+}
+
+ENMA_HOT_FN ivec2 operator/(const ivec2& v, const ivec_divider& d)
+{
+	return ivec2(DivTrunc(LoadXY(v), d));
+}
+
+ENMA_HOT_FN ivec3 operator/(const ivec3& v, const ivec_divider& d)
+{
+	return ivec3(DivTrunc(LoadXYZ(v), d));
+}
+
+ENMA_HOT_FN ivec4 operator/(const ivec4& v, const ivec_divider& d)
+{
+	return ivec4(DivTrunc(LoadXYZW(v), d));
+}
+
+ENMA_HOT_FN int32 operator%(const int32 n, const ivec_divider& d)
+{
+	return n - (n / d) * d.divisor;
+}
+
+ENMA_HOT_FN ivec2 operator%(const ivec2& v, const ivec_divider& d)
+{
+	const simd::int4 n = LoadXY(v);
+
+	return ivec2(n - DivTrunc(n, d) * simd::int4::Set1(d.divisor));
+}
+
+ENMA_HOT_FN ivec3 operator%(const ivec3& v, const ivec_divider& d)
+{
+	const simd::int4 n = LoadXYZ(v);
+
+	return ivec3(n - DivTrunc(n, d) * simd::int4::Set1(d.divisor));
+}
+
+ENMA_HOT_FN ivec4 operator%(const ivec4& v, const ivec_divider& d)
+{
+	const simd::int4 n = LoadXYZW(v);
+
+	return ivec4(n - DivTrunc(n, d) * simd::int4::Set1(d.divisor));
+}
+
+ENMA_HOT_FN int32 FloorDiv(const int32 n, const ivec_divider& d)
+{
+	const int32 q = n / d;
+	const int32 r = n - q * d.divisor;
+
+	return q - ((r != 0) & ((r ^ d.divisor) < 0));
+}
+
+ENMA_HOT_FN ivec2 FloorDiv(const ivec2& v, const ivec_divider& d)
+{
+	return ivec2(DivFloor(LoadXY(v), d));
+}
+
+ENMA_HOT_FN ivec3 FloorDiv(const ivec3& v, const ivec_divider& d)
+{
+	return ivec3(DivFloor(LoadXYZ(v), d));
+}
+
+ENMA_HOT_FN ivec4 FloorDiv(const ivec4& v, const ivec_divider& d)
+{
+	return ivec4(DivFloor(LoadXYZW(v), d));
+}
+
+ENMA_HOT_FN int32 FloorMod(const int32 n, const ivec_divider& d)
+{
+	const int32 r = n % d;
+
+	return ((r != 0) & ((r ^ d.divisor) < 0)) ? r + d.divisor : r;
+}
+
+ENMA_HOT_FN ivec2 FloorMod(const ivec2& v, const ivec_divider& d)
+{
+	return ivec2(ModFloor(LoadXY(v), d));
+}
+
+ENMA_HOT_FN ivec3 FloorMod(const ivec3& v, const ivec_divider& d)
+{
+	return ivec3(ModFloor(LoadXYZ(v), d));
+}
+
+ENMA_HOT_FN ivec4 FloorMod(const ivec4& v, const ivec_divider& d)
+{
+	return ivec4(ModFloor(LoadXYZW(v), d));
+}
+
+ENMA_HOT_FN uin32 operator/(const uin32 n, const uvec_divider& d)
+{
+	const uin32 q = static_cast<uin32>((static_cast<uin64>(d.magic) * n) >> 32);
+
+	return (((n - q) >> d.shift1) + q) >> d.shift2;
+}
+
+ENMA_HOT_FN uvec2 operator/(const uvec2& v, const uvec_divider& d)
+{
+	return uvec2(DivU(LoadXY(v), d));
+}
+
+ENMA_HOT_FN uvec3 operator/(const uvec3& v, const uvec_divider& d)
+{
+	return uvec3(DivU(LoadXYZ(v), d));
+}
+
+ENMA_HOT_FN uvec4 operator/(const uvec4& v, const uvec_divider& d)
+{
+	return uvec4(DivU(LoadXYZW(v), d));
+}
+
+ENMA_HOT_FN uin32 operator%(const uin32 n, const uvec_divider& d)
+{
+	return n - (n / d) * d.divisor;
+}
+
+ENMA_HOT_FN uvec2 operator%(const uvec2& v, const uvec_divider& d)
+{
+	return uvec2(ModU(LoadXY(v), d));
+}
+
+ENMA_HOT_FN uvec3 operator%(const uvec3& v, const uvec_divider& d)
+{
+	return uvec3(ModU(LoadXYZ(v), d));
+}
+
+ENMA_HOT_FN uvec4 operator%(const uvec4& v, const uvec_divider& d)
+{
+	return uvec4(ModU(LoadXYZW(v), d));
+}
+
+// Runs `op` over 8-lane blocks and finishes the tail with the scalar form
+template <typename T, typename Op, typename ScalarOp>
+inline void DividerApply(const T* in, T* out, uin32 count, Op op, ScalarOp scalarOp)
+{
+	const int32* src = reinterpret_cast<const int32*>(in);
+	int32* dst = reinterpret_cast<int32*>(out);
+
+	uin32 i = 0;
+	for(; i + 8 <= count; i += 8)
+	{
+		op(simd::int8::LoadU(src + i)).StoreU(dst + i);
+	}
+
+	for(; i < count; i++)
+	{
+		out[i] = scalarOp(in[i]);
+	}
+}
+
+ENMA_FN void Divide(const int32* in, int32* out, uin32 count, const ivec_divider& d)
+{
+	DividerApply(in, out, count, [&d](const simd::int8& n) { return DivTrunc(n, d); }, [&d](const int32 n) { return n / d; });
+}
+
+ENMA_FN void Divide(const uin32* in, uin32* out, uin32 count, const uvec_divider& d)
+{
+	DividerApply(in, out, count, [&d](const simd::int8& n) { return DivU(n, d); }, [&d](const uin32 n) { return n / d; });
+}
+
+ENMA_FN void Mod(const uin32* in, uin32* out, uin32 count, const uvec_divider& d)
+{
+	DividerApply(in, out, count, [&d](const simd::int8& n) { return ModU(n, d); }, [&d](const uin32 n) { return n % d; });
+}
+
+ENMA_FN void FloorDiv(const int32* in, int32* out, uin32 count, const ivec_divider& d)
+{
+	DividerApply(in, out, count, [&d](const simd::int8& n) { return DivFloor(n, d); }, [&d](const int32 n) { return FloorDiv(n, d); });
+}
+
+ENMA_FN void FloorMod(const int32* in, int32* out, uin32 count, const ivec_divider& d)
+{
+	DividerApply(in, out, count, [&d](const simd::int8& n) { return ModFloor(n, d); }, [&d](const int32 n) { return FloorMod(n, d); });
+}
+
+ENMA_FN void FloorDiv(const ivec3_soa& v, const ivec_divider& d, ivec3_soa& out)
+{
+	SoaApply(v, out, [&d](const simd::int8& n) { return DivFloor(n, d); });
+}
+
+ENMA_FN void FloorMod(const ivec3_soa& v, const ivec_divider& d, ivec3_soa& out)
+{
+	SoaApply(v, out, [&d](const simd::int8& n) { return ModFloor(n, d); });
+}
+
+#endif // ENMA_IMPLEMENTATION
@@ -9,9 +9,10 @@
 #pragma once
 #include "../../base.hpp"
 #include "../../empch.hpp"
-#include "../simd_helpers.hpp"
+#include "../simd.hpp"
 #include "swizzle.hpp"
 #include "bvec2.hpp"
+#include "vmask.hpp"
 
 using namespace std;
 
@@ -32,32 +33,26 @@ struct ALIGN(8) fvec2
 		FVEC2_SWIZZLE(fvec2);
     };
 
-	/**
-	 * Copy constructor.
-	 * 
-	 * \param v Another fvec2 to copy from.
-	 */
-	fvec2(const fvec2& v);
 	/**
 	 * Constructor with components.
 	 * 
 	 * \param x X component.
 	 * \param y Y component.
 	 */
-    fvec2(flt32 x, flt32 y);
+    constexpr fvec2(flt32 x, flt32 y);
 	/**
 	 * Single value constructor.
 	 *
 	 * \param val Value to initialize x and y components. 
 	 *			  Defaults to 0.0f if not provided.
 	 */
-	explicit fvec2(flt32 val = 0.0f);
+	constexpr explicit fvec2(flt32 val = 0.0f);
 	/**
 	 * Array constructor.
 	 * 
 	 * \param arr Pointer to an array of at least 2 flt32 elements.
 	 */
-	explicit fvec2(const flt32* arr);
+	constexpr explicit fvec2(const flt32* arr);
 	
 	/**
 	 * Indexing operator.
@@ -244,6 +239,15 @@ struct ALIGN(8) fvec2
 	 */
 	flt32 Distance(const fvec2& other);
 
+	/**
+	 * Constructor from simd::float4.
+	 * 
+	 * Initializes an fvec2 using the first two lanes of a simd::float4.
+	 * 
+	 * \param vals simd::float4 containing values to initialize x and y components.
+	 */
+	fvec2(const simd::float4& vals);
+
 	#ifdef USE_SIMD
 	/**
 	 * Constructor from __m128.
@@ -253,18 +257,18 @@ struct ALIGN(8) fvec2
 	 * \param vals __m128 SIMD data type containing values to initialize x and y components.
 	 */
 	fvec2(const __m128& vals);
+	#endif
 
 	/**
 	 * Linear Interpolation
 	 *
-	 * Interpolates from the given vector, consider it as `a`, to the other vector `b` based on interpolation parameter `t` using SIMD operations.
+	 * Interpolates from the given vector, consider it as `a`, to the other vector `b` based on interpolation parameter `t`.
 	 *
 	 * \param b The fvec2 to interpolate towards.
 	 * \param t Interpolation parameter (typically in the range [0, 1]).
 	 * \return The interpolated fvec2.
 	 */
 	fvec2 Lerp(const fvec2& b, flt32 t);
-	#endif
 	
 	#ifdef DEBUG
     friend std::ostream& operator<<(std::ostream& os, const fvec2& v)
@@ -345,7 +349,6 @@ flt32 Cross(const fvec2& v1, const fvec2& v2);
  */
 flt32 Distance(const fvec2& v1, const fvec2& v2);
 
-#ifdef USE_SIMD
 /**
  * Linear Interpolation
  *
@@ -357,456 +360,258 @@ flt32 Distance(const fvec2& v1, const fvec2& v2);
  * \return The interpolated fvec2.
  */
 fvec2 Lerp(const fvec2& a, const fvec2& b, flt32 t);
-#endif
-
-#ifdef ENMA_IMPLEMENTATION
-fvec2::fvec2(const fvec2& v) : x(v.x), y(v.y) {}
 
-fvec2::fvec2(flt32 x, flt32 y) : x(x), y(y) {}
-
-fvec2::fvec2(flt32 val) : x(val), y(val) {}
-
-fvec2::fvec2(const flt32* arr)
-{
-	this->_arr[0] = arr[0];
-	this->_arr[1] = arr[1];
-}
-
-flt32 fvec2::operator[](uin32 index) const
-{
-	return _arr[index];
-}
-
-flt32 fvec2::Cross(const fvec2& other)
-{
-	return this->x * other.y - other.x * this->y;
-}
-
-flt32 Cross(const fvec2& v1, const fvec2& v2)
-{
-	return v1.x * v2.y - v2.x * v1.y;
-}
-
-#ifdef USE_SIMD
-
-fvec2::fvec2(const __m128& vals)
-{
-	this->_arr[0] = vals[0];
-	this->_arr[1] = vals[1];
-}
-
-inline __m128 set(const fvec2& v)
-{
-	return _mm_set_ps(0.0f, 0.0f, v.y, v.x);
-}
-    
-inline fvec2 fvec2::operator+(const fvec2& other) const
-{
-	const __m128 v1 = set(*this);
-	const __m128 v2 = set(other);
-
-	return fvec2(_mm_add_ps(v1, v2));
-}
+/**
+ * Component-wise comparisons. Every result is a vmask2 lane mask for Select, Any/All/None, or conversion to bvec2.
+ */
+vmask2 operator==(const fvec2& a, const fvec2& b);
+vmask2 operator!=(const fvec2& a, const fvec2& b);
+vmask2 operator<(const fvec2& a, const fvec2& b);
+vmask2 operator<=(const fvec2& a, const fvec2& b);
+vmask2 operator>(const fvec2& a, const fvec2& b);
+vmask2 operator>=(const fvec2& a, const fvec2& b);
+/**
+ * Component-wise |a - b| <= epsilon.
+ */
+vmask2 ApproxEqual(const fvec2& a, const fvec2& b, flt32 epsilon = 1e-5f);
+/**
+ * Branchless per-component select: mask ? a : b.
+ */
+fvec2 Select(const vmask2& mask, const fvec2& a, const fvec2& b);
 
-fvec2& fvec2::operator+=(const fvec2& other)
+/**
+ * Loads x and y into the first two lanes of a simd::float4, z and w are zero.
+ *
+ * \param v The fvec2 to load.
+ * \return The loaded simd::float4.
+ */
+inline simd::float4 LoadXY(const fvec2& v)
 {
-	const __m128 v1 = set(*this);
-	const __m128 v2 = set(other);
-
-	*this = _mm_add_ps(v1, v2);
-
-	return *this;
+	return simd::float4::LoadXY(v._arr);
 }
 
-fvec2 fvec2::operator-() const
+/**
+ * Stores the first two lanes of a simd::float4 into an fvec2.
+ *
+ * \param out The fvec2 to write to.
+ * \param v The simd::float4 to store.
+ */
+inline void StoreXY(fvec2& out, const simd::float4& v)
 {
-	return fvec2(-x, -y);
+	v.StoreXY(out._arr);
 }
 
-fvec2 fvec2::operator-(const fvec2& other) const
-{
-	const __m128 v1 = set(*this);
-	const __m128 v2 = set(other);
+constexpr fvec2::fvec2(flt32 x, flt32 y) : x(x), y(y) {}
 
-	return fvec2(_mm_sub_ps(v1, v2));
-}
+constexpr fvec2::fvec2(flt32 val) : x(val), y(val) {}
 
-fvec2& fvec2::operator-=(const fvec2& other)
-{
-	const __m128 v1 = set(*this);
-	const __m128 v2 = set(other);
+constexpr fvec2::fvec2(const flt32* arr) : x(arr[0]), y(arr[1]) {}
 
-	*this = _mm_sub_ps(v1, v2);
+inline constexpr fvec2 fvec2::zero 	= fvec2();
+inline constexpr fvec2 fvec2::one 	= fvec2(1.0f);
+inline constexpr fvec2 fvec2::neg	= fvec2(-1.0f);
 
-	return *this;
-}
+inline constexpr fvec2 fvec2::up 	= fvec2(0.0f, 1.0f);
+inline constexpr fvec2 fvec2::down 	= fvec2(0.0f, -1.0f);
+inline constexpr fvec2 fvec2::right = fvec2(1.0f, 0.0f);
+inline constexpr fvec2 fvec2::left 	= fvec2(-1.0f, 0.0f);
 
-fvec2 fvec2::operator*(const fvec2& other) const
-{
-	const __m128 v1 = set(*this);
-	const __m128 v2 = set(other);
-
-	return fvec2(_mm_mul_ps(v1, v2));
-}
+#ifdef ENMA_IMPLEMENTATION
 
-fvec2& fvec2::operator*=(const fvec2& other)
+ENMA_HOT_FN flt32 fvec2::operator[](uin32 index) const
 {
-	const __m128 v1 = set(*this);
-	const __m128 v2 = set(other);
-
-	*this = _mm_mul_ps(v1, v2);
-
-	return *this;
+	return _arr[index];
 }
 
-fvec2 fvec2::operator*(flt32 val) const
+ENMA_HOT_FN flt32 fvec2::Cross(const fvec2& other)
 {
-	const __m128 v1 = set(*this);
-	const __m128 v2 = set1(val);
-
-	return fvec2(_mm_mul_ps(v1, v2));
+	return this->x * other.y - other.x * this->y;
 }
 
-fvec2& fvec2::operator*=(flt32 val)
+ENMA_HOT_FN flt32 Cross(const fvec2& v1, const fvec2& v2)
 {
-	const __m128 v1 = set(*this);
-	const __m128 v2 = set1(val);
-
-	*this = _mm_mul_ps(v1, v2);
-
-	return *this;
+	return v1.x * v2.y - v2.x * v1.y;
 }
 
-fvec2 fvec2::operator/(const fvec2& other) const
+ENMA_HOT_FN fvec2::fvec2(const simd::float4& vals)
 {
-	const __m128 v1 = set(*this);
-	const __m128 v2 = set(other);
-
-	return fvec2(_mm_div_ps(v1, v2));
+	StoreXY(*this, vals);
 }
 
-fvec2& fvec2::operator/=(const fvec2& other)
-{
-	const __m128 v1 = set(*this);
-	const __m128 v2 = set(other);
-
-	*this = _mm_div_ps(v1, v2);
-
-	return *this;
-}
+#ifdef USE_SIMD
+ENMA_HOT_FN fvec2::fvec2(const __m128& vals) : fvec2(simd::float4(vals)) {}
+#endif
 
-fvec2 fvec2::operator/(flt32 val) const
+ENMA_HOT_FN fvec2 fvec2::operator+(const fvec2& other) const
 {
-	const __m128 v1 = set(*this);
-	const __m128 v2 = set1(val);
-
-	return fvec2(_mm_div_ps(v1, v2));
+	return fvec2(LoadXY(*this) + LoadXY(other));
 }
 
-fvec2& fvec2::operator/=(flt32 val)
+ENMA_HOT_FN fvec2& fvec2::operator+=(const fvec2& other)
 {
-	const __m128 v1 = set(*this);
-	const __m128 v2 = set1(val);
-
-	*this = _mm_div_ps(v1, v2);
-
-	return *this;
+	return *this = *this + other;
 }
 
-fvec2 fvec2::operator+(flt32 val) const
+ENMA_HOT_FN fvec2 fvec2::operator-() const
 {
-	const __m128 v1 = set(*this);
-	const __m128 v2 = set1(val);
-
-	return fvec2(_mm_add_ps(v1, v2));
+	return fvec2(-x, -y);
 }
 
-fvec2& fvec2::operator+=(flt32 val)
+ENMA_HOT_FN fvec2 fvec2::operator-(const fvec2& other) const
 {
-	const __m128 v1 = set(*this);
-	const __m128 v2 = set1(val);
-
-	*this = _mm_add_ps(v1, v2);
-
-	return *this;
+	return fvec2(LoadXY(*this) - LoadXY(other));
 }
 
-fvec2 fvec2::operator-(flt32 val) const
+ENMA_HOT_FN fvec2& fvec2::operator-=(const fvec2& other)
 {
-	const __m128 v1 = set(*this);
-	const __m128 v2 = set1(val);
-
-	return fvec2(_mm_sub_ps(v1, v2));
+	return *this = *this - other;
 }
 
-fvec2& fvec2::operator-=(flt32 val)
+ENMA_HOT_FN fvec2 fvec2::operator*(const fvec2& other) const
 {
-	const __m128 v1 = set(*this);
-	const __m128 v2 = set1(val);
-
-	*this = _mm_sub_ps(v1, v2);
-
-	return *this;
+	return fvec2(LoadXY(*this) * LoadXY(other));
 }
 
-fvec2& fvec2::Normalise()
+ENMA_HOT_FN fvec2& fvec2::operator*=(const fvec2& other)
 {
-	const __m128 vl = set(*this);
-	const __m128 x = _mm_dp_ps(vl, vl, 0x77);
-
-	const __m128 mag = _mm_sqrt_ps(x);		// The magnitude of the Vector
-
-	*this = _mm_div_ps(vl, mag);			// Normalised vector
-
-	return *this;
+	return *this = *this * other;
 }
 
-fvec2 Normalise(const fvec2& v)
+ENMA_HOT_FN fvec2 fvec2::operator*(flt32 val) const
 {
-	__m128 vl = set(v);
-	const __m128 x = _mm_dp_ps(vl, vl, 0x77);
-
-	const __m128 mag = _mm_sqrt_ps(x);	// The magnitude of the Vector
-
-	vl = _mm_div_ps(vl, mag);	// Normalised vector
-
-	return fvec2(vl);
+	return fvec2(LoadXY(*this) * val);
 }
 
-flt32 fvec2::Dot(const fvec2& other)
+ENMA_HOT_FN fvec2& fvec2::operator*=(flt32 val)
 {
-	const __m128 v1 = set(*this);
-	const __m128 v2 = set(other);
-		
-	const __m128 dot = _mm_dp_ps(v1, v2, 0x77);
-
-	return dot[0];
+	return *this = *this * val;
 }
 
-flt32 Dot(const fvec2& v1, const fvec2& v2)
+ENMA_HOT_FN fvec2 fvec2::operator/(const fvec2& other) const
 {
-	const __m128 lv1 = set(v1);
-	const __m128 lv2 = set(v2);
-		
-	const __m128 dot = _mm_dp_ps(lv1, lv2, 0x77);
-
-	return dot[0];
+	// Only x and y are stored back, so the 0 / 0 in the upper lanes is harmless
+	return fvec2(LoadXY(*this) / LoadXY(other));
 }
 
-flt32 fvec2::Distance(const fvec2& other)
+ENMA_HOT_FN fvec2& fvec2::operator/=(const fvec2& other)
 {
-	__m128 v1 = set(*this);
-	__m128 v2 = set(other);
-
-	v1 = _mm_sub_ps(v1, v2);
-
-	v1 = _mm_dp_ps(v1, v1, 0xFF);
-
-	v1 = _mm_sqrt_ps(v1);
-
-	return v1[0];
+	return *this = *this / other;
 }
 
-flt32 Distance(const fvec2& v1, const fvec2& v2)
+ENMA_HOT_FN fvec2 fvec2::operator/(flt32 val) const
 {
-	__m128 lv1 = set(v1);
-	__m128 lv2 = set(v2);
-
-	lv1 = _mm_sub_ps(lv1, lv2);
-
-	lv1 = _mm_dp_ps(lv1, lv1, 0xFF);
-
-	lv1 = _mm_sqrt_ps(lv1);
-
-	return lv1[0];
+	return fvec2(LoadXY(*this) / val);
 }
 
-fvec2 fvec2::Lerp(const fvec2& b, flt32 t)
+ENMA_HOT_FN fvec2& fvec2::operator/=(flt32 val)
 {
-	__m128 lv1 = set(*this);
-	__m128 lv2 = set(b);
-
-	__m128 lt = set1(t);
-
-	__m128 bma = _mm_sub_ps(lv2, lv1);
-
-	return fvec2(_mm_fmadd_ps(lt, bma, lv1));
+	return *this = *this / val;
 }
 
-fvec2 Lerp(const fvec2& a, const fvec2& b, flt32 t)
+ENMA_HOT_FN fvec2 fvec2::operator+(flt32 val) const
 {
-	__m128 lv1 = set(a);
-	__m128 lv2 = set(b);
-
-	__m128 lt = set1(t);
-
-	__m128 bma = _mm_sub_ps(lv2, lv1);
-
-	return fvec2(_mm_fmadd_ps(lt, bma, lv1));
+	return fvec2(LoadXY(*this) + val);
 }
 
-#else
-
-fvec2 fvec2::operator+(const fvec2& other) const
+ENMA_HOT_FN fvec2& fvec2::operator+=(flt32 val)
 {
-	return fvec2(this->x + other.x, this->y + other.y);
+	return *this = *this + val;
 }
 
-fvec2& fvec2::operator+=(const fvec2& other)
+ENMA_HOT_FN fvec2 fvec2::operator-(flt32 val) const
 {
-	this->x += other.x;
-	this->y += other.y;
-
-	return *this;
+	return fvec2(LoadXY(*this) - val);
 }
 
-fvec2 fvec2::operator-() const
+ENMA_HOT_FN fvec2& fvec2::operator-=(flt32 val)
 {
-	return fvec2(-x, -y);
+	return *this = *this - val;
 }
 
-fvec2 fvec2::operator-(const fvec2& other) const
+ENMA_HOT_FN fvec2& fvec2::Normalise()
 {
-	return fvec2(this->x - other.x, this->y - other.y);
+	return *this = ::Normalise(*this);
 }
 
-fvec2& fvec2::operator-=(const fvec2& other)
+ENMA_HOT_FN fvec2 Normalise(const fvec2& v)
 {
-	this->x -= other.x;
-	this->y -= other.y;
-
-	return *this;
-}
+	const simd::float4 vl = LoadXY(v);
 
-fvec2 fvec2::operator*(const fvec2& other) const
-{
-	return fvec2(this->x * other.x, this->y * other.y);
+	return fvec2(vl / simd::Sqrt(simd::Dot2(vl, vl)));
 }
 
-fvec2& fvec2::operator*=(const fvec2& other)
+ENMA_HOT_FN flt32 fvec2::Dot(const fvec2& other)
 {
-	this->x *= other.x;
-	this->y *= other.y;
-
-	return *this;
+	return ::Dot(*this, other);
 }
 
-fvec2 fvec2::operator*(flt32 val) const
+ENMA_HOT_FN flt32 Dot(const fvec2& v1, const fvec2& v2)
 {
-	return fvec2(this->x * val, this->y * val);
+	return simd::Dot2(LoadXY(v1), LoadXY(v2)).X();
 }
 
-fvec2& fvec2::operator*=(flt32 val)
+ENMA_HOT_FN flt32 fvec2::Distance(const fvec2& other)
 {
-	this->x *= val;
-	this->y *= val;
-
-	return *this;
+	return ::Distance(*this, other);
 }
 
-fvec2 fvec2::operator/(const fvec2& other) const
+ENMA_HOT_FN flt32 Distance(const fvec2& v1, const fvec2& v2)
 {
+	const simd::float4 d = LoadXY(v1) - LoadXY(v2);
 
-	return fvec2(this->x / other.x, this->y / other.y);
+	return simd::Sqrt(simd::Dot2(d, d)).X();
 }
 
-fvec2& fvec2::operator/=(const fvec2& other)
+ENMA_HOT_FN fvec2 fvec2::Lerp(const fvec2& b, flt32 t)
 {
-	this->x /= other.x;
-	this->y /= other.y;
-
-	return *this;
+	return ::Lerp(*this, b, t);
 }
 
-fvec2 fvec2::operator/(flt32 val) const
+ENMA_HOT_FN fvec2 Lerp(const fvec2& a, const fvec2& b, flt32 t)
 {
-	const flt32 rec = 1.0f / val;
+	const simd::float4 lv1 = LoadXY(a);
 
-	return fvec2(this->x * rec, this->y * rec);
+	return fvec2(simd::Fmadd(simd::float4::Set1(t), LoadXY(b) - lv1, lv1));
 }
 
-fvec2& fvec2::operator/=(flt32 val)
+ENMA_HOT_FN vmask2 operator==(const fvec2& a, const fvec2& b)
 {
-	const flt32 rec = 1.0f / val;
-
-	this->x *= rec;
-	this->y *= rec;
-
-	return *this;
+	return vmask2(simd::AsInt(simd::CmpEq(LoadXY(a), LoadXY(b))));
 }
 
-fvec2 fvec2::operator+(flt32 val) const
+ENMA_HOT_FN vmask2 operator!=(const fvec2& a, const fvec2& b)
 {
-	return fvec2(this->x + val, this->y + val);
+	return vmask2(simd::AsInt(simd::CmpNeq(LoadXY(a), LoadXY(b))));
 }
 
-fvec2& fvec2::operator+=(flt32 val)
+ENMA_HOT_FN vmask2 operator<(const fvec2& a, const fvec2& b)
 {
-	this->x += val;
-	this->y += val;
-
-	return *this;
+	return vmask2(simd::AsInt(simd::CmpLt(LoadXY(a), LoadXY(b))));
 }
 
-fvec2 fvec2::operator-(flt32 val) const
+ENMA_HOT_FN vmask2 operator<=(const fvec2& a, const fvec2& b)
 {
-	return fvec2(this->x - val, this->y - val);
+	return vmask2(simd::AsInt(simd::CmpLe(LoadXY(a), LoadXY(b))));
 }
 
-fvec2& fvec2::operator-=(flt32 val)
+ENMA_HOT_FN vmask2 operator>(const fvec2& a, const fvec2& b)
 {
-	this->x -= val;
-	this->y -= val;
-
-	return *this;
+	return vmask2(simd::AsInt(simd::CmpGt(LoadXY(a), LoadXY(b))));
 }
 
-/**
- * @return Normalised form of the given vector
- */
-fvec2& fvec2::Normalise()
+ENMA_HOT_FN vmask2 operator>=(const fvec2& a, const fvec2& b)
 {
-	flt32 xt = this->x * this->x;
-	flt32 yt = this->y * this->y;
-
-	const flt32 mag = 1.0f / sqrt(xt + yt);
-	*this *= mag;
-
-	return *this;
+	return vmask2(simd::AsInt(simd::CmpGe(LoadXY(a), LoadXY(b))));
 }
 
-/**
- * @param other The other vector with which the dot product is calculated
- * @return Returns the dot product between the given vector and the other vector
- */
-flt32 fvec2::Dot(const fvec2& other)
+ENMA_HOT_FN vmask2 ApproxEqual(const fvec2& a, const fvec2& b, flt32 epsilon)
 {
-    return this->x * other.x + this->y * other.y;
+	return vmask2(simd::AsInt(simd::CmpLe(simd::Abs(LoadXY(a) - LoadXY(b)), simd::float4::Set1(epsilon))));
 }
 
-/**
- * @brief Calculates the Euclidean distance between this vector and another vector.
- *
- * @param other The other vector to which the distance is calculated.
- * @return Distance between this vector and the other vector.
- */
-flt32 fvec2::Distance(const fvec2& other)
+ENMA_HOT_FN fvec2 Select(const vmask2& mask, const fvec2& a, const fvec2& b)
 {
-	flt32 dx = this->x - other.x;
-	flt32 dy = this->y - other.y;
-
-	return sqrt(dx * dx + dy * dy);
+	return fvec2(simd::Select(simd::AsFloat(mask.lanes), LoadXY(a), LoadXY(b)));
 }
 
-#endif
-
-const fvec2 fvec2::zero 	= fvec2();
-const fvec2 fvec2::one 		= fvec2(1.0f);
-const fvec2 fvec2::neg		= fvec2(-1.0f);
-
-const fvec2 fvec2::up 		= fvec2(0.0f, 1.0f);
-const fvec2 fvec2::down 	= fvec2(0.0f, -1.0f);
-const fvec2 fvec2::right 	= fvec2(1.0f, 0.0f);
-const fvec2 fvec2::left 	= fvec2(-1.0f, 0.0f);
-
 #endif	// ENMA_IMPLEMENTATION
@@ -10,8 +10,9 @@
 #include "fvec2.hpp"
 #include "../../base.hpp"
 #include "../../empch.hpp"
-#include "../simd_helpers.hpp"
+#include "../simd.hpp"
 #include "swizzle.hpp"
+#include "vmask.hpp"
 
 struct ALIGN(16) fvec3
 {
@@ -34,12 +35,6 @@ struct ALIGN(16) fvec3
 		#endif
     };
 	
-	/**
-	 * Copy constructor.
-	 * 
-	 * \param v Another fvec3 to copy from.
-	 */
-	fvec3(const fvec3& v);
 	/**
 	 * Constructor with components.
 	 * 
@@ -47,20 +42,20 @@ struct ALIGN(16) fvec3
 	 * \param y Y component.
 	 * \param z Z component. Defaults to 0.0f if not provided.
 	 */
-	fvec3(flt32 x, flt32 y, flt32 z = 0.0f);
+	constexpr fvec3(flt32 x, flt32 y, flt32 z = 0.0f);
 	/**
 	 * Single value constructor.
 	 *
 	 * \param val Value to initialize x, y and z components.
 	 *			  Defaults to 0.0f if not provided.
 	 */
-	explicit fvec3(flt32 val = 0.0f);
+	constexpr explicit fvec3(flt32 val = 0.0f);
 	/**
 	 * Array constructor.
 	 * 
 	 * \param arr Pointer to an array of at least 3 flt32 elements.
 	 */
-	explicit fvec3(const flt32* arr);
+	constexpr explicit fvec3(const flt32* arr);
 	
 	/**
 	 * Constructor with a value and a vector.
@@ -68,14 +63,14 @@ struct ALIGN(16) fvec3
 	 * \param x X component.
 	 * \param yz YZ fvec2. Sets the y and z components.
 	 */
-	fvec3(flt32 x, const vec2& yz);
+	constexpr fvec3(flt32 x, const vec2& yz);
 	/**
 	 * Constructor with a vector and a value.
 	 * 
 	 * \param xy XY fvec2. Sets the x and y components.
 	 * \param z Z component.
 	 */
-	fvec3(const vec2& xy, flt32 z);
+	constexpr fvec3(const vec2& xy, flt32 z);
 
 	/**
 	 * Conversion operator to fvec2.
@@ -273,6 +268,15 @@ struct ALIGN(16) fvec3
 	 */
 	flt32 Distance(const fvec3& other);
 
+	/**
+	 * Constructor from simd::float4.
+	 * 
+	 * Initializes an fvec3 using the first three lanes of a simd::float4.
+	 * 
+	 * \param vals simd::float4 containing values to initialize x, y and z components.
+	 */
+	fvec3(const simd::float4& vals);
+
 	#ifdef USE_SIMD
 	/**
 	 * Constructor from __m128.
@@ -282,18 +286,18 @@ struct ALIGN(16) fvec3
 	 * \param vals A SIMD __m128 data containing values to initialize x, y and z components.
 	 */
 	fvec3(const __m128& vals);
+	#endif
 
 	/**
 	 * Linear Interpolation
 	 *
-	 * Interpolates from the given vector, consider it as `a`, to the other vector `b` based on interpolation parameter `t` using SIMD operations.
+	 * Interpolates from the given vector, consider it as `a`, to the other vector `b` based on interpolation parameter `t`.
 	 *
 	 * \param b The fvec3 to interpolate towards.
 	 * \param t Interpolation parameter (typically in the range [0, 1]).
 	 * \return The interpolated fvec3.
 	 */
 	fvec3 Lerp(const fvec3& b, flt32 t);
-	#endif
 
 	#ifdef DEBUG
 	friend std::ostream& operator<<(std::ostream& os, const fvec3& v)
@@ -386,777 +390,298 @@ fvec3 Cross(const fvec3& v1, const fvec3& v2);
  */
 flt32 Distance(const fvec3& v1, const fvec3& v2);
 
-#ifdef USE_SIMD
+/**
+ * Linear Interpolation
+ *
+ * Interpolates from the given vector `a` to the other vector `b` based on interpolation parameter `t`.
+ *
+ * \param a The fvec3 to interpolate from.
+ * \param b The fvec3 to interpolate towards.
+ * \param t Interpolation parameter (typically in the range [0, 1]).
+ * \return The interpolated fvec3.
+ */
 fvec3 Lerp(const fvec3& a, const fvec3& b, flt32 t);
-#endif
-
-#ifdef ENMA_IMPLEMENTATION
-fvec3::fvec3(const fvec3& v)
-{
-	this->x = v.x;
-	this->y = v.y;
-	this->z = v.z;
-}
-
-fvec3::fvec3(flt32 x, flt32 y, flt32 z) : x(x), y(y), z(z) {}
-
-fvec3::fvec3(flt32 val) : x(val), y(val), z(val) {}
-
-fvec3::fvec3(const flt32* arr)
-{
-	this->_arr[0] = arr[0];
-	this->_arr[1] = arr[1];
-	this->_arr[2] = arr[2];
-}
-
-fvec3::fvec3(flt32 x, const vec2& yz) : x(x), y(yz.x), z(yz.y) {}
-
-fvec3::fvec3(const vec2& xy, flt32 z) : x(xy.x), y(xy.y), z(z) {}
-
-fvec3::operator vec2() const
-{
-	return vec2(this->x, this->y);
-}
-
-flt32 fvec3::operator[](uin32 index) const
-{
-	return _arr[index];
-}
-
-fvec3 fvec3::operator-() const
-{
-	return fvec3(-x, -y, -z);
-}
-
-#ifdef USE_SIMD
-
-__m128 set(const fvec3& v)
-{
-	return _mm_set_ps(0.0f, v.z, v.y, v.x);
-}
-
-#ifdef USE_MEM_ALIGNED
-fvec3::fvec3(const __m128& vals)
-{
-	this->_vals = vals;
-}
-
-fvec3 fvec3::operator+(const fvec3& other) const
-{
-	return fvec3(_mm_add_ps(this->_vals, other._vals));
-}
-	
-fvec3& fvec3::operator+=(const fvec3& other)
-{
-	this->_vals = _mm_add_ps(this->_vals, other._vals);
-
-	return *this;
-}
-
-fvec3 fvec3::operator-(const fvec3& other) const
-{
-	return fvec3(_mm_sub_ps(this->_vals, other._vals));
-}
-
-fvec3& fvec3::operator-=(const fvec3& other)
-{
-	this->_vals = _mm_sub_ps(this->_vals, other._vals);
-		
-	return *this;
-}
-
-fvec3 fvec3::operator*(const fvec3& other) const
-{
-	return fvec3(_mm_mul_ps(this->_vals, other._vals));
-}
-
-fvec3& fvec3::operator*=(const fvec3& other)
-{
-	this->_vals = _mm_mul_ps(this->_vals, other._vals);
-
-	return *this;
-}
-
-fvec3 fvec3::operator*(flt32 val) const
-{
-	const __m128 v2 = set1(val);
-
-	return fvec3(_mm_mul_ps(this->_vals, v2));
-}
 
-fvec3& fvec3::operator*=(flt32 val)
-{
-	const __m128 v2 = set1(val);
-
-	this->_vals = _mm_mul_ps(this->_vals, v2);
-
-	return *this;
-}
-
-fvec3 fvec3::operator/(const fvec3& other) const
-{
-	return fvec3(_mm_div_ps(this->_vals, other._vals));
-}
-
-fvec3& fvec3::operator/=(const fvec3& other)
-{
-	this->_vals =_mm_div_ps(this->_vals, other._vals);
-
-	return *this;
-}
-
-fvec3 fvec3::operator/(flt32 val) const
-{
-	const __m128 v2 = set1(val);
-
-	return fvec3(_mm_div_ps(this->_vals, v2));
-}
-
-fvec3& fvec3::operator/=(flt32 val)
-{
-	const __m128 v2 = set1(val);
-
-	this->_vals = _mm_div_ps(this->_vals, v2);
-
-	return *this;
-}
-
-fvec3 fvec3::operator+(flt32 val) const
-{
-	const __m128 v2 = set1(val);
-
-	return fvec3(_mm_add_ps(this->_vals, v2));
-}
-
-fvec3& fvec3::operator+=(flt32 val)
-{
-	const __m128 v2 = set1(val);
-
-	this->_vals = _mm_add_ps(this->_vals, v2);
-
-	return *this;
-}
-
-fvec3 fvec3::operator-(flt32 val) const
-{
-	const __m128 v2 = set1(val);
-
-	return fvec3(_mm_sub_ps(this->_vals, v2));
-}
-
-fvec3& fvec3::operator-=(flt32 val)
-{
-	const __m128 v2 = set1(val);
-
-	this->_vals = _mm_sub_ps(this->_vals, v2);
-
-	return *this;
-}
-fvec3& fvec3::Normalise()
-{
-	__m128 vl = this->_vals;
-	__m128 x = _mm_dp_ps(vl, vl, 0x77);
-
-	__m128 mag = _mm_sqrt_ps(x);		// The magnitude of the Vector
-
-	*this = _mm_div_ps(vl, mag);		// Normalised vector
-
-	return *this;
-}
-
-fvec3 Normalise(const fvec3& v)
-{
-	__m128 vl = v._vals;
-	__m128 x = _mm_dp_ps(vl, vl, 0x77);
-
-	__m128 mag = _mm_sqrt_ps(x);	// The magnitude of the Vector
-
-	vl = _mm_div_ps(vl, mag);	// Normalised vector
-
-	return fvec3(vl);
-}
-
-flt32 fvec3::Dot(const fvec3& other)
-{
-	__m128 dot = _mm_dp_ps(this->_vals, other._vals, 0x77);
-
-	return dot[0];
-}
-
-flt32 Dot(const fvec3& v1, const fvec3& v2)
-{
-	__m128 dot = _mm_dp_ps(v1._vals, v2._vals, 0x77);
-
-	return dot[0];
-}
-
-fvec3& fvec3::Cross(const fvec3& other)
-{
-	__m128 v1 = this->_vals;
-	__m128 v2 = other._vals;
-
-	const __m128 i1 = _mm_shuffle_ps(v2, v2, 0x09);
-	const __m128 i2 = _mm_shuffle_ps(v1, v1, 0x12);
-
-	v1 = _mm_mul_ps(v1, i1);
-	v1 = _mm_shuffle_ps(v1, v1, 0x09);
-	v2 = _mm_mul_ps(i1, i2);
-
-	*this = _mm_sub_ps(v1, v2);
-
-	return *this;
-}
-
-fvec3 Cross(const fvec3& v1, const fvec3& v2)
-{
-	__m128 lv1 = v1._vals;
-	__m128 lv2 = v2._vals;
-
-	const __m128 i1 = _mm_shuffle_ps(lv2, lv2, 0x09);
-	const __m128 i2 = _mm_shuffle_ps(lv1, lv1, 0x12);
-
-	lv1 = _mm_mul_ps(lv1, i1);
-	lv1 = _mm_shuffle_ps(lv1, lv1, 0x09);
-	lv2 = _mm_mul_ps(i1, i2);
-
-	return fvec3(_mm_sub_ps(lv1, lv2));
-}
-
-flt32 fvec3::Distance(const fvec3& other)
-{
-	__m128 v1 = this->_vals;
-	__m128 v2 = other._vals;
-
-	v1 = _mm_sub_ps(v1, v2);
-
-	v1 = _mm_dp_ps(v1, v1, 0xFF);
-
-	v1 = _mm_sqrt_ps(v1);
-
-	return v1[0];
-}
-
-flt32 Distance(const fvec3& v1, const fvec3& v2)
-{
-	__m128 lv1 = _mm_sub_ps(v1._vals, v2._vals);
-
-	lv1 = _mm_dp_ps(lv1, lv1, 0xFF);
-
-	lv1 = _mm_sqrt_ps(lv1);
-
-	return lv1[0];
-}
-
-fvec3 fvec3::Lerp(const fvec3& b, flt32 t)
-{
-	__m128 lv1 = this->_vals;
-	__m128 lv2 = b._vals;
-
-	__m128 lt = set1(t);
-
-	__m128 bma = _mm_sub_ps(lv2, lv1);
-
-	return fvec3(_mm_fmadd_ps(lt, bma, lv1));
-}
-
-fvec3 Lerp(const fvec3& a, const fvec3& b, flt32 t)
-{
-	__m128 lv1 = a._vals;
-	__m128 lv2 = b._vals;
-
-	__m128 lt = set1(t);
-
-	__m128 bma = _mm_sub_ps(lv2, lv1);
-
-	return fvec3(_mm_fmadd_ps(lt, bma, lv1));
-}
-
-#else // USE_MEM_ALIGNED
-
-fvec3::fvec3(const __m128& vals)
-{
-	this->_arr[0] = vals[0];
-	this->_arr[1] = vals[1];
-	this->_arr[2] = vals[2];
-}
-
-fvec3 fvec3::operator+(const fvec3& other) const
-{
-	const __m128 v1 = set(*this);
-	const __m128 v2 = set(other);
-		
-	return fvec3(_mm_add_ps(v1, v2));
-}
-
-fvec3& fvec3::operator+=(const fvec3& other)
-{
-	const __m128 v1 = set(*this);
-	const __m128 v2 = set(other);
-
-	*this = _mm_add_ps(v1, v2);
-
-	return *this;
-}
-
-fvec3 fvec3::operator-(const fvec3& other) const
-{
-	const __m128 v1 = set(*this);
-	const __m128 v2 = set(other);
-		
-	return fvec3(_mm_sub_ps(v1, v2));
-}
-
-fvec3& fvec3::operator-=(const fvec3& other)
-{
-	const __m128 v1 = set(*this);
-	const __m128 v2 = set(other);
-
-	*this = _mm_sub_ps(v1, v2);
-		
-	return *this;
-}
-
-fvec3 fvec3::operator*(const fvec3& other) const
-{
-	const __m128 v1 = set(*this);
-	const __m128 v2 = set(other);
-
-	return fvec3(_mm_mul_ps(v1, v2));
-}
+/**
+ * Component-wise comparisons. Every result is a vmask3 lane mask for Select, Any/All/None, or conversion to bvec3.
+ */
+vmask3 operator==(const fvec3& a, const fvec3& b);
+vmask3 operator!=(const fvec3& a, const fvec3& b);
+vmask3 operator<(const fvec3& a, const fvec3& b);
+vmask3 operator<=(const fvec3& a, const fvec3& b);
+vmask3 operator>(const fvec3& a, const fvec3& b);
+vmask3 operator>=(const fvec3& a, const fvec3& b);
+/**
+ * Component-wise |a - b| <= epsilon.
+ */
+vmask3 ApproxEqual(const fvec3& a, const fvec3& b, flt32 epsilon = 1e-5f);
+/**
+ * Branchless per-component select: mask ? a : b.
+ */
+fvec3 Select(const vmask3& mask, const fvec3& a, const fvec3& b);
 
-fvec3& fvec3::operator*=(const fvec3& other)
+/**
+ * Loads x, y and z into the first three lanes of a simd::float4. Never reads past z; w is zero unless USE_MEM_ALIGNED.
+ *
+ * \param v The fvec3 to load.
+ * \return The loaded simd::float4.
+ */
+inline simd::float4 LoadXYZ(const fvec3& v)
 {
-	const __m128 v1 = set(*this);
-	const __m128 v2 = set(other);
-
-	*this = _mm_mul_ps(v1, v2);
-
-	return *this;
+	#ifdef USE_MEM_ALIGNED
+	return v._vals;
+	#else
+	return simd::float4::LoadXYZ(v._arr);
+	#endif
 }
 
-fvec3 fvec3::operator*(flt32 val) const
+/**
+ * Stores the first three lanes of a simd::float4 into an fvec3. Never writes past z.
+ *
+ * \param out The fvec3 to write to.
+ * \param v The simd::float4 to store.
+ */
+inline void StoreXYZ(fvec3& out, const simd::float4& v)
 {
-	const __m128 v1 = set(*this);
-	const __m128 v2 = set1(val);
-
-	return fvec3(_mm_mul_ps(v1, v2));
+	#ifdef USE_MEM_ALIGNED
+	out._vals = v;
+	#else
+	v.StoreXYZ(out._arr);
+	#endif
 }
 
-fvec3& fvec3::operator*=(flt32 val)
-{
-	const __m128 v1 = set(*this);
-	const __m128 v2 = set1(val);
+constexpr fvec3::fvec3(flt32 x, flt32 y, flt32 z) : x(x), y(y), z(z) {}
 
-	*this = _mm_mul_ps(v1, v2);
+constexpr fvec3::fvec3(flt32 val) : x(val), y(val), z(val) {}
 
-	return *this;
-}
+constexpr fvec3::fvec3(const flt32* arr) : x(arr[0]), y(arr[1]), z(arr[2]) {}
 
-fvec3 fvec3::operator/(const fvec3& other) const
-{
-	const __m128 v1 = set(*this);
-	const __m128 v2 = set(other);
+constexpr fvec3::fvec3(flt32 x, const vec2& yz) : x(x), y(yz.x), z(yz.y) {}
 
-	return fvec3(_mm_div_ps(v1, v2));
-}
+constexpr fvec3::fvec3(const vec2& xy, flt32 z) : x(xy.x), y(xy.y), z(z) {}
 
-fvec3& fvec3::operator/=(const fvec3& other)
-{
-	const __m128 v1 = set(*this);
-	const __m128 v2 = set(other);
+inline constexpr fvec3 fvec3::zero 		= fvec3();
+inline constexpr fvec3 fvec3::one 		= fvec3(1.0f);
+inline constexpr fvec3 fvec3::neg 		= fvec3(-1.0f);
 
-	*this = _mm_div_ps(v1, v2);
-
-	return *this;
-}
-
-fvec3 fvec3::operator/(flt32 val) const
-{
-	const __m128 v1 = set(*this);
-	const __m128 v2 = set1(val);
+inline constexpr fvec3 fvec3::up 		= fvec3(0.0f, 1.0f, 0.0f);
+inline constexpr fvec3 fvec3::down 		= fvec3(0.0f, -1.0f, 0.0f);
+inline constexpr fvec3 fvec3::right 	= fvec3(1.0f, 0.0f, 0.0f);
+inline constexpr fvec3 fvec3::left 		= fvec3(-1.0f, 0.0f, 0.0f);
+inline constexpr fvec3 fvec3::forward 	= fvec3(0.0f, 0.0f, 1.0f);
+inline constexpr fvec3 fvec3::back 		= fvec3(0.0f, 0.0f, -1.0f);
 
-	return fvec3(_mm_div_ps(v1, v2));
-}
-
-fvec3& fvec3::operator/=(flt32 val)
+#ifdef ENMA_IMPLEMENTATION
+ENMA_HOT_FN fvec3::operator vec2() const
 {
-	const __m128 v1 = set(*this);
-	const __m128 v2 = set1(val);
-
-	*this = _mm_div_ps(v1, v2);
-
-	return *this;
+	return vec2(this->x, this->y);
 }
 
-fvec3 fvec3::operator+(flt32 val) const
+ENMA_HOT_FN flt32 fvec3::operator[](uin32 index) const
 {
-	const __m128 v1 = set(*this);
-	const __m128 v2 = set1(val);
-
-	return fvec3(_mm_add_ps(v1, v2));
+	return _arr[index];
 }
 
-fvec3& fvec3::operator+=(flt32 val)
+ENMA_HOT_FN fvec3 fvec3::operator-() const
 {
-	const __m128 v1 = set(*this);
-	const __m128 v2 = set1(val);
-
-	*this = _mm_add_ps(v1, v2);
-
-	return *this;
+	return fvec3(-x, -y, -z);
 }
 
-fvec3 fvec3::operator-(flt32 val) const
+ENMA_HOT_FN fvec3::fvec3(const simd::float4& vals)
 {
-	const __m128 v1 = set(*this);
-	const __m128 v2 = set1(val);
-
-	return fvec3(_mm_sub_ps(v1, v2));
+	#ifdef USE_MEM_ALIGNED
+	this->_vals = vals;
+	#else
+	vals.StoreXYZ(_arr);
+	#endif
 }
 
-fvec3& fvec3::operator-=(flt32 val)
-{
-	const __m128 v1 = set(*this);
-	const __m128 v2 = set1(val);
-
-	*this = _mm_sub_ps(v1, v2);
-
-	return *this;
-}
+#ifdef USE_SIMD
+ENMA_HOT_FN fvec3::fvec3(const __m128& vals) : fvec3(simd::float4(vals)) {}
+#endif
 
-fvec3& fvec3::Normalise()
+ENMA_HOT_FN fvec3 fvec3::operator+(const fvec3& other) const
 {
-	const __m128 vl = set(*this);
-	const __m128 x = _mm_dp_ps(vl, vl, 0x77);
-
-	const __m128 mag = _mm_sqrt_ps(x);		// The magnitude of the Vector
-
-	*this = _mm_div_ps(vl, mag);			// Normalised vector
-
-	return *this;
+	return fvec3(LoadXYZ(*this) + LoadXYZ(other));
 }
 
-fvec3 Normalise(const fvec3& v)
+ENMA_HOT_FN fvec3& fvec3::operator+=(const fvec3& other)
 {
-	__m128 vl = set(v);
-	const __m128 x = _mm_dp_ps(vl, vl, 0x77);
-
-	const __m128 mag = _mm_sqrt_ps(x);	// The magnitude of the Vector
-
-	vl = _mm_div_ps(vl, mag);	// Normalised vector
-
-	return fvec3(vl);
+	return *this = *this + other;
 }
 
-flt32 fvec3::Dot(const fvec3& other)
+ENMA_HOT_FN fvec3 fvec3::operator-(const fvec3& other) const
 {
-	const __m128 v1 = set(*this);
-	const __m128 v2 = set(other);
-		
-	const __m128 dot = _mm_dp_ps(v1, v2, 0x77);
-
-	return dot[0];
+	return fvec3(LoadXYZ(*this) - LoadXYZ(other));
 }
 
-flt32 Dot(const fvec3& v1, const fvec3& v2)
+ENMA_HOT_FN fvec3& fvec3::operator-=(const fvec3& other)
 {
-	const __m128 lv1 = set(v1);
-	const __m128 lv2 = set(v2);
-		
-	const __m128 dot = _mm_dp_ps(lv1, lv2, 0x77);
-
-	return dot[0];
+	return *this = *this - other;
 }
 
-fvec3& fvec3::Cross(const fvec3& other)
+ENMA_HOT_FN fvec3 fvec3::operator*(const fvec3& other) const
 {
-	__m128 v1 = set(*this);
-	__m128 v2 = set(other);
-
-	const __m128 i1 = _mm_shuffle_ps(v2, v2, 0x09);
-	const __m128 i2 = _mm_shuffle_ps(v1, v1, 0x12);
-
-	v1 = _mm_mul_ps(v1, i1);
-	v1 = _mm_shuffle_ps(v1, v1, 0x09);
-	v2 = _mm_mul_ps(i1, i2);
-
-	*this = _mm_sub_ps(v1, v2);
-
-	return *this;
+	return fvec3(LoadXYZ(*this) * LoadXYZ(other));
 }
 
-fvec3 Cross(const fvec3& v1, const fvec3& v2)
+ENMA_HOT_FN fvec3& fvec3::operator*=(const fvec3& other)
 {
-	__m128 lv1 = set(v1);
-	__m128 lv2 = set(v2);
-
-	const __m128 i1 = _mm_shuffle_ps(lv2, lv2, 0x09);
-	const __m128 i2 = _mm_shuffle_ps(lv1, lv1, 0x12);
-
-	lv1 = _mm_mul_ps(lv1, i1);
-	lv1 = _mm_shuffle_ps(lv1, lv1, 0x09);
-	lv2 = _mm_mul_ps(i1, i2);
-
-	return fvec3(_mm_sub_ps(lv1, lv2));
+	return *this = *this * other;
 }
 
-flt32 fvec3::Distance(const fvec3& other)
+ENMA_HOT_FN fvec3 fvec3::operator*(flt32 val) const
 {
-	__m128 v1 = set(*this);
-	__m128 v2 = set(other);
-
-	v1 = _mm_sub_ps(v1, v2);
-
-	v1 = _mm_dp_ps(v1, v1, 0xFF);
-
-	v1 = _mm_sqrt_ps(v1);
-
-	return v1[0];
+	return fvec3(LoadXYZ(*this) * val);
 }
 
-flt32 Distance(const fvec3& v1, const fvec3& v2)
+ENMA_HOT_FN fvec3& fvec3::operator*=(flt32 val)
 {
-	__m128 lv1 = set(v1);
-	__m128 lv2 = set(v2);
-
-	lv1 = _mm_sub_ps(lv1, lv2);
-
-	lv1 = _mm_dp_ps(lv1, lv1, 0xFF);
-
-	lv1 = _mm_sqrt_ps(lv1);
-
-	return lv1[0];
+	return *this = *this * val;
 }
 
-fvec3 fvec3::Lerp(const fvec3& b, flt32 t)
+ENMA_HOT_FN fvec3 fvec3::operator/(const fvec3& other) const
 {
-	__m128 lv1 = set(*this);
-	__m128 lv2 = set(b);
-
-	__m128 lt = set1(t);
-
-	__m128 bma = _mm_sub_ps(lv2, lv1);
-
-	return fvec3(_mm_fmadd_ps(lt, bma, lv1));
+	return fvec3(LoadXYZ(*this) / LoadXYZ(other));
 }
 
-fvec3 Lerp(const fvec3& a, const fvec3& b, flt32 t)
+ENMA_HOT_FN fvec3& fvec3::operator/=(const fvec3& other)
 {
-	__m128 lv1 = set(a);
-	__m128 lv2 = set(b);
-
-	__m128 lt = set1(t);
-	
-	__m128 bma = _mm_sub_ps(lv2, lv1);
-
-	return fvec3(_mm_fmadd_ps(lt, bma, lv1));
+	return *this = *this / other;
 }
 
-#endif // USE_SIMD && ! USE_MEM_ALIGNED
-
-#else // ! USE_SIMD
-
-fvec3 fvec3::operator+(const fvec3& other) const
+ENMA_HOT_FN fvec3 fvec3::operator/(flt32 val) const
 {
-	return fvec3(this->x + other.x, this->y + other.y, this->z + other.z);
+	return fvec3(LoadXYZ(*this) / val);
 }
 
-fvec3& fvec3::operator+=(const fvec3& other)
+ENMA_HOT_FN fvec3& fvec3::operator/=(flt32 val)
 {
-	this->x += other.x;
-	this->y += other.y;
-	this->z += other.z;
-
-	return *this;
+	return *this = *this / val;
 }
 
-fvec3 fvec3::operator-(const fvec3& other) const
+ENMA_HOT_FN fvec3 fvec3::operator+(flt32 val) const
 {
-	return fvec3(this->x - other.x, this->y - other.y, this->z - other.z);
+	return fvec3(LoadXYZ(*this) + val);
 }
 
-fvec3& fvec3::operator-=(const fvec3& other)
+ENMA_HOT_FN fvec3& fvec3::operator+=(flt32 val)
 {
-	this->x -= other.x;
-	this->y -= other.y;
-	this->z -= other.z;
-
-	return *this;
+	return *this = *this + val;
 }
 
-fvec3 fvec3::operator*(const fvec3& other) const
+ENMA_HOT_FN fvec3 fvec3::operator-(flt32 val) const
 {
-	return fvec3(this->x * other.x, this->y * other.y, this->z * other.z);
+	return fvec3(LoadXYZ(*this) - val);
 }
 
-fvec3& fvec3::operator*=(const fvec3& other)
+ENMA_HOT_FN fvec3& fvec3::operator-=(flt32 val)
 {
-	this->x *= other.x;
-	this->y *= other.y;
-	this->z *= other.z;
-
-	return *this;
+	return *this = *this - val;
 }
 
-fvec3 fvec3::operator*(flt32 val) const
+ENMA_HOT_FN fvec3& fvec3::Normalise()
 {
-	return fvec3(this->x * val, this->y * val, this->z * val);
+	return *this = ::Normalise(*this);
 }
 
-fvec3& fvec3::operator*=(flt32 val)
+ENMA_HOT_FN fvec3 Normalise(const fvec3& v)
 {
-	this->x *= val;
-	this->y *= val;
-	this->z *= val;
+	const simd::float4 vl = LoadXYZ(v);
 
-	return *this;
+	return fvec3(vl / simd::Sqrt(simd::Dot3(vl, vl)));
 }
 
-fvec3 fvec3::operator/(const fvec3& other) const
+ENMA_HOT_FN flt32 fvec3::Dot(const fvec3& other)
 {
-
-	return fvec3(this->x / other.x, this->y / other.y, this->z / other.z);
+	return ::Dot(*this, other);
 }
 
-fvec3& fvec3::operator/=(const fvec3& other)
+ENMA_HOT_FN flt32 Dot(const fvec3& v1, const fvec3& v2)
 {
-	this->x /= other.x;
-	this->y /= other.y;
-	this->z /= other.z;
-
-	return *this;
+	return simd::Dot3(LoadXYZ(v1), LoadXYZ(v2)).X();
 }
 
-fvec3 fvec3::operator/(flt32 val) const
+ENMA_HOT_FN fvec3& fvec3::Cross(const fvec3& other)
 {
-	const flt32 rec = 1.0f / val;
-
-	return fvec3(this->x * rec, this->y * rec, this->z * rec);
+	return *this = ::Cross(*this, other);
 }
 
-fvec3& fvec3::operator/=(flt32 val)
+ENMA_HOT_FN fvec3 Cross(const fvec3& v1, const fvec3& v2)
 {
-	const flt32 rec = 1.0f / val;
+	const simd::float4 a = LoadXYZ(v1);
+	const simd::float4 b = LoadXYZ(v2);
 
-	this->x *= rec;
-	this->y *= rec;
-	this->z *= rec;
+	// a * b.yzx - a.yzx * b, then rotated back to xyz
+	const simd::float4 c = simd::Fmsub(a, simd::Shuffle<1, 2, 0, 3>(b), simd::Shuffle<1, 2, 0, 3>(a) * b);
 
-	return *this;
+	return fvec3(simd::Shuffle<1, 2, 0, 3>(c));
 }
 
-fvec3 fvec3::operator+(flt32 val) const
+ENMA_HOT_FN flt32 fvec3::Distance(const fvec3& other)
 {
-
-	return fvec3(this->x + val, this->y + val, this->z + val);
+	return ::Distance(*this, other);
 }
 
-fvec3& fvec3::operator+=(flt32 val)
+ENMA_HOT_FN flt32 Distance(const fvec3& v1, const fvec3& v2)
 {
-	this->x += val;
-	this->y += val;
-	this->z += val;
+	const simd::float4 d = LoadXYZ(v1) - LoadXYZ(v2);
 
-	return *this;
+	return simd::Sqrt(simd::Dot3(d, d)).X();
 }
 
-fvec3 fvec3::operator-(flt32 val) const
+ENMA_HOT_FN fvec3 fvec3::Lerp(const fvec3& b, flt32 t)
 {
-
-	return fvec3(this->x - val, this->y - val, this->z - val);
+	return ::Lerp(*this, b, t);
 }
 
-fvec3& fvec3::operator-=(flt32 val)
+ENMA_HOT_FN fvec3 Lerp(const fvec3& a, const fvec3& b, flt32 t)
 {
-	this->x -= val;
-	this->y -= val;
-	this->z -= val;
+	const simd::float4 lv1 = LoadXYZ(a);
 
-	return *this;
+	return fvec3(simd::Fmadd(simd::float4::Set1(t), LoadXYZ(b) - lv1, lv1));
 }
 
-/*bvec3 fvec3::Equals(const fvec3 &other)
+ENMA_HOT_FN vmask3 operator==(const fvec3& a, const fvec3& b)
 {
-	return bvec3(this->x == other.x, this->y == other.y);
-}*/
-
-fvec3& fvec3::Normalise()
-{
-	flt32 xt = this->x * this->x;
-	flt32 yt = this->y * this->y;
-	flt32 zt = this->z * this->z;
-
-	const flt32 mag = 1.0f / sqrt(xt + yt + zt);
-	*this *= mag;
-
-	return *this;
+	return vmask3(simd::AsInt(simd::CmpEq(LoadXYZ(a), LoadXYZ(b))));
 }
 
-fvec3 Normalise(const fvec3& v)
+ENMA_HOT_FN vmask3 operator!=(const fvec3& a, const fvec3& b)
 {
-	fvec3 res = v;
-	flt32 xt = v.x * v.x;
-	flt32 yt = v.y * v.y;
-	flt32 zt = v.z * v.z;
-
-	const flt32 mag = 1.0f / sqrt(xt + yt + zt);
-	res *= mag;
-
-	return res;
+	return vmask3(simd::AsInt(simd::CmpNeq(LoadXYZ(a), LoadXYZ(b))));
 }
 
-flt32 fvec3::Dot(const fvec3& other)
+ENMA_HOT_FN vmask3 operator<(const fvec3& a, const fvec3& b)
 {
-    return this->x * other.x + this->y * other.y + this->z * other.z;
+	return vmask3(simd::AsInt(simd::CmpLt(LoadXYZ(a), LoadXYZ(b))));
 }
 
-flt32 Dot(const fvec3& v1, const fvec3& v2)
+ENMA_HOT_FN vmask3 operator<=(const fvec3& a, const fvec3& b)
 {
-	return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z;
+	return vmask3(simd::AsInt(simd::CmpLe(LoadXYZ(a), LoadXYZ(b))));
 }
 
-fvec3& fvec3::Cross(const fvec3& other)
+ENMA_HOT_FN vmask3 operator>(const fvec3& a, const fvec3& b)
 {
-	*this = fvec3(this->y * other.z - this->z * other.y, this->z * other.x - this->x * other.z, this->x * other.y - this->y * other.x);
-	return *this;
+	return vmask3(simd::AsInt(simd::CmpGt(LoadXYZ(a), LoadXYZ(b))));
 }
 
-fvec3 Cross(const fvec3& v1, const fvec3& v2)
+ENMA_HOT_FN vmask3 operator>=(const fvec3& a, const fvec3& b)
 {
-	return fvec3(v1.y * v2.z - v1.z * v2.y, v1.z * v2.x - v1.x * v2.z, v1.x * v2.y - v1.y * v2.x);
+	return vmask3(simd::AsInt(simd::CmpGe(LoadXYZ(a), LoadXYZ(b))));
 }
 
-flt32 fvec3::Distance(const fvec3& other)
+ENMA_HOT_FN vmask3 ApproxEqual(const fvec3& a, const fvec3& b, flt32 epsilon)
 {
-	flt32 dx = this->x - other.x;
-	flt32 dy = this->y - other.y;
-	flt32 dz = this->z - other.z;
-
-	return sqrt(dx * dx + dy * dy + dz * dz);
+	return vmask3(simd::AsInt(simd::CmpLe(simd::Abs(LoadXYZ(a) - LoadXYZ(b)), simd::float4::Set1(epsilon))));
 }
 
-flt32 Distance(const fvec3& v1, const fvec3& v2)
+ENMA_HOT_FN fvec3 Select(const vmask3& mask, const fvec3& a, const fvec3& b)
 {
-	flt32 dx = v1.x - v2.x;
-	flt32 dy = v1.y - v2.y;
-	flt32 dz = v1.z - v2.z;
-
-	return sqrt(dx * dx + dy * dy + dz * dz);
+	return fvec3(simd::Select(simd::AsFloat(mask.lanes), LoadXYZ(a), LoadXYZ(b)));
 }
 
-#endif
-
-const fvec3 fvec3::zero 	= vec3();
-const fvec3 fvec3::one 		= vec3(1.0f);
-const fvec3 fvec3::neg 		= vec3(-1.0f);
-
-const fvec3 fvec3::up 		= vec3(0.0f, 1.0f, 0.0f);
-const fvec3 fvec3::down 	= vec3(0.0f, -1.0f, 0.0f);
-const fvec3 fvec3::right 	= vec3(1.0f, 0.0f, 0.0f);
-const fvec3 fvec3::left 	= vec3(-1.0f, 0.0f, 0.0f);
-const fvec3 fvec3::forward 	= vec3(0.0f, 0.0f, 1.0f);
-const fvec3 fvec3::back 	= vec3(0.0f, 0.0f, -1.0f);
-
 #endif	// ENMA_IMPLEMENTATION
 
 //////////////////////////////////////////////////////
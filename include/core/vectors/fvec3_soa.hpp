@@ -0,0 +1,855 @@
+/* Structure-of-Arrays Stream of 3 Component Single Precision Floating-Point Vectors
+ *
+ * This header file is part of Enmatica library
+ *
+ * Copyright (c) 202X by Villainous Softworks
+ *
+ */
+
+#pragma once
+#include "fvec3.hpp"
+#include "../../base.hpp"
+#include "../../empch.hpp"
+#include "../simd.hpp"
+#include <cassert>
+
+/**
+ * A stream of fvec3 stored as three separate component arrays.
+ *
+ * The x, y and z arrays are 64-byte aligned and padded to a multiple of 16 elements
+ * so that every bulk operation processes 16 vectors per __m512 (or 8 per __m256)
+ * with full lane use and no scalar tail. Padding lanes are zero-filled and never read back.
+ * Functions writing to a plain flt32 array (Dot, Distance) write exactly `count` elements.
+ */
+struct fvec3_soa
+{
+	flt32* x;
+	flt32* y;
+	flt32* z;
+
+	uin32 count;		// Number of vectors stored
+	uin32 capacity;		// Number of allocated lanes, always a multiple of 16
+
+	/**
+	 * Constructor with a vector count.
+	 *
+	 * \param count Number of vectors to allocate. All components are zero-initialised.
+	 */
+	explicit fvec3_soa(uin32 count = 0);
+	/**
+	 * Array constructor.
+	 *
+	 * Transposes an array of fvec3 into component arrays.
+	 *
+	 * \param vecs Pointer to an array of at least `count` fvec3 elements.
+	 * \param count Number of vectors to copy.
+	 */
+	fvec3_soa(const fvec3* vecs, uin32 count);
+	/**
+	 * Copy constructor.
+	 *
+	 * \param s Another fvec3_soa to copy from.
+	 */
+	fvec3_soa(const fvec3_soa& s);
+	/**
+	 * Move constructor.
+	 *
+	 * \param s Another fvec3_soa whose storage is taken over.
+	 */
+	fvec3_soa(fvec3_soa&& s) noexcept;
+	~fvec3_soa();
+
+	fvec3_soa& operator=(const fvec3_soa& s);
+	fvec3_soa& operator=(fvec3_soa&& s) noexcept;
+
+	/**
+	 * Indexing operator.
+	 *
+	 * \param index Index of the vector to gather.
+	 * \return The fvec3 stored at the specified `index`.
+	 */
+	fvec3 operator[](uin32 index) const;
+	/**
+	 * Scatters a vector into the stream.
+	 *
+	 * \param index Index of the vector to overwrite.
+	 * \param v The fvec3 to store.
+	 */
+	void Set(uin32 index, const fvec3& v);
+	/**
+	 * Transposes the stream back into an array of fvec3.
+	 *
+	 * \param out Pointer to an array of at least `count` fvec3 elements.
+	 */
+	void Store(fvec3* out) const;
+
+	/**
+	 * Addition assignment operator.
+	 *
+	 * \param other The other fvec3_soa. Must hold the same number of vectors.
+	 * \return Reference to the modified fvec3_soa after addition.
+	 */
+	fvec3_soa& operator+=(const fvec3_soa& other);
+	/**
+	 * Subtraction assignment operator.
+	 *
+	 * \param other The other fvec3_soa. Must hold the same number of vectors.
+	 * \return Reference to the modified fvec3_soa after subtraction.
+	 */
+	fvec3_soa& operator-=(const fvec3_soa& other);
+	/**
+	 * Multiplication assignment operator (element-wise).
+	 *
+	 * \param other The other fvec3_soa. Must hold the same number of vectors.
+	 * \return Reference to the modified fvec3_soa after multiplication.
+	 */
+	fvec3_soa& operator*=(const fvec3_soa& other);
+	/**
+	 * Multiplication assignment operator (scalar).
+	 *
+	 * \param val A scalar value.
+	 * \return Reference to the modified fvec3_soa after multiplication.
+	 */
+	fvec3_soa& operator*=(flt32 val);
+
+	/**
+	 * Normalises every vector in the stream. Zero-length vectors stay zero.
+	 *
+	 * \return Reference to the modified fvec3_soa after normalisation.
+	 */
+	fvec3_soa& Normalise();
+};
+
+/**
+ * Adds two streams component-wise: out[i] = a[i] + b[i].
+ */
+void Add(const fvec3_soa& a, const fvec3_soa& b, fvec3_soa& out);
+/**
+ * Subtracts two streams component-wise: out[i] = a[i] - b[i].
+ */
+void Sub(const fvec3_soa& a, const fvec3_soa& b, fvec3_soa& out);
+/**
+ * Multiplies two streams component-wise: out[i] = a[i] * b[i].
+ */
+void Mul(const fvec3_soa& a, const fvec3_soa& b, fvec3_soa& out);
+/**
+ * Fused multiply-add over three streams: out[i] = a[i] * b[i] + c[i].
+ */
+void Fma(const fvec3_soa& a, const fvec3_soa& b, const fvec3_soa& c, fvec3_soa& out);
+/**
+ * Calculates the dot product of every pair of vectors.
+ *
+ * \param a The first fvec3_soa.
+ * \param b The second fvec3_soa.
+ * \param out Pointer to an array of at least `a.count` flt32 elements.
+ */
+void Dot(const fvec3_soa& a, const fvec3_soa& b, flt32* out);
+/**
+ * Calculates the cross product of every pair of vectors: out[i] = a[i] x b[i].
+ */
+void Cross(const fvec3_soa& a, const fvec3_soa& b, fvec3_soa& out);
+/**
+ * Normalises every vector of `v` into `out`. Zero-length vectors normalise to zero.
+ */
+void Normalise(const fvec3_soa& v, fvec3_soa& out);
+/**
+ * Calculates the distance between every pair of vectors.
+ *
+ * \param a The first fvec3_soa.
+ * \param b The second fvec3_soa.
+ * \param out Pointer to an array of at least `a.count` flt32 elements.
+ */
+void Distance(const fvec3_soa& a, const fvec3_soa& b, flt32* out);
+/**
+ * Linearly interpolates every pair of vectors: out[i] = a[i] + t * (b[i] - a[i]).
+ */
+void Lerp(const fvec3_soa& a, const fvec3_soa& b, flt32 t, fvec3_soa& out);
+
+#ifdef ENMA_IMPLEMENTATION
+inline uin32 SoaCapacity(uin32 count)
+{
+	return (count + 15u) & ~15u;
+}
+
+template <typename T = flt32>
+inline T* SoaAlloc(uin32 capacity)
+{
+	if(capacity == 0)
+	{
+		return nullptr;
+	}
+
+	T* p = static_cast<T*>(_mm_malloc(sizeof(T) * capacity, 64));
+	std::fill(p, p + capacity, T(0));
+
+	return p;
+}
+
+ENMA_FN fvec3_soa::fvec3_soa(uin32 count) : count(count), capacity(SoaCapacity(count))
+{
+	this->x = SoaAlloc(capacity);
+	this->y = SoaAlloc(capacity);
+	this->z = SoaAlloc(capacity);
+}
+
+ENMA_FN fvec3_soa::fvec3_soa(const fvec3* vecs, uin32 count) : fvec3_soa(count)
+{
+	for(uin32 i = 0; i < count; i++)
+	{
+		this->x[i] = vecs[i].x;
+		this->y[i] = vecs[i].y;
+		this->z[i] = vecs[i].z;
+	}
+}
+
+ENMA_FN fvec3_soa::fvec3_soa(const fvec3_soa& s) : fvec3_soa(s.count)
+{
+	std::copy(s.x, s.x + capacity, this->x);
+	std::copy(s.y, s.y + capacity, this->y);
+	std::copy(s.z, s.z + capacity, this->z);
+}
+
+ENMA_FN fvec3_soa::fvec3_soa(fvec3_soa&& s) noexcept : x(s.x), y(s.y), z(s.z), count(s.count), capacity(s.capacity)
+{
+	s.x = s.y = s.z = nullptr;
+	s.count = s.capacity = 0;
+}
+
+ENMA_FN fvec3_soa::~fvec3_soa()
+{
+	_mm_free(this->x);
+	_mm_free(this->y);
+	_mm_free(this->z);
+}
+
+ENMA_FN fvec3_soa& fvec3_soa::operator=(const fvec3_soa& s)
+{
+	if(this != &s)
+	{
+		*this = fvec3_soa(s);
+	}
+
+	return *this;
+}
+
+ENMA_FN fvec3_soa& fvec3_soa::operator=(fvec3_soa&& s) noexcept
+{
+	std::swap(this->x, s.x);
+	std::swap(this->y, s.y);
+	std::swap(this->z, s.z);
+	std::swap(this->count, s.count);
+	std::swap(this->capacity, s.capacity);
+
+	return *this;
+}
+
+ENMA_FN fvec3 fvec3_soa::operator[](uin32 index) const
+{
+	return fvec3(x[index], y[index], z[index]);
+}
+
+ENMA_FN void fvec3_soa::Set(uin32 index, const fvec3& v)
+{
+	this->x[index] = v.x;
+	this->y[index] = v.y;
+	this->z[index] = v.z;
+}
+
+ENMA_FN void fvec3_soa::Store(fvec3* out) const
+{
+	for(uin32 i = 0; i < count; i++)
+	{
+		out[i] = fvec3(x[i], y[i], z[i]);
+	}
+}
+
+// Stores the first `n` lanes of `v`, the flt32 outputs end at `count` rather than at the padded capacity
+inline void SoaStoreN(const simd::float4& v, flt32* p, uin32 n)
+{
+	if(n >= 4)
+	{
+		v.StoreU(p);
+		return;
+	}
+
+	alignas(16) flt32 lanes[4];
+	v.Store(lanes);
+	std::copy(lanes, lanes + n, p);
+}
+
+// The baseline kernels are written on the SIMD layer; without USE_SIMD they run on its scalar fallback
+ENMA_FN void ScaleSSE41(fvec3_soa& v, flt32 val)
+{
+	using namespace simd;
+
+	for(uin32 i = 0; i < v.capacity; i += 4)
+	{
+		(float4::Load(v.x + i) * val).Store(v.x + i);
+		(float4::Load(v.y + i) * val).Store(v.y + i);
+		(float4::Load(v.z + i) * val).Store(v.z + i);
+	}
+}
+
+ENMA_FN void AddSSE41(const fvec3_soa& a, const fvec3_soa& b, fvec3_soa& out)
+{
+	using namespace simd;
+
+	for(uin32 i = 0; i < a.capacity; i += 4)
+	{
+		(float4::Load(a.x + i) + float4::Load(b.x + i)).Store(out.x + i);
+		(float4::Load(a.y + i) + float4::Load(b.y + i)).Store(out.y + i);
+		(float4::Load(a.z + i) + float4::Load(b.z + i)).Store(out.z + i);
+	}
+}
+
+ENMA_FN void SubSSE41(const fvec3_soa& a, const fvec3_soa& b, fvec3_soa& out)
+{
+	using namespace simd;
+
+	for(uin32 i = 0; i < a.capacity; i += 4)
+	{
+		(float4::Load(a.x + i) - float4::Load(b.x + i)).Store(out.x + i);
+		(float4::Load(a.y + i) - float4::Load(b.y + i)).Store(out.y + i);
+		(float4::Load(a.z + i) - float4::Load(b.z + i)).Store(out.z + i);
+	}
+}
+
+ENMA_FN void MulSSE41(const fvec3_soa& a, const fvec3_soa& b, fvec3_soa& out)
+{
+	using namespace simd;
+
+	for(uin32 i = 0; i < a.capacity; i += 4)
+	{
+		(float4::Load(a.x + i) * float4::Load(b.x + i)).Store(out.x + i);
+		(float4::Load(a.y + i) * float4::Load(b.y + i)).Store(out.y + i);
+		(float4::Load(a.z + i) * float4::Load(b.z + i)).Store(out.z + i);
+	}
+}
+
+ENMA_FN void FmaSSE41(const fvec3_soa& a, const fvec3_soa& b, const fvec3_soa& c, fvec3_soa& out)
+{
+	using namespace simd;
+
+	for(uin32 i = 0; i < a.capacity; i += 4)
+	{
+		Fmadd(float4::Load(a.x + i), float4::Load(b.x + i), float4::Load(c.x + i)).Store(out.x + i);
+		Fmadd(float4::Load(a.y + i), float4::Load(b.y + i), float4::Load(c.y + i)).Store(out.y + i);
+		Fmadd(float4::Load(a.z + i), float4::Load(b.z + i), float4::Load(c.z + i)).Store(out.z + i);
+	}
+}
+
+ENMA_FN void DotSSE41(const fvec3_soa& a, const fvec3_soa& b, flt32* out)
+{
+	using namespace simd;
+
+	for(uin32 i = 0; i < a.count; i += 4)
+	{
+		float4 d = float4::Load(a.x + i) * float4::Load(b.x + i);
+		d = Fmadd(float4::Load(a.y + i), float4::Load(b.y + i), d);
+		d = Fmadd(float4::Load(a.z + i), float4::Load(b.z + i), d);
+
+		SoaStoreN(d, out + i, a.count - i);
+	}
+}
+
+ENMA_FN void CrossSSE41(const fvec3_soa& a, const fvec3_soa& b, fvec3_soa& out)
+{
+	using namespace simd;
+
+	for(uin32 i = 0; i < a.capacity; i += 4)
+	{
+		const float4 ax = float4::Load(a.x + i);
+		const float4 ay = float4::Load(a.y + i);
+		const float4 az = float4::Load(a.z + i);
+
+		const float4 bx = float4::Load(b.x + i);
+		const float4 by = float4::Load(b.y + i);
+		const float4 bz = float4::Load(b.z + i);
+
+		Fmsub(ay, bz, az * by).Store(out.x + i);
+		Fmsub(az, bx, ax * bz).Store(out.y + i);
+		Fmsub(ax, by, ay * bx).Store(out.z + i);
+	}
+}
+
+ENMA_FN void NormaliseSSE41(const fvec3_soa& v, fvec3_soa& out)
+{
+	using namespace simd;
+
+	for(uin32 i = 0; i < v.capacity; i += 4)
+	{
+		const float4 vx = float4::Load(v.x + i);
+		const float4 vy = float4::Load(v.y + i);
+		const float4 vz = float4::Load(v.z + i);
+
+		float4 mag = vx * vx;
+		mag = Fmadd(vy, vy, mag);
+		mag = Fmadd(vz, vz, mag);
+		mag = Sqrt(mag);		// The magnitude of the Vectors
+
+		// Zero-length vectors, padding lanes included, stay zero instead of turning into NaN
+		const float4 nonZero = CmpGt(mag, float4::Zero());
+
+		And(vx / mag, nonZero).Store(out.x + i);
+		And(vy / mag, nonZero).Store(out.y + i);
+		And(vz / mag, nonZero).Store(out.z + i);
+	}
+}
+
+ENMA_FN void DistanceSSE41(const fvec3_soa& a, const fvec3_soa& b, flt32* out)
+{
+	using namespace simd;
+
+	for(uin32 i = 0; i < a.count; i += 4)
+	{
+		const float4 dx = float4::Load(a.x + i) - float4::Load(b.x + i);
+		const float4 dy = float4::Load(a.y + i) - float4::Load(b.y + i);
+		const float4 dz = float4::Load(a.z + i) - float4::Load(b.z + i);
+
+		float4 d = dx * dx;
+		d = Fmadd(dy, dy, d);
+		d = Fmadd(dz, dz, d);
+
+		SoaStoreN(Sqrt(d), out + i, a.count - i);
+	}
+}
+
+ENMA_FN void LerpSSE41(const fvec3_soa& a, const fvec3_soa& b, flt32 t, fvec3_soa& out)
+{
+	using namespace simd;
+
+	const float4 lt = float4::Set1(t);
+
+	for(uin32 i = 0; i < a.capacity; i += 4)
+	{
+		const float4 ax = float4::Load(a.x + i);
+		const float4 ay = float4::Load(a.y + i);
+		const float4 az = float4::Load(a.z + i);
+
+		Fmadd(lt, float4::Load(b.x + i) - ax, ax).Store(out.x + i);
+		Fmadd(lt, float4::Load(b.y + i) - ay, ay).Store(out.y + i);
+		Fmadd(lt, float4::Load(b.z + i) - az, az).Store(out.z + i);
+	}
+}
+
+#ifdef USE_SIMD
+ENMA_FN ENMA_TARGET_AVX2 void ScaleAVX2(fvec3_soa& v, flt32 val)
+{
+	const __m256 s = _mm256_set1_ps(val);
+
+	for(uin32 i = 0; i < v.capacity; i += 8)
+	{
+		_mm256_store_ps(v.x + i, _mm256_mul_ps(_mm256_load_ps(v.x + i), s));
+		_mm256_store_ps(v.y + i, _mm256_mul_ps(_mm256_load_ps(v.y + i), s));
+		_mm256_store_ps(v.z + i, _mm256_mul_ps(_mm256_load_ps(v.z + i), s));
+	}
+}
+
+ENMA_FN ENMA_TARGET_AVX2 void AddAVX2(const fvec3_soa& a, const fvec3_soa& b, fvec3_soa& out)
+{
+	for(uin32 i = 0; i < a.capacity; i += 8)
+	{
+		_mm256_store_ps(out.x + i, _mm256_add_ps(_mm256_load_ps(a.x + i), _mm256_load_ps(b.x + i)));
+		_mm256_store_ps(out.y + i, _mm256_add_ps(_mm256_load_ps(a.y + i), _mm256_load_ps(b.y + i)));
+		_mm256_store_ps(out.z + i, _mm256_add_ps(_mm256_load_ps(a.z + i), _mm256_load_ps(b.z + i)));
+	}
+}
+
+ENMA_FN ENMA_TARGET_AVX2 void SubAVX2(const fvec3_soa& a, const fvec3_soa& b, fvec3_soa& out)
+{
+	for(uin32 i = 0; i < a.capacity; i += 8)
+	{
+		_mm256_store_ps(out.x + i, _mm256_sub_ps(_mm256_load_ps(a.x + i), _mm256_load_ps(b.x + i)));
+		_mm256_store_ps(out.y + i, _mm256_sub_ps(_mm256_load_ps(a.y + i), _mm256_load_ps(b.y + i)));
+		_mm256_store_ps(out.z + i, _mm256_sub_ps(_mm256_load_ps(a.z + i), _mm256_load_ps(b.z + i)));
+	}
+}
+
+ENMA_FN ENMA_TARGET_AVX2 void MulAVX2(const fvec3_soa& a, const fvec3_soa& b, fvec3_soa& out)
+{
+	for(uin32 i = 0; i < a.capacity; i += 8)
+	{
+		_mm256_store_ps(out.x + i, _mm256_mul_ps(_mm256_load_ps(a.x + i), _mm256_load_ps(b.x + i)));
+		_mm256_store_ps(out.y + i, _mm256_mul_ps(_mm256_load_ps(a.y + i), _mm256_load_ps(b.y + i)));
+		_mm256_store_ps(out.z + i, _mm256_mul_ps(_mm256_load_ps(a.z + i), _mm256_load_ps(b.z + i)));
+	}
+}
+
+ENMA_FN ENMA_TARGET_AVX2 void FmaAVX2(const fvec3_soa& a, const fvec3_soa& b, const fvec3_soa& c, fvec3_soa& out)
+{
+	for(uin32 i = 0; i < a.capacity; i += 8)
+	{
+		_mm256_store_ps(out.x + i, _mm256_fmadd_ps(_mm256_load_ps(a.x + i), _mm256_load_ps(b.x + i), _mm256_load_ps(c.x + i)));
+		_mm256_store_ps(out.y + i, _mm256_fmadd_ps(_mm256_load_ps(a.y + i), _mm256_load_ps(b.y + i), _mm256_load_ps(c.y + i)));
+		_mm256_store_ps(out.z + i, _mm256_fmadd_ps(_mm256_load_ps(a.z + i), _mm256_load_ps(b.z + i), _mm256_load_ps(c.z + i)));
+	}
+}
+
+ENMA_FN ENMA_TARGET_AVX2 void DotAVX2(const fvec3_soa& a, const fvec3_soa& b, flt32* out)
+{
+	const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+	for(uin32 i = 0; i < a.count; i += 8)
+	{
+		__m256 d = _mm256_mul_ps(_mm256_load_ps(a.x + i), _mm256_load_ps(b.x + i));
+		d = _mm256_fmadd_ps(_mm256_load_ps(a.y + i), _mm256_load_ps(b.y + i), d);
+		d = _mm256_fmadd_ps(_mm256_load_ps(a.z + i), _mm256_load_ps(b.z + i), d);
+
+		if(a.count - i >= 8)
+			_mm256_storeu_ps(out + i, d);
+		else
+			_mm256_maskstore_ps(out + i, _mm256_cmpgt_epi32(_mm256_set1_epi32(int32(a.count - i)), lanes), d);
+	}
+}
+
+ENMA_FN ENMA_TARGET_AVX2 void CrossAVX2(const fvec3_soa& a, const fvec3_soa& b, fvec3_soa& out)
+{
+	for(uin32 i = 0; i < a.capacity; i += 8)
+	{
+		const __m256 ax = _mm256_load_ps(a.x + i);
+		const __m256 ay = _mm256_load_ps(a.y + i);
+		const __m256 az = _mm256_load_ps(a.z + i);
+
+		const __m256 bx = _mm256_load_ps(b.x + i);
+		const __m256 by = _mm256_load_ps(b.y + i);
+		const __m256 bz = _mm256_load_ps(b.z + i);
+
+		_mm256_store_ps(out.x + i, _mm256_fmsub_ps(ay, bz, _mm256_mul_ps(az, by)));
+		_mm256_store_ps(out.y + i, _mm256_fmsub_ps(az, bx, _mm256_mul_ps(ax, bz)));
+		_mm256_store_ps(out.z + i, _mm256_fmsub_ps(ax, by, _mm256_mul_ps(ay, bx)));
+	}
+}
+
+ENMA_FN ENMA_TARGET_AVX2 void NormaliseAVX2(const fvec3_soa& v, fvec3_soa& out)
+{
+	for(uin32 i = 0; i < v.capacity; i += 8)
+	{
+		const __m256 vx = _mm256_load_ps(v.x + i);
+		const __m256 vy = _mm256_load_ps(v.y + i);
+		const __m256 vz = _mm256_load_ps(v.z + i);
+
+		__m256 mag = _mm256_mul_ps(vx, vx);
+		mag = _mm256_fmadd_ps(vy, vy, mag);
+		mag = _mm256_fmadd_ps(vz, vz, mag);
+		mag = _mm256_sqrt_ps(mag);		// The magnitude of the Vectors
+
+		const __m256 nonZero = _mm256_cmp_ps(mag, _mm256_setzero_ps(), _CMP_GT_OQ);
+
+		_mm256_store_ps(out.x + i, _mm256_and_ps(_mm256_div_ps(vx, mag), nonZero));
+		_mm256_store_ps(out.y + i, _mm256_and_ps(_mm256_div_ps(vy, mag), nonZero));
+		_mm256_store_ps(out.z + i, _mm256_and_ps(_mm256_div_ps(vz, mag), nonZero));
+	}
+}
+
+ENMA_FN ENMA_TARGET_AVX2 void DistanceAVX2(const fvec3_soa& a, const fvec3_soa& b, flt32* out)
+{
+	const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+	for(uin32 i = 0; i < a.count; i += 8)
+	{
+		const __m256 dx = _mm256_sub_ps(_mm256_load_ps(a.x + i), _mm256_load_ps(b.x + i));
+		const __m256 dy = _mm256_sub_ps(_mm256_load_ps(a.y + i), _mm256_load_ps(b.y + i));
+		const __m256 dz = _mm256_sub_ps(_mm256_load_ps(a.z + i), _mm256_load_ps(b.z + i));
+
+		__m256 d = _mm256_mul_ps(dx, dx);
+		d = _mm256_fmadd_ps(dy, dy, d);
+		d = _mm256_fmadd_ps(dz, dz, d);
+
+		d = _mm256_sqrt_ps(d);
+
+		if(a.count - i >= 8)
+			_mm256_storeu_ps(out + i, d);
+		else
+			_mm256_maskstore_ps(out + i, _mm256_cmpgt_epi32(_mm256_set1_epi32(int32(a.count - i)), lanes), d);
+	}
+}
+
+ENMA_FN ENMA_TARGET_AVX2 void LerpAVX2(const fvec3_soa& a, const fvec3_soa& b, flt32 t, fvec3_soa& out)
+{
+	const __m256 lt = _mm256_set1_ps(t);
+
+	for(uin32 i = 0; i < a.capacity; i += 8)
+	{
+		const __m256 ax = _mm256_load_ps(a.x + i);
+		const __m256 ay = _mm256_load_ps(a.y + i);
+		const __m256 az = _mm256_load_ps(a.z + i);
+
+		_mm256_store_ps(out.x + i, _mm256_fmadd_ps(lt, _mm256_sub_ps(_mm256_load_ps(b.x + i), ax), ax));
+		_mm256_store_ps(out.y + i, _mm256_fmadd_ps(lt, _mm256_sub_ps(_mm256_load_ps(b.y + i), ay), ay));
+		_mm256_store_ps(out.z + i, _mm256_fmadd_ps(lt, _mm256_sub_ps(_mm256_load_ps(b.z + i), az), az));
+	}
+}
+
+ENMA_FN ENMA_TARGET_AVX512 void ScaleAVX512(fvec3_soa& v, flt32 val)
+{
+	const __m512 s = _mm512_set1_ps(val);
+
+	for(uin32 i = 0; i < v.capacity; i += 16)
+	{
+		_mm512_store_ps(v.x + i, _mm512_mul_ps(_mm512_load_ps(v.x + i), s));
+		_mm512_store_ps(v.y + i, _mm512_mul_ps(_mm512_load_ps(v.y + i), s));
+		_mm512_store_ps(v.z + i, _mm512_mul_ps(_mm512_load_ps(v.z + i), s));
+	}
+}
+
+ENMA_FN ENMA_TARGET_AVX512 void AddAVX512(const fvec3_soa& a, const fvec3_soa& b, fvec3_soa& out)
+{
+	for(uin32 i = 0; i < a.capacity; i += 16)
+	{
+		_mm512_store_ps(out.x + i, _mm512_add_ps(_mm512_load_ps(a.x + i), _mm512_load_ps(b.x + i)));
+		_mm512_store_ps(out.y + i, _mm512_add_ps(_mm512_load_ps(a.y + i), _mm512_load_ps(b.y + i)));
+		_mm512_store_ps(out.z + i, _mm512_add_ps(_mm512_load_ps(a.z + i), _mm512_load_ps(b.z + i)));
+	}
+}
+
+ENMA_FN ENMA_TARGET_AVX512 void SubAVX512(const fvec3_soa& a, const fvec3_soa& b, fvec3_soa& out)
+{
+	for(uin32 i = 0; i < a.capacity; i += 16)
+	{
+		_mm512_store_ps(out.x + i, _mm512_sub_ps(_mm512_load_ps(a.x + i), _mm512_load_ps(b.x + i)));
+		_mm512_store_ps(out.y + i, _mm512_sub_ps(_mm512_load_ps(a.y + i), _mm512_load_ps(b.y + i)));
+		_mm512_store_ps(out.z + i, _mm512_sub_ps(_mm512_load_ps(a.z + i), _mm512_load_ps(b.z + i)));
+	}
+}
+
+ENMA_FN ENMA_TARGET_AVX512 void MulAVX512(const fvec3_soa& a, const fvec3_soa& b, fvec3_soa& out)
+{
+	for(uin32 i = 0; i < a.capacity; i += 16)
+	{
+		_mm512_store_ps(out.x + i, _mm512_mul_ps(_mm512_load_ps(a.x + i), _mm512_load_ps(b.x + i)));
+		_mm512_store_ps(out.y + i, _mm512_mul_ps(_mm512_load_ps(a.y + i), _mm512_load_ps(b.y + i)));
+		_mm512_store_ps(out.z + i, _mm512_mul_ps(_mm512_load_ps(a.z + i), _mm512_load_ps(b.z + i)));
+	}
+}
+
+ENMA_FN ENMA_TARGET_AVX512 void FmaAVX512(const fvec3_soa& a, const fvec3_soa& b, const fvec3_soa& c, fvec3_soa& out)
+{
+	for(uin32 i = 0; i < a.capacity; i += 16)
+	{
+		_mm512_store_ps(out.x + i, _mm512_fmadd_ps(_mm512_load_ps(a.x + i), _mm512_load_ps(b.x + i), _mm512_load_ps(c.x + i)));
+		_mm512_store_ps(out.y + i, _mm512_fmadd_ps(_mm512_load_ps(a.y + i), _mm512_load_ps(b.y + i), _mm512_load_ps(c.y + i)));
+		_mm512_store_ps(out.z + i, _mm512_fmadd_ps(_mm512_load_ps(a.z + i), _mm512_load_ps(b.z + i), _mm512_load_ps(c.z + i)));
+	}
+}
+
+ENMA_FN ENMA_TARGET_AVX512 void DotAVX512(const fvec3_soa& a, const fvec3_soa& b, flt32* out)
+{
+	for(uin32 i = 0; i < a.count; i += 16)
+	{
+		__m512 d = _mm512_mul_ps(_mm512_load_ps(a.x + i), _mm512_load_ps(b.x + i));
+		d = _mm512_fmadd_ps(_mm512_load_ps(a.y + i), _mm512_load_ps(b.y + i), d);
+		d = _mm512_fmadd_ps(_mm512_load_ps(a.z + i), _mm512_load_ps(b.z + i), d);
+
+		const __mmask16 mask = a.count - i >= 16 ? __mmask16(0xFFFF) : __mmask16((1u << (a.count - i)) - 1);
+		_mm512_mask_storeu_ps(out + i, mask, d);
+	}
+}
+
+ENMA_FN ENMA_TARGET_AVX512 void CrossAVX512(const fvec3_soa& a, const fvec3_soa& b, fvec3_soa& out)
+{
+	for(uin32 i = 0; i < a.capacity; i += 16)
+	{
+		const __m512 ax = _mm512_load_ps(a.x + i);
+		const __m512 ay = _mm512_load_ps(a.y + i);
+		const __m512 az = _mm512_load_ps(a.z + i);
+
+		const __m512 bx = _mm512_load_ps(b.x + i);
+		const __m512 by = _mm512_load_ps(b.y + i);
+		const __m512 bz = _mm512_load_ps(b.z + i);
+
+		_mm512_store_ps(out.x + i, _mm512_fmsub_ps(ay, bz, _mm512_mul_ps(az, by)));
+		_mm512_store_ps(out.y + i, _mm512_fmsub_ps(az, bx, _mm512_mul_ps(ax, bz)));
+		_mm512_store_ps(out.z + i, _mm512_fmsub_ps(ax, by, _mm512_mul_ps(ay, bx)));
+	}
+}
+
+ENMA_FN ENMA_TARGET_AVX512 void NormaliseAVX512(const fvec3_soa& v, fvec3_soa& out)
+{
+	for(uin32 i = 0; i < v.capacity; i += 16)
+	{
+		const __m512 vx = _mm512_load_ps(v.x + i);
+		const __m512 vy = _mm512_load_ps(v.y + i);
+		const __m512 vz = _mm512_load_ps(v.z + i);
+
+		__m512 mag = _mm512_mul_ps(vx, vx);
+		mag = _mm512_fmadd_ps(vy, vy, mag);
+		mag = _mm512_fmadd_ps(vz, vz, mag);
+		mag = _mm512_sqrt_ps(mag);		// The magnitude of the Vectors
+
+		const __mmask16 nonZero = _mm512_cmp_ps_mask(mag, _mm512_setzero_ps(), _CMP_GT_OQ);
+
+		_mm512_store_ps(out.x + i, _mm512_maskz_div_ps(nonZero, vx, mag));
+		_mm512_store_ps(out.y + i, _mm512_maskz_div_ps(nonZero, vy, mag));
+		_mm512_store_ps(out.z + i, _mm512_maskz_div_ps(nonZero, vz, mag));
+	}
+}
+
+ENMA_FN ENMA_TARGET_AVX512 void DistanceAVX512(const fvec3_soa& a, const fvec3_soa& b, flt32* out)
+{
+	for(uin32 i = 0; i < a.count; i += 16)
+	{
+		const __m512 dx = _mm512_sub_ps(_mm512_load_ps(a.x + i), _mm512_load_ps(b.x + i));
+		const __m512 dy = _mm512_sub_ps(_mm512_load_ps(a.y + i), _mm512_load_ps(b.y + i));
+		const __m512 dz = _mm512_sub_ps(_mm512_load_ps(a.z + i), _mm512_load_ps(b.z + i));
+
+		__m512 d = _mm512_mul_ps(dx, dx);
+		d = _mm512_fmadd_ps(dy, dy, d);
+		d = _mm512_fmadd_ps(dz, dz, d);
+
+		const __mmask16 mask = a.count - i >= 16 ? __mmask16(0xFFFF) : __mmask16((1u << (a.count - i)) - 1);
+		_mm512_mask_storeu_ps(out + i, mask, _mm512_sqrt_ps(d));
+	}
+}
+
+ENMA_FN ENMA_TARGET_AVX512 void LerpAVX512(const fvec3_soa& a, const fvec3_soa& b, flt32 t, fvec3_soa& out)
+{
+	const __m512 lt = _mm512_set1_ps(t);
+
+	for(uin32 i = 0; i < a.capacity; i += 16)
+	{
+		const __m512 ax = _mm512_load_ps(a.x + i);
+		const __m512 ay = _mm512_load_ps(a.y + i);
+		const __m512 az = _mm512_load_ps(a.z + i);
+
+		_mm512_store_ps(out.x + i, _mm512_fmadd_ps(lt, _mm512_sub_ps(_mm512_load_ps(b.x + i), ax), ax));
+		_mm512_store_ps(out.y + i, _mm512_fmadd_ps(lt, _mm512_sub_ps(_mm512_load_ps(b.y + i), ay), ay));
+		_mm512_store_ps(out.z + i, _mm512_fmadd_ps(lt, _mm512_sub_ps(_mm512_load_ps(b.z + i), az), az));
+	}
+}
+
+#endif // USE_SIMD
+
+// Kernels of the fastest tier the host supports, selected once on first use; without USE_SIMD always the baseline
+struct SoaKernels
+{
+	void (*add)(const fvec3_soa&, const fvec3_soa&, fvec3_soa&);
+	void (*sub)(const fvec3_soa&, const fvec3_soa&, fvec3_soa&);
+	void (*mul)(const fvec3_soa&, const fvec3_soa&, fvec3_soa&);
+	void (*scale)(fvec3_soa&, flt32);
+	void (*fma)(const fvec3_soa&, const fvec3_soa&, const fvec3_soa&, fvec3_soa&);
+	void (*dot)(const fvec3_soa&, const fvec3_soa&, flt32*);
+	void (*cross)(const fvec3_soa&, const fvec3_soa&, fvec3_soa&);
+	void (*normalise)(const fvec3_soa&, fvec3_soa&);
+	void (*distance)(const fvec3_soa&, const fvec3_soa&, flt32*);
+	void (*lerp)(const fvec3_soa&, const fvec3_soa&, flt32, fvec3_soa&);
+};
+
+inline SoaKernels SelectSoaKernels()
+{
+	#ifdef USE_SIMD
+	if(GetSimdLevel() >= SimdLevel::AVX512)
+		return { AddAVX512, SubAVX512, MulAVX512, ScaleAVX512, FmaAVX512, DotAVX512, CrossAVX512, NormaliseAVX512, DistanceAVX512, LerpAVX512 };
+
+	if(GetSimdLevel() >= SimdLevel::AVX2)
+		return { AddAVX2, SubAVX2, MulAVX2, ScaleAVX2, FmaAVX2, DotAVX2, CrossAVX2, NormaliseAVX2, DistanceAVX2, LerpAVX2 };
+	#endif
+
+	return { AddSSE41, SubSSE41, MulSSE41, ScaleSSE41, FmaSSE41, DotSSE41, CrossSSE41, NormaliseSSE41, DistanceSSE41, LerpSSE41 };
+}
+
+inline const SoaKernels& GetSoaKernels()
+{
+	static const SoaKernels kernels = SelectSoaKernels();
+
+	return kernels;
+}
+
+ENMA_FN fvec3_soa& fvec3_soa::operator+=(const fvec3_soa& other)
+{
+	Add(*this, other, *this);
+
+	return *this;
+}
+
+ENMA_FN fvec3_soa& fvec3_soa::operator-=(const fvec3_soa& other)
+{
+	Sub(*this, other, *this);
+
+	return *this;
+}
+
+ENMA_FN fvec3_soa& fvec3_soa::operator*=(const fvec3_soa& other)
+{
+	Mul(*this, other, *this);
+
+	return *this;
+}
+
+ENMA_FN fvec3_soa& fvec3_soa::operator*=(flt32 val)
+{
+	GetSoaKernels().scale(*this, val);
+
+	return *this;
+}
+
+ENMA_FN fvec3_soa& fvec3_soa::Normalise()
+{
+	::Normalise(*this, *this);
+
+	return *this;
+}
+
+ENMA_FN void Add(const fvec3_soa& a, const fvec3_soa& b, fvec3_soa& out)
+{
+	assert(a.capacity == b.capacity && a.capacity == out.capacity);
+
+	GetSoaKernels().add(a, b, out);
+}
+
+ENMA_FN void Sub(const fvec3_soa& a, const fvec3_soa& b, fvec3_soa& out)
+{
+	assert(a.capacity == b.capacity && a.capacity == out.capacity);
+
+	GetSoaKernels().sub(a, b, out);
+}
+
+ENMA_FN void Mul(const fvec3_soa& a, const fvec3_soa& b, fvec3_soa& out)
+{
+	assert(a.capacity == b.capacity && a.capacity == out.capacity);
+
+	GetSoaKernels().mul(a, b, out);
+}
+
+ENMA_FN void Fma(const fvec3_soa& a, const fvec3_soa& b, const fvec3_soa& c, fvec3_soa& out)
+{
+	assert(a.capacity == b.capacity && a.capacity == c.capacity && a.capacity == out.capacity);
+
+	GetSoaKernels().fma(a, b, c, out);
+}
+
+ENMA_FN void Dot(const fvec3_soa& a, const fvec3_soa& b, flt32* out)
+{
+	assert(a.capacity == b.capacity);
+
+	GetSoaKernels().dot(a, b, out);
+}
+
+ENMA_FN void Cross(const fvec3_soa& a, const fvec3_soa& b, fvec3_soa& out)
+{
+	assert(a.capacity == b.capacity && a.capacity == out.capacity);
+
+	GetSoaKernels().cross(a, b, out);
+}
+
+ENMA_FN void Normalise(const fvec3_soa& v, fvec3_soa& out)
+{
+	assert(v.capacity == out.capacity);
+
+	GetSoaKernels().normalise(v, out);
+}
+
+ENMA_FN void Distance(const fvec3_soa& a, const fvec3_soa& b, flt32* out)
+{
+	assert(a.capacity == b.capacity);
+
+	GetSoaKernels().distance(a, b, out);
+}
+
+ENMA_FN void Lerp(const fvec3_soa& a, const fvec3_soa& b, flt32 t, fvec3_soa& out)
+{
+	assert(a.capacity == b.capacity && a.capacity == out.capacity);
+
+	GetSoaKernels().lerp(a, b, t, out);
+}
+
+#endif // ENMA_IMPLEMENTATION
@@ -11,8 +11,9 @@
 #include "fvec3.hpp"
 #include "../../base.hpp"
 #include "../../empch.hpp"
-#include "../simd_helpers.hpp"
+#include "../simd.hpp"
 #include "swizzle.hpp"
+#include "vmask.hpp"
 
 struct ALIGN(16) fvec4
 {
@@ -35,12 +36,6 @@ struct ALIGN(16) fvec4
 		#endif
     };
 
-	/**
-	 * Copy constructor.
-	 * 
-	 * \param v Another fvec4 to copy from.
-	 */
-	fvec4(const fvec4& v);
 	/**
 	 * Constructor with components.
 	 * 
@@ -49,20 +44,20 @@ struct ALIGN(16) fvec4
 	 * \param z Z component. Defaults to 0.0f if not provided.
 	 * \param w W component. Defaults to 0.0f if not provided.
 	 */
-    fvec4(flt32 fx, flt32 y, flt32 z = 0.0f, flt32 w = 0.0f);
+    constexpr fvec4(flt32 x, flt32 y, flt32 z = 0.0f, flt32 w = 0.0f);
 	/**
 	 * Single value constructor.
 	 *
 	 * \param val Value to initialize x, y, z and w components.
 	 *			  Defaults to 0.0f if not provided.
 	 */
-	explicit fvec4(flt32 val = 0.0f);
+	constexpr explicit fvec4(flt32 val = 0.0f);
 	/**
 	 * Array constructor.
 	 * 
 	 * \param arr Pointer to an array of at least 4 flt32 elements.
 	 */
-    explicit fvec4(const flt32* arr);
+    constexpr explicit fvec4(const flt32* arr);
 
 	/**
 	 * Constructor with two vectors.
@@ -70,21 +65,21 @@ struct ALIGN(16) fvec4
 	 * \param xy XY fvec2. Sets the x and y components.
 	 * \param zw ZW fvec2. Sets the z and w components.
 	 */
-	fvec4(const fvec2& xy, const fvec2& zw);
+	constexpr fvec4(const fvec2& xy, const fvec2& zw);
 	/**
 	 * Constructor with a value and a vector.
 	 * 
 	 * \param x X component.
 	 * \param yzw YZW fvec3. Sets the y, z and w components.
 	 */
-	fvec4(flt32 x, const fvec3& yzw);
+	constexpr fvec4(flt32 x, const fvec3& yzw);
 	/**
 	 * Constructor with a vector and a value.
 	 * 
 	 * \param xyz XYZ fvec3. Sets the x, y and z components.
 	 * \param w W component.
 	 */
-	fvec4(const fvec3& xyz, flt32 w);
+	constexpr fvec4(const fvec3& xyz, flt32 w);
 	
 	/**
 	 * Conversion operator to fvec2.
@@ -284,6 +279,15 @@ struct ALIGN(16) fvec4
 	 */
 	flt32 Distance(const fvec4& other) const;
 	
+	/**
+	 * Constructor from simd::float4.
+	 * 
+	 * Initializes an fvec4 using the four lanes of a simd::float4.
+	 * 
+	 * \param vals simd::float4 containing values to initialize x, y, z and w components.
+	 */
+	fvec4(const simd::float4& vals);
+
 	#ifdef USE_SIMD
 	/**
 	 * Conversion operator to __m128.
@@ -302,18 +306,18 @@ struct ALIGN(16) fvec4
 	 * \param vals A SIMD __m128 data containing values to initialize x, y, z and w components.
 	 */
 	fvec4(const __m128& vals);
+	#endif
 
 	/**
 	 * Linear Interpolation
 	 *
-	 * Interpolates from the given vector, consider it as `a`, to the other vector `b` based on interpolation parameter `t` using SIMD operations.
+	 * Interpolates from the given vector, consider it as `a`, to the other vector `b` based on interpolation parameter `t`.
 	 *
-	 * \param b The fvec2 to interpolate towards.
+	 * \param b The fvec4 to interpolate towards.
 	 * \param t Interpolation parameter (typically in the range [0, 1]).
 	 * \return The interpolated fvec4.
 	 */
 	fvec4 Lerp(const fvec4& b, flt32 t) const;
-	#endif
 	
 	#ifdef DEBUG
     friend std::ostream& operator<<(std::ostream& os, const fvec4& v)
@@ -366,7 +370,6 @@ flt32 Dot(const fvec4& v1, const fvec4& v2);
  */
 flt32 Distance(const fvec4& v1, const fvec4& v2);
 
-#ifdef USE_SIMD
 /**
  * Linear Interpolation
  *
@@ -378,448 +381,268 @@ flt32 Distance(const fvec4& v1, const fvec4& v2);
  * \return The interpolated fvec4.
  */
 fvec4 Lerp(const fvec4& a, const fvec4& b, flt32 t);
-#endif
-
-#ifdef ENMA_IMPLEMENTATION
-fvec4::fvec4(const fvec4& v) : x(v.x), y(v.y), z(v.z), w(v.w) {}
-
-fvec4::fvec4(flt32 x, flt32 y, flt32 z, flt32 w) : x(x), y(y), z(z), w(w) {}
-
-fvec4::fvec4(flt32 val) : x(val), y(val), z(val), w(val) {}
-
-fvec4::fvec4(const flt32* arr)
-{
-	this->_arr[0] = arr[0];
-	this->_arr[1] = arr[1];
-	this->_arr[2] = arr[2];
-	this->_arr[3] = arr[3];
-}
-
-fvec4::fvec4(const fvec2& xy, const fvec2& zw) : x(xy.x), y(xy.y), z(zw.x), w(zw.y) {}
-
-fvec4::fvec4(const flt32 x, const fvec3& yzw) : x(x), y(yzw.x), z(yzw.y), w(yzw.z) {}
-
-fvec4::fvec4(const fvec3& xyz, const flt32 w) : x(xyz.x), y(xyz.y), z(xyz.z), w(w) {}
-
-fvec4::operator vec2() const
-{
-	return vec2(this->x, this->y);
-}
-
-fvec4::operator vec3() const
-{
-	return vec3(this->x, this->y, this->z);
-}
-
-flt32 fvec4::operator[](uin32 index) const
-{
-	return _arr[index];
-}
-
-#ifdef USE_SIMD
-fvec4::operator __m128() const
-{
-	return this->_vals;
-}
-
-fvec4::fvec4(const __m128& vals)
-{
-	this->_vals = vals;
-}
-
-fvec4 fvec4::operator+(const fvec4& other) const
-{
-	return fvec4(_mm_add_ps(this->_vals, other._vals));
-}
-
-fvec4& fvec4::operator+=(const fvec4& other)
-{
-	this->_vals = _mm_add_ps(this->_vals, other._vals);
-
-	return *this;
-}
 
-fvec4 fvec4::operator-() const
-{
-	return fvec4(-x, -y, -z, -w);
-}
-
-fvec4 fvec4::operator-(const fvec4& other) const
-{
-	return fvec4(_mm_sub_ps(this->_vals, other._vals));
-}
+/**
+ * Component-wise comparisons. Every result is a vmask4 lane mask for Select, Any/All/None, or conversion to bvec4.
+ */
+vmask4 operator==(const fvec4& a, const fvec4& b);
+vmask4 operator!=(const fvec4& a, const fvec4& b);
+vmask4 operator<(const fvec4& a, const fvec4& b);
+vmask4 operator<=(const fvec4& a, const fvec4& b);
+vmask4 operator>(const fvec4& a, const fvec4& b);
+vmask4 operator>=(const fvec4& a, const fvec4& b);
+/**
+ * Component-wise |a - b| <= epsilon.
+ */
+vmask4 ApproxEqual(const fvec4& a, const fvec4& b, flt32 epsilon = 1e-5f);
+/**
+ * Branchless per-component select: mask ? a : b.
+ */
+fvec4 Select(const vmask4& mask, const fvec4& a, const fvec4& b);
 
-fvec4& fvec4::operator-=(const fvec4& other)
+/**
+ * Loads the four components of an fvec4 into a simd::float4.
+ *
+ * \param v The fvec4 to load.
+ * \return The loaded simd::float4.
+ */
+inline simd::float4 LoadXYZW(const fvec4& v)
 {
-	this->_vals = _mm_sub_ps(this->_vals, other._vals);
-
-	return *this;
+	#ifdef USE_SIMD
+	return v._vals;
+	#else
+	return simd::float4::LoadU(v._arr);
+	#endif
 }
 
-fvec4 fvec4::operator*(const fvec4& other) const
+/**
+ * Stores a simd::float4 into the four components of an fvec4.
+ *
+ * \param out The fvec4 to write to.
+ * \param v The simd::float4 to store.
+ */
+inline void StoreXYZW(fvec4& out, const simd::float4& v)
 {
-	return fvec4(_mm_mul_ps(this->_vals, other._vals));
+	#ifdef USE_SIMD
+	out._vals = v;
+	#else
+	v.StoreU(out._arr);
+	#endif
 }
 
-fvec4& fvec4::operator*=(const fvec4& other)
-{			
-	this->_vals = _mm_mul_ps(this->_vals, other._vals);
+constexpr fvec4::fvec4(flt32 x, flt32 y, flt32 z, flt32 w) : x(x), y(y), z(z), w(w) {}
 
-	return *this;
-}
+constexpr fvec4::fvec4(flt32 val) : x(val), y(val), z(val), w(val) {}
 
-fvec4 fvec4::operator*(const flt32 val) const
-{
-	const __m128 v2 = set1(val);
+constexpr fvec4::fvec4(const flt32* arr) : x(arr[0]), y(arr[1]), z(arr[2]), w(arr[3]) {}
 
-	return fvec4(_mm_mul_ps(this->_vals, v2));				// Return the result of the multiplication of the two values
-}
+constexpr fvec4::fvec4(const fvec2& xy, const fvec2& zw) : x(xy.x), y(xy.y), z(zw.x), w(zw.y) {}
 
-fvec4& fvec4::operator*=(const flt32 val)
-{
-	const __m128 v2 = set1(val);		
+constexpr fvec4::fvec4(const flt32 x, const fvec3& yzw) : x(x), y(yzw.x), z(yzw.y), w(yzw.z) {}
 
-	this->_vals = _mm_mul_ps(this->_vals, v2);
+constexpr fvec4::fvec4(const fvec3& xyz, const flt32 w) : x(xyz.x), y(xyz.y), z(xyz.z), w(w) {}
 
-	return *this;
-}
+inline constexpr fvec4 fvec4::zero 	= fvec4();
+inline constexpr fvec4 fvec4::one 	= fvec4(1.0f);
+inline constexpr fvec4 fvec4::neg 	= fvec4(-1.0f);
 
-fvec4 fvec4::operator/(const fvec4& other) const
+#ifdef ENMA_IMPLEMENTATION
+ENMA_HOT_FN fvec4::operator vec2() const
 {
-	return fvec4(_mm_div_ps(this->_vals, other._vals));
+	return vec2(this->x, this->y);
 }
 
-fvec4& fvec4::operator/=(const fvec4& other)
+ENMA_HOT_FN fvec4::operator vec3() const
 {
-	this->_vals = _mm_div_ps(this->_vals, other._vals);
-
-    return *this;
+	return vec3(this->x, this->y, this->z);
 }
 
-fvec4 fvec4::operator/(const flt32 val) const
+ENMA_HOT_FN flt32 fvec4::operator[](uin32 index) const
 {
-	const __m128 v2 = set1(val);
-
-	return fvec4(_mm_div_ps(this->_vals, v2));
+	return _arr[index];
 }
 
-fvec4& fvec4::operator/=(const flt32 val)
+ENMA_HOT_FN fvec4::fvec4(const simd::float4& vals)
 {
-	const __m128 v2 = set1(val);
-
-	this->_vals = _mm_div_ps(this->_vals, v2);
-
-	return *this;
+	StoreXYZW(*this, vals);
 }
 
-fvec4 fvec4::operator+(flt32 val) const
+#ifdef USE_SIMD
+ENMA_HOT_FN fvec4::operator __m128() const
 {
-	const __m128 v2 = set1(val);
-
-	return fvec4(_mm_add_ps(this->_vals, v2));
+	return this->_vals;
 }
 
-fvec4& fvec4::operator+=(flt32 val)
+ENMA_HOT_FN fvec4::fvec4(const __m128& vals)
 {
-	const __m128 v2 = set1(val);
-
-	*this = _mm_add_ps(this->_vals, v2);
-
-	return *this;
+	this->_vals = vals;
 }
+#endif
 
-fvec4 fvec4::operator-(flt32 val) const
+ENMA_HOT_FN fvec4 fvec4::operator+(const fvec4& other) const
 {
-	const __m128 v2 = set1(val);
-
-	return fvec4(_mm_sub_ps(this->_vals, v2));
+	return fvec4(LoadXYZW(*this) + LoadXYZW(other));
 }
 
-fvec4& fvec4::operator-=(flt32 val)
+ENMA_HOT_FN fvec4& fvec4::operator+=(const fvec4& other)
 {
-	const __m128 v2 = set1(val);
-
-	*this = _mm_sub_ps(this->_vals, v2);
-
-	return *this;
+	return *this = *this + other;
 }
 
-fvec4& fvec4::Normalise()
+ENMA_HOT_FN fvec4 fvec4::operator-(const fvec4& other) const
 {
-	const __m128 ld = this->_vals;
-	__m128 dp = _mm_dp_ps(ld, ld, 0xFF);
-	__m128 dpsqrt = _mm_sqrt_ps(dp);
-
-	*this = _mm_div_ps(ld, dp);
-
-	return *this;
+	return fvec4(LoadXYZW(*this) - LoadXYZW(other));
 }
 
-fvec4 Normalise(const fvec4& v)
+ENMA_HOT_FN fvec4& fvec4::operator-=(const fvec4& other)
 {
-	const __m128 ld = v._vals;
-	__m128 dp = _mm_dp_ps(ld, ld, 0xFF);
-	__m128 dpsqrt = _mm_sqrt_ps(dp);
-
-	return fvec4(_mm_div_ps(ld, dp));
+	return *this = *this - other;
 }
 
-flt32 fvec4::Dot(const fvec4& other) const
+ENMA_HOT_FN fvec4 fvec4::operator*(const fvec4& other) const
 {
-	__m128 dot = _mm_dp_ps(this->_vals, other._vals, 0xFF);
-
-	return dot[0];
+	return fvec4(LoadXYZW(*this) * LoadXYZW(other));
 }
 
-flt32 Dot(const fvec4& v1, const fvec4& v2)
+ENMA_HOT_FN fvec4& fvec4::operator*=(const fvec4& other)
 {
-	__m128 dot = _mm_dp_ps(v1._vals, v2._vals, 0xFF);
-
-	return dot[0];
+	return *this = *this * other;
 }
 
-flt32 fvec4::Distance(const fvec4& other) const
+ENMA_HOT_FN fvec4 fvec4::operator/(const fvec4& other) const
 {
-	__m128 v1 = this->_vals;
-	__m128 v2 = other._vals;
-
-	v1 = _mm_sub_ps(v1, v2);
-	v1 = _mm_dp_ps(v1, v1, 0xFF);
-	v1 = _mm_sqrt_ps(v1);
-
-	return v1[0];
+	return fvec4(LoadXYZW(*this) / LoadXYZW(other));
 }
 
-flt32 Distance(const fvec4& v1, const fvec4& v2)
+ENMA_HOT_FN fvec4& fvec4::operator/=(const fvec4& other)
 {
-	__m128 m = v1._vals;
-	__m128 n = v2._vals;
-
-	m = _mm_sub_ps(m, n);
-	m = _mm_dp_ps(m, m, 0xFF);
-	m = _mm_sqrt_ps(m);
-
-	return m[0];
+	return *this = *this / other;
 }
 
-fvec4 fvec4::Lerp(const fvec4& b, flt32 t) const
+ENMA_HOT_FN fvec4 fvec4::operator*(flt32 val) const
 {
-	__m128 lv1 = this->_vals;
-	__m128 lv2 = b._vals;
-
-	__m128 lt = set1(t);
-
-	__m128 bma = _mm_sub_ps(lv2, lv1);
-
-	return fvec4(_mm_fmadd_ps(lt, bma, lv1));
+	return fvec4(LoadXYZW(*this) * val);
 }
 
-fvec4 Lerp(const fvec4& a, const fvec4& b, flt32 t)
+ENMA_HOT_FN fvec4& fvec4::operator*=(flt32 val)
 {
-	__m128 lv1 = a._vals;
-	__m128 lv2 = b._vals;
-
-	__m128 lt = set1(t);
-
-	__m128 bma = _mm_sub_ps(lv2, lv1);
-
-	return fvec4(_mm_fmadd_ps(lt, bma, lv1));
+	return *this = *this * val;
 }
 
-#else // ! USE_SIMD
-
-fvec4 fvec4::operator+(const fvec4& other) const
+ENMA_HOT_FN fvec4 fvec4::operator/(flt32 val) const
 {
-	return fvec4(this->x + other.x, this->y + other.y, this->z + other.z, this->w + other.w);
+	return fvec4(LoadXYZW(*this) / val);
 }
 
-fvec4& fvec4::operator+=(const fvec4& other)
+ENMA_HOT_FN fvec4& fvec4::operator/=(flt32 val)
 {
-	this->x += other.x;
-	this->y += other.y;
-	this->z += other.z;
-	this->w += other.w;
-
-	return *this;
+	return *this = *this / val;
 }
 
-fvec4 fvec4::operator-(const fvec4& other) const
+ENMA_HOT_FN fvec4 fvec4::operator+(flt32 val) const
 {
-	return fvec4(this->x - other.x, this->y - other.y, this->z - other.z, this->w - other.w);
+	return fvec4(LoadXYZW(*this) + val);
 }
 
-fvec4& fvec4::operator-=(const fvec4& other)
+ENMA_HOT_FN fvec4& fvec4::operator+=(flt32 val)
 {
-	this->x -= other.x;
-	this->y -= other.y;
-	this->z -= other.z;
-	this->w -= other.w;
-
-	return *this;
+	return *this = *this + val;
 }
 
-fvec4 fvec4::operator*(const fvec4& other) const
+ENMA_HOT_FN fvec4 fvec4::operator-(flt32 val) const
 {
-	return fvec4(this->x * other.x, this->y * other.y, this->z * other.z, this->w * other.w);
+	return fvec4(LoadXYZW(*this) - val);
 }
 
-fvec4& fvec4::operator*=(const fvec4& other)
+ENMA_HOT_FN fvec4& fvec4::operator-=(flt32 val)
 {
-	this->x *= other.x;
-	this->y *= other.y;
-	this->z *= other.z;
-	this->w *= other.w;
-
-	return *this;
+	return *this = *this - val;
 }
 
-fvec4 fvec4::operator*(const flt32 val) const
+ENMA_HOT_FN fvec4& fvec4::Normalise()
 {
-	return fvec4(this->x * val, this->y * val, this->z * val, this->w * val);
+	return *this = ::Normalise(*this);
 }
 
-fvec4& fvec4::operator*=(const flt32 val)
+ENMA_HOT_FN fvec4 Normalise(const fvec4& v)
 {
-	this->x *= val;
-	this->y *= val;
-	this->z *= val;
-	this->w *= val;
+	const simd::float4 ld = LoadXYZW(v);
 
-	return *this;
+	return fvec4(ld / simd::Sqrt(simd::Dot4(ld, ld)));
 }
 
-fvec4 fvec4::operator/(const fvec4& other) const
+ENMA_HOT_FN flt32 fvec4::Dot(const fvec4& other) const
 {
-
-	return fvec4(this->x / other.x, this->y / other.y, this->z / other.z, this->w / other.w);
+	return ::Dot(*this, other);
 }
 
-fvec4& fvec4::operator/=(const fvec4& other)
+ENMA_HOT_FN flt32 Dot(const fvec4& v1, const fvec4& v2)
 {
-	this->x /= other.x;
-	this->y /= other.y;
-	this->z /= other.z;
-	this->w /= other.w;
-
-	return *this;
+	return simd::Dot4(LoadXYZW(v1), LoadXYZW(v2)).X();
 }
 
-fvec4 fvec4::operator/(flt32 val) const
+ENMA_HOT_FN flt32 fvec4::Distance(const fvec4& other) const
 {
-	const flt32 rec = 1.0f / val;
-
-	return fvec4(this->x * rec, this->y * rec, this->z * rec, this->w * rec);
+	return ::Distance(*this, other);
 }
 
-fvec4& fvec4::operator/=(flt32 val)
+ENMA_HOT_FN flt32 Distance(const fvec4& v1, const fvec4& v2)
 {
-	const flt32 rec = 1.0f / val;
+	const simd::float4 d = LoadXYZW(v1) - LoadXYZW(v2);
 
-	this->x *= rec;
-	this->y *= rec;
-	this->z *= rec;
-	this->w *= rec;
-
-	return *this;
+	return simd::Sqrt(simd::Dot4(d, d)).X();
 }
 
-fvec4 fvec4::operator+(flt32 val) const
+ENMA_HOT_FN fvec4 fvec4::Lerp(const fvec4& b, flt32 t) const
 {
-	return fvec4(this->x + val, this->y + val, this->z + val, this->w + val);
+	return ::Lerp(*this, b, t);
 }
 
-fvec4& fvec4::operator+=(flt32 val)
+ENMA_HOT_FN fvec4 Lerp(const fvec4& a, const fvec4& b, flt32 t)
 {
-	this->x += val;
-	this->y += val;
-	this->z += val;
-	this->w += val;
+	const simd::float4 lv1 = LoadXYZW(a);
 
-	return *this;
+	return fvec4(simd::Fmadd(simd::float4::Set1(t), LoadXYZW(b) - lv1, lv1));
 }
 
-fvec4 fvec4::operator-(flt32 val) const
+ENMA_HOT_FN vmask4 operator==(const fvec4& a, const fvec4& b)
 {
-	return fvec4(this->x - val, this->y - val, this->z - val, this->w - val);
+	return vmask4(simd::AsInt(simd::CmpEq(LoadXYZW(a), LoadXYZW(b))));
 }
 
-fvec4& fvec4::operator-=(flt32 val)
+ENMA_HOT_FN vmask4 operator!=(const fvec4& a, const fvec4& b)
 {
-	this->x -= val;
-	this->y -= val;
-	this->z -= val;
-	this->w -= val;
-
-	return *this;
+	return vmask4(simd::AsInt(simd::CmpNeq(LoadXYZW(a), LoadXYZW(b))));
 }
 
-/*bvec3 fvec4::Equals(const fvec4 &other)
+ENMA_HOT_FN vmask4 operator<(const fvec4& a, const fvec4& b)
 {
-	return bvec3(this->x == other.x, this->y == other.y);
-}*/
-
-fvec4& fvec4::Normalise()
-{
-	flt32 xt = this->x * this->x;
-	flt32 yt = this->y * this->y;
-	flt32 zt = this->z * this->z;
-	flt32 wt = this->w * this->w;
-
-	const flt32 mag = 1.0f / sqrt(xt + yt + zt + wt);
-	*this *= mag;
-
-	return *this;
+	return vmask4(simd::AsInt(simd::CmpLt(LoadXYZW(a), LoadXYZW(b))));
 }
 
-fvec4 Normalise(const fvec4& v)
+ENMA_HOT_FN vmask4 operator<=(const fvec4& a, const fvec4& b)
 {
-	fvec4 res = v;
-
-	flt32 xt = v.x * v.x;
-	flt32 yt = v.y * v.y;
-	flt32 zt = v.z * v.z;
-	flt32 wt = v.w * v.w;
-
-	const flt32 mag = 1.0f / sqrt(xt + yt + zt + wt);
-	res *= mag;
-
-	return res;
+	return vmask4(simd::AsInt(simd::CmpLe(LoadXYZW(a), LoadXYZW(b))));
 }
 
-flt32 fvec4::Dot(const fvec4& other) const
+ENMA_HOT_FN vmask4 operator>(const fvec4& a, const fvec4& b)
 {
-    return this->x * other.x + this->y * other.y + this->z * other.z + this->w * other.w;
+	return vmask4(simd::AsInt(simd::CmpGt(LoadXYZW(a), LoadXYZW(b))));
 }
 
-flt32 Dot(const fvec4& v1, const fvec4& v2)
+ENMA_HOT_FN vmask4 operator>=(const fvec4& a, const fvec4& b)
 {
-	return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z + v1.w * v2.w;
+	return vmask4(simd::AsInt(simd::CmpGe(LoadXYZW(a), LoadXYZW(b))));
 }
 
-flt32 fvec4::Distance(const fvec4& other) const
+ENMA_HOT_FN vmask4 ApproxEqual(const fvec4& a, const fvec4& b, flt32 epsilon)
 {
-	flt32 dx = this->x - other.x;
-	flt32 dy = this->y - other.y;
-	flt32 dz = this->z - other.z;
-	flt32 dw = this->w - other.w;
-
-	return sqrt(dx * dx + dy * dy + dz * dz + dw * dw);
+	return vmask4(simd::AsInt(simd::CmpLe(simd::Abs(LoadXYZW(a) - LoadXYZW(b)), simd::float4::Set1(epsilon))));
 }
 
-flt32 Distance(const fvec4& v1, const fvec4& v2)
+ENMA_HOT_FN fvec4 Select(const vmask4& mask, const fvec4& a, const fvec4& b)
 {
-	flt32 dx = v1.x - v2.x;
-	flt32 dy = v1.y - v2.y;
-	flt32 dz = v1.z - v2.z;
-	flt32 dw = v1.w - v2.w;
-
-	return sqrt(dx * dx + dy * dy + dz * dz + dw * dw);
+	return fvec4(simd::Select(simd::AsFloat(mask.lanes), LoadXYZW(a), LoadXYZW(b)));
 }
 
-#endif
-
-const fvec4 fvec4::zero = vec4();
-const fvec4 fvec4::one 	= vec4(1.0f);
-const fvec4 fvec4::neg 	= vec4(-1.0f);
-
 #endif // ENMA_IMPLEMENTATION
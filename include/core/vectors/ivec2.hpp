@@ -9,8 +9,9 @@
 #pragma once
 #include "../../base.hpp"
 #include "../../empch.hpp"
-#include "../simd_helpers.hpp"
+#include "../simd.hpp"
 #include "swizzle.hpp"
+#include "vmask.hpp"
 
 struct ALIGN(8) ivec2
 {
@@ -29,32 +30,26 @@ struct ALIGN(8) ivec2
 		IVEC2_SWIZZLE(ivec2);
 	};
 
-	/**
-	 * Copy constructor.
-	 * 
-	 * \param v Another ivec2 to copy from.
-	 */
-	ivec2(const ivec2 &v);
 	/**
 	 * Constructor with components.
 	 * 
 	 * \param x X component.
 	 * \param y Y component.
 	 */
-	ivec2(int32 x, int32 y);
+	constexpr ivec2(int32 x, int32 y);
 	/**
 	 * Single value constructor.
 	 *
 	 * \param val Value to initialize x and y components. 
 	 *			  Defaults to 0 if not provided.
 	 */
-	explicit ivec2(int32 val = 0);
+	constexpr explicit ivec2(int32 val = 0);
 	/**
 	 * Array constructor.
 	 * 
 	 * \param arr Pointer to an array of at least 2 int32 elements.
 	 */
-	explicit ivec2(const int32* arr);
+	constexpr explicit ivec2(const int32* arr);
 
 	/**
 	 * Indexing operator.
@@ -85,6 +80,29 @@ struct ALIGN(8) ivec2
 	ivec2& operator/=(const ivec2& other);
 	ivec2 operator/(const int32 val) const;
 	ivec2& operator/=(const int32 val);
+
+	ivec2 operator&(const ivec2& other) const;
+	ivec2& operator&=(const ivec2& other);
+	ivec2 operator|(const ivec2& other) const;
+	ivec2& operator|=(const ivec2& other);
+	ivec2 operator^(const ivec2& other) const;
+	ivec2& operator^=(const ivec2& other);
+	ivec2 operator~() const;
+
+	/**
+	 * Shifts every component left.
+	 *
+	 * \param shift Number of bits to shift by, in [0, 31].
+	 */
+	ivec2 operator<<(const int32 shift) const;
+	ivec2& operator<<=(const int32 shift);
+	/**
+	 * Shifts every component right, replicating the sign bit.
+	 *
+	 * \param shift Number of bits to shift by, in [0, 31].
+	 */
+	ivec2 operator>>(const int32 shift) const;
+	ivec2& operator>>=(const int32 shift);
 	
 	//			Extension Functions for Ease of Use 		//
 
@@ -145,6 +163,11 @@ struct ALIGN(8) ivec2
 	 */
 	flt32 Distance(const ivec2& other) const;
 
+	ivec2(const simd::int4& vals);
+	#ifdef USE_SIMD
+	ivec2(const __m128i& vals);
+	#endif
+
 	#ifdef DEBUG
     friend std::ostream& operator<<(std::ostream& os, const ivec2& v)
     {
@@ -197,135 +220,239 @@ int32 Dot(const ivec2& v1, const ivec2& v2);
 int32 Cross(const ivec2& v1, const ivec2& v2);
 flt32 Distance(const ivec2& v1, const ivec2& v2);
 
+ivec2 Min(const ivec2& a, const ivec2& b);
+ivec2 Max(const ivec2& a, const ivec2& b);
+ivec2 Abs(const ivec2& v);
+ivec2 Clamp(const ivec2& v, const ivec2& minimum, const ivec2& maximum);
+
+/**
+ * Component-wise comparisons. Every result is a vmask2 lane mask for Select, Any/All/None, or conversion to bvec2.
+ */
+vmask2 operator==(const ivec2& a, const ivec2& b);
+vmask2 operator!=(const ivec2& a, const ivec2& b);
+vmask2 operator<(const ivec2& a, const ivec2& b);
+vmask2 operator<=(const ivec2& a, const ivec2& b);
+vmask2 operator>(const ivec2& a, const ivec2& b);
+vmask2 operator>=(const ivec2& a, const ivec2& b);
+/**
+ * Branchless per-component select: mask ? a : b.
+ */
+ivec2 Select(const vmask2& mask, const ivec2& a, const ivec2& b);
+
+/**
+ * Loads x and y into the first two lanes of a simd::int4, z and w are zero.
+ *
+ * \param v The ivec2 to load.
+ * \return The loaded simd::int4.
+ */
+inline simd::int4 LoadXY(const ivec2& v)
+{
+	return simd::int4::LoadXY(v._arr);
+}
+
+/**
+ * Stores the first two lanes of a simd::int4 into an ivec2.
+ *
+ * \param out The ivec2 to write to.
+ * \param v The simd::int4 to store.
+ */
+inline void StoreXY(ivec2& out, const simd::int4& v)
+{
+	v.StoreXY(out._arr);
+}
+
+constexpr ivec2::ivec2(int32 x, int32 y) : x(x), y(y) {}
+
+constexpr ivec2::ivec2(int32 val) : x(val), y(val) {}
+
+constexpr ivec2::ivec2(const int32* arr) : x(arr[0]), y(arr[1]) {}
+
+inline constexpr ivec2 ivec2::zero 	= ivec2(0);
+inline constexpr ivec2 ivec2::one 	= ivec2(1);
+inline constexpr ivec2 ivec2::neg 	= ivec2(-1);
+
+inline constexpr ivec2 ivec2::up 	= ivec2(0, 1);
+inline constexpr ivec2 ivec2::down 	= ivec2(0, -1);
+inline constexpr ivec2 ivec2::right = ivec2(1, 0);
+inline constexpr ivec2 ivec2::left 	= ivec2(-1, 0);
+
 #ifdef ENMA_IMPLEMENTATION
-ivec2::ivec2(const ivec2& v)
+ENMA_HOT_FN int32 ivec2::operator[](uin32 index) const
 {
-	this->x = v.x;
-	this->y = v.y;
+	return _arr[index];
 }
 
-ivec2::ivec2(int32 x, int32 y) : x(x), y(y) {}
+ENMA_HOT_FN ivec2::ivec2(const simd::int4& vals)
+{
+	StoreXY(*this, vals);
+}
 
-ivec2::ivec2(int32 val) : x(val), y(val) {}
+#ifdef USE_SIMD
+ENMA_HOT_FN ivec2::ivec2(const __m128i& vals) : ivec2(simd::int4(vals)) {}
+#endif
 
-ivec2::ivec2(const int32* arr)
+ENMA_HOT_FN ivec2 ivec2::operator+(const ivec2& other) const
 {
-	this->_arr[0] = arr[0];
-	this->_arr[1] = arr[1];
+	return ivec2(LoadXY(*this) + LoadXY(other));
 }
 
-int32 ivec2::operator[](uin32 index) const
+ENMA_HOT_FN ivec2& ivec2::operator+=(const ivec2& other)
 {
-	return _arr[index];
+	return *this = *this + other;
 }
 
-ivec2 ivec2::operator+(const ivec2& other) const
+ENMA_HOT_FN ivec2 ivec2::operator-() const
 {
-	return ivec2(this->x + other.x, this->y + other.y);
+	return ivec2(simd::int4::Zero() - LoadXY(*this));
 }
 
-ivec2& ivec2::operator+=(const ivec2& other)
+ENMA_HOT_FN ivec2 ivec2::operator-(const ivec2& other) const
 {
-	this->x += other.x;
-	this->y += other.y;
+	return ivec2(LoadXY(*this) - LoadXY(other));
+}
 
-	return *this;
+ENMA_HOT_FN ivec2& ivec2::operator-=(const ivec2& other)
+{
+	return *this = *this - other;
 }
 
-ivec2 ivec2::operator-() const
+ENMA_HOT_FN ivec2 ivec2::operator*(const ivec2& other) const
 {
-	return ivec2(-x, -y);
+	return ivec2(LoadXY(*this) * LoadXY(other));
 }
 
-ivec2 ivec2::operator-(const ivec2& other) const
+ENMA_HOT_FN ivec2& ivec2::operator*=(const ivec2& other)
 {
-	return ivec2(this->x - other.x, this->y - other.y);
+	return *this = *this * other;
 }
 
-ivec2& ivec2::operator-=(const ivec2& other)
+ENMA_HOT_FN ivec2 ivec2::operator*(const int32 val) const
 {
-	this->x -= other.x;
-	this->y -= other.y;
+	return ivec2(LoadXY(*this) * simd::int4::Set1(val));
+}
 
-	return *this;
+ENMA_HOT_FN ivec2& ivec2::operator*=(const int32 val)
+{
+	return *this = *this * val;
 }
 
-ivec2 ivec2::operator*(const ivec2& other) const
+// No integer divide instruction, one hardware divide per component
+ENMA_HOT_FN ivec2 ivec2::operator/(const ivec2& other) const
 {
-	return ivec2(this->x * other.x, this->y * other.y);
+	return ivec2(this->x / other.x, this->y / other.y);
 }
 
-ivec2& ivec2::operator*=(const ivec2& other)
+ENMA_HOT_FN ivec2& ivec2::operator/=(const ivec2& other)
 {
-	this->x *= other.x;
-	this->y *= other.y;
+	return *this = *this / other;
+}
 
-	return *this;
+ENMA_HOT_FN ivec2 ivec2::operator/(const int32 val) const
+{
+	return ivec2(this->x / val, this->y / val);
 }
 
-ivec2 ivec2::operator*(const int32 val) const
+ENMA_HOT_FN ivec2& ivec2::operator/=(const int32 val)
 {
-	return ivec2(this->x * val, this->y * val);
+	return *this = *this / val;
 }
 
-ivec2& ivec2::operator*=(const int32 val)
+ENMA_HOT_FN ivec2 ivec2::operator+(int32 val) const
 {
-	this->x *= val;
-	this->y *= val;
+	return ivec2(LoadXY(*this) + simd::int4::Set1(val));
+}
 
-	return *this;
+ENMA_HOT_FN ivec2& ivec2::operator+=(int32 val)
+{
+	return *this = *this + val;
 }
 
-ivec2 ivec2::operator/(const ivec2& other) const
+ENMA_HOT_FN ivec2 ivec2::operator-(int32 val) const
 {
+	return ivec2(LoadXY(*this) - simd::int4::Set1(val));
+}
 
-	return ivec2(this->x / other.x, this->y / other.y);
+ENMA_HOT_FN ivec2& ivec2::operator-=(int32 val)
+{
+	return *this = *this - val;
 }
 
-ivec2& ivec2::operator/=(const ivec2& other)
+ENMA_HOT_FN ivec2 ivec2::operator&(const ivec2& other) const
 {
-	this->x /= other.x;
-	this->y /= other.y;
+	return ivec2(simd::And(LoadXY(*this), LoadXY(other)));
+}
 
-	return *this;
+ENMA_HOT_FN ivec2& ivec2::operator&=(const ivec2& other)
+{
+	return *this = *this & other;
 }
 
-ivec2 ivec2::operator/(const int32 val) const
+ENMA_HOT_FN ivec2 ivec2::operator|(const ivec2& other) const
 {
+	return ivec2(simd::Or(LoadXY(*this), LoadXY(other)));
+}
 
-	return ivec2(this->x / val, this->y / val);
+ENMA_HOT_FN ivec2& ivec2::operator|=(const ivec2& other)
+{
+	return *this = *this | other;
 }
 
-ivec2& ivec2::operator/=(const int32 val)
+ENMA_HOT_FN ivec2 ivec2::operator^(const ivec2& other) const
 {
+	return ivec2(simd::Xor(LoadXY(*this), LoadXY(other)));
+}
 
-	this->x *= val;
-	this->y *= val;
+ENMA_HOT_FN ivec2& ivec2::operator^=(const ivec2& other)
+{
+	return *this = *this ^ other;
+}
 
-	return *this;
+ENMA_HOT_FN ivec2 ivec2::operator~() const
+{
+	return ivec2(simd::Xor(LoadXY(*this), simd::int4::Set1(-1)));
+}
+
+ENMA_HOT_FN ivec2 ivec2::operator<<(const int32 shift) const
+{
+	return ivec2(simd::ShiftLeft(LoadXY(*this), shift));
+}
+
+ENMA_HOT_FN ivec2& ivec2::operator<<=(const int32 shift)
+{
+	return *this = *this << shift;
 }
 
-int32 ivec2::Dot(const ivec2& other) const
+ENMA_HOT_FN ivec2 ivec2::operator>>(const int32 shift) const
+{
+	return ivec2(simd::ShiftRight(LoadXY(*this), shift));
+}
+
+ENMA_HOT_FN ivec2& ivec2::operator>>=(const int32 shift)
+{
+	return *this = *this >> shift;
+}
+
+ENMA_HOT_FN int32 ivec2::Dot(const ivec2& other) const
 {
 	return this->x * other.x + this->y * other.y;
 }
 
-int32 Dot(const ivec2& v1, const ivec2& v2)
+ENMA_HOT_FN int32 Dot(const ivec2& v1, const ivec2& v2)
 {
 	return v1.x * v2.x + v1.y * v2.y;
 }
 
-int32 ivec2::Cross(const ivec2& other) const
+ENMA_HOT_FN int32 ivec2::Cross(const ivec2& other) const
 {
 	return this->x * other.y - other.x * this->y;
 }
 
-int32 Cross(const ivec2& v1, const ivec2& v2)
+ENMA_HOT_FN int32 Cross(const ivec2& v1, const ivec2& v2)
 {
 	return v1.x * v2.y - v2.x * v1.y;
 }
 
-flt32 ivec2::Distance(const ivec2& other) const
+ENMA_HOT_FN flt32 ivec2::Distance(const ivec2& other) const
 {
 	const int32 xt = this->x - other.x;
 	const int32 yt = this->y - other.y;
@@ -333,7 +460,7 @@ flt32 ivec2::Distance(const ivec2& other) const
 	return sqrt(xt * xt + yt * yt);
 }
 
-flt32 Distance(const ivec2& v1, const ivec2& v2)
+ENMA_HOT_FN flt32 Distance(const ivec2& v1, const ivec2& v2)
 {
 	const int32 xt = v1.x - v2.x;
 	const int32 yt = v1.y - v2.y;
@@ -341,13 +468,59 @@ flt32 Distance(const ivec2& v1, const ivec2& v2)
 	return sqrt(xt * xt + yt * yt);
 }
 
-const ivec2 ivec2::zero 	= ivec2(0);
-const ivec2 ivec2::one 		= ivec2(1);
-const ivec2 ivec2::neg 		= ivec2(-1);
+ENMA_HOT_FN ivec2 Min(const ivec2& a, const ivec2& b)
+{
+	return ivec2(simd::Min(LoadXY(a), LoadXY(b)));
+}
+
+ENMA_HOT_FN ivec2 Max(const ivec2& a, const ivec2& b)
+{
+	return ivec2(simd::Max(LoadXY(a), LoadXY(b)));
+}
+
+ENMA_HOT_FN ivec2 Abs(const ivec2& v)
+{
+	return ivec2(simd::Abs(LoadXY(v)));
+}
 
-const ivec2 ivec2::up 		= ivec2(0, 1);
-const ivec2 ivec2::down 	= ivec2(0, -1);
-const ivec2 ivec2::right 	= ivec2(1, 0);
-const ivec2 ivec2::left 	= ivec2(-1, 0);
+ENMA_HOT_FN ivec2 Clamp(const ivec2& v, const ivec2& minimum, const ivec2& maximum)
+{
+	return ivec2(simd::Min(simd::Max(LoadXY(v), LoadXY(minimum)), LoadXY(maximum)));
+}
+
+ENMA_HOT_FN vmask2 operator==(const ivec2& a, const ivec2& b)
+{
+	return vmask2(simd::CmpEq(LoadXY(a), LoadXY(b)));
+}
+
+ENMA_HOT_FN vmask2 operator!=(const ivec2& a, const ivec2& b)
+{
+	return ~(a == b);
+}
+
+ENMA_HOT_FN vmask2 operator<(const ivec2& a, const ivec2& b)
+{
+	return vmask2(simd::CmpLt(LoadXY(a), LoadXY(b)));
+}
+
+ENMA_HOT_FN vmask2 operator<=(const ivec2& a, const ivec2& b)
+{
+	return ~(a > b);
+}
+
+ENMA_HOT_FN vmask2 operator>(const ivec2& a, const ivec2& b)
+{
+	return vmask2(simd::CmpGt(LoadXY(a), LoadXY(b)));
+}
+
+ENMA_HOT_FN vmask2 operator>=(const ivec2& a, const ivec2& b)
+{
+	return ~(a < b);
+}
+
+ENMA_HOT_FN ivec2 Select(const vmask2& mask, const ivec2& a, const ivec2& b)
+{
+	return ivec2(simd::Select(mask.lanes, LoadXY(a), LoadXY(b)));
+}
 
 #endif	// ENMA_IMPLEMENTATION
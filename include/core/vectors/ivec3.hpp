@@ -10,6 +10,7 @@
 #include "ivec2.hpp"
 #include "../../base.hpp"
 #include "../../empch.hpp"
+#include "vmask.hpp"
 
 struct ALIGN(16) ivec3
 {
@@ -23,11 +24,10 @@ struct ALIGN(16) ivec3
     };
     
 public:
-    ivec3(const ivec3 &v);
-    ivec3(const int32 val = 0);
-    ivec3(const int32 ix, const int32 iy, const int32 iz);
-    ivec3(const int32 x, const ivec2& yz);
-	ivec3(const ivec2& xy, const int32 z);
+    constexpr ivec3(const int32 val = 0);
+    constexpr ivec3(const int32 ix, const int32 iy, const int32 iz);
+    constexpr ivec3(const int32 x, const ivec2& yz);
+	constexpr ivec3(const ivec2& xy, const int32 z);
 
     ivec3 operator+(const ivec3& other) const;
 	ivec3& operator+=(const ivec3& other);
@@ -43,10 +43,38 @@ public:
 	ivec3 operator/(const int32 val) const;
 	ivec3& operator/=(const int32 val);
 
+	ivec3 operator&(const ivec3& other) const;
+	ivec3& operator&=(const ivec3& other);
+	ivec3 operator|(const ivec3& other) const;
+	ivec3& operator|=(const ivec3& other);
+	ivec3 operator^(const ivec3& other) const;
+	ivec3& operator^=(const ivec3& other);
+	ivec3 operator~() const;
+
+	/**
+	 * Shifts every component left.
+	 *
+	 * \param shift Number of bits to shift by, in [0, 31].
+	 */
+	ivec3 operator<<(const int32 shift) const;
+	ivec3& operator<<=(const int32 shift);
+	/**
+	 * Shifts every component right, replicating the sign bit.
+	 *
+	 * \param shift Number of bits to shift by, in [0, 31].
+	 */
+	ivec3 operator>>(const int32 shift) const;
+	ivec3& operator>>=(const int32 shift);
+
 	flt32 Dot(const ivec3& other) const;
 	ivec3 Cross(const ivec3& other) const;
 	int32 Distance(const ivec3& other) const;
 	
+	ivec3(const simd::int4& vals);
+	#ifdef USE_SIMD
+	ivec3(const __m128i& vals);
+	#endif
+
 	#ifdef DEBUG
 	friend std::ostream& operator<<(std::ostream& os, const ivec3& v)
 	{
@@ -61,143 +89,208 @@ flt32 Dot(const ivec3& v1, const ivec3& v2);
 ivec3 Cross(const ivec3& v1, const ivec3& v2);
 int32 Distance(const ivec3& v1, const ivec3& v2);
 
+ivec3 Min(const ivec3& a, const ivec3& b);
+ivec3 Max(const ivec3& a, const ivec3& b);
+ivec3 Abs(const ivec3& v);
+ivec3 Clamp(const ivec3& v, const ivec3& minimum, const ivec3& maximum);
+
+/**
+ * Component-wise comparisons. Every result is a vmask3 lane mask for Select, Any/All/None, or conversion to bvec3.
+ */
+vmask3 operator==(const ivec3& a, const ivec3& b);
+vmask3 operator!=(const ivec3& a, const ivec3& b);
+vmask3 operator<(const ivec3& a, const ivec3& b);
+vmask3 operator<=(const ivec3& a, const ivec3& b);
+vmask3 operator>(const ivec3& a, const ivec3& b);
+vmask3 operator>=(const ivec3& a, const ivec3& b);
+/**
+ * Branchless per-component select: mask ? a : b.
+ */
+ivec3 Select(const vmask3& mask, const ivec3& a, const ivec3& b);
+
+/**
+ * Loads x, y and z into the first three lanes of a simd::int4, w is zero.
+ *
+ * \param v The ivec3 to load.
+ * \return The loaded simd::int4.
+ */
+inline simd::int4 LoadXYZ(const ivec3& v)
+{
+	return simd::int4::LoadXYZ(v.arr);
+}
+
+/**
+ * Stores the first three lanes of a simd::int4 into an ivec3. Never writes past z.
+ *
+ * \param out The ivec3 to write to.
+ * \param v The simd::int4 to store.
+ */
+inline void StoreXYZ(ivec3& out, const simd::int4& v)
+{
+	v.StoreXYZ(out.arr);
+}
+
+constexpr ivec3::ivec3(int32 val) : x(val), y(val), z(val) {}
+
+constexpr ivec3::ivec3(int32 ix, int32 iy, int32 iz) : x(ix), y(iy), z(iz) {}
+
+constexpr ivec3::ivec3(const int32 x, const ivec2& yz) : x(x), y(yz.x), z(yz.y) {}
+
+constexpr ivec3::ivec3(const ivec2& xy, const int32 z) : x(xy.x), y(xy.y), z(z) {}
+
 #ifdef ENMA_IMPLEMENTATION
-ivec3::ivec3(const ivec3& v)
+ENMA_HOT_FN ivec3::ivec3(const simd::int4& vals)
 {
-	this->x = v.x;
-	this->y = v.y;
-	this->z = v.z;
+	StoreXYZ(*this, vals);
 }
 
-ivec3::ivec3(int32 val) : x(val), y(val), z(val) {}
+#ifdef USE_SIMD
+ENMA_HOT_FN ivec3::ivec3(const __m128i& vals) : ivec3(simd::int4(vals)) {}
+#endif
 
-ivec3::ivec3(int32 ix, int32 iy, int32 iz) : x(ix), y(iy), z(iz) {}
+ENMA_HOT_FN ivec3 ivec3::operator+(const ivec3& other) const
+{
+	return ivec3(LoadXYZ(*this) + LoadXYZ(other));
+}
 
-ivec3::ivec3(const int32 x, const ivec2& yz)
+ENMA_HOT_FN ivec3& ivec3::operator+=(const ivec3& other)
 {
-	this->x = x;
-	this->y = yz.x;
-	this->z = yz.y;
+	return *this = *this + other;
 }
 
-ivec3::ivec3(const ivec2& xy, const int32 z)
+ENMA_HOT_FN ivec3 ivec3::operator-() const
 {
-	this->x = xy.x;
-	this->y = xy.y;
-	this->z = z;
+	return ivec3(simd::int4::Zero() - LoadXYZ(*this));
 }
 
-ivec3 ivec3::operator+(const ivec3& other) const
+ENMA_HOT_FN ivec3 ivec3::operator-(const ivec3& other) const
 {
-	return ivec3(this->x + other.x, this->y + other.y, this->z + other.z);
+	return ivec3(LoadXYZ(*this) - LoadXYZ(other));
 }
 
-ivec3& ivec3::operator+=(const ivec3& other)
+ENMA_HOT_FN ivec3& ivec3::operator-=(const ivec3& other)
 {
-	this->x += other.x;
-	this->y += other.y;
-	this->z += other.z;
+	return *this = *this - other;
+}
 
-	return *this;
+ENMA_HOT_FN ivec3 ivec3::operator*(const ivec3& other) const
+{
+	return ivec3(LoadXYZ(*this) * LoadXYZ(other));
 }
 
-ivec3 ivec3::operator-() const
+ENMA_HOT_FN ivec3& ivec3::operator*=(const ivec3& other)
 {
-	return ivec3(-x, -y, -z);
+	return *this = *this * other;
 }
 
-ivec3 ivec3::operator-(const ivec3& other) const
+ENMA_HOT_FN ivec3 ivec3::operator*(const int32 val) const
 {
-	return ivec3(this->x - other.x, this->y - other.y, this->z - other.z);
+	return ivec3(LoadXYZ(*this) * simd::int4::Set1(val));
 }
 
-ivec3& ivec3::operator-=(const ivec3& other)
+ENMA_HOT_FN ivec3& ivec3::operator*=(const int32 val)
 {
-	this->x -= other.x;
-	this->y -= other.y;
-	this->z -= other.z;
-	
-	return *this;
+	return *this = *this * val;
 }
 
-ivec3 ivec3::operator*(const ivec3& other) const
+// No integer divide instruction, one hardware divide per component
+ENMA_HOT_FN ivec3 ivec3::operator/(const ivec3& other) const
 {
-	return ivec3(this->x * other.x, this->y * other.y, this->z * other.z);
+	return ivec3(this->x / other.x, this->y / other.y, this->z / other.z);
 }
 
-ivec3& ivec3::operator*=(const ivec3& other)
+ENMA_HOT_FN ivec3& ivec3::operator/=(const ivec3& other)
 {
-	this->x *= other.x;
-	this->y *= other.y;
-	this->z *= other.z;
+	return *this = *this / other;
+}
+
+ENMA_HOT_FN ivec3 ivec3::operator/(const int32 val) const
+{
+	return ivec3(this->x / val, this->y / val, this->z / val);
+}
 
-	return *this;
+ENMA_HOT_FN ivec3& ivec3::operator/=(const int32 val)
+{
+	return *this = *this / val;
 }
 
-ivec3 ivec3::operator*(const int32 val) const
+ENMA_HOT_FN ivec3 ivec3::operator&(const ivec3& other) const
 {
-	return ivec3(this->x * val, this->y * val, this->z * val);
+	return ivec3(simd::And(LoadXYZ(*this), LoadXYZ(other)));
 }
 
-ivec3& ivec3::operator*=(const int32 val)
+ENMA_HOT_FN ivec3& ivec3::operator&=(const ivec3& other)
 {
-	this->x *= val;
-	this->y *= val;
-	this->z *= val;
+	return *this = *this & other;
+}
 
-	return *this;
+ENMA_HOT_FN ivec3 ivec3::operator|(const ivec3& other) const
+{
+	return ivec3(simd::Or(LoadXYZ(*this), LoadXYZ(other)));
 }
 
-ivec3 ivec3::operator/(const ivec3& other) const
+ENMA_HOT_FN ivec3& ivec3::operator|=(const ivec3& other)
 {
-	return ivec3(this->x / other.x, this->y / other.y, this->z / other.z);
+	return *this = *this | other;
 }
 
-ivec3& ivec3::operator/=(const ivec3& other)
+ENMA_HOT_FN ivec3 ivec3::operator^(const ivec3& other) const
 {
-	this->x /= other.x;
-	this->y /= other.y;
-	this->z /= other.z;
+	return ivec3(simd::Xor(LoadXYZ(*this), LoadXYZ(other)));
+}
 
-	return *this;
+ENMA_HOT_FN ivec3& ivec3::operator^=(const ivec3& other)
+{
+	return *this = *this ^ other;
 }
 
-ivec3 ivec3::operator/(const int32 val) const
+ENMA_HOT_FN ivec3 ivec3::operator~() const
 {
-	return ivec3(this->x / val, this->y / val, this->z / val);
+	return ivec3(simd::Xor(LoadXYZ(*this), simd::int4::Set1(-1)));
 }
 
-ivec3& ivec3::operator/=(const int32 val)
+ENMA_HOT_FN ivec3 ivec3::operator<<(const int32 shift) const
 {
-	this->x /= val;
-	this->y /= val;
-	this->z /= val;
+	return ivec3(simd::ShiftLeft(LoadXYZ(*this), shift));
+}
 
-	return *this;
+ENMA_HOT_FN ivec3& ivec3::operator<<=(const int32 shift)
+{
+	return *this = *this << shift;
 }
 
-flt32 ivec3::Dot(const ivec3& other) const
+ENMA_HOT_FN ivec3 ivec3::operator>>(const int32 shift) const
+{
+	return ivec3(simd::ShiftRight(LoadXYZ(*this), shift));
+}
+
+ENMA_HOT_FN ivec3& ivec3::operator>>=(const int32 shift)
+{
+	return *this = *this >> shift;
+}
+
+ENMA_HOT_FN flt32 ivec3::Dot(const ivec3& other) const
 {
 	return this->x * other.x + this->y * other.y + this->z * other.z;
 }
 
-flt32 Dot(const ivec3& v1, const ivec3& v2)
+ENMA_HOT_FN flt32 Dot(const ivec3& v1, const ivec3& v2)
 {
 	return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z;
 }	
 
-ivec3 ivec3::Cross(const ivec3& other) const
+ENMA_HOT_FN ivec3 ivec3::Cross(const ivec3& other) const
 {
 	return ivec3(this->y * other.z - this->z * other.y, this->z * other.x - this->x * other.z, this->x * other.y - this->y * other.x);
 }
 
-ivec3 Cross(const ivec3& v1, const ivec3& v2)
+ENMA_HOT_FN ivec3 Cross(const ivec3& v1, const ivec3& v2)
 {
 	return ivec3(v1.y * v2.z - v1.z * v2.y, v1.z * v2.x - v1.x * v2.z, v1.x * v2.y - v1.y * v2.x);
 }
 
 // Not Tested Yet - Maybe Removed
-int32 ivec3::Distance(const ivec3& other) const
+ENMA_HOT_FN int32 ivec3::Distance(const ivec3& other) const
 {
 	const flt32 xt = this->x - other.x;
 	const flt32 yt = this->y - other.y;
@@ -207,7 +300,7 @@ int32 ivec3::Distance(const ivec3& other) const
 }
 
 // Not Tested Yet - Maybe Removed or the type be changed
-int32 Distance(const ivec3& v1, const ivec3& v2)
+ENMA_HOT_FN int32 Distance(const ivec3& v1, const ivec3& v2)
 {
 	const flt32 xt = v1.x - v2.x;
 	const flt32 yt = v1.y - v2.y;
@@ -215,4 +308,60 @@ int32 Distance(const ivec3& v1, const ivec3& v2)
 
 	return sqrt(xt * xt + yt * yt + zt * zt);
 }
+
+ENMA_HOT_FN ivec3 Min(const ivec3& a, const ivec3& b)
+{
+	return ivec3(simd::Min(LoadXYZ(a), LoadXYZ(b)));
+}
+
+ENMA_HOT_FN ivec3 Max(const ivec3& a, const ivec3& b)
+{
+	return ivec3(simd::Max(LoadXYZ(a), LoadXYZ(b)));
+}
+
+ENMA_HOT_FN ivec3 Abs(const ivec3& v)
+{
+	return ivec3(simd::Abs(LoadXYZ(v)));
+}
+
+ENMA_HOT_FN ivec3 Clamp(const ivec3& v, const ivec3& minimum, const ivec3& maximum)
+{
+	return ivec3(simd::Min(simd::Max(LoadXYZ(v), LoadXYZ(minimum)), LoadXYZ(maximum)));
+}
+
+ENMA_HOT_FN vmask3 operator==(const ivec3& a, const ivec3& b)
+{
+	return vmask3(simd::CmpEq(LoadXYZ(a), LoadXYZ(b)));
+}
+
+ENMA_HOT_FN vmask3 operator!=(const ivec3& a, const ivec3& b)
+{
+	return ~(a == b);
+}
+
+ENMA_HOT_FN vmask3 operator<(const ivec3& a, const ivec3& b)
+{
+	return vmask3(simd::CmpLt(LoadXYZ(a), LoadXYZ(b)));
+}
+
+ENMA_HOT_FN vmask3 operator<=(const ivec3& a, const ivec3& b)
+{
+	return ~(a > b);
+}
+
+ENMA_HOT_FN vmask3 operator>(const ivec3& a, const ivec3& b)
+{
+	return vmask3(simd::CmpGt(LoadXYZ(a), LoadXYZ(b)));
+}
+
+ENMA_HOT_FN vmask3 operator>=(const ivec3& a, const ivec3& b)
+{
+	return ~(a < b);
+}
+
+ENMA_HOT_FN ivec3 Select(const vmask3& mask, const ivec3& a, const ivec3& b)
+{
+	return ivec3(simd::Select(mask.lanes, LoadXYZ(a), LoadXYZ(b)));
+}
+
 #endif
\ No newline at end of file
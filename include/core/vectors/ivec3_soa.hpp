@@ -0,0 +1,354 @@
+/* Structure-of-Arrays Stream of 3 Component Integer Vectors
+ *
+ * This header file is part of Enmatica library
+ *
+ * Copyright (c) 202X by Villainous Softworks
+ *
+ */
+
+#pragma once
+#include "ivec3.hpp"
+#include "fvec3_soa.hpp"
+#include "../../base.hpp"
+#include "../../empch.hpp"
+#include "../simd.hpp"
+
+/**
+ * A stream of ivec3 stored as three separate component arrays.
+ *
+ * Shares the layout of fvec3_soa: 64-byte aligned arrays padded to a multiple of 16 elements,
+ * processed 8 lanes at a time through simd::int8. Padding lanes are zero-filled and never read back.
+ *
+ * These functions have no runtime-dispatched tiers: simd::int8 is one __m256i only when the translation
+ * unit is compiled with `-mavx2`, on the SSE4.1 baseline every step runs as two int4 halves.
+ */
+struct ivec3_soa
+{
+	int32* x;
+	int32* y;
+	int32* z;
+
+	uin32 count;		// Number of vectors stored
+	uin32 capacity;		// Number of allocated lanes, always a multiple of 16
+
+	/**
+	 * Constructor with a vector count.
+	 *
+	 * \param count Number of vectors to allocate. All components are zero-initialised.
+	 */
+	explicit ivec3_soa(uin32 count = 0);
+	/**
+	 * Array constructor.
+	 *
+	 * Transposes an array of ivec3 into component arrays.
+	 *
+	 * \param vecs Pointer to an array of at least `count` ivec3 elements.
+	 * \param count Number of vectors to copy.
+	 */
+	ivec3_soa(const ivec3* vecs, uin32 count);
+	/**
+	 * Copy constructor.
+	 *
+	 * \param s Another ivec3_soa to copy from.
+	 */
+	ivec3_soa(const ivec3_soa& s);
+	/**
+	 * Move constructor.
+	 *
+	 * \param s Another ivec3_soa whose storage is taken over.
+	 */
+	ivec3_soa(ivec3_soa&& s) noexcept;
+	~ivec3_soa();
+
+	ivec3_soa& operator=(const ivec3_soa& s);
+	ivec3_soa& operator=(ivec3_soa&& s) noexcept;
+
+	/**
+	 * Indexing operator.
+	 *
+	 * \param index Index of the vector to gather.
+	 * \return The ivec3 stored at the specified `index`.
+	 */
+	ivec3 operator[](uin32 index) const;
+	/**
+	 * Scatters a vector into the stream.
+	 *
+	 * \param index Index of the vector to overwrite.
+	 * \param v The ivec3 to store.
+	 */
+	void Set(uin32 index, const ivec3& v);
+	/**
+	 * Transposes the stream back into an array of ivec3.
+	 *
+	 * \param out Pointer to an array of at least `count` ivec3 elements.
+	 */
+	void Store(ivec3* out) const;
+
+	/**
+	 * Addition assignment operator.
+	 *
+	 * \param other The other ivec3_soa. Must hold the same number of vectors.
+	 * \return Reference to the modified ivec3_soa after addition.
+	 */
+	ivec3_soa& operator+=(const ivec3_soa& other);
+	/**
+	 * Subtraction assignment operator.
+	 *
+	 * \param other The other ivec3_soa. Must hold the same number of vectors.
+	 * \return Reference to the modified ivec3_soa after subtraction.
+	 */
+	ivec3_soa& operator-=(const ivec3_soa& other);
+	/**
+	 * Multiplication assignment operator (element-wise).
+	 *
+	 * \param other The other ivec3_soa. Must hold the same number of vectors.
+	 * \return Reference to the modified ivec3_soa after multiplication.
+	 */
+	ivec3_soa& operator*=(const ivec3_soa& other);
+	/**
+	 * Multiplication assignment operator (scalar).
+	 *
+	 * \param val A scalar value.
+	 * \return Reference to the modified ivec3_soa after multiplication.
+	 */
+	ivec3_soa& operator*=(int32 val);
+	/**
+	 * Left shift assignment operator.
+	 *
+	 * \param shift Number of bits to shift every component by.
+	 * \return Reference to the modified ivec3_soa after shifting.
+	 */
+	ivec3_soa& operator<<=(int32 shift);
+	/**
+	 * Arithmetic right shift assignment operator.
+	 *
+	 * \param shift Number of bits to shift every component by.
+	 * \return Reference to the modified ivec3_soa after shifting.
+	 */
+	ivec3_soa& operator>>=(int32 shift);
+};
+
+/**
+ * Adds two streams component-wise: out[i] = a[i] + b[i].
+ */
+void Add(const ivec3_soa& a, const ivec3_soa& b, ivec3_soa& out);
+/**
+ * Subtracts two streams component-wise: out[i] = a[i] - b[i].
+ */
+void Sub(const ivec3_soa& a, const ivec3_soa& b, ivec3_soa& out);
+/**
+ * Multiplies two streams component-wise: out[i] = a[i] * b[i].
+ */
+void Mul(const ivec3_soa& a, const ivec3_soa& b, ivec3_soa& out);
+/**
+ * Component-wise minimum of two streams: out[i] = Min(a[i], b[i]).
+ */
+void Min(const ivec3_soa& a, const ivec3_soa& b, ivec3_soa& out);
+/**
+ * Component-wise maximum of two streams: out[i] = Max(a[i], b[i]).
+ */
+void Max(const ivec3_soa& a, const ivec3_soa& b, ivec3_soa& out);
+/**
+ * Component-wise absolute value of a stream: out[i] = Abs(v[i]).
+ */
+void Abs(const ivec3_soa& v, ivec3_soa& out);
+/**
+ * Clamps every vector of a stream to a box: out[i] = Clamp(v[i], minimum, maximum).
+ */
+void Clamp(const ivec3_soa& v, const ivec3& minimum, const ivec3& maximum, ivec3_soa& out);
+
+#ifdef ENMA_IMPLEMENTATION
+ENMA_FN ivec3_soa::ivec3_soa(uin32 count) : count(count), capacity(SoaCapacity(count))
+{
+	this->x = SoaAlloc<int32>(capacity);
+	this->y = SoaAlloc<int32>(capacity);
+	this->z = SoaAlloc<int32>(capacity);
+}
+
+ENMA_FN ivec3_soa::ivec3_soa(const ivec3* vecs, uin32 count) : ivec3_soa(count)
+{
+	for(uin32 i = 0; i < count; i++)
+	{
+		this->x[i] = vecs[i].x;
+		this->y[i] = vecs[i].y;
+		this->z[i] = vecs[i].z;
+	}
+}
+
+ENMA_FN ivec3_soa::ivec3_soa(const ivec3_soa& s) : ivec3_soa(s.count)
+{
+	std::copy(s.x, s.x + capacity, this->x);
+	std::copy(s.y, s.y + capacity, this->y);
+	std::copy(s.z, s.z + capacity, this->z);
+}
+
+ENMA_FN ivec3_soa::ivec3_soa(ivec3_soa&& s) noexcept : x(s.x), y(s.y), z(s.z), count(s.count), capacity(s.capacity)
+{
+	s.x = s.y = s.z = nullptr;
+	s.count = s.capacity = 0;
+}
+
+ENMA_FN ivec3_soa::~ivec3_soa()
+{
+	_mm_free(this->x);
+	_mm_free(this->y);
+	_mm_free(this->z);
+}
+
+ENMA_FN ivec3_soa& ivec3_soa::operator=(const ivec3_soa& s)
+{
+	if(this != &s)
+	{
+		*this = ivec3_soa(s);
+	}
+
+	return *this;
+}
+
+ENMA_FN ivec3_soa& ivec3_soa::operator=(ivec3_soa&& s) noexcept
+{
+	std::swap(this->x, s.x);
+	std::swap(this->y, s.y);
+	std::swap(this->z, s.z);
+	std::swap(this->count, s.count);
+	std::swap(this->capacity, s.capacity);
+
+	return *this;
+}
+
+ENMA_FN ivec3 ivec3_soa::operator[](uin32 index) const
+{
+	return ivec3(x[index], y[index], z[index]);
+}
+
+ENMA_FN void ivec3_soa::Set(uin32 index, const ivec3& v)
+{
+	this->x[index] = v.x;
+	this->y[index] = v.y;
+	this->z[index] = v.z;
+}
+
+ENMA_FN void ivec3_soa::Store(ivec3* out) const
+{
+	for(uin32 i = 0; i < count; i++)
+	{
+		out[i] = ivec3(x[i], y[i], z[i]);
+	}
+}
+
+// Applies `op` to each component array 8 lanes at a time; simd::int8 splits into two int4 halves without AVX2
+template <typename Op>
+inline void SoaApply(const ivec3_soa& a, const ivec3_soa& b, ivec3_soa& out, Op op)
+{
+	for(uin32 i = 0; i < a.capacity; i += 8)
+	{
+		op(simd::int8::Load(a.x + i), simd::int8::Load(b.x + i)).Store(out.x + i);
+		op(simd::int8::Load(a.y + i), simd::int8::Load(b.y + i)).Store(out.y + i);
+		op(simd::int8::Load(a.z + i), simd::int8::Load(b.z + i)).Store(out.z + i);
+	}
+}
+
+template <typename Op>
+inline void SoaApply(const ivec3_soa& v, ivec3_soa& out, Op op)
+{
+	for(uin32 i = 0; i < v.capacity; i += 8)
+	{
+		op(simd::int8::Load(v.x + i)).Store(out.x + i);
+		op(simd::int8::Load(v.y + i)).Store(out.y + i);
+		op(simd::int8::Load(v.z + i)).Store(out.z + i);
+	}
+}
+
+ENMA_FN ivec3_soa& ivec3_soa::operator+=(const ivec3_soa& other)
+{
+	Add(*this, other, *this);
+
+	return *this;
+}
+
+ENMA_FN ivec3_soa& ivec3_soa::operator-=(const ivec3_soa& other)
+{
+	Sub(*this, other, *this);
+
+	return *this;
+}
+
+ENMA_FN ivec3_soa& ivec3_soa::operator*=(const ivec3_soa& other)
+{
+	Mul(*this, other, *this);
+
+	return *this;
+}
+
+ENMA_FN ivec3_soa& ivec3_soa::operator*=(int32 val)
+{
+	const simd::int8 s = simd::int8::Set1(val);
+
+	SoaApply(*this, *this, [s](const simd::int8& v) { return v * s; });
+
+	return *this;
+}
+
+ENMA_FN ivec3_soa& ivec3_soa::operator<<=(int32 shift)
+{
+	SoaApply(*this, *this, [shift](const simd::int8& v) { return simd::ShiftLeft(v, shift); });
+
+	return *this;
+}
+
+ENMA_FN ivec3_soa& ivec3_soa::operator>>=(int32 shift)
+{
+	SoaApply(*this, *this, [shift](const simd::int8& v) { return simd::ShiftRight(v, shift); });
+
+	return *this;
+}
+
+ENMA_FN void Add(const ivec3_soa& a, const ivec3_soa& b, ivec3_soa& out)
+{
+	SoaApply(a, b, out, [](const simd::int8& l, const simd::int8& r) { return l + r; });
+}
+
+ENMA_FN void Sub(const ivec3_soa& a, const ivec3_soa& b, ivec3_soa& out)
+{
+	SoaApply(a, b, out, [](const simd::int8& l, const simd::int8& r) { return l - r; });
+}
+
+ENMA_FN void Mul(const ivec3_soa& a, const ivec3_soa& b, ivec3_soa& out)
+{
+	SoaApply(a, b, out, [](const simd::int8& l, const simd::int8& r) { return l * r; });
+}
+
+ENMA_FN void Min(const ivec3_soa& a, const ivec3_soa& b, ivec3_soa& out)
+{
+	SoaApply(a, b, out, [](const simd::int8& l, const simd::int8& r) { return simd::Min(l, r); });
+}
+
+ENMA_FN void Max(const ivec3_soa& a, const ivec3_soa& b, ivec3_soa& out)
+{
+	SoaApply(a, b, out, [](const simd::int8& l, const simd::int8& r) { return simd::Max(l, r); });
+}
+
+ENMA_FN void Abs(const ivec3_soa& v, ivec3_soa& out)
+{
+	SoaApply(v, out, [](const simd::int8& l) { return simd::Abs(l); });
+}
+
+ENMA_FN void Clamp(const ivec3_soa& v, const ivec3& minimum, const ivec3& maximum, ivec3_soa& out)
+{
+	const simd::int8 minX = simd::int8::Set1(minimum.x), minY = simd::int8::Set1(minimum.y), minZ = simd::int8::Set1(minimum.z);
+	const simd::int8 maxX = simd::int8::Set1(maximum.x), maxY = simd::int8::Set1(maximum.y), maxZ = simd::int8::Set1(maximum.z);
+
+	for(uin32 i = 0; i < v.capacity; i += 8)
+	{
+		simd::Min(simd::Max(simd::int8::Load(v.x + i), minX), maxX).Store(out.x + i);
+		simd::Min(simd::Max(simd::int8::Load(v.y + i), minY), maxY).Store(out.y + i);
+		simd::Min(simd::Max(simd::int8::Load(v.z + i), minZ), maxZ).Store(out.z + i);
+	}
+
+	// A box that excludes zero clamps the padding lanes too, zero them again
+	std::fill(out.x + v.count, out.x + v.capacity, 0);
+	std::fill(out.y + v.count, out.y + v.capacity, 0);
+	std::fill(out.z + v.count, out.z + v.capacity, 0);
+}
+
+#endif // ENMA_IMPLEMENTATION
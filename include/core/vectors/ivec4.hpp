@@ -11,6 +11,7 @@
 #include "ivec3.hpp"
 #include "../../base.hpp"
 #include "../../empch.hpp"
+#include "vmask.hpp"
 
 struct ALIGN(16) ivec4
 {
@@ -26,13 +27,12 @@ struct ALIGN(16) ivec4
 		#endif
     };
 
-    ivec4(const ivec4& v);
-	ivec4(const int32 val = 0);
-    ivec4(const int32 ix, const int32 iy, const int32 iz, const int32 iw);
-    ivec4(const int32* arr);
-	ivec4(const ivec2& v1, const ivec2& v2);
-	ivec4(const int32 x, const ivec3& yzw);
-	ivec4(const ivec3& xyz, const int32 w);
+	constexpr ivec4(const int32 val = 0);
+    constexpr ivec4(const int32 ix, const int32 iy, const int32 iz, const int32 iw);
+    constexpr ivec4(const int32* arr);
+	constexpr ivec4(const ivec2& v1, const ivec2& v2);
+	constexpr ivec4(const int32 x, const ivec3& yzw);
+	constexpr ivec4(const ivec3& xyz, const int32 w);
 
     ivec4 operator+(const ivec4& other) const;
 	ivec4& operator+=(const ivec4& other);
@@ -48,9 +48,33 @@ struct ALIGN(16) ivec4
 	ivec4 operator/(const int32 val) const;
 	ivec4& operator/=(const int32 val);
 
+	ivec4 operator&(const ivec4& other) const;
+	ivec4& operator&=(const ivec4& other);
+	ivec4 operator|(const ivec4& other) const;
+	ivec4& operator|=(const ivec4& other);
+	ivec4 operator^(const ivec4& other) const;
+	ivec4& operator^=(const ivec4& other);
+	ivec4 operator~() const;
+
+	/**
+	 * Shifts every component left.
+	 *
+	 * \param shift Number of bits to shift by, in [0, 31].
+	 */
+	ivec4 operator<<(const int32 shift) const;
+	ivec4& operator<<=(const int32 shift);
+	/**
+	 * Shifts every component right, replicating the sign bit.
+	 *
+	 * \param shift Number of bits to shift by, in [0, 31].
+	 */
+	ivec4 operator>>(const int32 shift) const;
+	ivec4& operator>>=(const int32 shift);
+
 	int32 Dot(const ivec4& other) const;
 	int32 Distance(const ivec4& other) const;
 
+	ivec4(const simd::int4& vals);
 	#ifdef USE_SIMD
 	ivec4(const __m128i& vals);
 	#endif
@@ -68,165 +92,210 @@ struct ALIGN(16) ivec4
 int32 Dot(const ivec4& v1, const ivec4& v2);
 int32 Distance(const ivec4& v1, const ivec4& v2);
 
-#ifdef ENMA_IMPLEMENTATION
-ivec4::ivec4(const ivec4& v)
+ivec4 Min(const ivec4& a, const ivec4& b);
+ivec4 Max(const ivec4& a, const ivec4& b);
+ivec4 Abs(const ivec4& v);
+ivec4 Clamp(const ivec4& v, const ivec4& minimum, const ivec4& maximum);
+
+/**
+ * Component-wise comparisons. Every result is a vmask4 lane mask for Select, Any/All/None, or conversion to bvec4.
+ */
+vmask4 operator==(const ivec4& a, const ivec4& b);
+vmask4 operator!=(const ivec4& a, const ivec4& b);
+vmask4 operator<(const ivec4& a, const ivec4& b);
+vmask4 operator<=(const ivec4& a, const ivec4& b);
+vmask4 operator>(const ivec4& a, const ivec4& b);
+vmask4 operator>=(const ivec4& a, const ivec4& b);
+/**
+ * Branchless per-component select: mask ? a : b.
+ */
+ivec4 Select(const vmask4& mask, const ivec4& a, const ivec4& b);
+
+/**
+ * Loads all four components into a simd::int4.
+ *
+ * \param v The ivec4 to load.
+ * \return The loaded simd::int4.
+ */
+inline simd::int4 LoadXYZW(const ivec4& v)
+{
+	#ifdef USE_SIMD
+	return v.vals;
+	#else
+	return simd::int4::LoadU(v.arr);
+	#endif
+}
+
+/**
+ * Stores a simd::int4 into an ivec4.
+ *
+ * \param out The ivec4 to write to.
+ * \param v The simd::int4 to store.
+ */
+inline void StoreXYZW(ivec4& out, const simd::int4& v)
 {
-	this->x = v.x;
+	#ifdef USE_SIMD
+	out.vals = v;
+	#else
+	v.StoreU(out.arr);
+	#endif
 }
 
-ivec4::ivec4(const int32 val) : x(val), y(val), z(val), w(val) {}
+constexpr ivec4::ivec4(const int32 val) : x(val), y(val), z(val), w(val) {}
+
+constexpr ivec4::ivec4(const int32 ix, const int32 iy, const int32 iz, const int32 iw) : x(ix), y(iy), z(iz), w(iw) {}
+
+constexpr ivec4::ivec4(const int32* arr) : x(arr[0]), y(arr[1]), z(arr[2]), w(arr[3]) {}
+
+constexpr ivec4::ivec4(const ivec2& v1, const ivec2& v2) : x(v1.x), y(v1.y), z(v2.x), w(v2.y) {}
 
-ivec4::ivec4(const int32 ix, const int32 iy, const int32 iz, const int32 iw) : x(ix), y(iy), z(iz), w(iw) {}
+constexpr ivec4::ivec4(const int32 x, const ivec3& yzw) : x(x), y(yzw.x), z(yzw.y), w(yzw.z) {}
 
-ivec4::ivec4(const int32* arr)
+constexpr ivec4::ivec4(const ivec3& xyz, const int32 w) : x(xyz.x), y(xyz.y), z(xyz.z), w(w) {}
+
+#ifdef ENMA_IMPLEMENTATION
+ENMA_HOT_FN ivec4::ivec4(const simd::int4& vals)
 {
-	this->arr[0] = arr[0];
-	this->arr[1] = arr[1];
-	this->arr[2] = arr[2];
-	this->arr[3] = arr[3];
+	StoreXYZW(*this, vals);
 }
 
-ivec4::ivec4(const ivec2& v1, const ivec2& v2)
+#ifdef USE_SIMD
+ENMA_HOT_FN ivec4::ivec4(const __m128i& vals) : ivec4(simd::int4(vals)) {}
+#endif
+
+ENMA_HOT_FN ivec4 ivec4::operator+(const ivec4& other) const
 {
-	this->x = v1.x;
-	this->y = v1.y;
-	this->z = v2.x;
-	this->w = v2.y;
+	return ivec4(LoadXYZW(*this) + LoadXYZW(other));
 }
 
-ivec4::ivec4(const int32 x, const ivec3& yzw)
+ENMA_HOT_FN ivec4& ivec4::operator+=(const ivec4& other)
 {
-	this->x = x;
-	this->y = yzw.x;
-	this->z = yzw.y;
-	this->w = yzw.z;
+	return *this = *this + other;
 }
 
-ivec4::ivec4(const ivec3& xyz, const int32 w)
+ENMA_HOT_FN ivec4 ivec4::operator-() const
 {
-	this->x = xyz.x;
-	this->y = xyz.y;
-	this->z = xyz.z;
-	this->w = w;
+	return ivec4(simd::int4::Zero() - LoadXYZW(*this));
 }
 
-#ifdef USE_SIMD
-
-ivec4::ivec4(const __m128i& vals)
+ENMA_HOT_FN ivec4 ivec4::operator-(const ivec4& other) const
 {
-	this->vals = vals;
+	return ivec4(LoadXYZW(*this) - LoadXYZW(other));
 }
 
-#endif
+ENMA_HOT_FN ivec4& ivec4::operator-=(const ivec4& other)
+{
+	return *this = *this - other;
+}
 
-ivec4 ivec4::operator+(const ivec4& other) const
+ENMA_HOT_FN ivec4 ivec4::operator*(const ivec4& other) const
 {
-	return ivec4(this->x + other.x, this->y + other.y, this->z + other.z, this->w + other.w);
+	return ivec4(LoadXYZW(*this) * LoadXYZW(other));
 }
 
-ivec4& ivec4::operator+=(const ivec4 &other)
+ENMA_HOT_FN ivec4& ivec4::operator*=(const ivec4& other)
 {
-	this->x += other.x;
-	this->y += other.y;
-	this->z += other.z;
-	this->w += other.w;
+	return *this = *this * other;
+}
 
-	return *this;
+ENMA_HOT_FN ivec4 ivec4::operator*(const int32 val) const
+{
+	return ivec4(LoadXYZW(*this) * simd::int4::Set1(val));
 }
 
-ivec4 ivec4::operator-() const
+ENMA_HOT_FN ivec4& ivec4::operator*=(const int32 val)
 {
-	return ivec4(-x, -y, -z, -w);
+	return *this = *this * val;
 }
 
-ivec4 ivec4::operator-(const ivec4& other) const
+// No integer divide instruction, one hardware divide per component
+ENMA_HOT_FN ivec4 ivec4::operator/(const ivec4& other) const
 {
-	return ivec4(this->x - other.x, this->y - other.y, this->z - other.z, this->w - other.w);
+	return ivec4(this->x / other.x, this->y / other.y, this->z / other.z, this->w / other.w);
 }
 
-ivec4& ivec4::operator-=(const ivec4& other)
+ENMA_HOT_FN ivec4& ivec4::operator/=(const ivec4& other)
 {
-	this->x -= other.x;
-	this->y -= other.y;
-	this->z -= other.z;
-	this->w -= other.w;
+	return *this = *this / other;
+}
 
-	return *this;
+ENMA_HOT_FN ivec4 ivec4::operator/(const int32 val) const
+{
+	return ivec4(this->x / val, this->y / val, this->z / val, this->w / val);
 }
 
-ivec4 ivec4::operator*(const ivec4& other) const
+ENMA_HOT_FN ivec4& ivec4::operator/=(const int32 val)
 {
-	return ivec4(this->x * other.x, this->y * other.y, this->z * other.z, this->w * other.w);
+	return *this = *this / val;
 }
 
-ivec4& ivec4::operator*=(const ivec4& other)
+ENMA_HOT_FN ivec4 ivec4::operator&(const ivec4& other) const
 {
-	this->x *= other.x;
-	this->y *= other.y;
-	this->z *= other.z;
-	this->w *= other.w;
-	
-	return *this;
+	return ivec4(simd::And(LoadXYZW(*this), LoadXYZW(other)));
 }
 
-ivec4 ivec4::operator*(const int32 val) const
+ENMA_HOT_FN ivec4& ivec4::operator&=(const ivec4& other)
 {
-	return ivec4(this->x * val, this->y * val, this->z * val, this->w * val);
+	return *this = *this & other;
 }
 
-ivec4& ivec4::operator*=(const int32 val)
+ENMA_HOT_FN ivec4 ivec4::operator|(const ivec4& other) const
 {
-	this->x *= val;
-	this->y *= val;
-	this->z *= val;
-	this->w *= val;
+	return ivec4(simd::Or(LoadXYZW(*this), LoadXYZW(other)));
+}
 
-	return *this;
+ENMA_HOT_FN ivec4& ivec4::operator|=(const ivec4& other)
+{
+	return *this = *this | other;
 }
 
-ivec4 ivec4::operator/(const ivec4& other) const
+ENMA_HOT_FN ivec4 ivec4::operator^(const ivec4& other) const
 {
-	return ivec4(this->x / other.x, this->y / other.y, this->z / other.z, this->w / other.w);
+	return ivec4(simd::Xor(LoadXYZW(*this), LoadXYZW(other)));
 }
 
-ivec4& ivec4::operator/=(const ivec4 &other)
+ENMA_HOT_FN ivec4& ivec4::operator^=(const ivec4& other)
 {
-	this->x /= other.x;
-	this->y /= other.y;
-	this->z /= other.z;
-	this->w /= other.w;
+	return *this = *this ^ other;
+}
 
-	return *this;
+ENMA_HOT_FN ivec4 ivec4::operator~() const
+{
+	return ivec4(simd::Xor(LoadXYZW(*this), simd::int4::Set1(-1)));
 }
 
-ivec4 ivec4::operator/(const int32 val) const
+ENMA_HOT_FN ivec4 ivec4::operator<<(const int32 shift) const
 {
+	return ivec4(simd::ShiftLeft(LoadXYZW(*this), shift));
+}
 
-	return ivec4(this->x / val, this->y / val, this->z / val, this->w / val);
+ENMA_HOT_FN ivec4& ivec4::operator<<=(const int32 shift)
+{
+	return *this = *this << shift;
 }
 
-ivec4& ivec4::operator/=(const int32 val)
+ENMA_HOT_FN ivec4 ivec4::operator>>(const int32 shift) const
 {
-	this->x /= val;
-	this->y /= val;
-	this->z /= val;
-	this->w /= val;
+	return ivec4(simd::ShiftRight(LoadXYZW(*this), shift));
+}
 
-	return *this;
+ENMA_HOT_FN ivec4& ivec4::operator>>=(const int32 shift)
+{
+	return *this = *this >> shift;
 }
 
-int32 ivec4::Dot(const ivec4& other) const
+ENMA_HOT_FN int32 ivec4::Dot(const ivec4& other) const
 {
 	return this->x * other.x + this->y * other.y + this->z * other.z + this->w * other.w;
 }
 
-int32 Dot(const ivec4& v1, const ivec4& v2)
+ENMA_HOT_FN int32 Dot(const ivec4& v1, const ivec4& v2)
 {
 	return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z + v1.w * v2.w;
 }
 
 // Not Tested Yet - Maybe Removed
-int32 ivec4::Distance(const ivec4& other) const
+ENMA_HOT_FN int32 ivec4::Distance(const ivec4& other) const
 {
 	const flt32 xt = this->x - other.x;
 	const flt32 yt = this->y - other.y;
@@ -237,7 +306,7 @@ int32 ivec4::Distance(const ivec4& other) const
 }
 
 // Not Tested Yet - Maybe Removed
-int32 Distance(const ivec4& v1, const ivec4& v2)
+ENMA_HOT_FN int32 Distance(const ivec4& v1, const ivec4& v2)
 {
 	const flt32 xt = v1.x - v2.x;
 	const flt32 yt = v1.y - v2.y;
@@ -247,4 +316,59 @@ int32 Distance(const ivec4& v1, const ivec4& v2)
 	return sqrt(xt * xt + yt * yt + zt * zt + wt * wt);
 }
 
+ENMA_HOT_FN ivec4 Min(const ivec4& a, const ivec4& b)
+{
+	return ivec4(simd::Min(LoadXYZW(a), LoadXYZW(b)));
+}
+
+ENMA_HOT_FN ivec4 Max(const ivec4& a, const ivec4& b)
+{
+	return ivec4(simd::Max(LoadXYZW(a), LoadXYZW(b)));
+}
+
+ENMA_HOT_FN ivec4 Abs(const ivec4& v)
+{
+	return ivec4(simd::Abs(LoadXYZW(v)));
+}
+
+ENMA_HOT_FN ivec4 Clamp(const ivec4& v, const ivec4& minimum, const ivec4& maximum)
+{
+	return ivec4(simd::Min(simd::Max(LoadXYZW(v), LoadXYZW(minimum)), LoadXYZW(maximum)));
+}
+
+ENMA_HOT_FN vmask4 operator==(const ivec4& a, const ivec4& b)
+{
+	return vmask4(simd::CmpEq(LoadXYZW(a), LoadXYZW(b)));
+}
+
+ENMA_HOT_FN vmask4 operator!=(const ivec4& a, const ivec4& b)
+{
+	return ~(a == b);
+}
+
+ENMA_HOT_FN vmask4 operator<(const ivec4& a, const ivec4& b)
+{
+	return vmask4(simd::CmpLt(LoadXYZW(a), LoadXYZW(b)));
+}
+
+ENMA_HOT_FN vmask4 operator<=(const ivec4& a, const ivec4& b)
+{
+	return ~(a > b);
+}
+
+ENMA_HOT_FN vmask4 operator>(const ivec4& a, const ivec4& b)
+{
+	return vmask4(simd::CmpGt(LoadXYZW(a), LoadXYZW(b)));
+}
+
+ENMA_HOT_FN vmask4 operator>=(const ivec4& a, const ivec4& b)
+{
+	return ~(a < b);
+}
+
+ENMA_HOT_FN ivec4 Select(const vmask4& mask, const ivec4& a, const ivec4& b)
+{
+	return ivec4(simd::Select(mask.lanes, LoadXYZW(a), LoadXYZW(b)));
+}
+
 #endif
\ No newline at end of file
@@ -9,6 +9,8 @@
 #pragma once
 #include "../../base.hpp"
 #include "../../empch.hpp"
+#include "../simd.hpp"
+#include "vmask.hpp"
 
 struct ALIGN(8) uvec2
 {
@@ -21,9 +23,8 @@ struct ALIGN(8) uvec2
 		uin32 arr[2];
 	};
 
-	uvec2(const uvec2& v);
-	uvec2(uin32 val = 0U);
-	uvec2(uin32 ux, uin32 uy);
+	constexpr uvec2(uin32 val = 0U);
+	constexpr uvec2(uin32 ux, uin32 uy);
 
 	uvec2 operator+(const uvec2& other) const;
 	uvec2& operator+=(const uvec2& other);
@@ -39,10 +40,38 @@ struct ALIGN(8) uvec2
 	uvec2 operator/(const uin32 val) const;
 	uvec2& operator/=(const uin32 val);
 
+	uvec2 operator&(const uvec2& other) const;
+	uvec2& operator&=(const uvec2& other);
+	uvec2 operator|(const uvec2& other) const;
+	uvec2& operator|=(const uvec2& other);
+	uvec2 operator^(const uvec2& other) const;
+	uvec2& operator^=(const uvec2& other);
+	uvec2 operator~() const;
+
+	/**
+	 * Shifts every component left.
+	 *
+	 * \param shift Number of bits to shift by, in [0, 31].
+	 */
+	uvec2 operator<<(const int32 shift) const;
+	uvec2& operator<<=(const int32 shift);
+	/**
+	 * Shifts every component right, shifting in zeros.
+	 *
+	 * \param shift Number of bits to shift by, in [0, 31].
+	 */
+	uvec2 operator>>(const int32 shift) const;
+	uvec2& operator>>=(const int32 shift);
+
     uin32 Dot(const uvec2& other) const;
 	uin32 Cross(const uvec2& other) const;
 	uin32 Distance(const uvec2& other) const;
 
+	uvec2(const simd::int4& vals);
+	#ifdef USE_SIMD
+	uvec2(const __m128i& vals);
+	#endif
+
 	#ifdef DEBUG
     friend std::ostream& operator<<(std::ostream& os, const uvec2& vec)
     {
@@ -57,128 +86,207 @@ uin32 Dot(const uvec2& v1, const uvec2& v2);
 uin32 Cross(const uvec2& v1, const uvec2& v2);
 uin32 Distance(const uvec2& v1, const uvec2& v2);
 
+uvec2 Min(const uvec2& a, const uvec2& b);
+uvec2 Max(const uvec2& a, const uvec2& b);
+uvec2 Clamp(const uvec2& v, const uvec2& minimum, const uvec2& maximum);
+
+/**
+ * Component-wise comparisons. Every result is a vmask2 lane mask for Select, Any/All/None, or conversion to bvec2.
+ */
+vmask2 operator==(const uvec2& a, const uvec2& b);
+vmask2 operator!=(const uvec2& a, const uvec2& b);
+vmask2 operator<(const uvec2& a, const uvec2& b);
+vmask2 operator<=(const uvec2& a, const uvec2& b);
+vmask2 operator>(const uvec2& a, const uvec2& b);
+vmask2 operator>=(const uvec2& a, const uvec2& b);
+/**
+ * Branchless per-component select: mask ? a : b.
+ */
+uvec2 Select(const vmask2& mask, const uvec2& a, const uvec2& b);
+
+/**
+ * Loads x and y into the first two lanes of a simd::int4, z and w are zero.
+ *
+ * \param v The uvec2 to load.
+ * \return The loaded simd::int4.
+ */
+inline simd::int4 LoadXY(const uvec2& v)
+{
+	return simd::int4::LoadXY(reinterpret_cast<const int32*>(v.arr));
+}
+
+/**
+ * Stores the first two lanes of a simd::int4 into a uvec2.
+ *
+ * \param out The uvec2 to write to.
+ * \param v The simd::int4 to store.
+ */
+inline void StoreXY(uvec2& out, const simd::int4& v)
+{
+	v.StoreXY(reinterpret_cast<int32*>(out.arr));
+}
+
+constexpr uvec2::uvec2(uin32 val) : x(val), y(val) {}
+
+constexpr uvec2::uvec2(uin32 ux, uin32 uy) : x(ux), y(uy) {}
+
 #ifdef ENMA_IMPLEMENTATION
-uvec2::uvec2(const uvec2& v)
+ENMA_HOT_FN uvec2::uvec2(const simd::int4& vals)
 {
-	*this = v;
+	StoreXY(*this, vals);
 }
 
-uvec2::uvec2(uin32 val) : x(val), y(val) {}
+#ifdef USE_SIMD
+ENMA_HOT_FN uvec2::uvec2(const __m128i& vals) : uvec2(simd::int4(vals)) {}
+#endif
 
-uvec2::uvec2(uin32 ux, uin32 uy) : x(ux), y(uy) {}
+ENMA_HOT_FN uvec2 uvec2::operator+(const uvec2& other) const
+{
+	return uvec2(LoadXY(*this) + LoadXY(other));
+}
 
-uvec2 uvec2::operator+(const uvec2& other) const
+ENMA_HOT_FN uvec2& uvec2::operator+=(const uvec2& other)
 {
-	return uvec2(this->x + other.x, this->y + other.y);
+	return *this = *this + other;
 }
 
-uvec2& uvec2::operator+=(const uvec2& other)
+ENMA_HOT_FN uvec2 uvec2::operator-() const
 {
-	this->x += other.x;
-	this->y += other.y;
+	return uvec2(simd::int4::Zero() - LoadXY(*this));
+}
 
-	return *this;
+ENMA_HOT_FN uvec2 uvec2::operator-(const uvec2& other) const
+{
+	return uvec2(LoadXY(*this) - LoadXY(other));
 }
 
-uvec2 uvec2::operator-() const
+ENMA_HOT_FN uvec2& uvec2::operator-=(const uvec2& other)
 {
-	return uvec2(-x, -y);
+	return *this = *this - other;
 }
 
-uvec2 uvec2::operator-(const uvec2& other) const
+ENMA_HOT_FN uvec2 uvec2::operator*(const uvec2& other) const
 {
-	return uvec2(this->x - other.x, this->y - other.y);
+	return uvec2(LoadXY(*this) * LoadXY(other));
 }
 
-uvec2& uvec2::operator-=(const uvec2& other)
+ENMA_HOT_FN uvec2& uvec2::operator*=(const uvec2& other)
 {
-	this->x -= other.x;
-	this->y -= other.y;
+	return *this = *this * other;
+}
 
-	return *this;
+ENMA_HOT_FN uvec2 uvec2::operator*(const uin32 val) const
+{
+	return uvec2(LoadXY(*this) * simd::int4::Set1(static_cast<int32>(val)));
 }
 
-uvec2 uvec2::operator*(const uvec2& other) const
+ENMA_HOT_FN uvec2& uvec2::operator*=(const uin32 val)
 {
-	return uvec2(this->x * other.x, this->y * other.y);
+	return *this = *this * val;
 }
 
-uvec2& uvec2::operator*=(const uvec2& other)
+// No integer divide instruction, one hardware divide per component
+ENMA_HOT_FN uvec2 uvec2::operator/(const uvec2& other) const
 {
-	this->x *= other.x;
-	this->y *= other.y;
+	return uvec2(this->x / other.x, this->y / other.y);
+}
 
-	return *this;
+ENMA_HOT_FN uvec2& uvec2::operator/=(const uvec2& other)
+{
+	return *this = *this / other;
 }
 
-uvec2 uvec2::operator*(const uin32 val) const
+ENMA_HOT_FN uvec2 uvec2::operator/(const uin32 val) const
 {
-	return uvec2(this->x * val, this->y * val);
+	return uvec2(this->x / val, this->y / val);
 }
 
-uvec2& uvec2::operator*=(const uin32 val)
+ENMA_HOT_FN uvec2& uvec2::operator/=(const uin32 val)
 {
-	this->x *= val;
-	this->y *= val;
+	return *this = *this / val;
+}
 
-	return *this;
+ENMA_HOT_FN uvec2 uvec2::operator&(const uvec2& other) const
+{
+	return uvec2(simd::And(LoadXY(*this), LoadXY(other)));
 }
 
-uvec2 uvec2::operator/(const uvec2& other) const
+ENMA_HOT_FN uvec2& uvec2::operator&=(const uvec2& other)
 {
+	return *this = *this & other;
+}
 
-	return uvec2(this->x / other.x, this->y / other.y);
+ENMA_HOT_FN uvec2 uvec2::operator|(const uvec2& other) const
+{
+	return uvec2(simd::Or(LoadXY(*this), LoadXY(other)));
 }
 
-uvec2& uvec2::operator/=(const uvec2& other)
+ENMA_HOT_FN uvec2& uvec2::operator|=(const uvec2& other)
 {
-	this->x /= other.x;
-	this->y /= other.y;
+	return *this = *this | other;
+}
 
-	return *this;
+ENMA_HOT_FN uvec2 uvec2::operator^(const uvec2& other) const
+{
+	return uvec2(simd::Xor(LoadXY(*this), LoadXY(other)));
 }
 
-uvec2 uvec2::operator/(const uin32 val) const
+ENMA_HOT_FN uvec2& uvec2::operator^=(const uvec2& other)
 {
+	return *this = *this ^ other;
+}
 
-	return uvec2(this->x / val, this->y / val);
+ENMA_HOT_FN uvec2 uvec2::operator~() const
+{
+	return uvec2(simd::Xor(LoadXY(*this), simd::int4::Set1(-1)));
 }
 
-uvec2& uvec2::operator/=(const uin32 val)
+ENMA_HOT_FN uvec2 uvec2::operator<<(const int32 shift) const
 {
+	return uvec2(simd::ShiftLeft(LoadXY(*this), shift));
+}
 
-	this->x *= val;
-	this->y *= val;
+ENMA_HOT_FN uvec2& uvec2::operator<<=(const int32 shift)
+{
+	return *this = *this << shift;
+}
+
+ENMA_HOT_FN uvec2 uvec2::operator>>(const int32 shift) const
+{
+	return uvec2(simd::ShiftRightLogical(LoadXY(*this), shift));
+}
 
-	return *this;
+ENMA_HOT_FN uvec2& uvec2::operator>>=(const int32 shift)
+{
+	return *this = *this >> shift;
 }
 
 // Returns the dot product of two vectors
-uin32 uvec2::Dot(const uvec2& other) const
+ENMA_HOT_FN uin32 uvec2::Dot(const uvec2& other) const
 {
 	return this->x * other.x + this->y * other.y;
 }
 
 // Returns the dot product of two vectors
-uin32 Dot(const uvec2& v1, const uvec2& v2)
+ENMA_HOT_FN uin32 Dot(const uvec2& v1, const uvec2& v2)
 {
 	return v1.x * v2.x + v1.y * v2.y;
 }
 
 // Returns the z-component of 2D cross product of the vector
-uin32 uvec2::Cross(const uvec2& other) const
+ENMA_HOT_FN uin32 uvec2::Cross(const uvec2& other) const
 {
 	return this->x * other.y - other.x * this->y;
 }
 
 // Returns the z-component of 2D cross product of the vector
-uin32 Cross(const uvec2& v1, const uvec2& v2)
+ENMA_HOT_FN uin32 Cross(const uvec2& v1, const uvec2& v2)
 {
 	return v1.x * v2.y - v2.x * v1.y;
 }
 
 // Not Tested Yet - Maybe Removed
-uin32 uvec2::Distance(const uvec2& other) const
+ENMA_HOT_FN uin32 uvec2::Distance(const uvec2& other) const
 {
 	const uin32 xt = this->x - other.x;
 	const uin32 yt = this->y - other.y;
@@ -187,11 +295,62 @@ uin32 uvec2::Distance(const uvec2& other) const
 }
 
 // Not Tested Yet - Maybe Removed
-uin32 Distance(const uvec2& v1, const uvec2& v2)
+ENMA_HOT_FN uin32 Distance(const uvec2& v1, const uvec2& v2)
 {
 	const uin32 xt = v1.x - v2.x;
 	const uin32 yt = v1.y - v2.y;
 
 	return sqrt(xt * xt + yt * yt);
 }
+
+ENMA_HOT_FN uvec2 Min(const uvec2& a, const uvec2& b)
+{
+	return uvec2(simd::MinU(LoadXY(a), LoadXY(b)));
+}
+
+ENMA_HOT_FN uvec2 Max(const uvec2& a, const uvec2& b)
+{
+	return uvec2(simd::MaxU(LoadXY(a), LoadXY(b)));
+}
+
+ENMA_HOT_FN uvec2 Clamp(const uvec2& v, const uvec2& minimum, const uvec2& maximum)
+{
+	return uvec2(simd::MinU(simd::MaxU(LoadXY(v), LoadXY(minimum)), LoadXY(maximum)));
+}
+
+ENMA_HOT_FN vmask2 operator==(const uvec2& a, const uvec2& b)
+{
+	return vmask2(simd::CmpEq(LoadXY(a), LoadXY(b)));
+}
+
+ENMA_HOT_FN vmask2 operator!=(const uvec2& a, const uvec2& b)
+{
+	return ~(a == b);
+}
+
+ENMA_HOT_FN vmask2 operator<(const uvec2& a, const uvec2& b)
+{
+	return vmask2(simd::CmpLtU(LoadXY(a), LoadXY(b)));
+}
+
+ENMA_HOT_FN vmask2 operator<=(const uvec2& a, const uvec2& b)
+{
+	return ~(a > b);
+}
+
+ENMA_HOT_FN vmask2 operator>(const uvec2& a, const uvec2& b)
+{
+	return vmask2(simd::CmpGtU(LoadXY(a), LoadXY(b)));
+}
+
+ENMA_HOT_FN vmask2 operator>=(const uvec2& a, const uvec2& b)
+{
+	return ~(a < b);
+}
+
+ENMA_HOT_FN uvec2 Select(const vmask2& mask, const uvec2& a, const uvec2& b)
+{
+	return uvec2(simd::Select(mask.lanes, LoadXY(a), LoadXY(b)));
+}
+
 #endif
\ No newline at end of file
@@ -10,6 +10,7 @@
 #include "uvec2.hpp"
 #include "../../base.hpp"
 #include "../../empch.hpp"
+#include "vmask.hpp"
 
 struct ALIGN(16) uvec3
 {
@@ -23,11 +24,10 @@ struct ALIGN(16) uvec3
     };
 		
 public:
-    uvec3(const uvec3& v);
-    uvec3(const uin32 val = 0U);
-    uvec3(const uin32 ux, const uin32 uy, const uin32 uz);
-    uvec3(const uin32 x, const uvec2& yz);
-	uvec3(const uvec2& xy, const uin32 z);
+    constexpr uvec3(const uin32 val = 0U);
+    constexpr uvec3(const uin32 ux, const uin32 uy, const uin32 uz);
+    constexpr uvec3(const uin32 x, const uvec2& yz);
+	constexpr uvec3(const uvec2& xy, const uin32 z);
 
     uvec3 operator+(const uvec3& other) const;
 	uvec3& operator+=(const uvec3& other);
@@ -43,10 +43,38 @@ public:
 	uvec3 operator/(const uin32 val) const;
 	uvec3& operator/=(const uin32 val);
 
+	uvec3 operator&(const uvec3& other) const;
+	uvec3& operator&=(const uvec3& other);
+	uvec3 operator|(const uvec3& other) const;
+	uvec3& operator|=(const uvec3& other);
+	uvec3 operator^(const uvec3& other) const;
+	uvec3& operator^=(const uvec3& other);
+	uvec3 operator~() const;
+
+	/**
+	 * Shifts every component left.
+	 *
+	 * \param shift Number of bits to shift by, in [0, 31].
+	 */
+	uvec3 operator<<(const int32 shift) const;
+	uvec3& operator<<=(const int32 shift);
+	/**
+	 * Shifts every component right, shifting in zeros.
+	 *
+	 * \param shift Number of bits to shift by, in [0, 31].
+	 */
+	uvec3 operator>>(const int32 shift) const;
+	uvec3& operator>>=(const int32 shift);
+
 	uin32 Dot(const uvec3& other) const;
 	uvec3 Cross(const uvec3& other) const;
 	uin32 Distance(const uvec3& other) const;
 	
+	uvec3(const simd::int4& vals);
+	#ifdef USE_SIMD
+	uvec3(const __m128i& vals);
+	#endif
+
 	#ifdef DEBUG
 	friend std::ostream& operator<<(std::ostream& os, const uvec3& v)
 	{
@@ -61,143 +89,207 @@ uin32 Dot(const uvec3& v1, const uvec3& v2);
 uvec3 Cross(const uvec3& v1, const uvec3& v2);
 uin32 Distance(const uvec3& v1, const uvec3& v2);
 
+uvec3 Min(const uvec3& a, const uvec3& b);
+uvec3 Max(const uvec3& a, const uvec3& b);
+uvec3 Clamp(const uvec3& v, const uvec3& minimum, const uvec3& maximum);
+
+/**
+ * Component-wise comparisons. Every result is a vmask3 lane mask for Select, Any/All/None, or conversion to bvec3.
+ */
+vmask3 operator==(const uvec3& a, const uvec3& b);
+vmask3 operator!=(const uvec3& a, const uvec3& b);
+vmask3 operator<(const uvec3& a, const uvec3& b);
+vmask3 operator<=(const uvec3& a, const uvec3& b);
+vmask3 operator>(const uvec3& a, const uvec3& b);
+vmask3 operator>=(const uvec3& a, const uvec3& b);
+/**
+ * Branchless per-component select: mask ? a : b.
+ */
+uvec3 Select(const vmask3& mask, const uvec3& a, const uvec3& b);
+
+/**
+ * Loads x, y and z into the first three lanes of a simd::int4, w is zero.
+ *
+ * \param v The uvec3 to load.
+ * \return The loaded simd::int4.
+ */
+inline simd::int4 LoadXYZ(const uvec3& v)
+{
+	return simd::int4::LoadXYZ(reinterpret_cast<const int32*>(v.arr));
+}
+
+/**
+ * Stores the first three lanes of a simd::int4 into a uvec3. Never writes past z.
+ *
+ * \param out The uvec3 to write to.
+ * \param v The simd::int4 to store.
+ */
+inline void StoreXYZ(uvec3& out, const simd::int4& v)
+{
+	v.StoreXYZ(reinterpret_cast<int32*>(out.arr));
+}
+
+constexpr uvec3::uvec3(const uin32 val) : x(val), y(val), z(val) {}
+
+constexpr uvec3::uvec3(const uin32 ux, const uin32 uy, const uin32 uz) : x(ux), y(uy), z(uz) {}
+
+constexpr uvec3::uvec3(const uin32 x, const uvec2& yz) : x(x), y(yz.x), z(yz.y) {}
+
+constexpr uvec3::uvec3(const uvec2& xy, const uin32 z) : x(xy.x), y(xy.y), z(z) {}
+
 #ifdef ENMA_IMPLEMENTATION
-uvec3::uvec3(const uvec3& v)
+ENMA_HOT_FN uvec3::uvec3(const simd::int4& vals)
 {
-	this->x = v.x;
-	this->y = v.y;
-	this->z = v.z;
+	StoreXYZ(*this, vals);
 }
 
-uvec3::uvec3(const uin32 val) : x(val), y(val), z(val) {}
+#ifdef USE_SIMD
+ENMA_HOT_FN uvec3::uvec3(const __m128i& vals) : uvec3(simd::int4(vals)) {}
+#endif
 
-uvec3::uvec3(const uin32 ux, const uin32 uy, const uin32 uz) : x(ux), y(uy), z(uz) {}
+ENMA_HOT_FN uvec3 uvec3::operator+(const uvec3& other) const
+{
+	return uvec3(LoadXYZ(*this) + LoadXYZ(other));
+}
 
-uvec3::uvec3(const uin32 x, const uvec2& yz)
+ENMA_HOT_FN uvec3& uvec3::operator+=(const uvec3& other)
 {
-	this->x = x;
-	this->y = yz.x;
-	this->z = yz.y;
+	return *this = *this + other;
 }
 
-uvec3::uvec3(const uvec2& xy, const uin32 z)
+ENMA_HOT_FN uvec3 uvec3::operator-() const
 {
-	this->x = xy.x;
-	this->y = xy.y;
-	this->z = z;
+	return uvec3(simd::int4::Zero() - LoadXYZ(*this));
 }
 
-uvec3 uvec3::operator+(const uvec3& other) const
+ENMA_HOT_FN uvec3 uvec3::operator-(const uvec3& other) const
 {
-	return uvec3(this->x + other.x, this->y + other.y, this->z + other.z);
+	return uvec3(LoadXYZ(*this) - LoadXYZ(other));
 }
 
-uvec3& uvec3::operator+=(const uvec3& other)
+ENMA_HOT_FN uvec3& uvec3::operator-=(const uvec3& other)
 {
-	this->x += other.x;
-	this->y += other.y;
-	this->z += other.z;
+	return *this = *this - other;
+}
 
-	return *this;
+ENMA_HOT_FN uvec3 uvec3::operator*(const uvec3& other) const
+{
+	return uvec3(LoadXYZ(*this) * LoadXYZ(other));
 }
 
-uvec3 uvec3::operator-() const
+ENMA_HOT_FN uvec3& uvec3::operator*=(const uvec3& other)
 {
-	return uvec3(-x, -y, -z);
+	return *this = *this * other;
 }
 
-uvec3 uvec3::operator-(const uvec3& other) const
+ENMA_HOT_FN uvec3 uvec3::operator*(const uin32 val) const
 {
-	return uvec3(this->x - other.x, this->y - other.y, this->z - other.z);
+	return uvec3(LoadXYZ(*this) * simd::int4::Set1(static_cast<int32>(val)));
 }
 
-uvec3& uvec3::operator-=(const uvec3& other)
+ENMA_HOT_FN uvec3& uvec3::operator*=(const uin32 val)
 {
-	this->x -= other.x;
-	this->y -= other.y;
-	this->z -= other.z;
-	
-	return *this;
+	return *this = *this * val;
 }
 
-uvec3 uvec3::operator*(const uvec3& other) const
+// No integer divide instruction, one hardware divide per component
+ENMA_HOT_FN uvec3 uvec3::operator/(const uvec3& other) const
 {
-	return uvec3(this->x * other.x, this->y * other.y, this->z * other.z);
+	return uvec3(this->x / other.x, this->y / other.y, this->z / other.z);
 }
 
-uvec3& uvec3::operator*=(const uvec3& other)
+ENMA_HOT_FN uvec3& uvec3::operator/=(const uvec3& other)
 {
-	this->x *= other.x;
-	this->y *= other.y;
-	this->z *= other.z;
+	return *this = *this / other;
+}
 
-	return *this;
+ENMA_HOT_FN uvec3 uvec3::operator/(const uin32 val) const
+{
+	return uvec3(this->x / val, this->y / val, this->z / val);
 }
 
-uvec3 uvec3::operator*(const uin32 val) const
+ENMA_HOT_FN uvec3& uvec3::operator/=(const uin32 val)
 {
-	return uvec3(this->x * val, this->y * val, this->z * val);
+	return *this = *this / val;
 }
 
-uvec3& uvec3::operator*=(const uin32 val)
+ENMA_HOT_FN uvec3 uvec3::operator&(const uvec3& other) const
 {
-	this->x *= val;
-	this->y *= val;
-	this->z *= val;
+	return uvec3(simd::And(LoadXYZ(*this), LoadXYZ(other)));
+}
 
-	return *this;
+ENMA_HOT_FN uvec3& uvec3::operator&=(const uvec3& other)
+{
+	return *this = *this & other;
 }
 
-uvec3 uvec3::operator/(const uvec3& other) const
+ENMA_HOT_FN uvec3 uvec3::operator|(const uvec3& other) const
 {
-	return uvec3(this->x / other.x, this->y / other.y, this->z / other.z);
+	return uvec3(simd::Or(LoadXYZ(*this), LoadXYZ(other)));
 }
 
-uvec3& uvec3::operator/=(const uvec3& other)
+ENMA_HOT_FN uvec3& uvec3::operator|=(const uvec3& other)
 {
-	this->x /= other.x;
-	this->y /= other.y;
-	this->z /= other.z;
+	return *this = *this | other;
+}
 
-	return *this;
+ENMA_HOT_FN uvec3 uvec3::operator^(const uvec3& other) const
+{
+	return uvec3(simd::Xor(LoadXYZ(*this), LoadXYZ(other)));
 }
 
-uvec3 uvec3::operator/(const uin32 val) const
+ENMA_HOT_FN uvec3& uvec3::operator^=(const uvec3& other)
 {
-	return uvec3(this->x / val, this->y / val, this->z / val);
+	return *this = *this ^ other;
+}
+
+ENMA_HOT_FN uvec3 uvec3::operator~() const
+{
+	return uvec3(simd::Xor(LoadXYZ(*this), simd::int4::Set1(-1)));
 }
 
-uvec3& uvec3::operator/=(const uin32 val)
+ENMA_HOT_FN uvec3 uvec3::operator<<(const int32 shift) const
 {
-	this->x /= val;
-	this->y /= val;
-	this->z /= val;
+	return uvec3(simd::ShiftLeft(LoadXYZ(*this), shift));
+}
+
+ENMA_HOT_FN uvec3& uvec3::operator<<=(const int32 shift)
+{
+	return *this = *this << shift;
+}
+
+ENMA_HOT_FN uvec3 uvec3::operator>>(const int32 shift) const
+{
+	return uvec3(simd::ShiftRightLogical(LoadXYZ(*this), shift));
+}
 
-	return *this;
+ENMA_HOT_FN uvec3& uvec3::operator>>=(const int32 shift)
+{
+	return *this = *this >> shift;
 }
 
-uin32 uvec3::Dot(const uvec3& other) const
+ENMA_HOT_FN uin32 uvec3::Dot(const uvec3& other) const
 {
 	return this->x * other.x + this->y * other.y + this->z * other.z;
 }
 
-uin32 Dot(const uvec3& v1, const uvec3& v2)
+ENMA_HOT_FN uin32 Dot(const uvec3& v1, const uvec3& v2)
 {
 	return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z;
 }	
 
-uvec3 uvec3::Cross(const uvec3& other) const
+ENMA_HOT_FN uvec3 uvec3::Cross(const uvec3& other) const
 {
 	return uvec3(this->y * other.z - this->z * other.y, this->z * other.x - this->x * other.z, this->x * other.y - this->y * other.x);
 }
 
-uvec3 Cross(const uvec3& v1, const uvec3& v2)
+ENMA_HOT_FN uvec3 Cross(const uvec3& v1, const uvec3& v2)
 {
 	return uvec3(v1.y * v2.z - v1.z * v2.y, v1.z * v2.x - v1.x * v2.z, v1.x * v2.y - v1.y * v2.x);
 }
 
 // Not Tested Yet - Maybe Removed
-uin32 uvec3::Distance(const uvec3& other) const
+ENMA_HOT_FN uin32 uvec3::Distance(const uvec3& other) const
 {
 	const float xt = this->x - other.x;
 	const float yt = this->y - other.y;
@@ -207,7 +299,7 @@ uin32 uvec3::Distance(const uvec3& other) const
 }
 
 // Not Tested Yet - Maybe Removed
-uin32 Distance(const uvec3& v1, const uvec3& v2)
+ENMA_HOT_FN uin32 Distance(const uvec3& v1, const uvec3& v2)
 {
 	const float xt = v1.x - v2.x;
 	const float yt = v1.y - v2.y;
@@ -215,4 +307,55 @@ uin32 Distance(const uvec3& v1, const uvec3& v2)
 
 	return sqrt(xt * xt + yt * yt + zt * zt);
 }
+
+ENMA_HOT_FN uvec3 Min(const uvec3& a, const uvec3& b)
+{
+	return uvec3(simd::MinU(LoadXYZ(a), LoadXYZ(b)));
+}
+
+ENMA_HOT_FN uvec3 Max(const uvec3& a, const uvec3& b)
+{
+	return uvec3(simd::MaxU(LoadXYZ(a), LoadXYZ(b)));
+}
+
+ENMA_HOT_FN uvec3 Clamp(const uvec3& v, const uvec3& minimum, const uvec3& maximum)
+{
+	return uvec3(simd::MinU(simd::MaxU(LoadXYZ(v), LoadXYZ(minimum)), LoadXYZ(maximum)));
+}
+
+ENMA_HOT_FN vmask3 operator==(const uvec3& a, const uvec3& b)
+{
+	return vmask3(simd::CmpEq(LoadXYZ(a), LoadXYZ(b)));
+}
+
+ENMA_HOT_FN vmask3 operator!=(const uvec3& a, const uvec3& b)
+{
+	return ~(a == b);
+}
+
+ENMA_HOT_FN vmask3 operator<(const uvec3& a, const uvec3& b)
+{
+	return vmask3(simd::CmpLtU(LoadXYZ(a), LoadXYZ(b)));
+}
+
+ENMA_HOT_FN vmask3 operator<=(const uvec3& a, const uvec3& b)
+{
+	return ~(a > b);
+}
+
+ENMA_HOT_FN vmask3 operator>(const uvec3& a, const uvec3& b)
+{
+	return vmask3(simd::CmpGtU(LoadXYZ(a), LoadXYZ(b)));
+}
+
+ENMA_HOT_FN vmask3 operator>=(const uvec3& a, const uvec3& b)
+{
+	return ~(a < b);
+}
+
+ENMA_HOT_FN uvec3 Select(const vmask3& mask, const uvec3& a, const uvec3& b)
+{
+	return uvec3(simd::Select(mask.lanes, LoadXYZ(a), LoadXYZ(b)));
+}
+
 #endif
\ No newline at end of file
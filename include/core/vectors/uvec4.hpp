@@ -11,6 +11,7 @@
 #include "uvec3.hpp"
 #include "../../base.hpp"
 #include "../../empch.hpp"
+#include "vmask.hpp"
 
 struct ALIGN(16) uvec4
 {
@@ -21,15 +22,16 @@ struct ALIGN(16) uvec4
             uin32 x, y, z, w;
         };
         uin32 arr[4];
-        __m128i_u g;
+		#ifdef USE_SIMD
+        __m128i vals;
+		#endif
     };
 
-    uvec4(const uvec4 &v);
-    uvec4(const uin32 val = 0U);
-    uvec4(const uin32 ux, const uin32 uy, const uin32 uz, const uin32 uw);
-	uvec4(const uvec2& xy, const uvec2& zw);
-	uvec4(const uin32 x, const uvec3& yzw);
-	uvec4(const uvec3& xyz, const uin32 w);
+    constexpr uvec4(const uin32 val = 0U);
+    constexpr uvec4(const uin32 ux, const uin32 uy, const uin32 uz, const uin32 uw);
+	constexpr uvec4(const uvec2& xy, const uvec2& zw);
+	constexpr uvec4(const uin32 x, const uvec3& yzw);
+	constexpr uvec4(const uvec3& xyz, const uin32 w);
 
     uvec4 operator+(const uvec4& other) const;
 	uvec4& operator+=(const uvec4& other);
@@ -45,9 +47,37 @@ struct ALIGN(16) uvec4
 	uvec4 operator/(const uin32 val) const;
 	uvec4& operator/=(const uin32 val);
 
+	uvec4 operator&(const uvec4& other) const;
+	uvec4& operator&=(const uvec4& other);
+	uvec4 operator|(const uvec4& other) const;
+	uvec4& operator|=(const uvec4& other);
+	uvec4 operator^(const uvec4& other) const;
+	uvec4& operator^=(const uvec4& other);
+	uvec4 operator~() const;
+
+	/**
+	 * Shifts every component left.
+	 *
+	 * \param shift Number of bits to shift by, in [0, 31].
+	 */
+	uvec4 operator<<(const int32 shift) const;
+	uvec4& operator<<=(const int32 shift);
+	/**
+	 * Shifts every component right, shifting in zeros.
+	 *
+	 * \param shift Number of bits to shift by, in [0, 31].
+	 */
+	uvec4 operator>>(const int32 shift) const;
+	uvec4& operator>>=(const int32 shift);
+
 	uin32 Dot(const uvec4& other) const;
 	uin32 Distance(const uvec4& other) const;
 
+	uvec4(const simd::int4& vals);
+	#ifdef USE_SIMD
+	uvec4(const __m128i& vals);
+	#endif
+
 	#ifdef DEBUG
     friend std::ostream& operator<<(std::ostream& os, const uvec4& v)
     {
@@ -61,151 +91,207 @@ struct ALIGN(16) uvec4
 uin32 Dot(const uvec4& v1, const uvec4& v2);
 uin32 Distance(const uvec4& v1, const uvec4& v2);
 
+uvec4 Min(const uvec4& a, const uvec4& b);
+uvec4 Max(const uvec4& a, const uvec4& b);
+uvec4 Clamp(const uvec4& v, const uvec4& minimum, const uvec4& maximum);
+
+/**
+ * Component-wise comparisons. Every result is a vmask4 lane mask for Select, Any/All/None, or conversion to bvec4.
+ */
+vmask4 operator==(const uvec4& a, const uvec4& b);
+vmask4 operator!=(const uvec4& a, const uvec4& b);
+vmask4 operator<(const uvec4& a, const uvec4& b);
+vmask4 operator<=(const uvec4& a, const uvec4& b);
+vmask4 operator>(const uvec4& a, const uvec4& b);
+vmask4 operator>=(const uvec4& a, const uvec4& b);
+/**
+ * Branchless per-component select: mask ? a : b.
+ */
+uvec4 Select(const vmask4& mask, const uvec4& a, const uvec4& b);
+
+/**
+ * Loads all four components into a simd::int4.
+ *
+ * \param v The uvec4 to load.
+ * \return The loaded simd::int4.
+ */
+inline simd::int4 LoadXYZW(const uvec4& v)
+{
+	#ifdef USE_SIMD
+	return v.vals;
+	#else
+	return simd::int4::LoadU(reinterpret_cast<const int32*>(v.arr));
+	#endif
+}
+
+/**
+ * Stores a simd::int4 into a uvec4.
+ *
+ * \param out The uvec4 to write to.
+ * \param v The simd::int4 to store.
+ */
+inline void StoreXYZW(uvec4& out, const simd::int4& v)
+{
+	#ifdef USE_SIMD
+	out.vals = v;
+	#else
+	v.StoreU(reinterpret_cast<int32*>(out.arr));
+	#endif
+}
+
+constexpr uvec4::uvec4(uin32 val) : x(val), y(val), z(val), w(val) {}
+
+constexpr uvec4::uvec4(uin32 ux, uin32 uy, uin32 uz, uin32 uw) : x(ux), y(uy), z(uz), w(uw) {}
+
+constexpr uvec4::uvec4(const uvec2& xy, const uvec2& zw) : x(xy.x), y(xy.y), z(zw.x), w(zw.y) {}
+
+constexpr uvec4::uvec4(const uin32 x, const uvec3& yzw) : x(x), y(yzw.x), z(yzw.y), w(yzw.z) {}
+
+constexpr uvec4::uvec4(const uvec3& xyz, const uin32 w) : x(xyz.x), y(xyz.y), z(xyz.z), w(w) {}
+
 #ifdef ENMA_IMPLEMENTATION
-uvec4::uvec4(const uvec4& v)
+ENMA_HOT_FN uvec4::uvec4(const simd::int4& vals)
 {
-    this->x = v.x;
-    this->y = v.y;
-    this->z = v.z;
-    this->w = v.w;
+	StoreXYZW(*this, vals);
 }
 
-uvec4::uvec4(uin32 val) : x(val), y(val), z(val), w(val) {}
+#ifdef USE_SIMD
+ENMA_HOT_FN uvec4::uvec4(const __m128i& vals) : uvec4(simd::int4(vals)) {}
+#endif
 
-uvec4::uvec4(uin32 ux, uin32 uy, uin32 uz, uin32 uw) : x(ux), y(uy), z(uz), w(uw) {}
+ENMA_HOT_FN uvec4 uvec4::operator+(const uvec4& other) const
+{
+	return uvec4(LoadXYZW(*this) + LoadXYZW(other));
+}
 
-uvec4::uvec4(const uvec2& xy, const uvec2& zw)
+ENMA_HOT_FN uvec4& uvec4::operator+=(const uvec4& other)
 {
-    this->x = xy.x;
-    this->y = xy.y;
-    this->z = zw.x;
-    this->w = zw.y;
+	return *this = *this + other;
 }
 
-uvec4::uvec4(const uin32 x, const uvec3& yzw)
+ENMA_HOT_FN uvec4 uvec4::operator-() const
 {
-    this->x = x;
-    this->y = yzw.x;
-    this->z = yzw.y;
-    this->w = yzw.z;
+	return uvec4(simd::int4::Zero() - LoadXYZW(*this));
 }
 
-uvec4::uvec4(const uvec3& xyz, const uin32 w)
+ENMA_HOT_FN uvec4 uvec4::operator-(const uvec4& other) const
 {
-    this->x = xyz.x;
-    this->y = xyz.y;
-    this->z = xyz.z;
-    this->w = w;
+	return uvec4(LoadXYZW(*this) - LoadXYZW(other));
 }
 
-uvec4 uvec4::operator+(const uvec4& other) const
+ENMA_HOT_FN uvec4& uvec4::operator-=(const uvec4& other)
 {
-    return uvec4(this->x + other.x, this->y + other.y, this->z + other.z, this->w + other.w);
+	return *this = *this - other;
 }
 
-uvec4& uvec4::operator+=(const uvec4& other)
+ENMA_HOT_FN uvec4 uvec4::operator*(const uvec4& other) const
 {
-    this->x += other.x;
-    this->y += other.y;
-    this->z += other.z;
-    this->w += other.w;
+	return uvec4(LoadXYZW(*this) * LoadXYZW(other));
+}
 
-    return *this;
+ENMA_HOT_FN uvec4& uvec4::operator*=(const uvec4& other)
+{
+	return *this = *this * other;
 }
 
-uvec4 uvec4::operator-() const
+ENMA_HOT_FN uvec4 uvec4::operator*(const uin32 val) const
 {
-	return uvec4(-x, -y, -z, -w);
+	return uvec4(LoadXYZW(*this) * simd::int4::Set1(static_cast<int32>(val)));
 }
 
-uvec4 uvec4::operator-(const uvec4& other) const
+ENMA_HOT_FN uvec4& uvec4::operator*=(const uin32 val)
 {
-    return uvec4(this->x - other.x, this->y - other.y, this->z - other.z, this->w - other.w);
+	return *this = *this * val;
 }
 
-uvec4& uvec4::operator-=(const uvec4& other)
+// No integer divide instruction, one hardware divide per component
+ENMA_HOT_FN uvec4 uvec4::operator/(const uvec4& other) const
 {
-    this->x -= other.x;
-    this->y -= other.y;
-    this->z -= other.z;
-    this->w -= other.w;
+	return uvec4(this->x / other.x, this->y / other.y, this->z / other.z, this->w / other.w);
+}
 
-    return *this;
+ENMA_HOT_FN uvec4& uvec4::operator/=(const uvec4& other)
+{
+	return *this = *this / other;
 }
 
-uvec4 uvec4::operator*(const uvec4& other) const
+ENMA_HOT_FN uvec4 uvec4::operator/(const uin32 val) const
 {
-    return uvec4(this->x * other.x, this->y * other.y, this->z * other.z, this->w * other.w);
+	return uvec4(this->x / val, this->y / val, this->z / val, this->w / val);
 }
 
-uvec4& uvec4::operator*=(const uvec4& other)
+ENMA_HOT_FN uvec4& uvec4::operator/=(const uin32 val)
 {
-    this->x *= other.x;
-    this->y *= other.y;
-    this->z *= other.z;
-    this->w *= other.w;
+	return *this = *this / val;
+}
 
-    return *this;
+ENMA_HOT_FN uvec4 uvec4::operator&(const uvec4& other) const
+{
+	return uvec4(simd::And(LoadXYZW(*this), LoadXYZW(other)));
 }
 
-uvec4 uvec4::operator*(const uin32 val) const
+ENMA_HOT_FN uvec4& uvec4::operator&=(const uvec4& other)
 {
-    return uvec4(this->x * val, this->y * val, this->z * val, this->w * val);
+	return *this = *this & other;
 }
 
-uvec4& uvec4::operator*=(const uin32 val)
+ENMA_HOT_FN uvec4 uvec4::operator|(const uvec4& other) const
 {
-    this->x *= val;
-    this->y *= val;
-    this->z *= val;
-    this->w *= val;
+	return uvec4(simd::Or(LoadXYZW(*this), LoadXYZW(other)));
+}
 
-    return *this;
+ENMA_HOT_FN uvec4& uvec4::operator|=(const uvec4& other)
+{
+	return *this = *this | other;
 }
 
-uvec4 uvec4::operator/(const uvec4& other) const
+ENMA_HOT_FN uvec4 uvec4::operator^(const uvec4& other) const
 {
-    return uvec4(this->x / other.x, this->y / other.y, this->z / other.z, this->w / other.w);
+	return uvec4(simd::Xor(LoadXYZW(*this), LoadXYZW(other)));
 }
 
-uvec4& uvec4::operator/=(const uvec4& other)
+ENMA_HOT_FN uvec4& uvec4::operator^=(const uvec4& other)
 {
-    this->x /= other.x;
-    this->y /= other.y;
-    this->z /= other.z;
-    this->w /= other.w;
+	return *this = *this ^ other;
+}
 
-    return *this;
+ENMA_HOT_FN uvec4 uvec4::operator~() const
+{
+	return uvec4(simd::Xor(LoadXYZW(*this), simd::int4::Set1(-1)));
 }
 
-uvec4 uvec4::operator/(const uin32 val) const
+ENMA_HOT_FN uvec4 uvec4::operator<<(const int32 shift) const
 {
+	return uvec4(simd::ShiftLeft(LoadXYZW(*this), shift));
+}
 
-    return uvec4(this->x / val, this->y / val, this->z / val, this->w / val);
+ENMA_HOT_FN uvec4& uvec4::operator<<=(const int32 shift)
+{
+	return *this = *this << shift;
 }
 
-uvec4& uvec4::operator/=(const uin32 val)
+ENMA_HOT_FN uvec4 uvec4::operator>>(const int32 shift) const
 {
-    this->x /= val;
-    this->y /= val;
-    this->z /= val;
-    this->w /= val;
+	return uvec4(simd::ShiftRightLogical(LoadXYZW(*this), shift));
+}
 
-    return *this;
+ENMA_HOT_FN uvec4& uvec4::operator>>=(const int32 shift)
+{
+	return *this = *this >> shift;
 }
 
-uin32 uvec4::Dot(const uvec4& other) const
+ENMA_HOT_FN uin32 uvec4::Dot(const uvec4& other) const
 {
     return this->x * other.x + this->y * other.y + this->z * other.z + this->w * other.w;
 }
 
-uin32 Dot(const uvec4& v1, const uvec4& v2)
+ENMA_HOT_FN uin32 Dot(const uvec4& v1, const uvec4& v2)
 {
     return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z + v1.w * v2.w;
 }
 
 // Not Tested Yet - Maybe Removed
-uin32 uvec4::Distance(const uvec4& other) const
+ENMA_HOT_FN uin32 uvec4::Distance(const uvec4& other) const
 {
 	const float xt = this->x - other.x;
 	const float yt = this->y - other.y;
@@ -216,7 +302,7 @@ uin32 uvec4::Distance(const uvec4& other) const
 }
 
 // Not Tested Yet - Maybe Removed
-uin32 Distance(const uvec4& v1, const uvec4& v2)
+ENMA_HOT_FN uin32 Distance(const uvec4& v1, const uvec4& v2)
 {
 	const float xt = v1.x - v2.x;
 	const float yt = v1.y - v2.y;
@@ -225,4 +311,55 @@ uin32 Distance(const uvec4& v1, const uvec4& v2)
 
 	return sqrt(xt * xt + yt * yt + zt * zt + wt * wt);
 }
+
+ENMA_HOT_FN uvec4 Min(const uvec4& a, const uvec4& b)
+{
+	return uvec4(simd::MinU(LoadXYZW(a), LoadXYZW(b)));
+}
+
+ENMA_HOT_FN uvec4 Max(const uvec4& a, const uvec4& b)
+{
+	return uvec4(simd::MaxU(LoadXYZW(a), LoadXYZW(b)));
+}
+
+ENMA_HOT_FN uvec4 Clamp(const uvec4& v, const uvec4& minimum, const uvec4& maximum)
+{
+	return uvec4(simd::MinU(simd::MaxU(LoadXYZW(v), LoadXYZW(minimum)), LoadXYZW(maximum)));
+}
+
+ENMA_HOT_FN vmask4 operator==(const uvec4& a, const uvec4& b)
+{
+	return vmask4(simd::CmpEq(LoadXYZW(a), LoadXYZW(b)));
+}
+
+ENMA_HOT_FN vmask4 operator!=(const uvec4& a, const uvec4& b)
+{
+	return ~(a == b);
+}
+
+ENMA_HOT_FN vmask4 operator<(const uvec4& a, const uvec4& b)
+{
+	return vmask4(simd::CmpLtU(LoadXYZW(a), LoadXYZW(b)));
+}
+
+ENMA_HOT_FN vmask4 operator<=(const uvec4& a, const uvec4& b)
+{
+	return ~(a > b);
+}
+
+ENMA_HOT_FN vmask4 operator>(const uvec4& a, const uvec4& b)
+{
+	return vmask4(simd::CmpGtU(LoadXYZW(a), LoadXYZW(b)));
+}
+
+ENMA_HOT_FN vmask4 operator>=(const uvec4& a, const uvec4& b)
+{
+	return ~(a < b);
+}
+
+ENMA_HOT_FN uvec4 Select(const vmask4& mask, const uvec4& a, const uvec4& b)
+{
+	return uvec4(simd::Select(mask.lanes, LoadXYZW(a), LoadXYZW(b)));
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,330 @@
+/* SIMD Comparison Masks
+ *
+ * This header file is part of Enmatica library
+ *
+ * Copyright (c) 202X by Villainous Softworks
+ *
+ */
+
+#pragma once
+#include "bvec2.hpp"
+#include "bvec3.hpp"
+#include "bvec4.hpp"
+#include "../../base.hpp"
+#include "../../empch.hpp"
+#include "../simd.hpp"
+
+/**
+ * Packed-bit boolean vector, bit i holds component i.
+ *
+ * The compact form of a comparison result: one byte instead of one bln8 per component,
+ * and Any/All/None are single integer tests.
+ */
+struct pbvec
+{
+	uin8 bits;
+	uin8 count;		// Number of components, 1 to 4
+
+	constexpr pbvec(const uin8 bits = 0, const uin8 count = 4);
+	constexpr pbvec(const bvec2& v);
+	constexpr pbvec(const bvec3& v);
+	constexpr pbvec(const bvec4& v);
+
+	/**
+	 * Indexing operator.
+	 *
+	 * \param index Index of the component to test.
+	 * \return Value of the component at the specified `index`.
+	 */
+	constexpr bln8 operator[](uin32 index) const;
+
+	constexpr operator bvec2() const;
+	constexpr operator bvec3() const;
+	constexpr operator bvec4() const;
+};
+
+constexpr pbvec::pbvec(const uin8 bits, const uin8 count) : bits(bits & ((1u << count) - 1u)), count(count) {}
+
+constexpr pbvec::pbvec(const bvec2& v) : bits(v.x | (v.y << 1)), count(2) {}
+
+constexpr pbvec::pbvec(const bvec3& v) : bits(v.x | (v.y << 1) | (v.z << 2)), count(3) {}
+
+constexpr pbvec::pbvec(const bvec4& v) : bits(v.x | (v.y << 1) | (v.z << 2) | (v.w << 3)), count(4) {}
+
+constexpr bln8 pbvec::operator[](uin32 index) const
+{
+	return (bits >> index) & 1u;
+}
+
+constexpr pbvec::operator bvec2() const
+{
+	return bvec2((*this)[0], (*this)[1]);
+}
+
+constexpr pbvec::operator bvec3() const
+{
+	return bvec3((*this)[0], (*this)[1], (*this)[2]);
+}
+
+constexpr pbvec::operator bvec4() const
+{
+	return bvec4((*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+}
+
+constexpr bln8 Any(const pbvec& m)
+{
+	return m.bits != 0;
+}
+
+constexpr bln8 All(const pbvec& m)
+{
+	return m.bits == (1u << m.count) - 1u;
+}
+
+constexpr bln8 None(const pbvec& m)
+{
+	return m.bits == 0;
+}
+
+/**
+ * Lane mask produced by comparing two 2 component vectors.
+ *
+ * Every lane is all ones or all zeros so it feeds blendv directly through Select.
+ * The lanes past y are unspecified and ignored by every reduction.
+ */
+struct vmask2
+{
+	simd::int4 lanes;
+
+	vmask2(const simd::int4& lanes);
+
+	vmask2 operator&(const vmask2& other) const;
+	vmask2 operator|(const vmask2& other) const;
+	vmask2 operator^(const vmask2& other) const;
+	vmask2 operator~() const;
+
+	operator bvec2() const;
+	operator pbvec() const;
+};
+
+/**
+ * Lane mask produced by comparing two 3 component vectors. The w lane is ignored.
+ */
+struct vmask3
+{
+	simd::int4 lanes;
+
+	vmask3(const simd::int4& lanes);
+
+	vmask3 operator&(const vmask3& other) const;
+	vmask3 operator|(const vmask3& other) const;
+	vmask3 operator^(const vmask3& other) const;
+	vmask3 operator~() const;
+
+	operator bvec3() const;
+	operator pbvec() const;
+};
+
+/**
+ * Lane mask produced by comparing two 4 component vectors.
+ */
+struct vmask4
+{
+	simd::int4 lanes;
+
+	vmask4(const simd::int4& lanes);
+
+	vmask4 operator&(const vmask4& other) const;
+	vmask4 operator|(const vmask4& other) const;
+	vmask4 operator^(const vmask4& other) const;
+	vmask4 operator~() const;
+
+	operator bvec4() const;
+	operator pbvec() const;
+};
+
+/**
+ * Packs the lanes of a mask into the low bits of an integer, bit i holds component i.
+ */
+uin32 Movemask(const vmask2& m);
+uin32 Movemask(const vmask3& m);
+uin32 Movemask(const vmask4& m);
+
+/**
+ * True if at least one component is set.
+ */
+bln8 Any(const vmask2& m);
+bln8 Any(const vmask3& m);
+bln8 Any(const vmask4& m);
+
+/**
+ * True if every component is set.
+ */
+bln8 All(const vmask2& m);
+bln8 All(const vmask3& m);
+bln8 All(const vmask4& m);
+
+/**
+ * True if no component is set.
+ */
+bln8 None(const vmask2& m);
+bln8 None(const vmask3& m);
+bln8 None(const vmask4& m);
+
+#ifdef ENMA_IMPLEMENTATION
+ENMA_HOT_FN vmask2::vmask2(const simd::int4& lanes) : lanes(lanes) {}
+
+ENMA_HOT_FN vmask3::vmask3(const simd::int4& lanes) : lanes(lanes) {}
+
+ENMA_HOT_FN vmask4::vmask4(const simd::int4& lanes) : lanes(lanes) {}
+
+ENMA_HOT_FN vmask2 vmask2::operator&(const vmask2& other) const
+{
+	return vmask2(simd::And(lanes, other.lanes));
+}
+
+ENMA_HOT_FN vmask2 vmask2::operator|(const vmask2& other) const
+{
+	return vmask2(simd::Or(lanes, other.lanes));
+}
+
+ENMA_HOT_FN vmask2 vmask2::operator^(const vmask2& other) const
+{
+	return vmask2(simd::Xor(lanes, other.lanes));
+}
+
+ENMA_HOT_FN vmask2 vmask2::operator~() const
+{
+	return vmask2(simd::Xor(lanes, simd::int4::Set1(-1)));
+}
+
+ENMA_HOT_FN vmask2::operator bvec2() const
+{
+	return pbvec(static_cast<uin8>(Movemask(*this)), 2);
+}
+
+ENMA_HOT_FN vmask2::operator pbvec() const
+{
+	return pbvec(static_cast<uin8>(Movemask(*this)), 2);
+}
+
+ENMA_HOT_FN vmask3 vmask3::operator&(const vmask3& other) const
+{
+	return vmask3(simd::And(lanes, other.lanes));
+}
+
+ENMA_HOT_FN vmask3 vmask3::operator|(const vmask3& other) const
+{
+	return vmask3(simd::Or(lanes, other.lanes));
+}
+
+ENMA_HOT_FN vmask3 vmask3::operator^(const vmask3& other) const
+{
+	return vmask3(simd::Xor(lanes, other.lanes));
+}
+
+ENMA_HOT_FN vmask3 vmask3::operator~() const
+{
+	return vmask3(simd::Xor(lanes, simd::int4::Set1(-1)));
+}
+
+ENMA_HOT_FN vmask3::operator bvec3() const
+{
+	return pbvec(static_cast<uin8>(Movemask(*this)), 3);
+}
+
+ENMA_HOT_FN vmask3::operator pbvec() const
+{
+	return pbvec(static_cast<uin8>(Movemask(*this)), 3);
+}
+
+ENMA_HOT_FN vmask4 vmask4::operator&(const vmask4& other) const
+{
+	return vmask4(simd::And(lanes, other.lanes));
+}
+
+ENMA_HOT_FN vmask4 vmask4::operator|(const vmask4& other) const
+{
+	return vmask4(simd::Or(lanes, other.lanes));
+}
+
+ENMA_HOT_FN vmask4 vmask4::operator^(const vmask4& other) const
+{
+	return vmask4(simd::Xor(lanes, other.lanes));
+}
+
+ENMA_HOT_FN vmask4 vmask4::operator~() const
+{
+	return vmask4(simd::Xor(lanes, simd::int4::Set1(-1)));
+}
+
+ENMA_HOT_FN vmask4::operator bvec4() const
+{
+	return pbvec(static_cast<uin8>(Movemask(*this)), 4);
+}
+
+ENMA_HOT_FN vmask4::operator pbvec() const
+{
+	return pbvec(static_cast<uin8>(Movemask(*this)), 4);
+}
+
+ENMA_HOT_FN uin32 Movemask(const vmask2& m)
+{
+	return static_cast<uin32>(simd::MoveMask(m.lanes)) & 0x3u;
+}
+
+ENMA_HOT_FN uin32 Movemask(const vmask3& m)
+{
+	return static_cast<uin32>(simd::MoveMask(m.lanes)) & 0x7u;
+}
+
+ENMA_HOT_FN uin32 Movemask(const vmask4& m)
+{
+	return static_cast<uin32>(simd::MoveMask(m.lanes));
+}
+
+ENMA_HOT_FN bln8 Any(const vmask2& m)
+{
+	return Movemask(m) != 0;
+}
+
+ENMA_HOT_FN bln8 Any(const vmask3& m)
+{
+	return Movemask(m) != 0;
+}
+
+ENMA_HOT_FN bln8 Any(const vmask4& m)
+{
+	return Movemask(m) != 0;
+}
+
+ENMA_HOT_FN bln8 All(const vmask2& m)
+{
+	return Movemask(m) == 0x3u;
+}
+
+ENMA_HOT_FN bln8 All(const vmask3& m)
+{
+	return Movemask(m) == 0x7u;
+}
+
+ENMA_HOT_FN bln8 All(const vmask4& m)
+{
+	return Movemask(m) == 0xFu;
+}
+
+ENMA_HOT_FN bln8 None(const vmask2& m)
+{
+	return Movemask(m) == 0;
+}
+
+ENMA_HOT_FN bln8 None(const vmask3& m)
+{
+	return Movemask(m) == 0;
+}
+
+ENMA_HOT_FN bln8 None(const vmask4& m)
+{
+	return Movemask(m) == 0;
+}
+#endif // ENMA_IMPLEMENTATION
@@ -38,6 +38,7 @@ T Lerp(T a, T b, P t)
 #include "trignometry.hpp"
 
 #include "vector.hpp"
+#include "sincos.hpp"
 #include "matrix.hpp"
 #include "quaternion.hpp"
 
@@ -0,0 +1,345 @@
+/* Axis-Aligned Bounding Boxes
+ *
+ * This header file is part of Enmatica library
+ *
+ * Copyright (c) 202X by Villainous Softworks
+ *
+ */
+
+#pragma once
+#include "../enma.hpp"
+#include "ray.hpp"
+#include <limits>
+
+/**
+ * An axis-aligned box held as two simd::float4 corners, the w lanes are unused.
+ *
+ * A default constructed box is empty (lower = +inf, upper = -inf), so expanding it by
+ * a point or a box yields exactly that point or box.
+ */
+struct aabb3
+{
+	simd::float4 lower;
+	simd::float4 upper;
+
+	/**
+	 * Empty box constructor.
+	 */
+	aabb3();
+	/**
+	 * Constructor with corners.
+	 *
+	 * \param lower Lower corner.
+	 * \param upper Upper corner.
+	 */
+	aabb3(const fvec3& lower, const fvec3& upper);
+	aabb3(const simd::float4& lower, const simd::float4& upper);
+
+	fvec3 Lower() const;
+	fvec3 Upper() const;
+	fvec3 Center() const;
+	fvec3 Size() const;
+
+	/**
+	 * True if lower > upper on any axis.
+	 */
+	bln8 IsEmpty() const;
+
+	/**
+	 * Grows the box to enclose a point.
+	 *
+	 * \param point The point to enclose.
+	 * \return Reference to the modified aabb3.
+	 */
+	aabb3& Expand(const fvec3& point);
+	/**
+	 * Grows the box to enclose another box.
+	 *
+	 * \param box The box to enclose.
+	 * \return Reference to the modified aabb3.
+	 */
+	aabb3& Expand(const aabb3& box);
+};
+
+/**
+ * Smallest box enclosing both boxes.
+ */
+aabb3 Union(const aabb3& a, const aabb3& b);
+/**
+ * Overlapping region of both boxes. Empty when they do not overlap.
+ */
+aabb3 Intersection(const aabb3& a, const aabb3& b);
+/**
+ * True if the boxes share at least one point, touching faces included.
+ */
+bln8 Overlaps(const aabb3& a, const aabb3& b);
+/**
+ * True if `point` lies inside or on the surface of `box`.
+ */
+bln8 Contains(const aabb3& box, const fvec3& point);
+/**
+ * True if `inner` lies entirely inside `outer`.
+ */
+bln8 Contains(const aabb3& outer, const aabb3& inner);
+/**
+ * Surface area of the box, 0 for an empty box. The cost metric of SAH builders.
+ */
+flt32 SurfaceArea(const aabb3& box);
+
+/**
+ * Slab test of a ray against a box.
+ *
+ * \param r The ray.
+ * \param box The box.
+ * \param tMin Start of the tested interval along the ray.
+ * \param tMax End of the tested interval along the ray.
+ * \param tEntry Receives the entry distance, clamped to `tMin` when the ray starts inside the box.
+ * \return True if the ray enters the box within [tMin, tMax].
+ */
+bln8 Intersect(const ray3& r, const aabb3& box, flt32 tMin, flt32 tMax, flt32& tEntry);
+
+/**
+ * Eight boxes in component arrays, the layout the 8-wide slab test consumes.
+ *
+ * Unused lanes hold empty boxes, which never report a hit.
+ */
+struct alignas(32) aabb3x8
+{
+	flt32 minX[8], minY[8], minZ[8];
+	flt32 maxX[8], maxY[8], maxZ[8];
+
+	/**
+	 * Constructor filling every lane with an empty box.
+	 */
+	aabb3x8();
+
+	/**
+	 * Writes a box into a lane.
+	 *
+	 * \param lane Lane index in [0, 8).
+	 * \param box The box to store.
+	 */
+	void Set(uin32 lane, const aabb3& box);
+	/**
+	 * Reads the box of a lane.
+	 *
+	 * \param lane Lane index in [0, 8).
+	 * \return The box stored in `lane`.
+	 */
+	aabb3 Get(uin32 lane) const;
+};
+
+/**
+ * Slab test of one ray against eight boxes at once.
+ *
+ * Picks the near and far planes per axis from the sign of the ray direction, so every axis
+ * costs two subtractions and two multiplies for all eight boxes.
+ *
+ * Runs on simd::float8 and is inlined into traversal loops rather than dispatched at runtime: it uses one
+ * AVX2 register and FMA only when compiled with `-mavx2 -mfma`, on the SSE4.1 baseline it is two float4 halves.
+ *
+ * \param r The ray.
+ * \param boxes The eight boxes.
+ * \param tMin Start of the tested interval along the ray.
+ * \param tMax End of the tested interval along the ray.
+ * \param tEntry Pointer to an array of 8 flt32 that receives the entry distance of every lane. Only meaningful for hit lanes.
+ * \return Bit i set when box i is entered within [tMin, tMax].
+ */
+uin32 Intersect(const ray3& r, const aabb3x8& boxes, flt32 tMin, flt32 tMax, flt32* tEntry);
+/**
+ * Overlap test of one box against eight boxes at once, touching faces included.
+ * Like Intersect, it is 256 bits wide only when compiled with `-mavx2`.
+ *
+ * \param boxes The eight boxes.
+ * \param box The box to test against.
+ * \return Bit i set when box i overlaps `box`.
+ */
+uin32 Overlaps(const aabb3x8& boxes, const aabb3& box);
+
+#ifdef ENMA_IMPLEMENTATION
+ENMA_HOT_FN aabb3::aabb3() :
+	lower(simd::float4::Set1(std::numeric_limits<flt32>::infinity())), upper(simd::float4::Set1(-std::numeric_limits<flt32>::infinity()))
+{
+}
+
+ENMA_HOT_FN aabb3::aabb3(const fvec3& lower, const fvec3& upper) : lower(LoadXYZ(lower)), upper(LoadXYZ(upper)) {}
+
+ENMA_HOT_FN aabb3::aabb3(const simd::float4& lower, const simd::float4& upper) : lower(lower), upper(upper) {}
+
+ENMA_HOT_FN fvec3 aabb3::Lower() const
+{
+	return fvec3(lower);
+}
+
+ENMA_HOT_FN fvec3 aabb3::Upper() const
+{
+	return fvec3(upper);
+}
+
+ENMA_HOT_FN fvec3 aabb3::Center() const
+{
+	return fvec3((lower + upper) * 0.5f);
+}
+
+ENMA_HOT_FN fvec3 aabb3::Size() const
+{
+	return fvec3(upper - lower);
+}
+
+ENMA_HOT_FN bln8 aabb3::IsEmpty() const
+{
+	return (simd::MoveMask(simd::CmpGt(lower, upper)) & 0x7) != 0;
+}
+
+ENMA_HOT_FN aabb3& aabb3::Expand(const fvec3& point)
+{
+	const simd::float4 p = LoadXYZ(point);
+
+	lower = simd::Min(lower, p);
+	upper = simd::Max(upper, p);
+
+	return *this;
+}
+
+ENMA_HOT_FN aabb3& aabb3::Expand(const aabb3& box)
+{
+	lower = simd::Min(lower, box.lower);
+	upper = simd::Max(upper, box.upper);
+
+	return *this;
+}
+
+ENMA_HOT_FN aabb3 Union(const aabb3& a, const aabb3& b)
+{
+	return aabb3(simd::Min(a.lower, b.lower), simd::Max(a.upper, b.upper));
+}
+
+ENMA_HOT_FN aabb3 Intersection(const aabb3& a, const aabb3& b)
+{
+	return aabb3(simd::Max(a.lower, b.lower), simd::Min(a.upper, b.upper));
+}
+
+ENMA_HOT_FN bln8 Overlaps(const aabb3& a, const aabb3& b)
+{
+	return (simd::MoveMask(simd::Or(simd::CmpGt(a.lower, b.upper), simd::CmpGt(b.lower, a.upper))) & 0x7) == 0;
+}
+
+ENMA_HOT_FN bln8 Contains(const aabb3& box, const fvec3& point)
+{
+	const simd::float4 p = LoadXYZ(point);
+
+	return (simd::MoveMask(simd::And(simd::CmpLe(box.lower, p), simd::CmpLe(p, box.upper))) & 0x7) == 0x7;
+}
+
+ENMA_HOT_FN bln8 Contains(const aabb3& outer, const aabb3& inner)
+{
+	return (simd::MoveMask(simd::And(simd::CmpLe(outer.lower, inner.lower), simd::CmpLe(inner.upper, outer.upper))) & 0x7) == 0x7;
+}
+
+ENMA_HOT_FN flt32 SurfaceArea(const aabb3& box)
+{
+	if(box.IsEmpty())
+	{
+		return 0.0f;
+	}
+
+	// dx * dy + dy * dz + dz * dx in one dot product
+	const simd::float4 d = box.upper - box.lower;
+
+	return 2.0f * simd::Dot3(d, simd::Shuffle<1, 2, 0, 3>(d)).X();
+}
+
+ENMA_HOT_FN bln8 Intersect(const ray3& r, const aabb3& box, flt32 tMin, flt32 tMax, flt32& tEntry)
+{
+	using namespace simd;
+
+	const float4 inv = LoadXYZ(r.invDirection);
+	const float4 origin = LoadXYZ(r.origin);
+	const float4 negative = CmpLt(inv, float4::Zero());
+
+	const float4 t0 = (Select(negative, box.upper, box.lower) - origin) * inv;
+	const float4 t1 = (Select(negative, box.lower, box.upper) - origin) * inv;
+
+	// Same operand order as the 8-wide test: the NaN of a ray lying in a slab plane (0 * inf) is dropped on every axis
+	const float4 tNear = Max(Max(t0, Shuffle<1, 1, 1, 1>(t0)), Max(Shuffle<2, 2, 2, 2>(t0), float4::Set1(tMin)));
+	const float4 tFar = Min(Min(t1, Shuffle<1, 1, 1, 1>(t1)), Min(Shuffle<2, 2, 2, 2>(t1), float4::Set1(tMax)));
+
+	tEntry = tNear.X();
+
+	return tEntry <= tFar.X();
+}
+
+ENMA_FN aabb3x8::aabb3x8()
+{
+	std::fill(minX, minX + 8, std::numeric_limits<flt32>::infinity());
+	std::fill(minY, minY + 8, std::numeric_limits<flt32>::infinity());
+	std::fill(minZ, minZ + 8, std::numeric_limits<flt32>::infinity());
+	std::fill(maxX, maxX + 8, -std::numeric_limits<flt32>::infinity());
+	std::fill(maxY, maxY + 8, -std::numeric_limits<flt32>::infinity());
+	std::fill(maxZ, maxZ + 8, -std::numeric_limits<flt32>::infinity());
+}
+
+ENMA_HOT_FN void aabb3x8::Set(uin32 lane, const aabb3& box)
+{
+	flt32 lo[4], hi[4];
+	box.lower.StoreU(lo);
+	box.upper.StoreU(hi);
+
+	minX[lane] = lo[0];
+	minY[lane] = lo[1];
+	minZ[lane] = lo[2];
+	maxX[lane] = hi[0];
+	maxY[lane] = hi[1];
+	maxZ[lane] = hi[2];
+}
+
+ENMA_HOT_FN aabb3 aabb3x8::Get(uin32 lane) const
+{
+	return aabb3(fvec3(minX[lane], minY[lane], minZ[lane]), fvec3(maxX[lane], maxY[lane], maxZ[lane]));
+}
+
+ENMA_HOT_FN uin32 Intersect(const ray3& r, const aabb3x8& boxes, flt32 tMin, flt32 tMax, flt32* tEntry)
+{
+	using simd::float8;
+
+	// An empty lane has lower = +inf on the near side, so its entry is +inf and it never hits
+	const bln8 nx = r.invDirection.x < 0.0f;
+	const bln8 ny = r.invDirection.y < 0.0f;
+	const bln8 nz = r.invDirection.z < 0.0f;
+
+	const float8 ix = float8::Set1(r.invDirection.x), ox = float8::Set1(r.origin.x);
+	const float8 iy = float8::Set1(r.invDirection.y), oy = float8::Set1(r.origin.y);
+	const float8 iz = float8::Set1(r.invDirection.z), oz = float8::Set1(r.origin.z);
+
+	const float8 nearX = (float8::Load(nx ? boxes.maxX : boxes.minX) - ox) * ix;
+	const float8 nearY = (float8::Load(ny ? boxes.maxY : boxes.minY) - oy) * iy;
+	const float8 nearZ = (float8::Load(nz ? boxes.maxZ : boxes.minZ) - oz) * iz;
+
+	const float8 farX = (float8::Load(nx ? boxes.minX : boxes.maxX) - ox) * ix;
+	const float8 farY = (float8::Load(ny ? boxes.minY : boxes.maxY) - oy) * iy;
+	const float8 farZ = (float8::Load(nz ? boxes.minZ : boxes.maxZ) - oz) * iz;
+
+	const float8 tNear = simd::Max(simd::Max(nearX, nearY), simd::Max(nearZ, float8::Set1(tMin)));
+	const float8 tFar = simd::Min(simd::Min(farX, farY), simd::Min(farZ, float8::Set1(tMax)));
+
+	tNear.StoreU(tEntry);
+
+	return static_cast<uin32>(simd::MoveMask(simd::CmpLe(tNear, tFar)));
+}
+
+ENMA_HOT_FN uin32 Overlaps(const aabb3x8& boxes, const aabb3& box)
+{
+	using simd::float8;
+
+	flt32 lo[4], hi[4];
+	box.lower.StoreU(lo);
+	box.upper.StoreU(hi);
+
+	// Written as lower <= other upper so that NaN lanes never overlap
+	float8 overlap = simd::And(simd::CmpLe(float8::Load(boxes.minX), float8::Set1(hi[0])), simd::CmpGe(float8::Load(boxes.maxX), float8::Set1(lo[0])));
+	overlap = simd::And(overlap, simd::And(simd::CmpLe(float8::Load(boxes.minY), float8::Set1(hi[1])), simd::CmpGe(float8::Load(boxes.maxY), float8::Set1(lo[1]))));
+	overlap = simd::And(overlap, simd::And(simd::CmpLe(float8::Load(boxes.minZ), float8::Set1(hi[2])), simd::CmpGe(float8::Load(boxes.maxZ), float8::Set1(lo[2]))));
+
+	return static_cast<uin32>(simd::MoveMask(overlap));
+}
+#endif // ENMA_IMPLEMENTATION
@@ -0,0 +1,715 @@
+/* Bounding Volume Hierarchy
+ *
+ * This header file is part of Enmatica library
+ *
+ * Copyright (c) 202X by Villainous Softworks
+ *
+ */
+
+#pragma once
+#include "../enma.hpp"
+#include "../core/parallel.hpp"
+#include "aabb.hpp"
+#include "triangle.hpp"
+#include <algorithm>
+#include <vector>
+
+/**
+ * Inner node of a bvh8: the boxes of up to eight children in component arrays, so one
+ * 8-wide slab or overlap test visits every child at once.
+ *
+ * A child reference is an index into bvh8::nodes, a bvh8::LeafFlag tagged index into
+ * bvh8::leaves, or bvh8::Empty. Empty children keep empty boxes and are never entered.
+ */
+struct alignas(32) bvh8_node
+{
+	aabb3x8 bounds;
+	uin32 children[8];
+
+	/**
+	 * Constructor with eight empty children.
+	 */
+	bvh8_node();
+};
+
+/**
+ * An 8-wide bounding volume hierarchy over a triangle mesh.
+ *
+ * Built top-down with binned SAH on all three axes. Every inner node splits its largest child
+ * until it has eight, and ranges of at most LeafSize triangles become leaves stored as one
+ * triangle8 packet, so the traversal kernels are the 8-wide slab and Möller-Trumbore tests.
+ *
+ * The upper levels are built on the calling thread with binning spread across threads; the
+ * subtrees below are then built in parallel and spliced in.
+ */
+struct bvh8
+{
+	static constexpr uin32 LeafFlag = 0x80000000u;
+	static constexpr uin32 Empty = ~0u;
+	static constexpr uin32 LeafSize = 8;
+	static constexpr uin32 BinCount = 16;
+	static constexpr uin32 MedianDepth = 16;		// Deeper nodes split at the object median, bounding the depth
+	static constexpr uin32 StackSize = 512;		// Enough for the depth MedianDepth allows on 2^32 triangles
+
+	std::vector<bvh8_node> nodes;
+	std::vector<triangle8> leaves;
+	uin32 root = Empty;				// Child reference of the root, a leaf for meshes of at most LeafSize triangles
+	aabb3 bounds;
+
+	bvh8() = default;
+	/**
+	 * Constructor building over an indexed triangle mesh.
+	 *
+	 * \param vertices Pointer to the vertex array.
+	 * \param indices Pointer to 3 * `count` vertex indices, three per triangle.
+	 * \param count Number of triangles.
+	 */
+	bvh8(const fvec3* vertices, const uin32* indices, uin32 count);
+
+	/**
+	 * Rebuilds the hierarchy over an indexed triangle mesh. Hits report the triangle number in [0, count).
+	 *
+	 * \param vertices Pointer to the vertex array.
+	 * \param indices Pointer to 3 * `count` vertex indices, three per triangle.
+	 * \param count Number of triangles.
+	 */
+	void Build(const fvec3* vertices, const uin32* indices, uin32 count);
+};
+
+/**
+ * Closest-hit traversal. Children are visited near to far and skipped once they start past the nearest hit.
+ *
+ * \param bvh The hierarchy.
+ * \param r The ray.
+ * \param hit Updated with the nearest triangle hit in (tMin, hit.t).
+ * \param tMin Start of the tested interval along the ray.
+ * \return True if `hit` was updated.
+ */
+bln8 Intersect(const bvh8& bvh, const ray3& r, rayhit& hit, flt32 tMin = 0.0f);
+/**
+ * Any-hit traversal for occlusion rays, returns as soon as one triangle is hit.
+ *
+ * \param bvh The hierarchy.
+ * \param r The ray.
+ * \param tMin Start of the tested interval along the ray.
+ * \param tMax End of the tested interval along the ray.
+ * \return True if any triangle is hit in (tMin, tMax).
+ */
+bln8 IntersectAny(const bvh8& bvh, const ray3& r, flt32 tMin, flt32 tMax);
+/**
+ * Overlap traversal, collects every triangle whose bounding box overlaps `box`.
+ *
+ * \param bvh The hierarchy.
+ * \param box The query box.
+ * \param triangles Receives the triangle numbers, appended in no particular order.
+ * \return Number of triangles appended.
+ */
+uin32 Overlap(const bvh8& bvh, const aabb3& box, std::vector<uin32>& triangles);
+
+#ifdef ENMA_IMPLEMENTATION
+/**
+ * Working state of bvh8::Build, shared read-only by the parallel subtree builds.
+ */
+struct bvh8_builder
+{
+	static constexpr uin32 BuildGrain = 1u << 16;		// Ranges this large bin across threads
+
+	struct Range
+	{
+		uin32 begin, end;
+		aabb3 bounds;
+
+		uin32 Count() const { return end - begin; }
+	};
+
+	struct Bins
+	{
+		aabb3 bounds[3][bvh8::BinCount];
+		uin32 counts[3][bvh8::BinCount] = {};
+	};
+
+	// A subtree left for the parallel phase, to be linked into nodes[node].children[slot]
+	struct Deferred
+	{
+		uin32 node, slot, depth;
+		Range range;
+	};
+
+	struct Output
+	{
+		std::vector<bvh8_node> nodes;
+		std::vector<triangle8> leaves;
+	};
+
+	const fvec3* vertices;
+	const uin32* indices;
+
+	std::vector<aabb3> boxes;		// Per triangle
+	std::vector<uin32> ids;			// Triangle numbers, partitioned in place
+
+	bln8 parallel = true;
+	uin32 deferLimit = 0;
+	std::vector<Deferred> deferred;
+
+	bvh8_builder(const fvec3* vertices, const uin32* indices, uin32 count) : vertices(vertices), indices(indices), boxes(count), ids(count)
+	{
+		const uin32 tasks = TaskCount(count, BuildGrain);
+
+		ParallelFor(tasks, [&](uin32 task)
+		{
+			for(uin32 i = TaskBegin(task, tasks, count), end = TaskBegin(task + 1, tasks, count); i < end; i++)
+			{
+				boxes[i] = aabb3().Expand(vertices[indices[3 * i]]).Expand(vertices[indices[3 * i + 1]]).Expand(vertices[indices[3 * i + 2]]);
+				ids[i] = i;
+			}
+		});
+	}
+
+	// Doubled centroid, the halving cancels out of every use
+	simd::float4 Centroid(uin32 id) const
+	{
+		return boxes[id].lower + boxes[id].upper;
+	}
+
+	// Number of tasks [begin, end) is split into, 1 in the serial phase
+	uin32 RangeTasks(uin32 begin, uin32 end) const
+	{
+		return parallel ? TaskCount(end - begin, BuildGrain) : 1;
+	}
+
+	// Runs fn(first, last, task) over `tasks` slices of [begin, end), one thread each
+	template <typename Fn>
+	void ForRange(uin32 begin, uin32 end, uin32 tasks, Fn&& fn) const
+	{
+		ParallelFor(tasks, [&](uin32 task)
+		{
+			fn(begin + TaskBegin(task, tasks, end - begin), begin + TaskBegin(task + 1, tasks, end - begin), task);
+		});
+	}
+
+	aabb3 Bounds(uin32 begin, uin32 end, bln8 centroids) const
+	{
+		auto bound = [&](uin32 first, uin32 last)
+		{
+			aabb3 box;
+
+			for(uin32 i = first; i < last; i++)
+			{
+				if(centroids)
+				{
+					const simd::float4 c = Centroid(ids[i]);
+					box.Expand(aabb3(c, c));
+				}
+				else
+				{
+					box.Expand(boxes[ids[i]]);
+				}
+			}
+
+			return box;
+		};
+
+		// The per-task results are only allocated when the range is actually split
+		const uin32 tasks = RangeTasks(begin, end);
+
+		if(tasks == 1)
+		{
+			return bound(begin, end);
+		}
+
+		std::vector<aabb3> partial(tasks);
+
+		ForRange(begin, end, tasks, [&](uin32 first, uin32 last, uin32 task)
+		{
+			partial[task] = bound(first, last);
+		});
+
+		aabb3 box;
+		for(uin32 task = 0; task < tasks; task++)
+		{
+			box.Expand(partial[task]);
+		}
+
+		return box;
+	}
+
+	// Object median along the widest centroid axis. `range` is a copy since `left` may alias it
+	void SplitMedian(const Range range, const aabb3& centroids, Range& left, Range& right)
+	{
+		flt32 extent[4];
+		(centroids.upper - centroids.lower).StoreU(extent);
+
+		const uin32 axis = extent[0] >= extent[1] ? (extent[0] >= extent[2] ? 0 : 2) : (extent[1] >= extent[2] ? 1 : 2);
+		const uin32 mid = range.begin + range.Count() / 2;
+
+		std::nth_element(ids.begin() + range.begin, ids.begin() + mid, ids.begin() + range.end, [&](uin32 a, uin32 b)
+		{
+			flt32 ca[4], cb[4];
+			Centroid(a).StoreU(ca);
+			Centroid(b).StoreU(cb);
+
+			return ca[axis] < cb[axis];
+		});
+
+		left = { range.begin, mid, Bounds(range.begin, mid, false) };
+		right = { mid, range.end, Bounds(mid, range.end, false) };
+	}
+
+	void SplitRange(const Range range, bln8 median, Range& left, Range& right)
+	{
+		using namespace simd;
+
+		const aabb3 centroids = Bounds(range.begin, range.end, true);
+		const float4 extent = centroids.upper - centroids.lower;
+
+		if(median || (MoveMask(CmpGt(extent, float4::Zero())) & 0x7) == 0)
+		{
+			return SplitMedian(range, centroids, left, right);
+		}
+
+		// Just under BinCount / extent so the largest centroid still lands in the last bin; flat axes get scale 0
+		const float4 scale = Select(CmpGt(extent, float4::Zero()), float4::Set1(bvh8::BinCount * 0.99999f) / extent, float4::Zero());
+		const int4 lastBin = int4::Set1(bvh8::BinCount - 1);
+
+		auto binOf = [&](uin32 id, int32 (&bin)[4])
+		{
+			Max(Min(ToIntTrunc((Centroid(id) - centroids.lower) * scale), lastBin), int4::Zero()).StoreU(bin);
+		};
+
+		auto fill = [&](uin32 first, uin32 last, Bins& bins)
+		{
+			for(uin32 i = first; i < last; i++)
+			{
+				int32 bin[4];
+				binOf(ids[i], bin);
+
+				for(uin32 axis = 0; axis < 3; axis++)
+				{
+					bins.bounds[axis][bin[axis]].Expand(boxes[ids[i]]);
+					bins.counts[axis][bin[axis]]++;
+				}
+			}
+		};
+
+		// A single task bins straight into the stack copy, per-task bins are only allocated for a split range
+		const uin32 tasks = RangeTasks(range.begin, range.end);
+		Bins bins;
+
+		if(tasks == 1)
+		{
+			fill(range.begin, range.end, bins);
+		}
+		else
+		{
+			std::vector<Bins> partial(tasks);
+
+			ForRange(range.begin, range.end, tasks, [&](uin32 first, uin32 last, uin32 task)
+			{
+				fill(first, last, partial[task]);
+			});
+
+			bins = partial[0];
+			for(uin32 task = 1; task < tasks; task++)
+			{
+				for(uin32 axis = 0; axis < 3; axis++)
+				{
+					for(uin32 b = 0; b < bvh8::BinCount; b++)
+					{
+						bins.bounds[axis][b].Expand(partial[task].bounds[axis][b]);
+						bins.counts[axis][b] += partial[task].counts[axis][b];
+					}
+				}
+			}
+		}
+
+		// Sweep from the right for the suffix costs, then from the left to find the cheapest plane
+		flt32 bestCost = std::numeric_limits<flt32>::infinity();
+		uin32 bestAxis = 0, bestBin = 0;
+
+		for(uin32 axis = 0; axis < 3; axis++)
+		{
+			flt32 rightCost[bvh8::BinCount];
+			aabb3 box;
+			uin32 count = 0;
+
+			for(uin32 b = bvh8::BinCount - 1; b > 0; b--)
+			{
+				box.Expand(bins.bounds[axis][b]);
+				count += bins.counts[axis][b];
+				rightCost[b] = count ? SurfaceArea(box) * count : 0.0f;
+			}
+
+			box = aabb3();
+			count = 0;
+
+			for(uin32 b = 0; b < bvh8::BinCount - 1; b++)
+			{
+				box.Expand(bins.bounds[axis][b]);
+				count += bins.counts[axis][b];
+
+				const flt32 cost = SurfaceArea(box) * count + rightCost[b + 1];
+
+				if(count > 0 && count < range.Count() && cost < bestCost)
+				{
+					bestCost = cost;
+					bestAxis = axis;
+					bestBin = b;
+				}
+			}
+		}
+
+		if(bestCost == std::numeric_limits<flt32>::infinity())
+		{
+			return SplitMedian(range, centroids, left, right);
+		}
+
+		const auto middle = std::partition(ids.begin() + range.begin, ids.begin() + range.end, [&](uin32 id)
+		{
+			int32 bin[4];
+			binOf(id, bin);
+
+			return static_cast<uin32>(bin[bestAxis]) <= bestBin;
+		});
+
+		const uin32 mid = static_cast<uin32>(middle - ids.begin());
+
+		left = { range.begin, mid, aabb3() };
+		right = { mid, range.end, aabb3() };
+
+		for(uin32 b = 0; b < bvh8::BinCount; b++)
+		{
+			(b <= bestBin ? left : right).bounds.Expand(bins.bounds[bestAxis][b]);
+		}
+	}
+
+	uin32 MakeLeaf(Output& out, const Range& range) const
+	{
+		triangle8 leaf;
+
+		for(uin32 i = range.begin; i < range.end; i++)
+		{
+			const uin32 id = ids[i];
+			leaf.Set(i - range.begin, vertices[indices[3 * id]], vertices[indices[3 * id + 1]], vertices[indices[3 * id + 2]], id);
+		}
+
+		out.leaves.push_back(leaf);
+
+		return bvh8::LeafFlag | static_cast<uin32>(out.leaves.size() - 1);
+	}
+
+	uin32 BuildNode(Output& out, const Range& range, uin32 depth)
+	{
+		const uin32 index = static_cast<uin32>(out.nodes.size());
+		out.nodes.emplace_back();
+
+		const bln8 median = depth >= bvh8::MedianDepth;
+
+		Range children[8] = { range };
+		uin32 count = 1;
+
+		// Open the child with the largest area (count past MedianDepth) until there are eight
+		while(count < 8)
+		{
+			uin32 widest = 8;
+			flt32 widestKey = 0.0f;
+
+			for(uin32 c = 0; c < count; c++)
+			{
+				const flt32 key = median ? flt32(children[c].Count()) : SurfaceArea(children[c].bounds);
+
+				if(children[c].Count() > bvh8::LeafSize && (widest == 8 || key > widestKey))
+				{
+					widest = c;
+					widestKey = key;
+				}
+			}
+
+			if(widest == 8)
+			{
+				break;
+			}
+
+			SplitRange(children[widest], median, children[widest], children[count]);
+			count++;
+		}
+
+		for(uin32 c = 0; c < count; c++)
+		{
+			out.nodes[index].bounds.Set(c, children[c].bounds);
+
+			uin32 child = bvh8::Empty;
+
+			if(children[c].Count() <= bvh8::LeafSize)
+			{
+				child = MakeLeaf(out, children[c]);
+			}
+			else if(children[c].Count() <= deferLimit)
+			{
+				deferred.push_back({ index, c, depth + 1, children[c] });
+			}
+			else
+			{
+				child = BuildNode(out, children[c], depth + 1);
+			}
+
+			// Not a reference into out.nodes held across BuildNode, which may reallocate it
+			out.nodes[index].children[c] = child;
+		}
+
+		return index;
+	}
+};
+
+ENMA_FN bvh8_node::bvh8_node()
+{
+	std::fill(children, children + 8, bvh8::Empty);
+}
+
+ENMA_FN bvh8::bvh8(const fvec3* vertices, const uin32* indices, uin32 count)
+{
+	Build(vertices, indices, count);
+}
+
+ENMA_FN void bvh8::Build(const fvec3* vertices, const uin32* indices, uin32 count)
+{
+	nodes.clear();
+	leaves.clear();
+	root = Empty;
+	bounds = aabb3();
+
+	if(count == 0)
+	{
+		return;
+	}
+
+	bvh8_builder builder(vertices, indices, count);
+	bvh8_builder::Output top;
+
+	const bvh8_builder::Range range = { 0, count, builder.Bounds(0, count, false) };
+	bounds = range.bounds;
+
+	if(count <= LeafSize)
+	{
+		root = builder.MakeLeaf(top, range);
+		leaves = std::move(top.leaves);
+
+		return;
+	}
+
+	// Subtrees this small are left for the parallel phase, about four per thread
+	const uin32 threads = GetThreadCount();
+	builder.deferLimit = threads > 1 ? count / (threads * 4) : 0;
+
+	root = builder.BuildNode(top, range, 0);
+
+	builder.parallel = false;
+	builder.deferLimit = 0;
+
+	// Largest subtree first onto the least loaded task
+	std::vector<bvh8_builder::Deferred>& deferred = builder.deferred;
+	std::sort(deferred.begin(), deferred.end(), [](const bvh8_builder::Deferred& a, const bvh8_builder::Deferred& b) { return a.range.Count() > b.range.Count(); });
+
+	const uin32 tasks = std::min(threads, static_cast<uin32>(deferred.size()));
+
+	std::vector<std::vector<uin32>> assigned(tasks);
+	std::vector<uin64> load(tasks, 0);
+
+	for(uin32 d = 0; d < deferred.size(); d++)
+	{
+		const uin32 task = static_cast<uin32>(std::min_element(load.begin(), load.end()) - load.begin());
+
+		assigned[task].push_back(d);
+		load[task] += deferred[d].range.Count();
+	}
+
+	std::vector<bvh8_builder::Output> outputs(tasks);
+	std::vector<uin32> roots(deferred.size());
+
+	ParallelFor(tasks, [&](uin32 task)
+	{
+		for(const uin32 d : assigned[task])
+		{
+			roots[d] = builder.BuildNode(outputs[task], deferred[d].range, deferred[d].depth);
+		}
+	});
+
+	// Splice every task's nodes and leaves behind the top levels, rebasing the references
+	nodes = std::move(top.nodes);
+	leaves = std::move(top.leaves);
+
+	for(uin32 task = 0; task < tasks; task++)
+	{
+		const uin32 nodeBase = static_cast<uin32>(nodes.size());
+		const uin32 leafBase = static_cast<uin32>(leaves.size());
+
+		for(bvh8_node& node : outputs[task].nodes)
+		{
+			for(uin32& child : node.children)
+			{
+				if(child != Empty)
+				{
+					child += (child & LeafFlag) ? leafBase : nodeBase;
+				}
+			}
+		}
+
+		nodes.insert(nodes.end(), outputs[task].nodes.begin(), outputs[task].nodes.end());
+		leaves.insert(leaves.end(), outputs[task].leaves.begin(), outputs[task].leaves.end());
+
+		for(const uin32 d : assigned[task])
+		{
+			nodes[deferred[d].node].children[deferred[d].slot] = roots[d] + nodeBase;
+		}
+	}
+}
+
+ENMA_FN bln8 Intersect(const bvh8& bvh, const ray3& r, rayhit& hit, flt32 tMin)
+{
+	struct Entry
+	{
+		uin32 child;
+		flt32 t;
+	};
+
+	if(bvh.root == bvh8::Empty)
+	{
+		return false;
+	}
+
+	Entry stack[bvh8::StackSize];
+	uin32 top = 0;
+	bln8 found = false;
+
+	stack[top++] = { bvh.root, tMin };
+
+	while(top)
+	{
+		const Entry entry = stack[--top];
+
+		if(entry.t > hit.t)
+		{
+			continue;
+		}
+
+		if(entry.child & bvh8::LeafFlag)
+		{
+			found |= Intersect(r, bvh.leaves[entry.child & ~bvh8::LeafFlag], hit, tMin);
+			continue;
+		}
+
+		const bvh8_node& node = bvh.nodes[entry.child];
+
+		flt32 entries[8];
+		const uin32 first = top;
+
+		// Insert the children sorted far to near, so the nearest is popped first
+		for(uin32 mask = Intersect(r, node.bounds, tMin, hit.t, entries); mask; mask &= mask - 1)
+		{
+			const uin32 lane = simd::PopCount((mask & (0u - mask)) - 1u);
+			const Entry child = { node.children[lane], entries[lane] };
+
+			uin32 slot = top++;
+			for(; slot > first && stack[slot - 1].t < child.t; slot--)
+			{
+				stack[slot] = stack[slot - 1];
+			}
+
+			stack[slot] = child;
+		}
+	}
+
+	return found;
+}
+
+ENMA_FN bln8 IntersectAny(const bvh8& bvh, const ray3& r, flt32 tMin, flt32 tMax)
+{
+	if(bvh.root == bvh8::Empty)
+	{
+		return false;
+	}
+
+	uin32 stack[bvh8::StackSize];
+	uin32 top = 0;
+
+	stack[top++] = bvh.root;
+
+	while(top)
+	{
+		const uin32 child = stack[--top];
+
+		if(child & bvh8::LeafFlag)
+		{
+			rayhit hit(tMax);
+
+			if(Intersect(r, bvh.leaves[child & ~bvh8::LeafFlag], hit, tMin))
+			{
+				return true;
+			}
+
+			continue;
+		}
+
+		const bvh8_node& node = bvh.nodes[child];
+
+		flt32 entries[8];
+		for(uin32 mask = Intersect(r, node.bounds, tMin, tMax, entries); mask; mask &= mask - 1)
+		{
+			stack[top++] = node.children[simd::PopCount((mask & (0u - mask)) - 1u)];
+		}
+	}
+
+	return false;
+}
+
+ENMA_FN uin32 Overlap(const bvh8& bvh, const aabb3& box, std::vector<uin32>& triangles)
+{
+	using simd::float8;
+
+	if(bvh.root == bvh8::Empty)
+	{
+		return 0;
+	}
+
+	const uin32 before = static_cast<uin32>(triangles.size());
+
+	uin32 stack[bvh8::StackSize];
+	uin32 top = 0;
+
+	stack[top++] = bvh.root;
+
+	while(top)
+	{
+		const uin32 child = stack[--top];
+
+		if(child & bvh8::LeafFlag)
+		{
+			const triangle8& leaf = bvh.leaves[child & ~bvh8::LeafFlag];
+
+			// Bounding boxes of the eight triangles, unused NaN lanes never overlap
+			aabb3x8 bounds;
+			simd::Min(simd::Min(float8::Load(leaf.ax), float8::Load(leaf.bx)), float8::Load(leaf.cx)).Store(bounds.minX);
+			simd::Min(simd::Min(float8::Load(leaf.ay), float8::Load(leaf.by)), float8::Load(leaf.cy)).Store(bounds.minY);
+			simd::Min(simd::Min(float8::Load(leaf.az), float8::Load(leaf.bz)), float8::Load(leaf.cz)).Store(bounds.minZ);
+			simd::Max(simd::Max(float8::Load(leaf.ax), float8::Load(leaf.bx)), float8::Load(leaf.cx)).Store(bounds.maxX);
+			simd::Max(simd::Max(float8::Load(leaf.ay), float8::Load(leaf.by)), float8::Load(leaf.cy)).Store(bounds.maxY);
+			simd::Max(simd::Max(float8::Load(leaf.az), float8::Load(leaf.bz)), float8::Load(leaf.cz)).Store(bounds.maxZ);
+
+			for(uin32 mask = Overlaps(bounds, box); mask; mask &= mask - 1)
+			{
+				triangles.push_back(leaf.index[simd::PopCount((mask & (0u - mask)) - 1u)]);
+			}
+
+			continue;
+		}
+
+		const bvh8_node& node = bvh.nodes[child];
+
+		for(uin32 mask = Overlaps(node.bounds, box); mask; mask &= mask - 1)
+		{
+			stack[top++] = node.children[simd::PopCount((mask & (0u - mask)) - 1u)];
+		}
+	}
+
+	return static_cast<uin32>(triangles.size()) - before;
+}
+#endif // ENMA_IMPLEMENTATION
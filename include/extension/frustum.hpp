@@ -0,0 +1,290 @@
+/* View Frustum Culling
+ *
+ * This header file is part of Enmatica library
+ *
+ * Copyright (c) 202X by Villainous Softworks
+ *
+ */
+
+#pragma once
+#include "../enma.hpp"
+#include "../core/parallel.hpp"
+#include "aabb.hpp"
+#include <cstring>
+
+/**
+ * The six clip planes of a view-projection matrix, normalised and stored as component arrays.
+ *
+ * Plane i is nx[i] * x + ny[i] * y + nz[i] * z + d[i] = 0 with the normal pointing inside, so a point
+ * is inside the frustum when every plane gives a non-negative distance. The planes are extracted
+ * for row vectors (clip = v * viewProjection) and a [0, w] clip depth, the conventions of LookAt,
+ * Perspective, Frustum and Orthographic.
+ */
+struct alignas(32) frustum
+{
+	enum Plane : uin32
+	{
+		Left, Right, Bottom, Top, Near, Far, PlaneCount
+	};
+
+	flt32 nx[PlaneCount];
+	flt32 ny[PlaneCount];
+	flt32 nz[PlaneCount];
+	flt32 d[PlaneCount];
+
+	frustum() = default;
+	/**
+	 * Extracts the planes of a view-projection matrix.
+	 *
+	 * \param viewProjection World to clip space matrix. A projection alone gives the planes in view space.
+	 */
+	explicit frustum(const fmat4x4& viewProjection);
+
+	/**
+	 * Signed distance of a point to one plane, positive inside.
+	 *
+	 * \param plane Index of the plane.
+	 * \param point The point.
+	 */
+	flt32 Distance(uin32 plane, const fvec3& point) const;
+};
+
+/**
+ * True if the sphere is at least partly inside the frustum.
+ *
+ * The test is conservative: a sphere outside near a frustum corner may still be reported visible.
+ */
+bln8 Intersect(const frustum& f, const fvec3& center, flt32 radius);
+/**
+ * True if the box is at least partly inside the frustum. Conservative like the sphere test.
+ */
+bln8 Intersect(const frustum& f, const aabb3& box);
+
+/**
+ * Culls a stream of bounding spheres, 8 per iteration, split across threads for large streams.
+ *
+ * Writes the indices of the visible spheres in ascending order instead of a flag per sphere, so
+ * the caller can walk the survivors directly.
+ *
+ * The blocks run on simd::float8 with no runtime-dispatched tier: they use AVX2 and FMA only when
+ * compiled with `-mavx2 -mfma`, on the SSE4.1 baseline every block is two float4 halves.
+ *
+ * \param f The frustum.
+ * \param centers Sphere centers.
+ * \param radii Pointer to an array of at least `centers.count` radii.
+ * \param visible Pointer to an array of at least `centers.count` indices that receives the visible ones.
+ * \return Number of indices written to `visible`.
+ */
+uin32 CullSpheres(const frustum& f, const fvec3_soa& centers, const flt32* radii, uin32* visible);
+/**
+ * Culls a stream of boxes, 8 per iteration, split across threads for large streams.
+ * Built for the same instruction set as CullSpheres.
+ *
+ * \param f The frustum.
+ * \param lower Lower corners.
+ * \param upper Upper corners, with the same count as `lower`.
+ * \param visible Pointer to an array of at least `lower.count` indices that receives the visible ones.
+ * \return Number of indices written to `visible`.
+ */
+uin32 CullBoxes(const frustum& f, const fvec3_soa& lower, const fvec3_soa& upper, uin32* visible);
+
+/**
+ * Splits `count` items into 8-aligned ranges, runs cull(begin, end, out) on each and packs the
+ * index lists of all ranges to the front of `visible`.
+ *
+ * A range writes its survivors to `visible + begin`, which can never overtake the next range.
+ */
+// Items per culling task below which a stream is not worth another thread
+constexpr uin32 CullGrain = 1u << 15;
+
+template <typename Cull>
+inline uin32 CullParallel(uin32 count, uin32* visible, Cull&& cull)
+{
+	const uin32 blocks = (count + 7) / 8;
+	const uin32 tasks = TaskCount(count, CullGrain);
+
+	std::vector<uin32> written(tasks);
+
+	ParallelFor(tasks, [&](uin32 task)
+	{
+		const uin32 begin = TaskBegin(task, tasks, blocks) * 8;
+		const uin32 end = std::min(count, TaskBegin(task + 1, tasks, blocks) * 8);
+
+		written[task] = cull(begin, end, visible + begin);
+	});
+
+	uin32 total = written[0];
+
+	for(uin32 task = 1; task < tasks; task++)
+	{
+		std::memmove(visible + total, visible + TaskBegin(task, tasks, blocks) * 8, written[task] * sizeof(uin32));
+		total += written[task];
+	}
+
+	return total;
+}
+
+/**
+ * Appends first + i to `out` for every lane i set in `mask`.
+ *
+ * A full block may store all 8 lanes since `out` never runs ahead of the block being culled.
+ * The tail block stores only the selected lanes so nothing is written past the last index.
+ */
+inline uin32 CullEmit(uin32* out, uin32 first, uin32 mask, bln8 full)
+{
+	if(full)
+	{
+		static constexpr int32 lanes[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+
+		return simd::CompressStoreU(reinterpret_cast<int32*>(out), simd::int8::Set1(static_cast<int32>(first)) + simd::int8::LoadU(lanes), mask);
+	}
+
+	uin32 written = 0;
+
+	for(; mask; mask &= mask - 1)
+	{
+		out[written++] = first + simd::PopCount((mask & (0u - mask)) - 1u);
+	}
+
+	return written;
+}
+
+#ifdef ENMA_IMPLEMENTATION
+ENMA_FN frustum::frustum(const fmat4x4& viewProjection)
+{
+	// Gribb-Hartmann: every plane is a sum or difference of two columns of the matrix
+	const fmat4x4 columns = Transpose(viewProjection);
+
+	const fvec4 x = columns[0];
+	const fvec4 y = columns[1];
+	const fvec4 z = columns[2];
+	const fvec4 w = columns[3];
+
+	const fvec4 planes[PlaneCount] = { w + x, w - x, w + y, w - y, z, w - z };
+
+	for(uin32 i = 0; i < PlaneCount; i++)
+	{
+		const flt32 scale = 1.0f / std::sqrt(planes[i].x * planes[i].x + planes[i].y * planes[i].y + planes[i].z * planes[i].z);
+
+		nx[i] = planes[i].x * scale;
+		ny[i] = planes[i].y * scale;
+		nz[i] = planes[i].z * scale;
+		d[i] = planes[i].w * scale;
+	}
+}
+
+ENMA_HOT_FN flt32 frustum::Distance(uin32 plane, const fvec3& point) const
+{
+	return nx[plane] * point.x + ny[plane] * point.y + nz[plane] * point.z + d[plane];
+}
+
+ENMA_FN bln8 Intersect(const frustum& f, const fvec3& center, flt32 radius)
+{
+	for(uin32 i = 0; i < frustum::PlaneCount; i++)
+	{
+		if(f.Distance(i, center) < -radius)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+ENMA_FN bln8 Intersect(const frustum& f, const aabb3& box)
+{
+	const fvec3 center = box.Center();
+	const fvec3 extent = box.Size() * 0.5f;
+
+	for(uin32 i = 0; i < frustum::PlaneCount; i++)
+	{
+		// Projected half-size of the box onto the plane normal
+		const flt32 reach = std::abs(f.nx[i]) * extent.x + std::abs(f.ny[i]) * extent.y + std::abs(f.nz[i]) * extent.z;
+
+		if(f.Distance(i, center) < -reach)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+ENMA_FN uin32 CullSpheres(const frustum& f, const fvec3_soa& centers, const flt32* radii, uin32* visible)
+{
+	using simd::float8;
+
+	return CullParallel(centers.count, visible, [&](uin32 begin, uin32 end, uin32* out)
+	{
+		uin32 written = 0;
+
+		for(uin32 i = begin; i < end; i += 8)
+		{
+			const bln8 full = i + 8 <= end;
+
+			// The center arrays are padded to 16 lanes, the radii are not
+			flt32 tail[8] = {};
+			if(!full)
+			{
+				std::copy(radii + i, radii + end, tail);
+			}
+
+			const float8 cx = float8::Load(centers.x + i);
+			const float8 cy = float8::Load(centers.y + i);
+			const float8 cz = float8::Load(centers.z + i);
+			const float8 r = -float8::LoadU(full ? radii + i : tail);
+
+			uin32 mask = full ? 0xFFu : (1u << (end - i)) - 1u;
+
+			for(uin32 p = 0; p < frustum::PlaneCount && mask; p++)
+			{
+				const float8 distance = simd::Fmadd(float8::Set1(f.nx[p]), cx, simd::Fmadd(float8::Set1(f.ny[p]), cy, simd::Fmadd(float8::Set1(f.nz[p]), cz, float8::Set1(f.d[p]))));
+
+				mask &= static_cast<uin32>(simd::MoveMask(simd::CmpGe(distance, r)));
+			}
+
+			written += CullEmit(out + written, i, mask, full);
+		}
+
+		return written;
+	});
+}
+
+ENMA_FN uin32 CullBoxes(const frustum& f, const fvec3_soa& lower, const fvec3_soa& upper, uin32* visible)
+{
+	using simd::float8;
+
+	return CullParallel(lower.count, visible, [&](uin32 begin, uin32 end, uin32* out)
+	{
+		const float8 half = float8::Set1(0.5f);
+		uin32 written = 0;
+
+		for(uin32 i = begin; i < end; i += 8)
+		{
+			const bln8 full = i + 8 <= end;
+
+			const float8 lx = float8::Load(lower.x + i), ux = float8::Load(upper.x + i);
+			const float8 ly = float8::Load(lower.y + i), uy = float8::Load(upper.y + i);
+			const float8 lz = float8::Load(lower.z + i), uz = float8::Load(upper.z + i);
+
+			const float8 cx = (lx + ux) * half, ex = (ux - lx) * half;
+			const float8 cy = (ly + uy) * half, ey = (uy - ly) * half;
+			const float8 cz = (lz + uz) * half, ez = (uz - lz) * half;
+
+			uin32 mask = full ? 0xFFu : (1u << (end - i)) - 1u;
+
+			for(uin32 p = 0; p < frustum::PlaneCount && mask; p++)
+			{
+				const float8 distance = simd::Fmadd(float8::Set1(f.nx[p]), cx, simd::Fmadd(float8::Set1(f.ny[p]), cy, simd::Fmadd(float8::Set1(f.nz[p]), cz, float8::Set1(f.d[p]))));
+				const float8 reach = simd::Fmadd(float8::Set1(std::abs(f.nx[p])), ex, simd::Fmadd(float8::Set1(std::abs(f.ny[p])), ey, float8::Set1(std::abs(f.nz[p])) * ez));
+
+				mask &= static_cast<uin32>(simd::MoveMask(simd::CmpGe(distance + reach, float8::Zero())));
+			}
+
+			written += CullEmit(out + written, i, mask, full);
+		}
+
+		return written;
+	});
+}
+#endif // ENMA_IMPLEMENTATION
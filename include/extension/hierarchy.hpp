@@ -0,0 +1,447 @@
+/* Transform Hierarchy
+ *
+ * This header file is part of Enmatica library
+ *
+ * Copyright (c) 202X by Villainous Softworks
+ *
+ */
+
+#pragma once
+#include "../enma.hpp"
+#include "../core/parallel.hpp"
+#include <algorithm>
+#include <vector>
+
+/**
+ * Local to parent matrix of a scale, then a rotation, then a translation, for row vectors
+ * (v * Compose(...) scales v first). Equal to Scale(scale) * ToRotationMatrix(rotation) * Translate(position).
+ *
+ * \param position Translation, stored in the fourth row.
+ * \param rotation Unit quaternion.
+ * \param scale Scale along the local axes.
+ */
+fmat4x4 Compose(const fvec3& position, const fquat& rotation, const fvec3& scale);
+
+/**
+ * A flat hierarchy of local transforms that propagates world matrices one depth level at a time.
+ *
+ * Nodes are stored breadth first, so every depth level is one contiguous range of slots and the
+ * children of a slot are contiguous in the level below. The world matrices of a level only read
+ * the level above, which lets Update split a level across threads. Between updates only the nodes
+ * whose local transform was set, and their descendants, are recomputed.
+ *
+ * Nodes are referred to by the handle Add returns. Adding nodes reorders the slots on the next
+ * Update, which then recomputes every node once.
+ */
+struct transform_hierarchy
+{
+	static constexpr uin32 None = ~0u;
+	static constexpr uin32 UpdateGrain = 1u << 13;		// Levels this large are split across threads
+
+	// Per slot, in breadth-first order
+	std::vector<fvec3> positions;
+	std::vector<fquat> rotations;
+	std::vector<fvec3> scales;
+	std::vector<fmat4x4> worlds;
+	std::vector<uin32> parents;				// Slot of the parent, None for roots
+	std::vector<uin32> children;			// Children of slot i are [children[i], children[i + 1])
+	std::vector<uin32> levels;				// Slots of depth d are [levels[d], levels[d + 1])
+
+	std::vector<uin32> slots;				// Slot of every handle
+
+	/**
+	 * Adds a node. Its world matrix is valid after the next Update.
+	 *
+	 * \param parent Handle of the parent node, or None for a root.
+	 * \param position Local translation.
+	 * \param rotation Local rotation, a unit quaternion.
+	 * \param scale Local scale.
+	 * \return Handle of the node, the number of nodes added before it.
+	 */
+	uin32 Add(uin32 parent, const fvec3& position, const fquat& rotation, const fvec3& scale);
+
+	/**
+	 * Sets the local transform of a node and marks it for the next Update.
+	 *
+	 * \param node Handle of the node.
+	 * \param position Local translation.
+	 * \param rotation Local rotation, a unit quaternion.
+	 * \param scale Local scale.
+	 */
+	void SetLocal(uin32 node, const fvec3& position, const fquat& rotation, const fvec3& scale);
+
+	/**
+	 * Local to world matrix of a node as of the last Update.
+	 *
+	 * \param node Handle of the node.
+	 */
+	const fmat4x4& World(uin32 node) const;
+
+	uin32 Count() const;
+
+	/**
+	 * Recomputes the world matrices of the changed nodes and their descendants.
+	 *
+	 * \return Number of world matrices recomputed.
+	 */
+	uin32 Update();
+
+private:
+	std::vector<uin32> dirty;				// Slots set since the last Update
+	std::vector<uin8> flags;				// Per slot, set while the slot is listed in `dirty` or being recomputed
+	std::vector<uin32> current, next, previous;		// Slots recomputed on the current, next and previous level
+	bln8 reorder = false;					// Nodes were added since the last Update
+
+	void Reorder();
+	void Compute(uin32 slot);
+	void ComputeLevels(uin32 first);
+	void ComputeSlots(const std::vector<uin32>& list);
+	uin32 ComputeFlagged();
+};
+
+#ifdef ENMA_IMPLEMENTATION
+ENMA_HOT_FN fmat4x4 Compose(const fvec3& position, const fquat& rotation, const fvec3& scale)
+{
+	const flt32 x2 = rotation.x * rotation.x;
+	const flt32 y2 = rotation.y * rotation.y;
+	const flt32 z2 = rotation.z * rotation.z;
+
+	const flt32 xy = rotation.x * rotation.y;
+	const flt32 wz = rotation.w * rotation.z;
+
+	const flt32 xz = rotation.x * rotation.z;
+	const flt32 wy = rotation.w * rotation.y;
+
+	const flt32 yz = rotation.y * rotation.z;
+	const flt32 wx = rotation.w * rotation.x;
+
+	return
+	{
+		scale.x * (1 - 2 * (y2 + z2)),	scale.x * 2 * (xy + wz), 		scale.x * 2 * (xz - wy), 		0.0f,
+		scale.y * 2 * (xy - wz),		scale.y * (1 - 2 * (x2 + z2)),	scale.y * 2 * (yz + wx), 		0.0f,
+		scale.z * 2 * (xz + wy),		scale.z * 2 * (yz - wx), 		scale.z * (1 - 2 * (x2 + y2)), 	0.0f,
+		position.x, 					position.y, 					position.z, 					1.0f
+	};
+}
+
+ENMA_FN uin32 transform_hierarchy::Add(uin32 parent, const fvec3& position, const fquat& rotation, const fvec3& scale)
+{
+	const uin32 handle = static_cast<uin32>(slots.size());
+
+	// Until the next Reorder new nodes sit past the sorted ones, still after their parents
+	slots.push_back(Count());
+	positions.push_back(position);
+	rotations.push_back(rotation);
+	scales.push_back(scale);
+	worlds.push_back(fmat4x4::identity);
+	parents.push_back(parent == None ? None : slots[parent]);
+	flags.push_back(0);
+
+	reorder = true;
+
+	return handle;
+}
+
+ENMA_FN void transform_hierarchy::SetLocal(uin32 node, const fvec3& position, const fquat& rotation, const fvec3& scale)
+{
+	const uin32 slot = slots[node];
+
+	positions[slot] = position;
+	rotations[slot] = rotation;
+	scales[slot] = scale;
+
+	if(!flags[slot])
+	{
+		flags[slot] = 1;
+		dirty.push_back(slot);
+	}
+}
+
+ENMA_HOT_FN const fmat4x4& transform_hierarchy::World(uin32 node) const
+{
+	return worlds[slots[node]];
+}
+
+ENMA_HOT_FN uin32 transform_hierarchy::Count() const
+{
+	return static_cast<uin32>(parents.size());
+}
+
+ENMA_FN void transform_hierarchy::Reorder()
+{
+	const uin32 count = Count();
+
+	// Children of every slot in the old order, counting sorted by parent
+	std::vector<uin32> offsets(count + 1, 0), list(count), order;
+	order.reserve(count);
+
+	for(uin32 s = 0; s < count; s++)
+	{
+		if(parents[s] == None)
+		{
+			order.push_back(s);
+		}
+		else
+		{
+			offsets[parents[s] + 1]++;
+		}
+	}
+
+	for(uin32 s = 0; s < count; s++)
+	{
+		offsets[s + 1] += offsets[s];
+	}
+
+	std::vector<uin32> fill(offsets.begin(), offsets.end() - 1);
+
+	for(uin32 s = 0; s < count; s++)
+	{
+		if(parents[s] != None)
+		{
+			list[fill[parents[s]]++] = s;
+		}
+	}
+
+	// Breadth first: a level ends where the children of the level above it end
+	levels.assign(1, 0);
+	uin32 levelEnd = static_cast<uin32>(order.size());
+
+	for(uin32 k = 0; k < order.size(); k++)
+	{
+		if(k == levelEnd)
+		{
+			levels.push_back(k);
+			levelEnd = static_cast<uin32>(order.size());
+		}
+
+		order.insert(order.end(), list.begin() + offsets[order[k]], list.begin() + offsets[order[k] + 1]);
+	}
+
+	levels.push_back(count);
+
+	std::vector<uin32> rank(count);
+
+	for(uin32 k = 0; k < count; k++)
+	{
+		rank[order[k]] = k;
+	}
+
+	auto permute = [&order](auto& values)
+	{
+		std::remove_reference_t<decltype(values)> sorted(values.size());
+
+		for(uin32 k = 0; k < sorted.size(); k++)
+		{
+			sorted[k] = values[order[k]];
+		}
+
+		values.swap(sorted);
+	};
+
+	permute(positions);
+	permute(rotations);
+	permute(scales);
+	permute(parents);
+
+	// The children of new slot k follow those of every slot before it, after the roots
+	children.assign(count + 1, 0);
+	children[0] = levels.size() > 1 ? levels[1] : 0;
+
+	for(uin32 k = 0; k < count; k++)
+	{
+		if(parents[k] != None)
+		{
+			parents[k] = rank[parents[k]];
+			children[parents[k] + 1]++;
+		}
+	}
+
+	for(uin32 k = 0; k < count; k++)
+	{
+		children[k + 1] += children[k];
+	}
+
+	for(uin32& slot : slots)
+	{
+		slot = rank[slot];
+	}
+}
+
+ENMA_HOT_FN void transform_hierarchy::Compute(uin32 slot)
+{
+	const fmat4x4 local = Compose(positions[slot], rotations[slot], scales[slot]);
+
+	worlds[slot] = parents[slot] == None ? local : local * worlds[parents[slot]];
+}
+
+ENMA_FN void transform_hierarchy::ComputeLevels(uin32 first)
+{
+	for(uin32 d = first; d + 1 < levels.size(); d++)
+	{
+		const uin32 begin = levels[d];
+		const uin32 count = levels[d + 1] - begin;
+		const uin32 tasks = TaskCount(count, UpdateGrain);
+
+		ParallelFor(tasks, [&](uin32 task)
+		{
+			const uin32 end = begin + TaskBegin(task + 1, tasks, count);
+
+			for(uin32 s = begin + TaskBegin(task, tasks, count); s < end; s++)
+			{
+				Compute(s);
+			}
+		});
+	}
+}
+
+ENMA_FN void transform_hierarchy::ComputeSlots(const std::vector<uin32>& list)
+{
+	const uin32 count = static_cast<uin32>(list.size());
+	const uin32 tasks = TaskCount(count, UpdateGrain);
+
+	ParallelFor(tasks, [&](uin32 task)
+	{
+		const uin32 end = TaskBegin(task + 1, tasks, count);
+
+		for(uin32 i = TaskBegin(task, tasks, count); i < end; i++)
+		{
+			Compute(list[i]);
+		}
+	});
+}
+
+ENMA_FN uin32 transform_hierarchy::ComputeFlagged()
+{
+	uin32 computed = 0;
+
+	for(uin32 d = 0; d + 1 < levels.size(); d++)
+	{
+		const uin32 begin = levels[d];
+		const uin32 count = levels[d + 1] - begin;
+		const uin32 tasks = TaskCount(count, UpdateGrain);
+
+		std::vector<uin32> counts(tasks, 0);
+
+		// A recomputed slot flags itself for its children; the threads only read the flags of the level above
+		ParallelFor(tasks, [&](uin32 task)
+		{
+			const uin32 end = begin + TaskBegin(task + 1, tasks, count);
+
+			for(uin32 s = begin + TaskBegin(task, tasks, count); s < end; s++)
+			{
+				if(flags[s] || (parents[s] != None && flags[parents[s]]))
+				{
+					flags[s] = 1;
+					Compute(s);
+					counts[task]++;
+				}
+			}
+		});
+
+		for(uin32 c : counts)
+		{
+			computed += c;
+		}
+	}
+
+	std::fill(flags.begin(), flags.end(), 0);
+
+	return computed;
+}
+
+ENMA_FN uin32 transform_hierarchy::Update()
+{
+	if(reorder)
+	{
+		dirty.clear();
+		std::fill(flags.begin(), flags.end(), 0);
+
+		Reorder();
+		ComputeLevels(0);
+
+		reorder = false;
+
+		return Count();
+	}
+
+	if(dirty.empty())
+	{
+		return 0;
+	}
+
+	// With this many changes sorting them costs more than testing the flags of every slot
+	if(dirty.size() > Count() / 16)
+	{
+		dirty.clear();
+
+		return ComputeFlagged();
+	}
+
+	// Sorted slots are sorted by depth, so the changed nodes of each level are consumed in turn
+	std::sort(dirty.begin(), dirty.end());
+
+	const uin32 depths = static_cast<uin32>(levels.size() - 1);
+	uin32 d = static_cast<uin32>(std::upper_bound(levels.begin(), levels.end(), dirty[0]) - levels.begin()) - 1;
+	uin32 listed = 0, computed = 0;
+
+	current.clear();
+	previous.clear();
+
+	for(; d < depths && (!current.empty() || listed < dirty.size()); d++)
+	{
+		// A changed node under a recomputed parent is already among that parent's children
+		for(; listed < dirty.size() && dirty[listed] < levels[d + 1]; listed++)
+		{
+			const uin32 slot = dirty[listed];
+
+			if(parents[slot] == None || !flags[parents[slot]])
+			{
+				current.push_back(slot);
+			}
+		}
+
+		for(uin32 slot : previous)
+		{
+			flags[slot] = 0;
+		}
+
+		// Every deeper node descends from a recomputed one, so the rest is a full update
+		if(current.size() == levels[d + 1] - levels[d])
+		{
+			ComputeLevels(d);
+			std::fill(flags.begin(), flags.end(), 0);
+
+			computed += Count() - levels[d];
+			current.clear();
+			previous.clear();
+			break;
+		}
+
+		ComputeSlots(current);
+		computed += static_cast<uin32>(current.size());
+
+		next.clear();
+
+		for(uin32 slot : current)
+		{
+			for(uin32 child = children[slot]; child < children[slot + 1]; child++)
+			{
+				flags[child] = 1;
+				next.push_back(child);
+			}
+		}
+
+		previous.swap(current);
+		current.swap(next);
+	}
+
+	for(uin32 slot : previous)
+	{
+		flags[slot] = 0;
+	}
+
+	dirty.clear();
+
+	return computed;
+}
+#endif // ENMA_IMPLEMENTATION
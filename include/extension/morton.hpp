@@ -0,0 +1,490 @@
+/* Morton (Z-Order) Codes and Spatial Sorting
+ *
+ * This header file is part of Enmatica library
+ *
+ * Copyright (c) 202X by Villainous Softworks
+ *
+ */
+
+#pragma once
+#include "../enma.hpp"
+#include "../core/parallel.hpp"
+
+// BMI2 is part of every AVX2 capable CPU, MSVC does not define __BMI2__ on its own
+#if defined(__BMI2__) || (defined(_MSC_VER) && defined(__AVX2__))
+#define ENMA_BMI2
+#endif
+
+/**
+ * Interleaves the low 16 bits of x and y into a 32-bit Morton code, x in the even bits.
+ */
+uin32 MortonEncode(const uvec2& v);
+/**
+ * Interleaves the low 10 bits of x, y and z into a 30-bit Morton code, x in bits 0, 3, 6...
+ */
+uin32 MortonEncode(const uvec3& v);
+/**
+ * Inverse of MortonEncode(const uvec2&).
+ */
+uvec2 MortonDecode2(uin32 code);
+/**
+ * Inverse of MortonEncode(const uvec3&).
+ */
+uvec3 MortonDecode3(uin32 code);
+
+// The batch overloads and MortonKeys run on simd::int8 and are not dispatched at runtime: a step is one AVX2
+// register only when the translation unit is compiled with `-mavx2`, on the SSE4.1 baseline it is two int4 halves
+/**
+ * Encodes `count` vectors, 8 per step.
+ */
+void MortonEncode(const uvec2* in, uin32* out, uin32 count);
+void MortonEncode(const uvec3* in, uin32* out, uin32 count);
+/**
+ * Decodes `count` codes, 8 per step.
+ */
+void MortonDecode2(const uin32* in, uvec2* out, uin32 count);
+void MortonDecode3(const uin32* in, uvec3* out, uin32 count);
+
+/**
+ * Quantises points to a 1024^3 grid spanning [minimum, maximum] and encodes them.
+ * Points outside the bounds are clamped to the nearest cell.
+ *
+ * \param points Pointer to an array of at least `count` fvec3 elements.
+ * \param keys Pointer to an array of at least `count` uin32 elements.
+ * \param count Number of points.
+ * \param minimum Lower corner of the grid.
+ * \param maximum Upper corner of the grid.
+ */
+void MortonKeys(const fvec3* points, uin32* keys, uin32 count, const fvec3& minimum, const fvec3& maximum);
+
+/**
+ * Sorts `keys` ascending with a stable LSD radix sort (8 bits per pass) and permutes `values` alongside.
+ *
+ * Large inputs are split across GetThreadCount() threads: each pass builds one histogram per thread,
+ * and every thread then scatters its own range to precomputed offsets. Passes whose digit is
+ * the same for every key are skipped.
+ *
+ * \param keys Pointer to an array of at least `count` uin32 keys.
+ * \param values Pointer to an array of at least `count` uin32 payloads, typically indices.
+ * \param count Number of elements.
+ */
+void RadixSort(uin32* keys, uin32* values, uin32 count);
+
+/**
+ * Reorders an array by a permutation: values[i] = old values[indices[i]].
+ */
+void Reorder(fvec3* values, const uin32* indices, uin32 count);
+
+/**
+ * Sorts points along a Z-order curve for cache locality.
+ *
+ * Encodes the points with MortonKeys, radix sorts them and reorders `points` in place.
+ * Companion arrays (velocities, colours...) can follow with Reorder and `indices`.
+ *
+ * \param points Pointer to an array of at least `count` fvec3 elements.
+ * \param count Number of points.
+ * \param minimum Lower corner of the bounds of the points.
+ * \param maximum Upper corner of the bounds of the points.
+ * \param indices Optional pointer to an array of at least `count` uin32 elements that receives the permutation.
+ */
+void MortonSort(fvec3* points, uin32 count, const fvec3& minimum, const fvec3& maximum, uin32* indices = nullptr);
+
+#ifdef ENMA_IMPLEMENTATION
+// Below this many elements per thread the radix sort stays on the calling thread
+constexpr uin32 RadixGrain = 1u << 15;
+
+// Magic-bits spreading and compaction, used when BMI2 is unavailable and for the 8-wide batches
+inline uin32 Part1By1(uin32 x)
+{
+	x &= 0x0000FFFFu;
+	x = (x | (x << 8)) & 0x00FF00FFu;
+	x = (x | (x << 4)) & 0x0F0F0F0Fu;
+	x = (x | (x << 2)) & 0x33333333u;
+	x = (x | (x << 1)) & 0x55555555u;
+
+	return x;
+}
+
+inline uin32 Part1By2(uin32 x)
+{
+	x &= 0x000003FFu;
+	x = (x | (x << 16)) & 0xFF0000FFu;
+	x = (x | (x << 8)) & 0x0300F00Fu;
+	x = (x | (x << 4)) & 0x030C30C3u;
+	x = (x | (x << 2)) & 0x09249249u;
+
+	return x;
+}
+
+inline uin32 Compact1By1(uin32 x)
+{
+	x &= 0x55555555u;
+	x = (x | (x >> 1)) & 0x33333333u;
+	x = (x | (x >> 2)) & 0x0F0F0F0Fu;
+	x = (x | (x >> 4)) & 0x00FF00FFu;
+	x = (x | (x >> 8)) & 0x0000FFFFu;
+
+	return x;
+}
+
+inline uin32 Compact1By2(uin32 x)
+{
+	x &= 0x09249249u;
+	x = (x | (x >> 2)) & 0x030C30C3u;
+	x = (x | (x >> 4)) & 0x0300F00Fu;
+	x = (x | (x >> 8)) & 0xFF0000FFu;
+	x = (x | (x >> 16)) & 0x000003FFu;
+
+	return x;
+}
+
+inline simd::int8 SpreadBits(const simd::int8& x, int32 shift, uin32 mask)
+{
+	return simd::And(simd::Or(x, simd::ShiftLeft(x, shift)), simd::int8::Set1(static_cast<int32>(mask)));
+}
+
+inline simd::int8 GatherBits(const simd::int8& x, int32 shift, uin32 mask)
+{
+	return simd::And(simd::Or(x, simd::ShiftRightLogical(x, shift)), simd::int8::Set1(static_cast<int32>(mask)));
+}
+
+inline simd::int8 Part1By1(const simd::int8& x)
+{
+	simd::int8 r = simd::And(x, simd::int8::Set1(0x0000FFFF));
+	r = SpreadBits(r, 8, 0x00FF00FFu);
+	r = SpreadBits(r, 4, 0x0F0F0F0Fu);
+	r = SpreadBits(r, 2, 0x33333333u);
+
+	return SpreadBits(r, 1, 0x55555555u);
+}
+
+inline simd::int8 Part1By2(const simd::int8& x)
+{
+	simd::int8 r = simd::And(x, simd::int8::Set1(0x000003FF));
+	r = SpreadBits(r, 16, 0xFF0000FFu);
+	r = SpreadBits(r, 8, 0x0300F00Fu);
+	r = SpreadBits(r, 4, 0x030C30C3u);
+
+	return SpreadBits(r, 2, 0x09249249u);
+}
+
+inline simd::int8 Compact1By1(const simd::int8& x)
+{
+	simd::int8 r = simd::And(x, simd::int8::Set1(0x55555555));
+	r = GatherBits(r, 1, 0x33333333u);
+	r = GatherBits(r, 2, 0x0F0F0F0Fu);
+	r = GatherBits(r, 4, 0x00FF00FFu);
+
+	return GatherBits(r, 8, 0x0000FFFFu);
+}
+
+inline simd::int8 Compact1By2(const simd::int8& x)
+{
+	simd::int8 r = simd::And(x, simd::int8::Set1(0x09249249));
+	r = GatherBits(r, 2, 0x030C30C3u);
+	r = GatherBits(r, 4, 0x0300F00Fu);
+	r = GatherBits(r, 8, 0xFF0000FFu);
+
+	return GatherBits(r, 16, 0x000003FFu);
+}
+
+// Encodes 8 quantised points held in component arrays
+inline void MortonEncodeBlock(const int32* xs, const int32* ys, const int32* zs, uin32* out)
+{
+	const simd::int8 code = simd::Or(simd::Or(Part1By2(simd::int8::LoadU(xs)), simd::ShiftLeft<1>(Part1By2(simd::int8::LoadU(ys)))), simd::ShiftLeft<2>(Part1By2(simd::int8::LoadU(zs))));
+
+	code.StoreU(reinterpret_cast<int32*>(out));
+}
+
+ENMA_HOT_FN uin32 MortonEncode(const uvec2& v)
+{
+	#ifdef ENMA_BMI2
+	return _pdep_u32(v.x, 0x55555555u) | _pdep_u32(v.y, 0xAAAAAAAAu);
+	#else
+	return Part1By1(v.x) | (Part1By1(v.y) << 1);
+	#endif
+}
+
+ENMA_HOT_FN uin32 MortonEncode(const uvec3& v)
+{
+	#ifdef ENMA_BMI2
+	return _pdep_u32(v.x, 0x09249249u) | _pdep_u32(v.y, 0x12492492u) | _pdep_u32(v.z, 0x24924924u);
+	#else
+	return Part1By2(v.x) | (Part1By2(v.y) << 1) | (Part1By2(v.z) << 2);
+	#endif
+}
+
+ENMA_HOT_FN uvec2 MortonDecode2(uin32 code)
+{
+	#ifdef ENMA_BMI2
+	return uvec2(_pext_u32(code, 0x55555555u), _pext_u32(code, 0xAAAAAAAAu));
+	#else
+	return uvec2(Compact1By1(code), Compact1By1(code >> 1));
+	#endif
+}
+
+ENMA_HOT_FN uvec3 MortonDecode3(uin32 code)
+{
+	#ifdef ENMA_BMI2
+	return uvec3(_pext_u32(code, 0x09249249u), _pext_u32(code, 0x12492492u), _pext_u32(code, 0x24924924u));
+	#else
+	return uvec3(Compact1By2(code), Compact1By2(code >> 1), Compact1By2(code >> 2));
+	#endif
+}
+
+// With BMI2 a scalar pdep/pext per component beats transposing AoS input into registers
+ENMA_FN void MortonEncode(const uvec2* in, uin32* out, uin32 count)
+{
+	uin32 i = 0;
+
+	#ifndef ENMA_BMI2
+	for(; i + 8 <= count; i += 8)
+	{
+		int32 xs[8], ys[8];
+
+		for(uin32 k = 0; k < 8; k++)
+		{
+			xs[k] = static_cast<int32>(in[i + k].x);
+			ys[k] = static_cast<int32>(in[i + k].y);
+		}
+
+		const simd::int8 code = simd::Or(Part1By1(simd::int8::LoadU(xs)), simd::ShiftLeft<1>(Part1By1(simd::int8::LoadU(ys))));
+		code.StoreU(reinterpret_cast<int32*>(out + i));
+	}
+	#endif
+
+	for(; i < count; i++)
+	{
+		out[i] = MortonEncode(in[i]);
+	}
+}
+
+ENMA_FN void MortonEncode(const uvec3* in, uin32* out, uin32 count)
+{
+	uin32 i = 0;
+
+	#ifndef ENMA_BMI2
+	for(; i + 8 <= count; i += 8)
+	{
+		int32 xs[8], ys[8], zs[8];
+
+		for(uin32 k = 0; k < 8; k++)
+		{
+			xs[k] = static_cast<int32>(in[i + k].x);
+			ys[k] = static_cast<int32>(in[i + k].y);
+			zs[k] = static_cast<int32>(in[i + k].z);
+		}
+
+		MortonEncodeBlock(xs, ys, zs, out + i);
+	}
+	#endif
+
+	for(; i < count; i++)
+	{
+		out[i] = MortonEncode(in[i]);
+	}
+}
+
+ENMA_FN void MortonDecode2(const uin32* in, uvec2* out, uin32 count)
+{
+	uin32 i = 0;
+
+	#ifndef ENMA_BMI2
+	for(; i + 8 <= count; i += 8)
+	{
+		const simd::int8 code = simd::int8::LoadU(reinterpret_cast<const int32*>(in + i));
+
+		int32 xs[8], ys[8];
+		Compact1By1(code).StoreU(xs);
+		Compact1By1(simd::ShiftRightLogical<1>(code)).StoreU(ys);
+
+		for(uin32 k = 0; k < 8; k++)
+		{
+			out[i + k] = uvec2(static_cast<uin32>(xs[k]), static_cast<uin32>(ys[k]));
+		}
+	}
+	#endif
+
+	for(; i < count; i++)
+	{
+		out[i] = MortonDecode2(in[i]);
+	}
+}
+
+ENMA_FN void MortonDecode3(const uin32* in, uvec3* out, uin32 count)
+{
+	uin32 i = 0;
+
+	#ifndef ENMA_BMI2
+	for(; i + 8 <= count; i += 8)
+	{
+		const simd::int8 code = simd::int8::LoadU(reinterpret_cast<const int32*>(in + i));
+
+		int32 xs[8], ys[8], zs[8];
+		Compact1By2(code).StoreU(xs);
+		Compact1By2(simd::ShiftRightLogical<1>(code)).StoreU(ys);
+		Compact1By2(simd::ShiftRightLogical<2>(code)).StoreU(zs);
+
+		for(uin32 k = 0; k < 8; k++)
+		{
+			out[i + k] = uvec3(static_cast<uin32>(xs[k]), static_cast<uin32>(ys[k]), static_cast<uin32>(zs[k]));
+		}
+	}
+	#endif
+
+	for(; i < count; i++)
+	{
+		out[i] = MortonDecode3(in[i]);
+	}
+}
+
+ENMA_FN void MortonKeys(const fvec3* points, uin32* keys, uin32 count, const fvec3& minimum, const fvec3& maximum)
+{
+	using namespace simd;
+
+	// Cells are 1024 wide, a degenerate axis maps every point to cell 0
+	const float4 lo = LoadXYZ(minimum);
+	const float4 extent = LoadXYZ(maximum) - lo;
+	const float4 scale = Select(CmpGt(extent, float4::Zero()), float4::Set1(1024.0f) / Max(extent, float4::Set1(1e-30f)), float4::Zero());
+	const float4 top = float4::Set1(1023.0f);
+
+	uin32 i = 0;
+	for(; i < count; i += 8)
+	{
+		const uin32 n = std::min(8u, count - i);
+
+		int32 xs[8] = {}, ys[8] = {}, zs[8] = {};
+		for(uin32 k = 0; k < n; k++)
+		{
+			int32 q[4];
+			ToIntTrunc(Min(Max((LoadXYZ(points[i + k]) - lo) * scale, float4::Zero()), top)).StoreU(q);
+
+			xs[k] = q[0];
+			ys[k] = q[1];
+			zs[k] = q[2];
+		}
+
+		if(n == 8)
+		{
+			MortonEncodeBlock(xs, ys, zs, keys + i);
+		}
+		else
+		{
+			uin32 block[8];
+			MortonEncodeBlock(xs, ys, zs, block);
+			std::copy(block, block + n, keys + i);
+		}
+	}
+}
+
+ENMA_FN void RadixSort(uin32* keys, uin32* values, uin32 count)
+{
+	const uin32 tasks = TaskCount(count, RadixGrain);
+
+	std::vector<uin32> tmpKeys(count), tmpValues(count);
+	std::vector<uin32> offsets(tasks * 256);
+
+	uin32* srcKeys = keys;
+	uin32* srcValues = values;
+	uin32* dstKeys = tmpKeys.data();
+	uin32* dstValues = tmpValues.data();
+
+	for(uin32 shift = 0; shift < 32; shift += 8)
+	{
+		std::fill(offsets.begin(), offsets.end(), 0u);
+
+		ParallelFor(tasks, [&](uin32 t)
+		{
+			uin32* histogram = offsets.data() + t * 256;
+
+			for(uin32 i = TaskBegin(t, tasks, count); i < TaskBegin(t + 1, tasks, count); i++)
+			{
+				histogram[(srcKeys[i] >> shift) & 0xFFu]++;
+			}
+		});
+
+		// Exclusive prefix sum, digit-major then task order, keeps the scatter stable
+		uin32 sum = 0;
+		bln8 uniform = false;
+
+		for(uin32 d = 0; d < 256; d++)
+		{
+			uin32 digitCount = 0;
+
+			for(uin32 t = 0; t < tasks; t++)
+			{
+				const uin32 c = offsets[t * 256 + d];
+				offsets[t * 256 + d] = sum;
+
+				sum += c;
+				digitCount += c;
+			}
+
+			uniform |= digitCount == count;
+		}
+
+		if(uniform)
+		{
+			continue;
+		}
+
+		ParallelFor(tasks, [&](uin32 t)
+		{
+			uin32* offset = offsets.data() + t * 256;
+
+			for(uin32 i = TaskBegin(t, tasks, count); i < TaskBegin(t + 1, tasks, count); i++)
+			{
+				const uin32 dst = offset[(srcKeys[i] >> shift) & 0xFFu]++;
+
+				dstKeys[dst] = srcKeys[i];
+				dstValues[dst] = srcValues[i];
+			}
+		});
+
+		std::swap(srcKeys, dstKeys);
+		std::swap(srcValues, dstValues);
+	}
+
+	if(srcKeys != keys)
+	{
+		std::copy(srcKeys, srcKeys + count, keys);
+		std::copy(srcValues, srcValues + count, values);
+	}
+}
+
+ENMA_FN void Reorder(fvec3* values, const uin32* indices, uin32 count)
+{
+	std::vector<fvec3> sorted(count);
+	const uin32 tasks = TaskCount(count, RadixGrain);
+
+	ParallelFor(tasks, [&](uin32 t)
+	{
+		for(uin32 i = TaskBegin(t, tasks, count); i < TaskBegin(t + 1, tasks, count); i++)
+		{
+			sorted[i] = values[indices[i]];
+		}
+	});
+
+	std::copy(sorted.begin(), sorted.end(), values);
+}
+
+ENMA_FN void MortonSort(fvec3* points, uin32 count, const fvec3& minimum, const fvec3& maximum, uin32* indices)
+{
+	std::vector<uin32> keys(count), order;
+
+	if(indices == nullptr)
+	{
+		order.resize(count);
+		indices = order.data();
+	}
+
+	for(uin32 i = 0; i < count; i++)
+	{
+		indices[i] = i;
+	}
+
+	MortonKeys(points, keys.data(), count, minimum, maximum);
+	RadixSort(keys.data(), indices, count);
+	Reorder(points, indices, count);
+}
+#endif // ENMA_IMPLEMENTATION
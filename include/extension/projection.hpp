@@ -11,7 +11,7 @@ mat4 Orthographic(flt32 width, flt32 height, flt32 zNear, flt32 zFar);
 mat4 Orthographic(flt32 left, flt32 right, flt32 bottom, flt32 top, flt32 cNear, flt32 cFar);
 
 #ifdef ENMA_IMPLEMENTATION
-mat4 LookAt(vec3 eye, vec3 target)
+ENMA_FN mat4 LookAt(vec3 eye, vec3 target)
 {
     vec3 eyeAt = target - eye;
     vec3 zaxis = Normalise(eyeAt);
@@ -39,7 +39,7 @@ mat4 LookAt(vec3 eye, vec3 target)
     return mat4(1.0f);
 }*/
 
-mat4 Frustum(flt32 left, flt32 right, flt32 bottom, flt32 top, flt32 zNear, flt32 zFar)
+ENMA_HOT_FN mat4 Frustum(flt32 left, flt32 right, flt32 bottom, flt32 top, flt32 zNear, flt32 zFar)
 {
     return
     {
@@ -50,9 +50,12 @@ mat4 Frustum(flt32 left, flt32 right, flt32 bottom, flt32 top, flt32 zNear, flt3
     };
 }
 
-mat4 Perspective(flt32 fovy, flt32 aspect, flt32 cNear, flt32 cFar)
+ENMA_FN mat4 Perspective(flt32 fovy, flt32 aspect, flt32 cNear, flt32 cFar)
 {
-    const flt32 focal = 1.0f / std::tan(fovy * 0.5f);
+    flt32 sHalf, cHalf;
+    SinCos(fovy * 0.5f, sHalf, cHalf);
+
+    const flt32 focal = cHalf / sHalf;
     const flt32 nearby = cFar / (cFar - cNear);
 
     return 
@@ -64,7 +67,7 @@ mat4 Perspective(flt32 fovy, flt32 aspect, flt32 cNear, flt32 cFar)
     };
 }
 
-mat4 Orthographic(flt32 width, flt32 height, flt32 cNear, flt32 cFar)
+ENMA_FN mat4 Orthographic(flt32 width, flt32 height, flt32 cNear, flt32 cFar)
 {
     //const flt32 nearby = zNear / (zNear - zFar);
     //const flt32 nearby = (1.0f - zNear) / (zFar - zNear);
@@ -82,7 +85,7 @@ mat4 Orthographic(flt32 width, flt32 height, flt32 cNear, flt32 cFar)
     };
 }
 
-mat4 Orthographic(flt32 left, flt32 right, flt32 bottom, flt32 top, flt32 cNear, flt32 cFar) 
+ENMA_FN mat4 Orthographic(flt32 left, flt32 right, flt32 bottom, flt32 top, flt32 cNear, flt32 cFar) 
 {
     return 
     {
@@ -0,0 +1,51 @@
+/* Rays
+ *
+ * This header file is part of Enmatica library
+ *
+ * Copyright (c) 202X by Villainous Softworks
+ *
+ */
+
+#pragma once
+#include "../enma.hpp"
+
+/**
+ * A half-line origin + t * direction, t >= 0.
+ *
+ * The reciprocal of the direction is computed once here because every slab test needs it.
+ */
+struct ray3
+{
+	fvec3 origin;
+	fvec3 direction;
+	fvec3 invDirection;		// 1 / direction per component, +-inf on axis-parallel directions
+
+	ray3() = default;
+	/**
+	 * Constructor with an origin and a direction.
+	 *
+	 * \param origin Origin of the ray.
+	 * \param direction Direction of the ray. Need not be normalised; distances are then in units of its length.
+	 */
+	ray3(const fvec3& origin, const fvec3& direction);
+
+	/**
+	 * Point at distance `t` along the ray.
+	 *
+	 * \param t Distance along the ray.
+	 * \return origin + t * direction.
+	 */
+	fvec3 At(flt32 t) const;
+};
+
+#ifdef ENMA_IMPLEMENTATION
+ENMA_HOT_FN ray3::ray3(const fvec3& origin, const fvec3& direction) :
+	origin(origin), direction(direction), invDirection(simd::float4::Set1(1.0f) / LoadXYZ(direction))
+{
+}
+
+ENMA_HOT_FN fvec3 ray3::At(flt32 t) const
+{
+	return origin + direction * t;
+}
+#endif // ENMA_IMPLEMENTATION
@@ -0,0 +1,430 @@
+/* Ray Packets and Streams
+ *
+ * This header file is part of Enmatica library
+ *
+ * Copyright (c) 202X by Villainous Softworks
+ *
+ */
+
+#pragma once
+#include "../enma.hpp"
+#include "../core/parallel.hpp"
+#include "bvh.hpp"
+
+/**
+ * Closest-hit traversal of eight rays together.
+ *
+ * Every node is tested against all active rays at once, one child box per 8-wide slab test, and a
+ * child is entered with the mask of the rays that hit its box. Rays that drop out of a subtree stop
+ * costing anything below it; leaves fall back to the per-ray triangle8 kernel. Best on coherent
+ * rays such as primary rays from one camera tile.
+ *
+ * \param bvh The hierarchy.
+ * \param rays Pointer to an array of 8 rays.
+ * \param hits Pointer to an array of 8 rayhit, each updated with the nearest triangle hit in (tMin, hit.t).
+ * \param active Bit i set when ray i takes part. Inactive rays and hits are not read.
+ * \param tMin Start of the tested interval along the rays.
+ * \return Bit i set when hit i was updated.
+ */
+uin32 IntersectPacket(const bvh8& bvh, const ray3* rays, rayhit* hits, uin32 active = 0xFF, flt32 tMin = 0.0f);
+/**
+ * Any-hit traversal of eight rays together, for shadow rays. A ray leaves the packet once it is occluded.
+ *
+ * \param bvh The hierarchy.
+ * \param rays Pointer to an array of 8 rays.
+ * \param tMax Pointer to an array of 8 interval ends, usually the distance to the light.
+ * \param active Bit i set when ray i takes part.
+ * \param tMin Start of the tested interval along the rays.
+ * \return Bit i set when ray i hits a triangle in (tMin, tMax[i]).
+ */
+uin32 IntersectAnyPacket(const bvh8& bvh, const ray3* rays, const flt32* tMax, uin32 active = 0xFF, flt32 tMin = 0.0f);
+
+/**
+ * Closest-hit traversal of a ray stream.
+ *
+ * The rays are bucketed by direction octant, keeping their order inside a bucket, and traced in
+ * packets of eight across threads, so rays sharing a packet tend to visit the same nodes in the same order.
+ *
+ * \param bvh The hierarchy.
+ * \param rays Pointer to an array of `count` rays.
+ * \param hits Pointer to an array of `count` rayhit, updated as by Intersect.
+ * \param count Number of rays.
+ */
+void IntersectStream(const bvh8& bvh, const ray3* rays, rayhit* hits, uin32 count);
+/**
+ * Any-hit traversal of a ray stream, bucketed and traced like IntersectStream.
+ *
+ * \param bvh The hierarchy.
+ * \param rays Pointer to an array of `count` rays.
+ * \param tMax Pointer to an array of `count` interval ends.
+ * \param occluded Pointer to an array of `count` flags, set when the ray hits a triangle in (0, tMax[i]).
+ * \param count Number of rays.
+ * \return Number of occluded rays.
+ */
+uin32 IntersectAnyStream(const bvh8& bvh, const ray3* rays, const flt32* tMax, bln8* occluded, uin32 count);
+
+/**
+ * Index of the direction octant of a ray, one bit per negative component.
+ */
+inline uin32 RayOctant(const ray3& r)
+{
+	return (r.direction.x < 0.0f) | ((r.direction.y < 0.0f) << 1) | ((r.direction.z < 0.0f) << 2);
+}
+
+/**
+ * Counting sort of ray indices by direction octant, stable inside an octant.
+ */
+inline std::vector<uin32> OctantOrder(const ray3* rays, uin32 count)
+{
+	uin32 offsets[9] = {};
+
+	for(uin32 i = 0; i < count; i++)
+	{
+		offsets[RayOctant(rays[i]) + 1]++;
+	}
+
+	for(uin32 octant = 1; octant < 9; octant++)
+	{
+		offsets[octant] += offsets[octant - 1];
+	}
+
+	std::vector<uin32> order(count);
+
+	for(uin32 i = 0; i < count; i++)
+	{
+		order[offsets[RayOctant(rays[i])]++] = i;
+	}
+
+	return order;
+}
+
+#ifdef ENMA_IMPLEMENTATION
+/**
+ * The eight rays of a packet in component arrays, with the end of every ray's interval.
+ */
+struct alignas(32) ray3x8
+{
+	simd::float8 x, y, z;
+	simd::float8 inX, inY, inZ;
+	simd::float8 negX, negY, negZ;		// Lanes with a negative direction component
+	alignas(32) flt32 tFar[8];			// -inf for inactive rays, so their slab tests always fail
+
+	ray3x8(const ray3* rays, uin32 active)
+	{
+		using simd::float8;
+
+		const uin32 first = simd::PopCount((active & (0u - active)) - 1u);
+
+		alignas(32) flt32 components[6][8];
+
+		// Inactive lanes repeat the first active ray, so no lane reads a ray the caller did not set
+		for(uin32 lane = 0; lane < 8; lane++)
+		{
+			const ray3& r = rays[(active >> lane) & 1u ? lane : first];
+
+			components[0][lane] = r.origin.x;
+			components[1][lane] = r.origin.y;
+			components[2][lane] = r.origin.z;
+			components[3][lane] = r.invDirection.x;
+			components[4][lane] = r.invDirection.y;
+			components[5][lane] = r.invDirection.z;
+			tFar[lane] = -std::numeric_limits<flt32>::infinity();
+		}
+
+		x = float8::Load(components[0]);
+		y = float8::Load(components[1]);
+		z = float8::Load(components[2]);
+		inX = float8::Load(components[3]);
+		inY = float8::Load(components[4]);
+		inZ = float8::Load(components[5]);
+
+		negX = simd::CmpLt(inX, float8::Zero());
+		negY = simd::CmpLt(inY, float8::Zero());
+		negZ = simd::CmpLt(inZ, float8::Zero());
+	}
+
+	/**
+	 * Slab test of all eight rays against child `c` of `node`.
+	 *
+	 * \return Lane mask of the rays entering the box within [tMin, tFar[i]]; `tEntry` receives the entry distances.
+	 */
+	simd::float8 Intersect(const bvh8_node& node, uin32 c, const simd::float8& tMin, simd::float8& tEntry) const
+	{
+		using simd::float8;
+
+		const aabb3x8& b = node.bounds;
+
+		// Rays of either sign share a packet, so the near plane is picked per lane; the operand order
+		// matches the single-ray test so that NaN from a ray lying in a slab plane is ignored the same way
+		const float8 loX = float8::Set1(b.minX[c]), hiX = float8::Set1(b.maxX[c]);
+		const float8 loY = float8::Set1(b.minY[c]), hiY = float8::Set1(b.maxY[c]);
+		const float8 loZ = float8::Set1(b.minZ[c]), hiZ = float8::Set1(b.maxZ[c]);
+
+		const float8 nearX = (simd::Select(negX, hiX, loX) - x) * inX, farX = (simd::Select(negX, loX, hiX) - x) * inX;
+		const float8 nearY = (simd::Select(negY, hiY, loY) - y) * inY, farY = (simd::Select(negY, loY, hiY) - y) * inY;
+		const float8 nearZ = (simd::Select(negZ, hiZ, loZ) - z) * inZ, farZ = (simd::Select(negZ, loZ, hiZ) - z) * inZ;
+
+		tEntry = simd::Max(simd::Max(nearX, nearY), simd::Max(nearZ, tMin));
+		const float8 tExit = simd::Min(simd::Min(farX, farY), simd::Min(farZ, float8::Load(tFar)));
+
+		return simd::CmpLe(tEntry, tExit);
+	}
+};
+
+ENMA_FN uin32 IntersectPacket(const bvh8& bvh, const ray3* rays, rayhit* hits, uin32 active, flt32 tMin)
+{
+	using simd::float8;
+
+	struct Entry
+	{
+		uin32 child;
+		uin32 rays;
+		flt32 t;				// Nearest entry distance of the rays
+	};
+
+	active &= 0xFFu;
+
+	if(bvh.root == bvh8::Empty || active == 0)
+	{
+		return 0;
+	}
+
+	ray3x8 packet(rays, active);
+
+	for(uin32 mask = active; mask; mask &= mask - 1)
+	{
+		const uin32 lane = simd::PopCount((mask & (0u - mask)) - 1u);
+		packet.tFar[lane] = hits[lane].t;
+	}
+
+	const float8 tStart = float8::Set1(tMin);
+	const float8 infinity = float8::Set1(std::numeric_limits<flt32>::infinity());
+
+	Entry stack[bvh8::StackSize];
+	uin32 top = 0;
+	uin32 found = 0;
+
+	stack[top++] = { bvh.root, active, tMin };
+
+	while(top)
+	{
+		Entry entry = stack[--top];
+
+		// Rays that found a hit nearer than the whole node no longer need it
+		entry.rays &= static_cast<uin32>(simd::MoveMask(simd::CmpGe(float8::Load(packet.tFar), float8::Set1(entry.t))));
+
+		if(entry.rays == 0)
+		{
+			continue;
+		}
+
+		if(entry.child & bvh8::LeafFlag)
+		{
+			const triangle8& leaf = bvh.leaves[entry.child & ~bvh8::LeafFlag];
+
+			for(uin32 mask = entry.rays; mask; mask &= mask - 1)
+			{
+				const uin32 lane = simd::PopCount((mask & (0u - mask)) - 1u);
+
+				if(Intersect(rays[lane], leaf, hits[lane], tMin))
+				{
+					found |= 1u << lane;
+					packet.tFar[lane] = hits[lane].t;
+				}
+			}
+
+			continue;
+		}
+
+		const bvh8_node& node = bvh.nodes[entry.child];
+		const uin32 first = top;
+
+		for(uin32 c = 0; c < 8 && node.children[c] != bvh8::Empty; c++)
+		{
+			float8 tEntry;
+			const float8 enter = packet.Intersect(node, c, tStart, tEntry);
+			const uin32 mask = static_cast<uin32>(simd::MoveMask(enter)) & entry.rays;
+
+			if(mask == 0)
+			{
+				continue;
+			}
+
+			// Over every entering ray, a superset of `mask`, so the distance stays a safe lower bound
+			const Entry child = { node.children[c], mask, simd::ReduceMin(simd::Select(enter, tEntry, infinity)) };
+
+			// Sorted far to near, so the nearest child is popped first
+			uin32 slot = top++;
+			for(; slot > first && stack[slot - 1].t < child.t; slot--)
+			{
+				stack[slot] = stack[slot - 1];
+			}
+
+			stack[slot] = child;
+		}
+	}
+
+	return found;
+}
+
+ENMA_FN uin32 IntersectAnyPacket(const bvh8& bvh, const ray3* rays, const flt32* tMax, uin32 active, flt32 tMin)
+{
+	using simd::float8;
+
+	struct Entry
+	{
+		uin32 child;
+		uin32 rays;
+	};
+
+	active &= 0xFFu;
+
+	if(bvh.root == bvh8::Empty || active == 0)
+	{
+		return 0;
+	}
+
+	ray3x8 packet(rays, active);
+
+	for(uin32 mask = active; mask; mask &= mask - 1)
+	{
+		const uin32 lane = simd::PopCount((mask & (0u - mask)) - 1u);
+		packet.tFar[lane] = tMax[lane];
+	}
+
+	const float8 tStart = float8::Set1(tMin);
+
+	Entry stack[bvh8::StackSize];
+	uin32 top = 0;
+	uin32 occluded = 0;
+
+	stack[top++] = { bvh.root, active };
+
+	while(top && occluded != active)
+	{
+		Entry entry = stack[--top];
+		entry.rays &= ~occluded;
+
+		if(entry.rays == 0)
+		{
+			continue;
+		}
+
+		if(entry.child & bvh8::LeafFlag)
+		{
+			const triangle8& leaf = bvh.leaves[entry.child & ~bvh8::LeafFlag];
+
+			for(uin32 mask = entry.rays; mask; mask &= mask - 1)
+			{
+				const uin32 lane = simd::PopCount((mask & (0u - mask)) - 1u);
+
+				rayhit hit(tMax[lane]);
+				if(Intersect(rays[lane], leaf, hit, tMin))
+				{
+					occluded |= 1u << lane;
+					packet.tFar[lane] = -std::numeric_limits<flt32>::infinity();
+				}
+			}
+
+			continue;
+		}
+
+		const bvh8_node& node = bvh.nodes[entry.child];
+
+		for(uin32 c = 0; c < 8 && node.children[c] != bvh8::Empty; c++)
+		{
+			float8 tEntry;
+			const uin32 mask = static_cast<uin32>(simd::MoveMask(packet.Intersect(node, c, tStart, tEntry))) & entry.rays;
+
+			if(mask)
+			{
+				stack[top++] = { node.children[c], mask };
+			}
+		}
+	}
+
+	return occluded;
+}
+
+ENMA_FN void IntersectStream(const bvh8& bvh, const ray3* rays, rayhit* hits, uin32 count)
+{
+	constexpr uin32 StreamGrain = 1u << 10;		// Packets per thread worth spawning it
+
+	const std::vector<uin32> order = OctantOrder(rays, count);
+
+	const uin32 packets = (count + 7) / 8;
+	const uin32 tasks = TaskCount(packets, StreamGrain);
+
+	ParallelFor(tasks, [&](uin32 task)
+	{
+		for(uin32 p = TaskBegin(task, tasks, packets), end = TaskBegin(task + 1, tasks, packets); p < end; p++)
+		{
+			const uin32 first = p * 8;
+			const uin32 lanes = std::min(8u, count - first);
+
+			ray3 packetRays[8];
+			rayhit packetHits[8];
+
+			for(uin32 lane = 0; lane < lanes; lane++)
+			{
+				packetRays[lane] = rays[order[first + lane]];
+				packetHits[lane] = hits[order[first + lane]];
+			}
+
+			IntersectPacket(bvh, packetRays, packetHits, (1u << lanes) - 1u);
+
+			for(uin32 lane = 0; lane < lanes; lane++)
+			{
+				hits[order[first + lane]] = packetHits[lane];
+			}
+		}
+	});
+}
+
+ENMA_FN uin32 IntersectAnyStream(const bvh8& bvh, const ray3* rays, const flt32* tMax, bln8* occluded, uin32 count)
+{
+	constexpr uin32 StreamGrain = 1u << 10;
+
+	const std::vector<uin32> order = OctantOrder(rays, count);
+
+	const uin32 packets = (count + 7) / 8;
+	const uin32 tasks = TaskCount(packets, StreamGrain);
+
+	std::vector<uin32> occludedCount(tasks, 0);
+
+	ParallelFor(tasks, [&](uin32 task)
+	{
+		for(uin32 p = TaskBegin(task, tasks, packets), end = TaskBegin(task + 1, tasks, packets); p < end; p++)
+		{
+			const uin32 first = p * 8;
+			const uin32 lanes = std::min(8u, count - first);
+
+			ray3 packetRays[8];
+			flt32 packetMax[8];
+
+			for(uin32 lane = 0; lane < lanes; lane++)
+			{
+				packetRays[lane] = rays[order[first + lane]];
+				packetMax[lane] = tMax[order[first + lane]];
+			}
+
+			const uin32 mask = IntersectAnyPacket(bvh, packetRays, packetMax, (1u << lanes) - 1u);
+
+			for(uin32 lane = 0; lane < lanes; lane++)
+			{
+				occluded[order[first + lane]] = (mask >> lane) & 1u;
+			}
+
+			occludedCount[task] += simd::PopCount(mask);
+		}
+	});
+
+	uin32 total = 0;
+	for(const uin32 n : occludedCount)
+	{
+		total += n;
+	}
+
+	return total;
+}
+#endif // ENMA_IMPLEMENTATION
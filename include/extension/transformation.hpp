@@ -15,7 +15,7 @@ mat4 Scale(flt32 &scale);
 mat4 Scale(const vec3 &scale);
 
 #ifdef ENMA_IMPLEMENTATION
-mat4 Translate(const vec3 &position)
+ENMA_HOT_FN mat4 Translate(const vec3 &position)
 {
     return 
     {
@@ -26,7 +26,7 @@ mat4 Translate(const vec3 &position)
     };
 }
 
-mat4 Rotate(flt32 angle)
+ENMA_FN mat4 Rotate(flt32 angle)
 {
     #ifdef USE_DEG
     const flt32 angles = ToRadians(angle);
@@ -34,8 +34,8 @@ mat4 Rotate(flt32 angle)
     const flt32 angles = angle;
     #endif
 
-    const flt32 cA = cos(angles);
-    const flt32 sA = sin(angles);
+    flt32 sA, cA;
+    SinCos(angles, sA, cA);
     
     const flt32 cA2 = cA * cA;      // cosa2
     const flt32 sA2 = sA * sA;      // sina2
@@ -80,43 +80,52 @@ mat4 Rotate(flt32 angle)
     };
 }*/
 
-auto RotationMatrixX = [](flt32 rotationAngle) -> mat4 {
+ENMA_FN auto RotationMatrixX = [](flt32 rotationAngle) -> mat4 {
     #ifdef USE_DEG
     rotationAngle = ToRadians(rotationAngle);
     #endif
+    flt32 sA, cA;
+    SinCos(rotationAngle, sA, cA);
+
     return mat4{
         1, 0, 0, 0,
-        0, cos(rotationAngle), sin(rotationAngle), 0,
-        0, sin(rotationAngle), cos(rotationAngle), 0,
+        0, cA, sA, 0,
+        0, sA, cA, 0,
         0, 0, 0, 1
     };
 };
 
-auto RotationMatrixY = [](flt32 rotationAngle) -> mat4 {
+ENMA_FN auto RotationMatrixY = [](flt32 rotationAngle) -> mat4 {
     #ifdef USE_DEG
     rotationAngle = ToRadians(rotationAngle);
     #endif
+    flt32 sA, cA;
+    SinCos(rotationAngle, sA, cA);
+
     return mat4{
-        cos(rotationAngle), 0, -sin(rotationAngle), 0,
+        cA, 0, -sA, 0,
         0, 1, 0, 0,
-        sin(rotationAngle), 0, cos(rotationAngle), 0,
+        sA, 0, cA, 0,
         0, 0, 0, 1
     };
 };
 
-auto RotationMatrixZ = [](flt32 rotationAngle) -> mat4 {
+ENMA_FN auto RotationMatrixZ = [](flt32 rotationAngle) -> mat4 {
     #ifdef USE_DEG
     rotationAngle = ToRadians(rotationAngle);
     #endif
+    flt32 sA, cA;
+    SinCos(rotationAngle, sA, cA);
+
     return mat4{
-        cos(rotationAngle), -sin(rotationAngle), 0, 0,
-        sin(rotationAngle), cos(rotationAngle), 0, 0,
+        cA, -sA, 0, 0,
+        sA, cA, 0, 0,
         0, 0, 1, 0,
         0, 0, 0, 1
     };
 };
 
-mat4 Rotate(const vec3 &eulerAngles)
+ENMA_FN mat4 Rotate(const vec3 &eulerAngles)
 {
     #ifdef USE_DEG
     const vec3 angles = ToRadians(eulerAngles);
@@ -124,13 +133,17 @@ mat4 Rotate(const vec3 &eulerAngles)
     const vec3 angles = eulerAngles;
     #endif
 
-    const flt32 cX = cos(angles.x);   // Cosine of Pitch
-    const flt32 cY = cos(angles.y);   // Cosine of Yaw
-    const flt32 cZ = cos(angles.z);   // Cosine of Roll
+    // All three angles go through a single SinCos call
+    fvec4 sines, cosines;
+    SinCos(fvec4(angles, 0.0f), sines, cosines);
 
-    const flt32 sX = sin(angles.x);   // Sine of Pitch
-    const flt32 sY = sin(angles.y);   // Sine of Yaw
-    const flt32 sZ = sin(angles.z);   // Sine of Roll
+    const flt32 cX = cosines.x;   // Cosine of Pitch
+    const flt32 cY = cosines.y;   // Cosine of Yaw
+    const flt32 cZ = cosines.z;   // Cosine of Roll
+
+    const flt32 sX = sines.x;     // Sine of Pitch
+    const flt32 sY = sines.y;     // Sine of Yaw
+    const flt32 sZ = sines.z;     // Sine of Roll
 
     const flt32 sYZ = sY * sZ;
     const flt32 sYcZ = sY * cZ;
@@ -144,7 +157,7 @@ mat4 Rotate(const vec3 &eulerAngles)
     };
 }
 
-mat4 Rotate(flt32 angle, const vec3 &axis)
+ENMA_FN mat4 Rotate(flt32 angle, const vec3 &axis)
 {
     const vec3 axs = Normalise(axis);
 
@@ -154,8 +167,8 @@ mat4 Rotate(flt32 angle, const vec3 &axis)
     const flt32 ang = angle;
     #endif
 
-    const flt32 cosT = cos(ang);    // Cosine Theta
-    const flt32 sinT = sin(ang);    // Sine Theta
+    flt32 sinT, cosT;               // Sine and Cosine Theta
+    SinCos(ang, sinT, cosT);
     const flt32 omCt = 1.0f - cosT;     // One minus Cosine Theta
     const flt32 xSt = axs.x * sinT;
     const flt32 ySt = axs.y * sinT;
@@ -178,7 +191,7 @@ mat4 Rotate(flt32 angle, const vec3 &axis)
     };
 }
 
-mat4 Scale(flt32 &scale)
+ENMA_FN mat4 Scale(flt32 &scale)
 {
     if(scale < 0.0f)
     {
@@ -195,7 +208,7 @@ mat4 Scale(flt32 &scale)
     };
 }
 
-mat4 Scale(const vec3 &scale)
+ENMA_HOT_FN mat4 Scale(const vec3 &scale)
 {
     return
     {
@@ -0,0 +1,370 @@
+/* Ray-Triangle Intersection
+ *
+ * This header file is part of Enmatica library
+ *
+ * Copyright (c) 202X by Villainous Softworks
+ *
+ */
+
+#pragma once
+#include "../enma.hpp"
+#include "ray.hpp"
+#include <limits>
+
+/**
+ * Nearest hit found so far along a ray.
+ *
+ * `t` doubles as the end of the search interval: the intersectors only accept hits closer than it,
+ * so the same rayhit can be passed through any number of triangle packets.
+ */
+struct rayhit
+{
+	flt32 t;			// Distance along the ray
+	flt32 u, v;			// Barycentric weights of the second and third vertex
+	uin32 index;		// Index of the hit triangle, NoHit if nothing was hit
+
+	static constexpr uin32 NoHit = ~0u;
+
+	/**
+	 * Constructor with the end of the search interval.
+	 *
+	 * \param tMax Farthest distance a hit is accepted at.
+	 */
+	rayhit(flt32 tMax = std::numeric_limits<flt32>::infinity());
+
+	/**
+	 * True if a triangle was hit.
+	 */
+	bln8 Hit() const;
+};
+
+/**
+ * Eight triangles in component arrays, the leaf layout of the 8-wide intersectors.
+ *
+ * The vertices are stored rather than the edges so that the watertight test sees exactly the
+ * same coordinates for a vertex shared by neighbouring triangles. Unused lanes hold NaN and never hit.
+ */
+struct alignas(32) triangle8
+{
+	flt32 ax[8], ay[8], az[8];
+	flt32 bx[8], by[8], bz[8];
+	flt32 cx[8], cy[8], cz[8];
+	uin32 index[8];
+
+	/**
+	 * Constructor filling every lane with an unused triangle.
+	 */
+	triangle8();
+
+	/**
+	 * Writes a triangle into a lane.
+	 *
+	 * \param lane Lane index in [0, 8).
+	 * \param a First vertex.
+	 * \param b Second vertex.
+	 * \param c Third vertex.
+	 * \param index Triangle index reported by a hit.
+	 */
+	void Set(uin32 lane, const fvec3& a, const fvec3& b, const fvec3& c, uin32 index);
+};
+
+/**
+ * Möller-Trumbore test of a ray against a single triangle, both faces.
+ *
+ * \param r The ray.
+ * \param a First vertex.
+ * \param b Second vertex.
+ * \param c Third vertex.
+ * \param index Triangle index stored in `hit`.
+ * \param hit Updated when the triangle is hit in (tMin, hit.t).
+ * \param tMin Start of the tested interval along the ray.
+ * \return True if `hit` was updated.
+ */
+bln8 Intersect(const ray3& r, const fvec3& a, const fvec3& b, const fvec3& c, uin32 index, rayhit& hit, flt32 tMin = 0.0f);
+/**
+ * Möller-Trumbore test of a ray against eight triangles at once, both faces.
+ *
+ * Rays passing exactly through a shared edge may slip between both triangles; use
+ * IntersectWatertight where that matters.
+ *
+ * Runs on simd::float8 and is called once per leaf, so it is not dispatched at runtime: the test is
+ * one AVX2 register with fused multiply-adds only when compiled with `-mavx2 -mfma`. On the SSE4.1
+ * baseline it runs as two float4 halves with separate multiplies and adds.
+ *
+ * \param r The ray.
+ * \param triangles The eight triangles.
+ * \param hit Updated with the nearest triangle hit in (tMin, hit.t).
+ * \param tMin Start of the tested interval along the ray.
+ * \return True if `hit` was updated.
+ */
+bln8 Intersect(const ray3& r, const triangle8& triangles, rayhit& hit, flt32 tMin = 0.0f);
+/**
+ * Watertight test of a ray against eight triangles (Woop, Benthin, Wald 2013).
+ *
+ * The triangles are moved into a ray space sheared along the dominant ray axis, where the edge
+ * tests of neighbouring triangles are exact negations of each other: a ray never passes between
+ * two triangles sharing an edge. Edge tests too close to 0 to trust their sign are redone in double precision.
+ * Slower than Intersect, and built for the same instruction set.
+ *
+ * \param r The ray.
+ * \param triangles The eight triangles.
+ * \param hit Updated with the nearest triangle hit in (tMin, hit.t).
+ * \param tMin Start of the tested interval along the ray.
+ * \return True if `hit` was updated.
+ */
+bln8 IntersectWatertight(const ray3& r, const triangle8& triangles, rayhit& hit, flt32 tMin = 0.0f);
+
+/**
+ * Stores the nearest lane of `mask` in `hit`. Returns false for an empty mask.
+ */
+inline bln8 NearestHit(uin32 mask, const simd::float8& t, const simd::float8& u, const simd::float8& v, const triangle8& triangles, rayhit& hit)
+{
+	if(mask == 0)
+	{
+		return false;
+	}
+
+	alignas(32) flt32 ts[8], us[8], vs[8];
+	t.Store(ts);
+	u.Store(us);
+	v.Store(vs);
+
+	uin32 nearest = simd::PopCount((mask & (0u - mask)) - 1u);
+
+	for(mask &= mask - 1; mask; mask &= mask - 1)
+	{
+		const uin32 lane = simd::PopCount((mask & (0u - mask)) - 1u);
+
+		if(ts[lane] < ts[nearest])
+		{
+			nearest = lane;
+		}
+	}
+
+	hit.t = ts[nearest];
+	hit.u = us[nearest];
+	hit.v = vs[nearest];
+	hit.index = triangles.index[nearest];
+
+	return true;
+}
+
+#ifdef ENMA_IMPLEMENTATION
+ENMA_HOT_FN rayhit::rayhit(flt32 tMax) : t(tMax), u(0.0f), v(0.0f), index(NoHit) {}
+
+ENMA_HOT_FN bln8 rayhit::Hit() const
+{
+	return index != NoHit;
+}
+
+ENMA_FN triangle8::triangle8()
+{
+	for(flt32* component : { ax, ay, az, bx, by, bz, cx, cy, cz })
+	{
+		std::fill(component, component + 8, std::numeric_limits<flt32>::quiet_NaN());
+	}
+
+	std::fill(index, index + 8, rayhit::NoHit);
+}
+
+ENMA_HOT_FN void triangle8::Set(uin32 lane, const fvec3& a, const fvec3& b, const fvec3& c, uin32 index)
+{
+	ax[lane] = a.x;
+	ay[lane] = a.y;
+	az[lane] = a.z;
+	bx[lane] = b.x;
+	by[lane] = b.y;
+	bz[lane] = b.z;
+	cx[lane] = c.x;
+	cy[lane] = c.y;
+	cz[lane] = c.z;
+
+	this->index[lane] = index;
+}
+
+ENMA_FN bln8 Intersect(const ray3& r, const fvec3& a, const fvec3& b, const fvec3& c, uin32 index, rayhit& hit, flt32 tMin)
+{
+	const fvec3 e1 = b - a;
+	const fvec3 e2 = c - a;
+
+	const fvec3 p = Cross(r.direction, e2);
+	const flt32 det = Dot(e1, p);
+
+	// Also rejects NaN
+	if(!(std::abs(det) > 0.0f))
+	{
+		return false;
+	}
+
+	const flt32 inv = 1.0f / det;
+	const fvec3 s = r.origin - a;
+
+	const flt32 u = Dot(s, p) * inv;
+	if(u < 0.0f || u > 1.0f)
+	{
+		return false;
+	}
+
+	const fvec3 q = Cross(s, e1);
+
+	const flt32 v = Dot(r.direction, q) * inv;
+	if(v < 0.0f || u + v > 1.0f)
+	{
+		return false;
+	}
+
+	const flt32 t = Dot(e2, q) * inv;
+	if(!(t > tMin && t < hit.t))
+	{
+		return false;
+	}
+
+	hit.t = t;
+	hit.u = u;
+	hit.v = v;
+	hit.index = index;
+
+	return true;
+}
+
+ENMA_FN bln8 Intersect(const ray3& r, const triangle8& triangles, rayhit& hit, flt32 tMin)
+{
+	using namespace simd;
+
+	const float8 dx = float8::Set1(r.direction.x), dy = float8::Set1(r.direction.y), dz = float8::Set1(r.direction.z);
+
+	const float8 ax = float8::Load(triangles.ax), ay = float8::Load(triangles.ay), az = float8::Load(triangles.az);
+
+	const float8 e1x = float8::Load(triangles.bx) - ax, e1y = float8::Load(triangles.by) - ay, e1z = float8::Load(triangles.bz) - az;
+	const float8 e2x = float8::Load(triangles.cx) - ax, e2y = float8::Load(triangles.cy) - ay, e2z = float8::Load(triangles.cz) - az;
+
+	// p = direction x e2
+	const float8 px = Fmsub(dy, e2z, dz * e2y);
+	const float8 py = Fmsub(dz, e2x, dx * e2z);
+	const float8 pz = Fmsub(dx, e2y, dy * e2x);
+
+	const float8 det = Fmadd(e1x, px, Fmadd(e1y, py, e1z * pz));
+	const float8 inv = float8::Set1(1.0f) / det;
+
+	const float8 sx = float8::Set1(r.origin.x) - ax, sy = float8::Set1(r.origin.y) - ay, sz = float8::Set1(r.origin.z) - az;
+
+	// q = s x e1
+	const float8 qx = Fmsub(sy, e1z, sz * e1y);
+	const float8 qy = Fmsub(sz, e1x, sx * e1z);
+	const float8 qz = Fmsub(sx, e1y, sy * e1x);
+
+	const float8 u = Fmadd(sx, px, Fmadd(sy, py, sz * pz)) * inv;
+	const float8 v = Fmadd(dx, qx, Fmadd(dy, qy, dz * qz)) * inv;
+	const float8 t = Fmadd(e2x, qx, Fmadd(e2y, qy, e2z * qz)) * inv;
+
+	const float8 zero = float8::Zero();
+
+	// Ordered compares are false for NaN, so unused lanes drop out here
+	float8 accept = CmpGt(Abs(det), zero);
+	accept = And(accept, And(CmpGe(u, zero), CmpGe(v, zero)));
+	accept = And(accept, CmpLe(u + v, float8::Set1(1.0f)));
+	accept = And(accept, And(CmpGt(t, float8::Set1(tMin)), CmpLt(t, float8::Set1(hit.t))));
+
+	return NearestHit(static_cast<uin32>(MoveMask(accept)), t, u, v, triangles, hit);
+}
+
+ENMA_FN bln8 IntersectWatertight(const ray3& r, const triangle8& triangles, rayhit& hit, flt32 tMin)
+{
+	using namespace simd;
+
+	const flt32 d[3] = { r.direction.x, r.direction.y, r.direction.z };
+	const flt32 o[3] = { r.origin.x, r.origin.y, r.origin.z };
+
+	// kz is the dominant axis, kx and ky are swapped for a negative kz to keep the winding
+	const uin32 kz = std::abs(d[0]) > std::abs(d[1]) ? (std::abs(d[0]) > std::abs(d[2]) ? 0 : 2) : (std::abs(d[1]) > std::abs(d[2]) ? 1 : 2);
+	uin32 kx = (kz + 1) % 3;
+	uin32 ky = (kx + 1) % 3;
+
+	if(d[kz] < 0.0f)
+	{
+		std::swap(kx, ky);
+	}
+
+	const flt32 shear[3] = { d[kx] / d[kz], d[ky] / d[kz], 1.0f / d[kz] };
+
+	const flt32* vertices[3][3] =
+	{
+		{ triangles.ax, triangles.ay, triangles.az },
+		{ triangles.bx, triangles.by, triangles.bz },
+		{ triangles.cx, triangles.cy, triangles.cz }
+	};
+
+	// Every vertex relative to the origin, sheared so the ray runs along +z
+	float8 px[3], py[3], pz[3];
+
+	for(uin32 i = 0; i < 3; i++)
+	{
+		const float8 z = float8::Load(vertices[i][kz]) - float8::Set1(o[kz]);
+
+		px[i] = Fnmadd(float8::Set1(shear[0]), z, float8::Load(vertices[i][kx]) - float8::Set1(o[kx]));
+		py[i] = Fnmadd(float8::Set1(shear[1]), z, float8::Load(vertices[i][ky]) - float8::Set1(o[ky]));
+		pz[i] = z * float8::Set1(shear[2]);
+	}
+
+	// Edge functions. Neighbouring triangles compute the same products in swapped order, so their
+	// values are exact negations unless the compiler fuses a product into the subtraction; a lane
+	// whose sign is not certain under that rounding error is redone below in double, where the
+	// products are exact
+	const float8 U0 = px[2] * py[1], U1 = py[2] * px[1];
+	const float8 V0 = px[0] * py[2], V1 = py[0] * px[2];
+	const float8 W0 = px[1] * py[0], W1 = py[1] * px[0];
+
+	float8 U = U0 - U1;
+	float8 V = V0 - V1;
+	float8 W = W0 - W1;
+
+	const float8 zero = float8::Zero();
+	const float8 epsilon = float8::Set1(2.4e-7f);		// 2^-22, bounds the rounding of a * b - c * d fused or not
+
+	const float8 uncertainU = CmpLe(Abs(U), epsilon * (Abs(U0) + Abs(U1)));
+	const float8 uncertainV = CmpLe(Abs(V), epsilon * (Abs(V0) + Abs(V1)));
+	const float8 uncertainW = CmpLe(Abs(W), epsilon * (Abs(W0) + Abs(W1)));
+
+	const uin32 exact = static_cast<uin32>(MoveMask(Or(Or(uncertainU, uncertainV), uncertainW)));
+
+	if(exact)
+	{
+		alignas(32) flt32 us[8], vs[8], ws[8], x[3][8], y[3][8];
+		U.Store(us);
+		V.Store(vs);
+		W.Store(ws);
+
+		for(uin32 i = 0; i < 3; i++)
+		{
+			px[i].Store(x[i]);
+			py[i].Store(y[i]);
+		}
+
+		for(uin32 mask = exact; mask; mask &= mask - 1)
+		{
+			const uin32 lane = PopCount((mask & (0u - mask)) - 1u);
+
+			us[lane] = static_cast<flt32>(static_cast<flt64>(x[2][lane]) * y[1][lane] - static_cast<flt64>(y[2][lane]) * x[1][lane]);
+			vs[lane] = static_cast<flt32>(static_cast<flt64>(x[0][lane]) * y[2][lane] - static_cast<flt64>(y[0][lane]) * x[2][lane]);
+			ws[lane] = static_cast<flt32>(static_cast<flt64>(x[1][lane]) * y[0][lane] - static_cast<flt64>(y[1][lane]) * x[0][lane]);
+		}
+
+		U = float8::Load(us);
+		V = float8::Load(vs);
+		W = float8::Load(ws);
+	}
+
+	// All edge functions on the same side, either winding; ordered compares drop NaN lanes
+	const float8 inside = And(And(CmpGe(U, zero), CmpGe(V, zero)), CmpGe(W, zero));
+	const float8 outside = And(And(CmpLe(U, zero), CmpLe(V, zero)), CmpLe(W, zero));
+
+	const float8 det = U + V + W;
+	const float8 inv = float8::Set1(1.0f) / det;
+	const float8 t = Fmadd(U, pz[0], Fmadd(V, pz[1], W * pz[2])) * inv;
+
+	float8 accept = And(Or(inside, outside), CmpGt(Abs(det), zero));
+	accept = And(accept, And(CmpGt(t, float8::Set1(tMin)), CmpLt(t, float8::Set1(hit.t))));
+
+	return NearestHit(static_cast<uin32>(MoveMask(accept)), t, V * inv, W * inv, triangles, hit);
+}
+#endif // ENMA_IMPLEMENTATION
@@ -6,4 +6,12 @@
 #endif
 
 #include "extension/transformation.hpp"
-#include "extension/projection.hpp"
\ No newline at end of file
+#include "extension/projection.hpp"
+#include "extension/morton.hpp"
+#include "extension/ray.hpp"
+#include "extension/aabb.hpp"
+#include "extension/frustum.hpp"
+#include "extension/triangle.hpp"
+#include "extension/bvh.hpp"
+#include "extension/raypacket.hpp"
+#include "extension/hierarchy.hpp"
\ No newline at end of file
@@ -138,7 +138,7 @@ std::ostream& operator<<(std::ostream& os, const __m128 vec)
 }
 
 
-std::ostream& operator<<(std::ostream& os, const __m256 vec)
+std::ostream& operator<<(std::ostream& os, const __m256& vec)
 {
     os << "| X1: " << vec[0] << "\tY1: " << vec[1] << "\tZ1: " << vec[2] << "\tW1: " << vec[3] << " |"
     <<    "| X2: " << vec[4] << "\tY2: " << vec[5] << "\tZ2: " << vec[6] << "\tW2: " << vec[7] << " |";
@@ -0,0 +1,215 @@
+/* Sine & Cosine
+ *
+ * This header file is part of Enmatica library
+ *
+ * Copyright (c) 202X Villainous Softworks
+ *
+ */
+
+#pragma once
+#include "trignometry.hpp"
+#include "vector.hpp"
+#include "base.hpp"
+#include "empch.hpp"
+
+/**
+ * Precision of the SinCos polynomials.
+ *
+ *   Fast       -  Two-step range reduction with degree 5/4 polynomials; absolute error below 1.5e-5 for |x| < 8192
+ *   Accurate   -  Four-step Cody-Waite range reduction with degree 7/8 polynomials; within 1.5 ULP of the exact result
+ *                 for |x| < 64, multiples of PI/2 included, and absolute error below 1e-7 for |x| < 8192
+ *
+ * Past |x| = 8192 the products of the reduction are no longer exact and the error grows with |x|,
+ * to about 1e-6 at |x| = 1e5 without FMA.
+ */
+enum class SinCosPrecision
+{
+	Fast,
+	Accurate
+};
+
+/**
+ * Calculates the sine and cosine of an angle at once.
+ *
+ * \param angle The angle in radians.
+ * \param s Receives the sine of `angle`.
+ * \param c Receives the cosine of `angle`.
+ * \param precision The polynomial precision to use.
+ */
+void SinCos(flt32 angle, flt32& s, flt32& c, SinCosPrecision precision = SinCosPrecision::Accurate);
+/**
+ * Calculates the sine and cosine of four angles at once.
+ *
+ * \param angles The angles in radians.
+ * \param s Receives the sines of `angles`.
+ * \param c Receives the cosines of `angles`.
+ * \param precision The polynomial precision to use.
+ */
+void SinCos(const fvec4& angles, fvec4& s, fvec4& c, SinCosPrecision precision = SinCosPrecision::Accurate);
+
+#ifdef USE_SIMD
+/**
+ * Calculates the sine and cosine of eight angles at once. Requires an AVX2 and FMA capable host, see GetSimdLevel.
+ *
+ * \param angles The angles in radians.
+ * \param s Receives the sines of `angles`.
+ * \param c Receives the cosines of `angles`.
+ * \param precision The polynomial precision to use.
+ */
+ENMA_TARGET_AVX2 void SinCos(const __m256& angles, __m256& s, __m256& c, SinCosPrecision precision = SinCosPrecision::Accurate);
+#endif
+
+#ifdef ENMA_IMPLEMENTATION
+
+// Angles are reduced to r = x - q * PI/2 with r in [-PI/4, PI/4]. PI/2 is split Cody-Waite style into
+// parts of at most 12 significant bits, so q * part is exact in single precision for |q| < 2^12 with or
+// without FMA and the differences near a multiple of PI/2 cancel exactly. The fast reduction uses the
+// first part and the rounded rest, the accurate one three exact parts and the rounded rest
+constexpr flt32 SINCOS_2OPI     = 0.636619772367581343f;
+constexpr flt32 SINCOS_PIO2_1   = 1.5703125f;
+constexpr flt32 SINCOS_PIO2_2   = 4.837512969970703125e-4f;
+constexpr flt32 SINCOS_PIO2_3   = 7.54953362047672271728515625e-8f;
+constexpr flt32 SINCOS_PIO2_4   = 2.56334415159451878819e-12f;
+constexpr flt32 SINCOS_PIO2_2F  = 4.83826794896619231321e-4f;		// PI/2 - SINCOS_PIO2_1
+
+// Minimax coefficients over [-PI/4, PI/4]: sin(r) = r + r^3 * S(r^2), cos(r) = 1 + r^2 * C(r^2)
+constexpr flt32 SINCOS_FAST_S1  = -1.6662834e-1f;
+constexpr flt32 SINCOS_FAST_S2  =  8.1529923e-3f;
+constexpr flt32 SINCOS_FAST_C1  = -4.9977631e-1f;
+constexpr flt32 SINCOS_FAST_C2  =  4.0488936e-2f;
+
+constexpr flt32 SINCOS_S1       = -1.6666654611e-1f;
+constexpr flt32 SINCOS_S2       =  8.3321608736e-3f;
+constexpr flt32 SINCOS_S3       = -1.9515295891e-4f;
+constexpr flt32 SINCOS_C1       = -0.5f;
+constexpr flt32 SINCOS_C2       =  4.166664568298827e-2f;
+constexpr flt32 SINCOS_C3       = -1.388731625493765e-3f;
+constexpr flt32 SINCOS_C4       =  2.443315711809948e-5f;
+
+inline void SinCosKernel(const simd::float4& x, simd::float4& s, simd::float4& c, SinCosPrecision precision)
+{
+	using namespace simd;
+
+	const float4 q = Round(x * SINCOS_2OPI);
+	const int4 qi = ToInt(q);
+
+	float4 r, sr, cr;
+
+	if(precision == SinCosPrecision::Fast)
+	{
+		r = Fnmadd(q, float4::Set1(SINCOS_PIO2_1), x);
+		r = Fnmadd(q, float4::Set1(SINCOS_PIO2_2F), r);
+
+		const float4 z = r * r;
+
+		sr = Fmadd(z, float4::Set1(SINCOS_FAST_S2), float4::Set1(SINCOS_FAST_S1));
+		sr = Fmadd(z * r, sr, r);
+
+		cr = Fmadd(z, float4::Set1(SINCOS_FAST_C2), float4::Set1(SINCOS_FAST_C1));
+		cr = Fmadd(z, cr, float4::Set1(1.0f));
+	}
+	else
+	{
+		r = Fnmadd(q, float4::Set1(SINCOS_PIO2_1), x);
+		r = Fnmadd(q, float4::Set1(SINCOS_PIO2_2), r);
+		r = Fnmadd(q, float4::Set1(SINCOS_PIO2_3), r);
+		r = Fnmadd(q, float4::Set1(SINCOS_PIO2_4), r);
+
+		const float4 z = r * r;
+
+		sr = Fmadd(z, float4::Set1(SINCOS_S3), float4::Set1(SINCOS_S2));
+		sr = Fmadd(z, sr, float4::Set1(SINCOS_S1));
+		sr = Fmadd(z * r, sr, r);
+
+		cr = Fmadd(z, float4::Set1(SINCOS_C4), float4::Set1(SINCOS_C3));
+		cr = Fmadd(z, cr, float4::Set1(SINCOS_C2));
+		cr = Fmadd(z, cr, float4::Set1(SINCOS_C1));
+		cr = Fmadd(z, cr, float4::Set1(1.0f));
+	}
+
+	// Odd quadrants swap sine and cosine; the sign of each follows bit 1 of q and q + 1 respectively
+	const int4 one = int4::Set1(1);
+	const float4 swap = AsFloat(CmpEq(And(qi, one), one));
+	const float4 signS = AsFloat(ShiftLeft<30>(And(qi, int4::Set1(2))));
+	const float4 signC = AsFloat(ShiftLeft<30>(And(qi + one, int4::Set1(2))));
+
+	s = Xor(Select(swap, cr, sr), signS);
+	c = Xor(Select(swap, sr, cr), signC);
+}
+
+#ifdef USE_SIMD
+ENMA_TARGET_AVX2 inline void SinCosKernel(const __m256& x, __m256& s, __m256& c, SinCosPrecision precision)
+{
+	const __m256 q = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(SINCOS_2OPI)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+	const __m256i qi = _mm256_cvtps_epi32(q);
+
+	__m256 r, sr, cr;
+
+	if(precision == SinCosPrecision::Fast)
+	{
+		r = _mm256_fnmadd_ps(q, _mm256_set1_ps(SINCOS_PIO2_1), x);
+		r = _mm256_fnmadd_ps(q, _mm256_set1_ps(SINCOS_PIO2_2F), r);
+
+		const __m256 z = _mm256_mul_ps(r, r);
+
+		sr = _mm256_fmadd_ps(z, _mm256_set1_ps(SINCOS_FAST_S2), _mm256_set1_ps(SINCOS_FAST_S1));
+		sr = _mm256_fmadd_ps(_mm256_mul_ps(z, r), sr, r);
+
+		cr = _mm256_fmadd_ps(z, _mm256_set1_ps(SINCOS_FAST_C2), _mm256_set1_ps(SINCOS_FAST_C1));
+		cr = _mm256_fmadd_ps(z, cr, _mm256_set1_ps(1.0f));
+	}
+	else
+	{
+		r = _mm256_fnmadd_ps(q, _mm256_set1_ps(SINCOS_PIO2_1), x);
+		r = _mm256_fnmadd_ps(q, _mm256_set1_ps(SINCOS_PIO2_2), r);
+		r = _mm256_fnmadd_ps(q, _mm256_set1_ps(SINCOS_PIO2_3), r);
+		r = _mm256_fnmadd_ps(q, _mm256_set1_ps(SINCOS_PIO2_4), r);
+
+		const __m256 z = _mm256_mul_ps(r, r);
+
+		sr = _mm256_fmadd_ps(z, _mm256_set1_ps(SINCOS_S3), _mm256_set1_ps(SINCOS_S2));
+		sr = _mm256_fmadd_ps(z, sr, _mm256_set1_ps(SINCOS_S1));
+		sr = _mm256_fmadd_ps(_mm256_mul_ps(z, r), sr, r);
+
+		cr = _mm256_fmadd_ps(z, _mm256_set1_ps(SINCOS_C4), _mm256_set1_ps(SINCOS_C3));
+		cr = _mm256_fmadd_ps(z, cr, _mm256_set1_ps(SINCOS_C2));
+		cr = _mm256_fmadd_ps(z, cr, _mm256_set1_ps(SINCOS_C1));
+		cr = _mm256_fmadd_ps(z, cr, _mm256_set1_ps(1.0f));
+	}
+
+	const __m256i one = _mm256_set1_epi32(1);
+	const __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(qi, one), one));
+	const __m256 signS = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(qi, _mm256_set1_epi32(2)), 30));
+	const __m256 signC = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(qi, one), _mm256_set1_epi32(2)), 30));
+
+	s = _mm256_xor_ps(_mm256_blendv_ps(sr, cr, swap), signS);
+	c = _mm256_xor_ps(_mm256_blendv_ps(cr, sr, swap), signC);
+}
+
+ENMA_FN ENMA_TARGET_AVX2 void SinCos(const __m256& angles, __m256& s, __m256& c, SinCosPrecision precision)
+{
+	SinCosKernel(angles, s, c, precision);
+}
+#endif
+
+ENMA_FN void SinCos(flt32 angle, flt32& s, flt32& c, SinCosPrecision precision)
+{
+	simd::float4 vs, vc;
+
+	SinCosKernel(simd::float4::Set1(angle), vs, vc, precision);
+
+	s = vs.X();
+	c = vc.X();
+}
+
+ENMA_FN void SinCos(const fvec4& angles, fvec4& s, fvec4& c, SinCosPrecision precision)
+{
+	simd::float4 vs, vc;
+
+	SinCosKernel(LoadXYZW(angles), vs, vc, precision);
+
+	StoreXYZW(s, vs);
+	StoreXYZW(c, vc);
+}
+
+#endif // ENMA_IMPLEMENTATION
@@ -22,6 +22,9 @@
 #include "core/vectors/fvec2.hpp"
 #include "core/vectors/fvec3.hpp"
 #include "core/vectors/fvec4.hpp"
+#include "core/vectors/fvec3_soa.hpp"
+#include "core/vectors/ivec3_soa.hpp"
+#include "core/vectors/divider.hpp"
 
 
 /* 										Double-Precision Floating Point Vectors 												*/
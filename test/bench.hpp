@@ -0,0 +1,74 @@
+#include "enma.hpp"
+#include "timer.hpp"
+#include "gtest/gtest.h"
+
+/**
+ * Reference fmat4x4 product using the transpose + _mm_dp_ps kernel that the library shipped
+ * before the broadcast-FMA rewrite. Kept only to benchmark against.
+ */
+mat4 DotProductMultiply(const mat4& a, const mat4& b)
+{
+    __m128 r10 = b._vals[0];
+    __m128 r11 = b._vals[1];
+    __m128 r12 = b._vals[2];
+    __m128 r13 = b._vals[3];
+
+    _MM_TRANSPOSE4_PS(r10, r11, r12, r13);
+
+    flt32 res[16];
+
+    for(int32 i = 0; i < 4; i++)
+    {
+        res[4 * i + 0] = _mm_cvtss_f32(_mm_dp_ps(a._vals[i], r10, 0xFF));
+        res[4 * i + 1] = _mm_cvtss_f32(_mm_dp_ps(a._vals[i], r11, 0xFF));
+        res[4 * i + 2] = _mm_cvtss_f32(_mm_dp_ps(a._vals[i], r12, 0xFF));
+        res[4 * i + 3] = _mm_cvtss_f32(_mm_dp_ps(a._vals[i], r13, 0xFF));
+    }
+
+    return mat4(vec4(res), vec4(res + 4), vec4(res + 8), vec4(res + 12));
+}
+
+template <typename F>
+flt32 BenchMultiply(F multiply, const mat4* mats, mat4* out, int32 count, int32 rounds)
+{
+    enma::TImer<flt32> timer;
+    timer.RestartTimer();
+
+    for(int32 r = 0; r < rounds; r++)
+    {
+        for(int32 i = 0; i < count; i++)
+        {
+            out[i] = multiply(mats[i], mats[(i + r) % count]);
+        }
+    }
+
+    return timer.ElapsedMicroSeconds();
+}
+
+void Mat4MultiplyBenchmark()
+{
+    constexpr int32 count = 1024;
+    constexpr int32 rounds = 256;
+
+    static mat4 mats[count], outOld[count], outNew[count];
+
+    for(int32 i = 0; i < count; i++)
+    {
+        mats[i] = Rotate(i * 0.37f, vec3(1.0f, 2.0f, 3.0f)) * Translate(vec3(i * 0.01f, 1.0f, -2.0f));
+    }
+
+    const flt32 oldTime = BenchMultiply(DotProductMultiply, mats, outOld, count, rounds);
+    const flt32 newTime = BenchMultiply([](const mat4& a, const mat4& b) { return a * b; }, mats, outNew, count, rounds);
+
+    for(int32 i = 0; i < count; i++)
+    {
+        EXPECT_MAT4_NEAR(outOld[i], outNew[i], 1e-4f);
+    }
+
+    LOG_D("Benchmark: mat4 Multiply (", count * rounds, " products) dp_ps: ", oldTime, "us\tFMA: ", newTime, "us");
+}
+
+TEST(benchmark, Mat4_Multiply)
+{
+    Mat4MultiplyBenchmark();
+}
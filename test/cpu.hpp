@@ -0,0 +1,204 @@
+#include "enma.hpp"
+#include "gtest/gtest.h"
+#include <cmath>
+
+void CpuFeatureLevel()
+{
+    const CpuFeatures& f = GetCpuFeatures();
+
+    // The headers are compiled for at least SSE4.1, so any host running the tests has it
+    EXPECT_TRUE(f.sse2);
+    EXPECT_TRUE(f.sse41);
+    EXPECT_GE(GetSimdLevel(), SimdLevel::SSE41);
+
+    if(f.level >= SimdLevel::AVX2)
+    {
+        EXPECT_TRUE(f.avx && f.avx2 && f.fma);
+    }
+
+    if(f.level == SimdLevel::AVX512)
+    {
+        EXPECT_TRUE(f.avx512f && f.avx512dq && f.avx512vl);
+    }
+
+    EXPECT_EQ(&GetCpuFeatures(), &f);
+
+    LOG_D("Test Successful: CPU Feature Level");
+}
+
+// Every tier of a dispatched kernel has to agree with the baseline tier
+void DispatchTiers()
+{
+    if(GetSimdLevel() < SimdLevel::AVX2)
+    {
+        GTEST_SKIP() << "Host has no AVX2 tier";
+    }
+
+    const mat4 m = Rotate(vec3(30.0f, -45.0f, 60.0f)) * Translate(vec3(1.0f, -2.0f, 3.0f));
+
+    constexpr uin32 count = 13;
+    vec3 p[count], a3[count], b3[count];
+    vec4 p4[count], a4[count], b4[count];
+    quat qa[count], qb[count], sa[count], sb[count];
+    flt32 t[count];
+
+    for(uin32 i = 0; i < count; i++)
+    {
+        p[i] = vec3(0.5f * i, 1.0f - i, 0.25f * i * i);
+        p4[i] = vec4(p[i], 1.0f - 0.1f * i);
+        qa[i] = Normalise(quat(1.0f, 0.1f * i, 0.2f, -0.3f));
+        qb[i] = Normalise(quat(-0.2f, 0.5f, 0.1f * i, 0.4f));
+        t[i] = i / flt32(count);
+    }
+
+    TransformPointsSSE41(m, p, a3, count);
+    TransformPointsAVX2(m, p, b3, count);
+    for(uin32 i = 0; i < count; i++)
+        EXPECT_VEC3_NEAR(a3[i], b3[i], 1e-4f);
+
+    TransformPointsProjectiveSSE41(m, p, a3, count);
+    TransformPointsProjectiveAVX2(m, p, b3, count);
+    for(uin32 i = 0; i < count; i++)
+        EXPECT_VEC3_NEAR(a3[i], b3[i], 1e-4f);
+
+    TransformPointsSSE41(m, p4, a4, count);
+    TransformPointsAVX2(m, p4, b4, count);
+    for(uin32 i = 0; i < count; i++)
+    {
+        EXPECT_VEC3_NEAR(a4[i], b4[i], 1e-4f);
+        EXPECT_NEAR(a4[i].w, b4[i].w, 1e-4f);
+    }
+
+    RotateVectorsSSE41(qa, p, a3, count);
+    RotateVectorsAVX2(qa, p, b3, count);
+    for(uin32 i = 0; i < count; i++)
+        EXPECT_VEC3_NEAR(a3[i], b3[i], 1e-4f);
+
+    NlerpQuaternionsSSE41(qa, qb, t, sa, count);
+    NlerpQuaternionsAVX2(qa, qb, t, sb, count);
+    for(uin32 i = 0; i < count; i++)
+        EXPECT_QUAT_NEAR(sa[i], sb[i], 1e-5f);
+
+    SlerpQuaternionsSSE41(qa, qb, t, sa, count);
+    SlerpQuaternionsAVX2(qa, qb, t, sb, count);
+    for(uin32 i = 0; i < count; i++)
+        EXPECT_QUAT_NEAR(sa[i], sb[i], 1e-5f);
+
+    fvec3_soa sp(p, count), sq(a3, count), ca(count), cb(count);
+    CrossSSE41(sp, sq, ca);
+    CrossAVX2(sp, sq, cb);
+    NormaliseSSE41(ca, ca);
+    NormaliseAVX2(cb, cb);
+    for(uin32 i = 0; i < count; i++)
+        EXPECT_VEC3_NEAR(ca[i], cb[i], 1e-5f);
+    for(uin32 i = count; i < cb.capacity; i++)
+        EXPECT_VEC3_EQ(cb[i], vec3(0.0f));
+
+    // One guard element past `count`, the flt32 outputs must stop at the element count
+    flt32 da[count + 1], db[count + 1];
+    da[count] = db[count] = -1.0f;
+    DistanceSSE41(sp, sq, da);
+    DistanceAVX2(sp, sq, db);
+    for(uin32 i = 0; i < count; i++)
+        EXPECT_NEAR(da[i], db[i], 1e-4f * (1.0f + da[i]));
+    EXPECT_EQ(da[count], -1.0f);
+    EXPECT_EQ(db[count], -1.0f);
+
+    DotSSE41(sp, sq, da);
+    DotAVX2(sp, sq, db);
+    for(uin32 i = 0; i < count; i++)
+        EXPECT_NEAR(da[i], db[i], 1e-4f * (1.0f + std::abs(da[i])));
+    EXPECT_EQ(da[count], -1.0f);
+    EXPECT_EQ(db[count], -1.0f);
+
+    LOG_D("Test Successful: Dispatch Tiers");
+}
+
+// The AVX-512 fvec3 kernels run 16 vectors per block, so the count covers two blocks and a tail
+void DispatchTiersAVX512()
+{
+    if(GetSimdLevel() < SimdLevel::AVX512)
+    {
+        GTEST_SKIP() << "Host has no AVX-512 tier";
+    }
+
+    const mat4 m = Perspective(60.0f, 1.5f, 0.1f, 100.0f) * Rotate(vec3(10.0f, 20.0f, -35.0f));
+
+    constexpr uin32 count = 39;
+    vec3 p[count], a3[count], b3[count];
+    vec4 p4[count], a4[count], b4[count];
+
+    for(uin32 i = 0; i < count; i++)
+    {
+        p[i] = vec3(0.5f * i, 1.0f - i, 0.25f * i * i + 1.0f);
+        p4[i] = vec4(p[i], 1.0f - 0.1f * i);
+    }
+
+    TransformPointsSSE41(m, p, a3, count);
+    TransformPointsAVX512(m, p, b3, count);
+    for(uin32 i = 0; i < count; i++)
+        EXPECT_VEC3_NEAR(a3[i], b3[i], 1e-3f);
+
+    TransformVectorsSSE41(m, p, a3, count);
+    TransformVectorsAVX512(m, p, b3, count);
+    for(uin32 i = 0; i < count; i++)
+        EXPECT_VEC3_NEAR(a3[i], b3[i], 1e-3f);
+
+    TransformPointsProjectiveSSE41(m, p, a3, count);
+    TransformPointsProjectiveAVX512(m, p, b3, count);
+    for(uin32 i = 0; i < count; i++)
+        EXPECT_VEC3_NEAR(a3[i], b3[i], 1e-4f);
+
+    // Odd count so that the masked tail is exercised
+    TransformPointsSSE41(m, p4, a4, count);
+    TransformPointsAVX512(m, p4, b4, count);
+    for(uin32 i = 0; i < count; i++)
+    {
+        EXPECT_VEC3_NEAR(a4[i], b4[i], 1e-3f);
+        EXPECT_NEAR(a4[i].w, b4[i].w, 1e-3f);
+    }
+
+    fvec3_soa sp(p, count), sq(a3, count), ca(count), cb(count);
+    CrossSSE41(sp, sq, ca);
+    CrossAVX512(sp, sq, cb);
+    NormaliseSSE41(ca, ca);
+    NormaliseAVX512(cb, cb);
+    for(uin32 i = 0; i < count; i++)
+        EXPECT_VEC3_NEAR(ca[i], cb[i], 1e-5f);
+    for(uin32 i = count; i < cb.capacity; i++)
+        EXPECT_VEC3_EQ(cb[i], vec3(0.0f));
+
+    // One guard element past `count`, the flt32 outputs must stop at the element count
+    flt32 da[count + 1], db[count + 1];
+    da[count] = db[count] = -1.0f;
+    DistanceSSE41(sp, sq, da);
+    DistanceAVX512(sp, sq, db);
+    for(uin32 i = 0; i < count; i++)
+        EXPECT_NEAR(da[i], db[i], 1e-4f * (1.0f + da[i]));
+    EXPECT_EQ(da[count], -1.0f);
+    EXPECT_EQ(db[count], -1.0f);
+
+    DotSSE41(sp, sq, da);
+    DotAVX512(sp, sq, db);
+    for(uin32 i = 0; i < count; i++)
+        EXPECT_NEAR(da[i], db[i], 1e-4f * (1.0f + std::abs(da[i])));
+    EXPECT_EQ(da[count], -1.0f);
+    EXPECT_EQ(db[count], -1.0f);
+
+    LOG_D("Test Successful: Dispatch Tiers AVX-512");
+}
+
+TEST(cpu, Feature_Level)
+{
+    CpuFeatureLevel();
+}
+
+TEST(cpu, Dispatch_Tiers)
+{
+    DispatchTiers();
+}
+
+TEST(cpu, Dispatch_Tiers_AVX512)
+{
+    DispatchTiersAVX512();
+}
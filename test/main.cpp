@@ -4,6 +4,14 @@
 #define ENMA_IMPLEMENTATION
 #include "enma.hpp"
 #include "vec.hpp"
+#include "mat.hpp"
+#include "quat.hpp"
+#include "simd.hpp"
+#include "spatial.hpp"
+#ifdef USE_SIMD
+#include "cpu.hpp"
+#include "bench.hpp"
+#endif
 
 int32 main(int32 argc, char** argv)
 {
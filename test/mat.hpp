@@ -0,0 +1,357 @@
+#include "enma.hpp"
+#include "gtest/gtest.h"
+#include <cmath>
+
+#define EXPECT_MAT4_NEAR(m1, m2, eps)                   \
+do                                                      \
+{                                                       \
+    for(int32 e = 0; e < 16; e++)                       \
+    {                                                   \
+        EXPECT_NEAR(m1._arr[e], m2._arr[e], eps);       \
+    }                                                   \
+} while (0)
+
+mat4 TestMatrix()
+{
+    return mat4
+    {
+        2.0f,   0.5f,   -1.0f,  0.0f,
+        0.0f,   1.5f,   3.0f,   0.0f,
+        1.0f,   -2.0f,  0.25f,  0.0f,
+        4.0f,   5.0f,   -6.0f,  1.0f
+    };
+}
+
+mat4 TestProjection()
+{
+    return mat4
+    {
+        1.2f,   0.1f,   0.3f,   0.2f,
+        0.0f,   -1.5f,  0.4f,   0.1f,
+        0.2f,   0.3f,   1.1f,   1.0f,
+        0.5f,   0.7f,   -0.2f,  2.0f
+    };
+}
+
+mat4 ReferenceMultiply(const mat4& a, const mat4& b)
+{
+    mat4 res;
+
+    for(int32 i = 0; i < 4; i++)
+    {
+        for(int32 j = 0; j < 4; j++)
+        {
+            flt32 sum = 0.0f;
+
+            for(int32 k = 0; k < 4; k++)
+            {
+                sum += a._arr[4 * i + k] * b._arr[4 * k + j];
+            }
+
+            res._arr[4 * i + j] = sum;
+        }
+    }
+
+    return res;
+}
+
+void Mat4Multiply()
+{
+    const mat4 a = TestMatrix();
+    const mat4 b = TestProjection();
+
+    const mat4 expect = ReferenceMultiply(a, b);
+    const mat4 expectSquare = ReferenceMultiply(a, a);
+
+    mat4 actual = a * b;
+    EXPECT_MAT4_NEAR(actual, expect, 1e-5f);
+
+    actual = a;
+    actual *= b;
+    EXPECT_MAT4_NEAR(actual, expect, 1e-5f);
+
+    actual = a;
+    actual *= actual;
+    EXPECT_MAT4_NEAR(actual, expectSquare, 1e-5f);
+
+    LOG_D("Test Successful: mat4 Multiplication");
+}
+
+TEST(mat4, Arithmetic_Multiplication)
+{
+    Mat4Multiply();
+}
+
+void Mat4Inverse()
+{
+    const mat4 m = TestMatrix();
+    const mat4 p = TestProjection();
+
+    EXPECT_MAT4_NEAR((m * Inverse(m)), mat4::identity, 1e-5f);
+    EXPECT_MAT4_NEAR((p * Inverse(p)), mat4::identity, 1e-5f);
+    EXPECT_MAT4_NEAR((Inverse(p) * p), mat4::identity, 1e-5f);
+
+    // Expanded along the last column of TestMatrix: det of the upper-left 3x3
+    EXPECT_NEAR(Determinant(m), 2.0f * (1.5f * 0.25f + 6.0f) - 0.5f * (0.0f - 3.0f) - 1.0f * (0.0f - 1.5f), 1e-5f);
+    EXPECT_NEAR(Determinant(p * m), Determinant(p) * Determinant(m), 1e-4f);
+
+    flt32 det = 0.0f;
+    const mat4 inv = InverseWithDeterminant(p, det);
+    EXPECT_MAT4_NEAR(inv, Inverse(p), 1e-6f);
+    EXPECT_NEAR(det, Determinant(p), 1e-6f);
+
+    const mat4 singular
+    {
+        1.0f,   2.0f,   3.0f,   4.0f,
+        2.0f,   4.0f,   6.0f,   8.0f,
+        0.0f,   1.0f,   0.0f,   1.0f,
+        5.0f,   0.0f,   1.0f,   0.0f
+    };
+
+    const mat4 singularInv = InverseWithDeterminant(singular, det);
+    EXPECT_FLOAT_EQ(det, 0.0f);
+    EXPECT_MAT4_NEAR(singularInv, mat4::zero, 0.0f);
+
+    LOG_D("Test Successful: mat4 Inverse");
+}
+
+TEST(mat4, Inverse)
+{
+    Mat4Inverse();
+}
+
+void Mat4StructuredInverse()
+{
+    const mat4 rotation = Rotate(37.0f, vec3(1.0f, -2.0f, 0.5f));
+    const mat4 rigid = rotation * Translate(vec3(3.0f, -1.0f, 7.0f));
+    const mat4 affine = Scale(vec3(2.0f, 0.5f, 3.0f)) * TestMatrix();
+
+    EXPECT_MAT4_NEAR(OrthonormalInverse(rotation), Inverse(rotation), 1e-5f);
+    EXPECT_MAT4_NEAR(RigidInverse(rigid), Inverse(rigid), 1e-5f);
+    EXPECT_MAT4_NEAR(AffineInverse(affine), Inverse(affine), 1e-5f);
+    EXPECT_MAT4_NEAR(AffineInverse(rigid), Inverse(rigid), 1e-5f);
+
+    LOG_D("Test Successful: mat4 Structured Inverse");
+}
+
+TEST(mat4, Structured_Inverse)
+{
+    Mat4StructuredInverse();
+}
+
+void Mat3x4Affine()
+{
+    const mat4 a4 = Rotate(25.0f, vec3(0.0f, 1.0f, 1.0f)) * Translate(vec3(1.0f, 2.0f, 3.0f));
+    const mat4 b4 = Scale(vec3(2.0f, 3.0f, 0.5f)) * TestMatrix();
+
+    const mat3x4 a(a4);
+    const mat3x4 b(b4);
+
+    EXPECT_MAT4_NEAR(static_cast<mat4>(a), a4, 0.0f);
+    EXPECT_MAT4_NEAR(static_cast<mat4>(a * b), (a4 * b4), 1e-5f);
+
+    mat3x4 ab = a;
+    ab *= b;
+    EXPECT_MAT4_NEAR(static_cast<mat4>(ab), (a4 * b4), 1e-5f);
+
+    EXPECT_MAT4_NEAR(static_cast<mat4>(RigidInverse(a)), Inverse(a4), 1e-5f);
+    EXPECT_MAT4_NEAR(static_cast<mat4>(AffineInverse(b)), Inverse(b4), 1e-5f);
+
+    const vec3 p(1.0f, -2.0f, 4.0f);
+    const vec4 expectPoint = vec4(p, 1.0f) * b4;
+    const vec4 expectVector = vec4(p, 0.0f) * b4;
+
+    const vec3 point = TransformPoint(b, p);
+    const vec3 vector = TransformVector(b, p);
+
+    EXPECT_NEAR(point.x, expectPoint.x, 1e-4f);
+    EXPECT_NEAR(point.y, expectPoint.y, 1e-4f);
+    EXPECT_NEAR(point.z, expectPoint.z, 1e-4f);
+    EXPECT_NEAR(vector.x, expectVector.x, 1e-4f);
+    EXPECT_NEAR(vector.y, expectVector.y, 1e-4f);
+    EXPECT_NEAR(vector.z, expectVector.z, 1e-4f);
+
+    LOG_D("Test Successful: mat3x4 Affine");
+}
+
+TEST(mat3x4, Affine)
+{
+    Mat3x4Affine();
+}
+
+void Mat2Mat3Multiply()
+{
+    mat2 a2(1.0f, 2.0f, 3.0f, 4.0f);
+    const mat2 b2(-1.0f, 0.5f, 2.0f, 3.0f);
+    const mat2 ab2 = a2 * b2;
+
+    EXPECT_FLOAT_EQ(ab2.m11, 3.0f);
+    EXPECT_FLOAT_EQ(ab2.m12, 6.5f);
+    EXPECT_FLOAT_EQ(ab2.m21, 5.0f);
+    EXPECT_FLOAT_EQ(ab2.m22, 13.5f);
+    EXPECT_FLOAT_EQ(a2.Determinant(), -2.0f);
+
+    mat3 a3(1.0f, 2.0f, 3.0f, 0.0f, 1.0f, 4.0f, 5.0f, 6.0f, 0.0f);
+    const mat3 b3(2.0f, 0.0f, 1.0f, 1.0f, 3.0f, 0.0f, 0.0f, 1.0f, 2.0f);
+    const mat3 ab3 = a3 * b3;
+
+    EXPECT_FLOAT_EQ(ab3.m11, 4.0f);
+    EXPECT_FLOAT_EQ(ab3.m12, 9.0f);
+    EXPECT_FLOAT_EQ(ab3.m13, 7.0f);
+    EXPECT_FLOAT_EQ(ab3.m23, 8.0f);
+    EXPECT_FLOAT_EQ(ab3.m31, 16.0f);
+    EXPECT_FLOAT_EQ(ab3.m33, 5.0f);
+
+    LOG_D("Test Successful: mat2 mat3 Multiplication");
+}
+
+TEST(mat2, Mat3_Multiplication)
+{
+    Mat2Mat3Multiply();
+}
+
+void Mat2x3Arithmetic()
+{
+    mat2x3 a(1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f);
+    const mat2x3 b(10.0f, 20.0f, 30.0f, 40.0f, 50.0f, 60.0f);
+
+    // Each row must combine with the same row of the other operand
+    const mat2x3 sum = a + b;
+    const mat2x3 diff = a - b;
+
+    for(int32 e = 0; e < 6; e++)
+    {
+        EXPECT_FLOAT_EQ(sum.arr[e], a.arr[e] + b.arr[e]);
+        EXPECT_FLOAT_EQ(diff.arr[e], a.arr[e] - b.arr[e]);
+    }
+
+    LOG_D("Test Successful: mat2x3 Arithmetic");
+}
+
+TEST(mat2x3, Arithmetic)
+{
+    Mat2x3Arithmetic();
+}
+
+void Mat4x3Multiply()
+{
+    mat4x3 a(1.0f, 2.0f, 3.0f, 0.0f, 1.0f, 4.0f, 5.0f, 6.0f, 0.0f, -1.0f, 2.0f, 0.5f);
+    const mat4x3 b(2.0f, 0.0f, 1.0f, 1.0f, 3.0f, 0.0f, 0.0f, 1.0f, 2.0f, 7.0f, 8.0f, 9.0f);
+    const mat4x3 ab = a * b;
+
+    // Both operands are 4x4 matrices with a zero last column, so the last row of `b` never contributes
+    for(int32 i = 0; i < 4; i++)
+    {
+        for(int32 j = 0; j < 3; j++)
+        {
+            flt32 sum = 0.0f;
+
+            for(int32 k = 0; k < 3; k++)
+            {
+                sum += a.arr[3 * i + k] * b.arr[3 * k + j];
+            }
+
+            EXPECT_FLOAT_EQ(ab.arr[3 * i + j], sum);
+        }
+    }
+
+    // The last row used to be dropped
+    EXPECT_FLOAT_EQ(ab.m41, 0.0f);
+    EXPECT_FLOAT_EQ(ab.m42, 6.5f);
+    EXPECT_FLOAT_EQ(ab.m43, 0.0f);
+
+    const mat4x3 sum = a + b;
+    const mat4x3 diff = a - b;
+
+    for(int32 e = 0; e < 12; e++)
+    {
+        EXPECT_FLOAT_EQ(sum.arr[e], a.arr[e] + b.arr[e]);
+        EXPECT_FLOAT_EQ(diff.arr[e], a.arr[e] - b.arr[e]);
+    }
+
+    LOG_D("Test Successful: mat4x3 Multiplication");
+}
+
+TEST(mat4x3, Multiplication)
+{
+    Mat4x3Multiply();
+}
+
+void Mat4TransformPoints()
+{
+    const mat4 m = TestMatrix();
+
+    vec3 points[7], result[7];
+
+    for(int32 i = 0; i < 7; i++)
+    {
+        points[i] = vec3(i, 1 - i, 2 * i + 3);
+    }
+
+    TransformPoints(m, points, result, 7);
+
+    for(int32 i = 0; i < 7; i++)
+    {
+        vec4 expect = vec4(points[i], 1.0f) * m;
+
+        EXPECT_NEAR(result[i].x, expect.x, 1e-4f);
+        EXPECT_NEAR(result[i].y, expect.y, 1e-4f);
+        EXPECT_NEAR(result[i].z, expect.z, 1e-4f);
+    }
+
+    TransformVectors(m, points, result, 7);
+
+    for(int32 i = 0; i < 7; i++)
+    {
+        vec4 expect = vec4(points[i], 0.0f) * m;
+
+        EXPECT_NEAR(result[i].x, expect.x, 1e-4f);
+        EXPECT_NEAR(result[i].y, expect.y, 1e-4f);
+        EXPECT_NEAR(result[i].z, expect.z, 1e-4f);
+    }
+
+    LOG_D("Test Successful: mat4 Transform Points");
+}
+
+void Mat4TransformHomogeneous()
+{
+    const mat4 m = TestProjection();
+
+    vec4 points[7], result[7];
+    vec3 points3[7], result3[7];
+
+    for(int32 i = 0; i < 7; i++)
+    {
+        points[i] = vec4(i, 1 - i, 2 * i + 3, 1.0f);
+        points3[i] = vec3(i, 1 - i, 2 * i + 3);
+    }
+
+    TransformPoints(m, points, result, 7);
+    TransformPointsProjective(m, points3, result3, 7);
+
+    for(int32 i = 0; i < 7; i++)
+    {
+        vec4 expect = points[i] * m;
+
+        EXPECT_NEAR(result[i].x, expect.x, 1e-4f);
+        EXPECT_NEAR(result[i].y, expect.y, 1e-4f);
+        EXPECT_NEAR(result[i].z, expect.z, 1e-4f);
+        EXPECT_NEAR(result[i].w, expect.w, 1e-4f);
+
+        EXPECT_NEAR(result3[i].x, expect.x / expect.w, 1e-4f);
+        EXPECT_NEAR(result3[i].y, expect.y / expect.w, 1e-4f);
+        EXPECT_NEAR(result3[i].z, expect.z / expect.w, 1e-4f);
+    }
+
+    LOG_D("Test Successful: mat4 Transform Homogeneous");
+}
+
+TEST(mat4, Transform_Points)
+{
+    Mat4TransformPoints();
+}
+
+TEST(mat4, Transform_Homogeneous)
+{
+    Mat4TransformHomogeneous();
+}
@@ -0,0 +1,190 @@
+#include "enma.hpp"
+#include "gtest/gtest.h"
+#include <cmath>
+
+#define EXPECT_QUAT_NEAR(q1, q2, eps)   \
+do                                      \
+{                                       \
+    EXPECT_NEAR(q1.w, q2.w, eps);       \
+    EXPECT_NEAR(q1.x, q2.x, eps);       \
+    EXPECT_NEAR(q1.y, q2.y, eps);       \
+    EXPECT_NEAR(q1.z, q2.z, eps);       \
+} while (0)
+
+#define EXPECT_VEC3_NEAR(v1, v2, eps)   \
+do                                      \
+{                                       \
+    EXPECT_NEAR(v1.x, v2.x, eps);       \
+    EXPECT_NEAR(v1.y, v2.y, eps);       \
+    EXPECT_NEAR(v1.z, v2.z, eps);       \
+} while (0)
+
+quat ReferenceHamilton(const quat& a, const quat& b)
+{
+    return quat
+    {
+        a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+        a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+        a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+        a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w
+    };
+}
+
+void QuatMultiplication()
+{
+    const quat a(0.5f, -1.25f, 2.0f, 0.75f);
+    const quat b(-1.5f, 0.25f, 3.0f, -2.0f);
+
+    EXPECT_QUAT_NEAR((a * b), ReferenceHamilton(a, b), 1e-5f);
+    EXPECT_QUAT_NEAR((b * a), ReferenceHamilton(b, a), 1e-5f);
+
+    const quat i(0.0f, 1.0f, 0.0f, 0.0f);
+    const quat j(0.0f, 0.0f, 1.0f, 0.0f);
+    const quat k(0.0f, 0.0f, 0.0f, 1.0f);
+    const quat ij = i * j;
+
+    EXPECT_QUAT_NEAR(ij, k, 1e-6f);
+
+    LOG_D("Test Successful: quat Multiplication");
+}
+
+void QuatNormaliseInverse()
+{
+    const quat a(0.5f, -1.25f, 2.0f, 0.75f);
+
+    const quat n = Normalise(a);
+    EXPECT_NEAR(Dot(n, n), 1.0f, 1e-6f);
+    EXPECT_NEAR(n.y, a.y / std::sqrt(Dot(a, a)), 1e-6f);
+
+    const quat id(1.0f, 0.0f, 0.0f, 0.0f);
+    const quat ai = a * Inverse(a);
+    const quat ia = Inverse(a) * a;
+
+    EXPECT_QUAT_NEAR(ai, id, 1e-5f);
+    EXPECT_QUAT_NEAR(ia, id, 1e-5f);
+
+    const quat c = a.Conjugate();
+    EXPECT_QUAT_NEAR(c, quat(0.5f, 1.25f, -2.0f, -0.75f), 0.0f);
+
+    LOG_D("Test Successful: quat Normalise & Inverse");
+}
+
+void QuatRotateVectors()
+{
+    const quat q = Normalise(quat(0.8f, 0.3f, -0.4f, 0.2f));
+    const mat4 m = ToRotationMatrix(q);
+
+    quat qs[7];
+    vec3 in[7], out[7], batch[7];
+
+    for(int32 i = 0; i < 7; i++)
+    {
+        in[i] = vec3(1.5f - i, 0.25f * i, 2.0f + 0.5f * i);
+        qs[i] = Normalise(quat(1.0f - 0.1f * i, 0.2f * i, -0.3f, 0.15f * i));
+    }
+
+    for(int32 i = 0; i < 7; i++)
+    {
+        const vec3 r = Rotate(q, in[i]);
+        const vec4 ref = vec4(in[i], 0.0f) * m;
+
+        EXPECT_VEC3_NEAR(r, ref, 1e-5f);
+
+        // Sandwich product q * v * q^-1
+        const quat s = qs[i] * quat(0.0f, in[i]) * Conjugate(qs[i]);
+        const vec3 rs = Rotate(qs[i], in[i]);
+
+        EXPECT_VEC3_NEAR(rs, s, 1e-5f);
+    }
+
+    RotateVectors(q, in, out, 7);
+    RotateVectors(qs, in, batch, 7);
+
+    for(int32 i = 0; i < 7; i++)
+    {
+        EXPECT_VEC3_NEAR(out[i], Rotate(q, in[i]), 1e-5f);
+        EXPECT_VEC3_NEAR(batch[i], Rotate(qs[i], in[i]), 1e-6f);
+    }
+
+    LOG_D("Test Successful: quat Rotate");
+}
+
+quat ReferenceSlerp(const quat& a, quat b, flt32 t)
+{
+    flt32 d = Dot(a, b);
+
+    if(d < 0.0f)
+    {
+        b = -b;
+        d = -d;
+    }
+
+    const flt32 theta = std::acos(std::min(d, 1.0f));
+    const flt32 sinTheta = std::sin(theta);
+
+    return a * (std::sin((1.0f - t) * theta) / sinTheta) + b * (std::sin(t * theta) / sinTheta);
+}
+
+void QuatInterpolation()
+{
+    constexpr int32 count = 19;
+
+    quat a[count], b[count], nl[count], sl[count];
+    flt32 t[count];
+
+    for(int32 i = 0; i < count; i++)
+    {
+        a[i] = Normalise(quat(1.0f, 0.1f * i, -0.2f, 0.05f * i));
+        b[i] = Normalise(quat(0.3f - 0.1f * i, 0.7f, 0.2f * i, -0.4f));
+        t[i] = i / flt32(count - 1);
+    }
+
+    // Nearly parallel pair exercises the Nlerp fallback
+    b[5] = Normalise(a[5] + quat(0.0f, 0.001f, 0.0f, 0.0f));
+
+    NlerpQuaternions(a, b, t, nl, count);
+    SlerpQuaternions(a, b, t, sl, count);
+
+    for(int32 i = 0; i < count; i++)
+    {
+        const quat n = Nlerp(a[i], b[i], t[i]);
+        const quat s = Slerp(a[i], b[i], t[i]);
+
+        EXPECT_NEAR(Dot(n, n), 1.0f, 1e-5f);
+        EXPECT_QUAT_NEAR(nl[i], n, 1e-5f);
+        EXPECT_QUAT_NEAR(sl[i], s, 1e-5f);
+        EXPECT_QUAT_NEAR(s, ReferenceSlerp(a[i], b[i], t[i]), 1e-5f);
+    }
+
+    // Endpoints, and Squad through its own keys
+    EXPECT_QUAT_NEAR(Slerp(a[3], b[3], 0.0f), a[3], 1e-6f);
+    EXPECT_QUAT_NEAR(Slerp(a[3], b[3], 1.0f), ReferenceSlerp(a[3], b[3], 1.0f), 1e-5f);
+
+    const quat s1 = SquadControlPoint(a[0], a[1], a[2]);
+    const quat s2 = SquadControlPoint(a[1], a[2], a[3]);
+
+    EXPECT_QUAT_NEAR(Squad(a[1], a[2], s1, s2, 0.0f), a[1], 1e-5f);
+    EXPECT_QUAT_NEAR(Squad(a[1], a[2], s1, s2, 1.0f), a[2], 1e-5f);
+
+    LOG_D("Test Successful: quat Interpolation");
+}
+
+TEST(quat, Arithmetic_Multiplication)
+{
+    QuatMultiplication();
+}
+
+TEST(quat, Normalise_Inverse)
+{
+    QuatNormaliseInverse();
+}
+
+TEST(quat, Rotate)
+{
+    QuatRotateVectors();
+}
+
+TEST(quat, Interpolation)
+{
+    QuatInterpolation();
+}
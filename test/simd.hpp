@@ -0,0 +1,95 @@
+#include "enma.hpp"
+#include "gtest/gtest.h"
+#include <cmath>
+
+void SimdFloat4()
+{
+    using namespace simd;
+
+    const flt32 in[4] = { 1.0f, -2.0f, 3.0f, -4.0f };
+    const float4 a = float4::LoadU(in);
+    const float4 b = float4::Set(0.5f, 0.25f, 2.0f, 4.0f);
+
+    flt32 out[4];
+
+    Shuffle<3, 2, 1, 0>(a).StoreU(out);
+    EXPECT_FLOAT_EQ(out[0], -4.0f);
+    EXPECT_FLOAT_EQ(out[3], 1.0f);
+
+    Shuffle<0, 1, 2, 3>(a, b).StoreU(out);
+    EXPECT_FLOAT_EQ(out[1], -2.0f);
+    EXPECT_FLOAT_EQ(out[2], 2.0f);
+
+    Blend<0, 1, 0, 1>(a, b).StoreU(out);
+    EXPECT_FLOAT_EQ(out[0], 1.0f);
+    EXPECT_FLOAT_EQ(out[1], 0.25f);
+
+    EXPECT_FLOAT_EQ(Dot3(a, b).X(), 0.5f - 0.5f + 6.0f);
+    EXPECT_FLOAT_EQ(Dot4(a, b).Get<3>(), 0.5f - 0.5f + 6.0f - 16.0f);
+    EXPECT_FLOAT_EQ(ReduceAdd(a), -2.0f);
+    EXPECT_FLOAT_EQ(Fmadd(a, b, float4::Set1(1.0f)).Get<2>(), 7.0f);
+    EXPECT_NEAR(Rsqrt(float4::Set1(4.0f)).X(), 0.5f, 1e-6f);
+
+    const float4 lt = CmpLt(a, float4::Zero());
+    EXPECT_EQ(MoveMask(lt), 0xA);
+    EXPECT_TRUE(Any(lt));
+    EXPECT_FALSE(All(lt));
+
+    Select(lt, Abs(a), a).StoreU(out);
+    EXPECT_FLOAT_EQ(out[1], 2.0f);
+    EXPECT_FLOAT_EQ(out[3], 4.0f);
+
+    float4 r0 = float4::Set(1, 2, 3, 4), r1 = float4::Set(5, 6, 7, 8), r2 = float4::Set(9, 10, 11, 12), r3 = float4::Set(13, 14, 15, 16);
+    Transpose(r0, r1, r2, r3);
+    r1.StoreU(out);
+    EXPECT_FLOAT_EQ(out[0], 2.0f);
+    EXPECT_FLOAT_EQ(out[3], 14.0f);
+
+    LOG_D("Test Successful: simd float4");
+}
+
+void SimdInt4Float8()
+{
+    using namespace simd;
+
+    const int4 i = ToInt(float4::Set(1.4f, -1.6f, 2.5f, 7.0f));
+    EXPECT_EQ(i.X(), 1);
+    EXPECT_EQ(i.Get<1>(), -2);
+    EXPECT_EQ(i.Get<3>(), 7);
+    EXPECT_EQ(ShiftLeft<2>(i).Get<3>(), 28);
+    EXPECT_EQ(MoveMask(CmpGt(i, int4::Zero())), 0xD);
+    EXPECT_FLOAT_EQ(ToFloat(i * int4::Set1(3)).Get<1>(), -6.0f);
+    EXPECT_EQ(Abs(i).Get<1>(), 2);
+    EXPECT_EQ(ShiftRight(i, 1).Get<1>(), -1);
+    EXPECT_EQ(MinU(i, int4::Set1(3)).Get<1>(), 3);
+    EXPECT_EQ(MaxU(i, int4::Set1(3)).Get<1>(), -2);
+
+    flt32 in[8], out[8];
+    for(uin32 k = 0; k < 8; k++)
+    {
+        in[k] = flt32(k) - 3.5f;
+    }
+
+    const float8 v = float8::LoadU(in);
+    Fmadd(v, float8::Set1(2.0f), float8::Set1(1.0f)).StoreU(out);
+
+    for(uin32 k = 0; k < 8; k++)
+    {
+        EXPECT_FLOAT_EQ(out[k], in[k] * 2.0f + 1.0f);
+    }
+
+    EXPECT_EQ(MoveMask(CmpGt(v, float8::Zero())), 0xF0);
+    EXPECT_FLOAT_EQ(v.High().X(), 0.5f);
+
+    LOG_D("Test Successful: simd int4 float8");
+}
+
+TEST(simd, Float4)
+{
+    SimdFloat4();
+}
+
+TEST(simd, Int4_Float8)
+{
+    SimdInt4Float8();
+}
@@ -0,0 +1,917 @@
+#include "enma.hpp"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+uin32 TestRandom(uin32& state)
+{
+    state = state * 1664525u + 1013904223u;
+
+    return state;
+}
+
+// Uniform in [-scale / 2, scale / 2)
+flt32 TestRandom(uin32& state, flt32 scale)
+{
+    return (flt32(TestRandom(state) >> 8) / flt32(1 << 24) - 0.5f) * scale;
+}
+
+fvec3 TestPoint(uin32& state, flt32 scale)
+{
+    return fvec3(TestRandom(state, scale), TestRandom(state, scale), TestRandom(state, scale));
+}
+
+void MortonCodes()
+{
+    EXPECT_EQ(MortonEncode(uvec2(1u, 0u)), 0x1u);
+    EXPECT_EQ(MortonEncode(uvec2(0u, 1u)), 0x2u);
+    EXPECT_EQ(MortonEncode(uvec2(0xFFFFu, 0xFFFFu)), 0xFFFFFFFFu);
+    EXPECT_EQ(MortonEncode(uvec3(1u, 1u, 1u)), 0x7u);
+    EXPECT_EQ(MortonEncode(uvec3(3u, 0u, 0u)), 0x9u);
+    EXPECT_EQ(MortonEncode(uvec3(0u, 0u, 0x3FFu)), 0x24924924u);
+
+    uin32 state = 7u;
+    std::vector<uvec2> in2(37);
+    std::vector<uvec3> in3(37);
+
+    for(uin32 i = 0; i < 37; i++)
+    {
+        in2[i] = uvec2(TestRandom(state) & 0xFFFFu, TestRandom(state) & 0xFFFFu);
+        in3[i] = uvec3(TestRandom(state) & 0x3FFu, TestRandom(state) & 0x3FFu, TestRandom(state) & 0x3FFu);
+    }
+
+    std::vector<uin32> codes2(37), codes3(37);
+    std::vector<uvec2> out2(37);
+    std::vector<uvec3> out3(37);
+
+    MortonEncode(in2.data(), codes2.data(), 37);
+    MortonEncode(in3.data(), codes3.data(), 37);
+    MortonDecode2(codes2.data(), out2.data(), 37);
+    MortonDecode3(codes3.data(), out3.data(), 37);
+
+    for(uin32 i = 0; i < 37; i++)
+    {
+        EXPECT_EQ(codes2[i], MortonEncode(in2[i]));
+        EXPECT_EQ(codes3[i], MortonEncode(in3[i]));
+        EXPECT_TRUE(All(out2[i] == in2[i]));
+        EXPECT_TRUE(All(out3[i] == in3[i]));
+        EXPECT_TRUE(All(MortonDecode3(codes3[i]) == in3[i]));
+    }
+
+    LOG_D("Test Successful: Morton Codes");
+}
+
+void MortonRadixSort()
+{
+    // Large enough to split into several tasks, with the thread count forced so that a single-core host takes that path too
+    const uin32 count = 200003;
+
+    uin32 state = 11u;
+    std::vector<uin32> keys(count), values(count);
+    std::vector<std::pair<uin32, uin32>> expect(count);
+
+    for(uin32 i = 0; i < count; i++)
+    {
+        keys[i] = TestRandom(state) & 0x3FFFFF0Fu;
+        values[i] = i;
+        expect[i] = { keys[i], i };
+    }
+
+    SetThreadCount(4);
+    EXPECT_GT(TaskCount(count, RadixGrain), 1u);
+    RadixSort(keys.data(), values.data(), count);
+    SetThreadCount(0);
+
+    std::stable_sort(expect.begin(), expect.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    for(uin32 i = 0; i < count; i++)
+    {
+        ASSERT_EQ(keys[i], expect[i].first);
+        ASSERT_EQ(values[i], expect[i].second);
+    }
+
+    std::vector<fvec3> points(1000);
+    for(uin32 i = 0; i < 1000; i++)
+    {
+        points[i] = fvec3(flt32(TestRandom(state) % 1000), flt32(TestRandom(state) % 1000), -flt32(TestRandom(state) % 1000));
+    }
+
+    const std::vector<fvec3> original = points;
+    std::vector<uin32> indices(1000), sortedKeys(1000);
+
+    MortonSort(points.data(), 1000, fvec3(0.0f, 0.0f, -1000.0f), fvec3(1000.0f, 1000.0f, 0.0f), indices.data());
+    MortonKeys(points.data(), sortedKeys.data(), 1000, fvec3(0.0f, 0.0f, -1000.0f), fvec3(1000.0f, 1000.0f, 0.0f));
+
+    for(uin32 i = 0; i < 1000; i++)
+    {
+        EXPECT_TRUE(All(points[i] == original[indices[i]]));
+
+        if(i > 0)
+        {
+            EXPECT_LE(sortedKeys[i - 1], sortedKeys[i]);
+        }
+    }
+
+    LOG_D("Test Successful: Morton Radix Sort");
+}
+
+void ParallelForExceptions()
+{
+    std::atomic<uin32> finished(0);
+
+    // Every other task must still finish, and the workers be joined, before the exception reaches the caller
+    EXPECT_THROW(ParallelFor(6, [&finished](uin32 task)
+    {
+        if(task == 3)
+        {
+            throw std::runtime_error("task 3");
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        finished++;
+    }), std::runtime_error);
+
+    EXPECT_EQ(finished.load(), 5u);
+
+    EXPECT_THROW(ParallelFor(3, [](uin32 task)
+    {
+        if(task == 0)
+        {
+            throw std::runtime_error("task 0");
+        }
+    }), std::runtime_error);
+
+    LOG_D("Test Successful: ParallelFor Exceptions");
+}
+
+TEST(parallel, Exceptions)
+{
+    ParallelForExceptions();
+}
+
+TEST(morton, Encode_Decode)
+{
+    MortonCodes();
+}
+
+TEST(morton, Radix_Sort)
+{
+    MortonRadixSort();
+}
+
+void AabbOperations()
+{
+    aabb3 box;
+    EXPECT_TRUE(box.IsEmpty());
+    EXPECT_FLOAT_EQ(SurfaceArea(box), 0.0f);
+
+    box.Expand(fvec3(1.0f, 2.0f, 3.0f)).Expand(fvec3(-1.0f, 0.0f, 5.0f));
+    EXPECT_FALSE(box.IsEmpty());
+    EXPECT_VEC3_EQ(box.Lower(), fvec3(-1.0f, 0.0f, 3.0f));
+    EXPECT_VEC3_EQ(box.Upper(), fvec3(1.0f, 2.0f, 5.0f));
+    EXPECT_VEC3_EQ(box.Center(), fvec3(0.0f, 1.0f, 4.0f));
+    EXPECT_FLOAT_EQ(SurfaceArea(box), 2.0f * (2.0f * 2.0f + 2.0f * 2.0f + 2.0f * 2.0f));
+
+    const aabb3 other(fvec3(0.5f, 1.5f, 4.5f), fvec3(3.0f, 3.0f, 6.0f));
+    EXPECT_TRUE(Overlaps(box, other));
+    EXPECT_FALSE(Overlaps(box, aabb3(fvec3(2.0f), fvec3(3.0f))));
+    EXPECT_VEC3_EQ(Union(box, other).Upper(), fvec3(3.0f, 3.0f, 6.0f));
+    EXPECT_VEC3_EQ(Intersection(box, other).Lower(), fvec3(0.5f, 1.5f, 4.5f));
+    EXPECT_TRUE(Intersection(box, aabb3(fvec3(2.0f), fvec3(3.0f))).IsEmpty());
+
+    EXPECT_TRUE(Contains(box, fvec3(0.0f, 1.0f, 4.0f)));
+    EXPECT_TRUE(Contains(box, fvec3(1.0f, 2.0f, 5.0f)));
+    EXPECT_FALSE(Contains(box, fvec3(0.0f, 1.0f, 5.5f)));
+    EXPECT_TRUE(Contains(Union(box, other), other));
+    EXPECT_FALSE(Contains(box, other));
+
+    LOG_D("Test Successful: aabb3 Operations");
+}
+
+void AabbRaySlab()
+{
+    flt32 t = 0.0f;
+    const aabb3 unit(fvec3(-1.0f), fvec3(1.0f));
+
+    EXPECT_TRUE(Intersect(ray3(fvec3(0.0f, 0.0f, -5.0f), fvec3(0.0f, 0.0f, 1.0f)), unit, 0.0f, 100.0f, t));
+    EXPECT_FLOAT_EQ(t, 4.0f);
+    EXPECT_FALSE(Intersect(ray3(fvec3(0.0f, 0.0f, -5.0f), fvec3(0.0f, 0.0f, 1.0f)), unit, 0.0f, 3.0f, t));
+    EXPECT_FALSE(Intersect(ray3(fvec3(0.0f, 2.0f, -5.0f), fvec3(0.0f, 0.0f, 1.0f)), unit, 0.0f, 100.0f, t));
+    EXPECT_TRUE(Intersect(ray3(fvec3(0.0f), fvec3(1.0f, -1.0f, 0.0f)), unit, 0.0f, 100.0f, t));
+    EXPECT_FLOAT_EQ(t, 0.0f);
+    EXPECT_FALSE(Intersect(ray3(fvec3(0.0f), fvec3(1.0f)), aabb3(), 0.0f, 100.0f, t));
+
+    // Rays lying in a slab plane give 0 * inf = NaN on that axis, the scalar and 8-wide tests must both ignore it
+    const aabb3 cube(fvec3(0.0f), fvec3(1.0f));
+    aabb3x8 cubes;
+    cubes.Set(0, cube);
+
+    for(uin32 axis = 0; axis < 3; axis++)
+    {
+        for(flt32 plane : { 0.0f, 1.0f })
+        {
+            flt32 origin[3] = { 0.5f, 0.5f, 0.5f }, direction[3] = { 0.0f, 0.0f, 0.0f };
+            const uin32 along = (axis + 1) % 3;
+
+            origin[axis] = plane;
+            origin[along] = -1.0f;
+            direction[along] = 1.0f;
+
+            const ray3 r(fvec3(origin[0], origin[1], origin[2]), fvec3(direction[0], direction[1], direction[2]));
+            flt32 entries[8];
+
+            EXPECT_TRUE(Intersect(r, cube, 0.0f, 100.0f, t));
+            EXPECT_FLOAT_EQ(t, 1.0f);
+            EXPECT_EQ(Intersect(r, cubes, 0.0f, 100.0f, entries), 1u);
+            EXPECT_FLOAT_EQ(entries[0], 1.0f);
+        }
+    }
+
+    uin32 state = 3u;
+
+    for(uin32 iteration = 0; iteration < 64; iteration++)
+    {
+        aabb3x8 boxes;
+        aabb3 reference[8];
+
+        // Lane 7 stays empty
+        for(uin32 lane = 0; lane < 7; lane++)
+        {
+            const fvec3 c = TestPoint(state, 20.0f);
+            const fvec3 e(std::abs(TestRandom(state, 6.0f)), std::abs(TestRandom(state, 6.0f)), std::abs(TestRandom(state, 6.0f)));
+
+            reference[lane] = aabb3(c - e, c + e);
+            boxes.Set(lane, reference[lane]);
+        }
+
+        const fvec3 direction(TestRandom(state, 2.0f), TestRandom(state, 2.0f), iteration % 4 == 0 ? 0.0f : TestRandom(state, 2.0f));
+        const ray3 r(TestPoint(state, 30.0f), direction);
+
+        flt32 entries[8];
+        const uin32 mask = Intersect(r, boxes, 0.0f, 50.0f, entries);
+
+        EXPECT_EQ(mask & 0x80u, 0u);
+
+        for(uin32 lane = 0; lane < 7; lane++)
+        {
+            const bln8 hit = Intersect(r, reference[lane], 0.0f, 50.0f, t);
+
+            EXPECT_EQ(((mask >> lane) & 1u) != 0, hit);
+            if(hit)
+            {
+                EXPECT_NEAR(entries[lane], t, 1e-4f);
+            }
+        }
+    }
+
+    LOG_D("Test Successful: aabb3 Ray Slab");
+}
+
+TEST(aabb3, Operations)
+{
+    AabbOperations();
+}
+
+TEST(aabb3, Ray_Slab)
+{
+    AabbRaySlab();
+}
+
+void FrustumPlanes()
+{
+    const frustum f(LookAt(fvec3(0.0f), fvec3(0.0f, 0.0f, 1.0f)) * Perspective(1.5707963f, 1.0f, 0.1f, 100.0f));
+
+    EXPECT_NEAR(f.Distance(frustum::Near, fvec3(0.0f, 0.0f, 50.0f)), 49.9f, 1e-3f);
+    EXPECT_NEAR(f.Distance(frustum::Far, fvec3(0.0f, 0.0f, 50.0f)), 50.0f, 1e-3f);
+    EXPECT_NEAR(f.Distance(frustum::Left, fvec3(0.0f, 0.0f, 10.0f)), 10.0f / std::sqrt(2.0f), 1e-4f);
+
+    EXPECT_TRUE(Intersect(f, fvec3(0.0f, 0.0f, 10.0f), 1.0f));
+    EXPECT_FALSE(Intersect(f, fvec3(0.0f, 0.0f, -10.0f), 1.0f));
+    EXPECT_FALSE(Intersect(f, fvec3(0.0f, 0.0f, 200.0f), 1.0f));
+    EXPECT_TRUE(Intersect(f, fvec3(0.0f, 0.0f, 101.0f), 2.0f));
+    EXPECT_FALSE(Intersect(f, fvec3(20.0f, 0.0f, 10.0f), 1.0f));
+    EXPECT_TRUE(Intersect(f, fvec3(10.5f, 0.0f, 10.0f), 1.0f));
+    EXPECT_FALSE(Intersect(f, fvec3(0.0f, -12.0f, 10.0f), 1.0f));
+
+    EXPECT_TRUE(Intersect(f, aabb3(fvec3(-1.0f, -1.0f, 5.0f), fvec3(1.0f, 1.0f, 6.0f))));
+    EXPECT_TRUE(Intersect(f, aabb3(fvec3(-1.0f, -1.0f, -5.0f), fvec3(1.0f, 1.0f, 6.0f))));
+    EXPECT_FALSE(Intersect(f, aabb3(fvec3(-1.0f, -1.0f, -6.0f), fvec3(1.0f, 1.0f, -5.0f))));
+    EXPECT_FALSE(Intersect(f, aabb3(fvec3(30.0f, -1.0f, 5.0f), fvec3(31.0f, 1.0f, 6.0f))));
+
+    LOG_D("Test Successful: frustum Planes");
+}
+
+void FrustumCullCount(uin32 count)
+{
+    const frustum f(LookAt(fvec3(1.0f, 2.0f, -3.0f), fvec3(4.0f, 0.0f, 20.0f)) * Perspective(1.2f, 1.5f, 0.5f, 60.0f));
+
+    uin32 state = 11u;
+
+    fvec3_soa centers(count), lower(count), upper(count);
+    std::vector<flt32> radii(count);
+
+    for(uin32 i = 0; i < count; i++)
+    {
+        const fvec3 c(TestRandom(state, 120.0f), TestRandom(state, 120.0f), TestRandom(state, 140.0f));
+        const fvec3 e(std::abs(TestRandom(state, 8.0f)), std::abs(TestRandom(state, 8.0f)), std::abs(TestRandom(state, 8.0f)));
+
+        centers.Set(i, c);
+        radii[i] = e.x;
+        lower.Set(i, c - e);
+        upper.Set(i, c + e);
+    }
+
+    std::vector<uin32> visible(count);
+
+    const uin32 spheres = CullSpheres(f, centers, radii.data(), visible.data());
+    std::vector<uin32> expected;
+
+    for(uin32 i = 0; i < count; i++)
+    {
+        if(Intersect(f, centers[i], radii[i]))
+        {
+            expected.push_back(i);
+        }
+    }
+
+    ASSERT_EQ(spheres, expected.size());
+    EXPECT_GT(spheres, 0u);
+    EXPECT_LT(spheres, count);
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), visible.begin()));
+
+    const uin32 boxes = CullBoxes(f, lower, upper, visible.data());
+    expected.clear();
+
+    for(uin32 i = 0; i < count; i++)
+    {
+        if(Intersect(f, aabb3(lower[i], upper[i])))
+        {
+            expected.push_back(i);
+        }
+    }
+
+    ASSERT_EQ(boxes, expected.size());
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), visible.begin()));
+
+    EXPECT_EQ(CullSpheres(f, fvec3_soa(), nullptr, visible.data()), 0u);
+}
+
+void FrustumCull()
+{
+    // Not a multiple of 8, so the tail block is exercised too
+    FrustumCullCount(1003);
+
+    // Several tasks with the thread count forced, so the range splits and the packing of their survivors run on any host
+    const uin32 count = 2 * CullGrain + 1003;
+
+    SetThreadCount(4);
+    EXPECT_GT(TaskCount(count, CullGrain), 1u);
+    FrustumCullCount(count);
+    SetThreadCount(0);
+
+    LOG_D("Test Successful: frustum Cull");
+}
+
+TEST(frustum, Planes)
+{
+    FrustumPlanes();
+}
+
+TEST(frustum, Cull)
+{
+    FrustumCull();
+}
+
+void TriangleIntersect()
+{
+    const ray3 r(fvec3(0.25f, 0.25f, 0.0f), fvec3(0.0f, 0.0f, 1.0f));
+    const fvec3 a(0.0f, 0.0f, 5.0f), b(1.0f, 0.0f, 5.0f), c(0.0f, 1.0f, 5.0f);
+
+    rayhit hit;
+    EXPECT_FALSE(hit.Hit());
+    EXPECT_TRUE(Intersect(r, a, b, c, 7u, hit));
+    EXPECT_FLOAT_EQ(hit.t, 5.0f);
+    EXPECT_FLOAT_EQ(hit.u, 0.25f);
+    EXPECT_FLOAT_EQ(hit.v, 0.25f);
+    EXPECT_EQ(hit.index, 7u);
+
+    // Nearer hits only
+    EXPECT_FALSE(Intersect(r, a + fvec3(0.0f, 0.0f, 1.0f), b + fvec3(0.0f, 0.0f, 1.0f), c + fvec3(0.0f, 0.0f, 1.0f), 8u, hit));
+    EXPECT_EQ(hit.index, 7u);
+
+    triangle8 packet;
+    packet.Set(2, a + fvec3(0.0f, 0.0f, 3.0f), b + fvec3(0.0f, 0.0f, 3.0f), c + fvec3(0.0f, 0.0f, 3.0f), 12u);
+    packet.Set(5, a, c, b, 15u);
+    packet.Set(6, a - fvec3(2.0f, 0.0f, 4.0f), b - fvec3(2.0f, 0.0f, 4.0f), c - fvec3(2.0f, 0.0f, 4.0f), 16u);
+
+    for(uin32 watertight = 0; watertight < 2; watertight++)
+    {
+        rayhit packetHit;
+        EXPECT_TRUE(watertight ? IntersectWatertight(r, packet, packetHit) : Intersect(r, packet, packetHit));
+        EXPECT_EQ(packetHit.index, 15u);
+        EXPECT_NEAR(packetHit.t, 5.0f, 1e-5f);
+        EXPECT_NEAR(packetHit.u, 0.25f, 1e-5f);
+        EXPECT_NEAR(packetHit.v, 0.25f, 1e-5f);
+
+        rayhit farHit(4.0f);
+        EXPECT_FALSE(watertight ? IntersectWatertight(r, packet, farHit) : Intersect(r, packet, farHit));
+        EXPECT_FALSE(farHit.Hit());
+    }
+
+    uin32 state = 5u;
+
+    for(uin32 iteration = 0; iteration < 200; iteration++)
+    {
+        triangle8 triangles;
+        fvec3 vertices[8][3];
+
+        for(uin32 lane = 0; lane < 8; lane++)
+        {
+            const fvec3 center = TestPoint(state, 8.0f);
+
+            vertices[lane][0] = center + TestPoint(state, 6.0f);
+            vertices[lane][1] = center + TestPoint(state, 6.0f);
+            vertices[lane][2] = center + TestPoint(state, 6.0f);
+            triangles.Set(lane, vertices[lane][0], vertices[lane][1], vertices[lane][2], 100u + lane);
+        }
+
+        const ray3 ray(TestPoint(state, 30.0f), TestPoint(state, 2.0f));
+
+        rayhit reference, fast, watertight;
+        for(uin32 lane = 0; lane < 8; lane++)
+        {
+            Intersect(ray, vertices[lane][0], vertices[lane][1], vertices[lane][2], 100u + lane, reference);
+        }
+
+        Intersect(ray, triangles, fast);
+        IntersectWatertight(ray, triangles, watertight);
+
+        EXPECT_EQ(fast.index, reference.index);
+        EXPECT_EQ(watertight.index, reference.index);
+
+        if(reference.Hit())
+        {
+            EXPECT_NEAR(fast.t, reference.t, 1e-3f);
+            EXPECT_NEAR(watertight.t, reference.t, 1e-3f);
+            EXPECT_NEAR(watertight.u, reference.u, 1e-3f);
+            EXPECT_NEAR(watertight.v, reference.v, 1e-3f);
+        }
+    }
+
+    LOG_D("Test Successful: triangle Intersect");
+}
+
+void TriangleWatertight()
+{
+    // A quad split along its diagonal, every ray aims at a point on the shared edge
+    triangle8 quad;
+    quad.Set(0, fvec3(0.1f, 0.3f, 2.7f), fvec3(3.3f, 0.2f, 2.9f), fvec3(3.1f, 3.7f, 3.3f), 0u);
+    quad.Set(1, fvec3(0.1f, 0.3f, 2.7f), fvec3(3.1f, 3.7f, 3.3f), fvec3(0.3f, 3.1f, 3.1f), 1u);
+
+    const fvec3 from(0.1f, 0.3f, 2.7f), to(3.1f, 3.7f, 3.3f);
+
+    uin32 state = 9u;
+    uin32 missed = 0;
+
+    for(uin32 iteration = 0; iteration < 4000; iteration++)
+    {
+        const flt32 s = flt32((TestRandom(state) >> 8) % 1000 + 1) / 1002.0f;
+        const fvec3 origin(flt32(TestRandom(state) % 17) - 8.0f, flt32(TestRandom(state) % 13) - 6.0f, -5.0f);
+
+        rayhit hit;
+        missed += !IntersectWatertight(ray3(origin, from + (to - from) * s - origin), quad, hit);
+    }
+
+    EXPECT_EQ(missed, 0u);
+
+    LOG_D("Test Successful: triangle Watertight");
+}
+
+TEST(triangle8, Intersect)
+{
+    TriangleIntersect();
+}
+
+TEST(triangle8, Watertight)
+{
+    TriangleWatertight();
+}
+
+void BvhBuildTraverse(uin32 count)
+{
+    uin32 state = 21u + count;
+
+    // A triangle soup with a dense cluster, so the SAH splits are uneven
+    std::vector<fvec3> vertices(3 * count);
+    std::vector<uin32> indices(3 * count);
+
+    for(uin32 i = 0; i < count; i++)
+    {
+        const fvec3 center = i % 4 == 0 ? TestPoint(state, 5.0f) : TestPoint(state, 100.0f);
+
+        for(uin32 k = 0; k < 3; k++)
+        {
+            vertices[3 * i + k] = center + TestPoint(state, 4.0f);
+            indices[3 * i + k] = 3 * i + (2 - k);
+        }
+    }
+
+    const bvh8 bvh(vertices.data(), indices.data(), count);
+
+    // Every triangle lands in exactly one leaf lane
+    std::vector<uin32> seen(count, 0);
+    for(const triangle8& leaf : bvh.leaves)
+    {
+        for(uin32 lane = 0; lane < 8; lane++)
+        {
+            if(leaf.index[lane] != rayhit::NoHit)
+            {
+                seen[leaf.index[lane]]++;
+            }
+        }
+    }
+
+    EXPECT_EQ(std::count(seen.begin(), seen.end(), 1u), count);
+
+    auto corner = [&](uin32 i, uin32 k) { return vertices[indices[3 * i + k]]; };
+
+    for(uin32 iteration = 0; iteration < 100; iteration++)
+    {
+        // Aimed at a triangle most of the time, so most rays hit something
+        const uin32 target = TestRandom(state) % count;
+        const fvec3 origin = TestPoint(state, 150.0f);
+        const fvec3 direction = iteration % 4 ? (corner(target, 0) + corner(target, 1) + corner(target, 2)) / 3.0f - origin : TestPoint(state, 2.0f);
+        const ray3 r(origin, direction);
+
+        rayhit expected;
+        for(uin32 i = 0; i < count; i++)
+        {
+            Intersect(r, corner(i, 0), corner(i, 1), corner(i, 2), i, expected);
+        }
+
+        rayhit hit;
+        EXPECT_EQ(Intersect(bvh, r, hit), expected.Hit());
+        EXPECT_EQ(hit.index, expected.index);
+        if(expected.Hit())
+        {
+            EXPECT_NEAR(hit.t, expected.t, 1e-3f);
+        }
+
+        EXPECT_EQ(IntersectAny(bvh, r, 0.0f, std::numeric_limits<flt32>::infinity()), expected.Hit());
+        if(expected.Hit())
+        {
+            EXPECT_FALSE(IntersectAny(bvh, r, 0.0f, expected.t * 0.999f));
+        }
+    }
+
+    for(uin32 iteration = 0; iteration < 20; iteration++)
+    {
+        const fvec3 center = TestPoint(state, 100.0f);
+        const aabb3 query(center - fvec3(10.0f), center + fvec3(10.0f));
+
+        std::vector<uin32> found;
+        const uin32 n = Overlap(bvh, query, found);
+        EXPECT_EQ(n, found.size());
+
+        std::vector<uin32> expected;
+        for(uin32 i = 0; i < count; i++)
+        {
+            if(Overlaps(query, aabb3().Expand(corner(i, 0)).Expand(corner(i, 1)).Expand(corner(i, 2))))
+            {
+                expected.push_back(i);
+            }
+        }
+
+        std::sort(found.begin(), found.end());
+        EXPECT_EQ(found, expected);
+    }
+}
+
+TEST(bvh8, Build_Traverse)
+{
+    BvhBuildTraverse(5);
+    BvhBuildTraverse(3001);
+
+    const bvh8 empty(nullptr, nullptr, 0);
+    rayhit hit;
+    std::vector<uin32> found;
+    EXPECT_FALSE(Intersect(empty, ray3(fvec3(0.0f), fvec3(1.0f)), hit));
+    EXPECT_FALSE(IntersectAny(empty, ray3(fvec3(0.0f), fvec3(1.0f)), 0.0f, 1.0f));
+    EXPECT_EQ(Overlap(empty, aabb3(fvec3(-1.0f), fvec3(1.0f)), found), 0u);
+
+    LOG_D("Test Successful: bvh8 Build Traverse");
+}
+
+// A 32x32 height field split into 2048 triangles
+void BvhTerrain(std::vector<fvec3>& vertices, std::vector<uin32>& indices)
+{
+    constexpr uin32 size = 32;
+
+    for(uin32 z = 0; z <= size; z++)
+    {
+        for(uin32 x = 0; x <= size; x++)
+        {
+            vertices.push_back(fvec3(flt32(x), std::sin(flt32(x) * 0.7f) * std::cos(flt32(z) * 0.4f) * 3.0f, flt32(z)));
+        }
+    }
+
+    for(uin32 z = 0; z < size; z++)
+    {
+        for(uin32 x = 0; x < size; x++)
+        {
+            const uin32 i = z * (size + 1) + x;
+
+            indices.insert(indices.end(), { i, i + 1, i + size + 2, i, i + size + 2, i + size + 1 });
+        }
+    }
+}
+
+void RayPacketStream()
+{
+    std::vector<fvec3> vertices;
+    std::vector<uin32> indices;
+    BvhTerrain(vertices, indices);
+
+    const bvh8 bvh(vertices.data(), indices.data(), static_cast<uin32>(indices.size() / 3));
+
+    uin32 state = 31u;
+
+    // Camera rays over the terrain, then incoherent ones, and a count that leaves a partial packet
+    std::vector<ray3> rays;
+    for(uin32 y = 0; y < 24; y++)
+    {
+        for(uin32 x = 0; x < 40; x++)
+        {
+            rays.push_back(ray3(fvec3(16.0f, 12.0f, -10.0f), fvec3(flt32(x) / 40.0f - 0.5f, -0.2f - flt32(y) / 40.0f, 1.0f)));
+        }
+    }
+
+    for(uin32 i = 0; i < 61; i++)
+    {
+        rays.push_back(ray3(fvec3(16.0f + TestRandom(state, 40.0f), TestRandom(state, 20.0f), 16.0f + TestRandom(state, 40.0f)), TestPoint(state, 2.0f)));
+    }
+
+    const uin32 count = static_cast<uin32>(rays.size());
+
+    std::vector<rayhit> expected(count);
+    std::vector<flt32> tMax(count);
+    uin32 hits = 0;
+
+    for(uin32 i = 0; i < count; i++)
+    {
+        hits += Intersect(bvh, rays[i], expected[i]);
+        tMax[i] = expected[i].Hit() ? (i % 2 ? expected[i].t * 0.5f : expected[i].t * 2.0f) : 100.0f;
+    }
+
+    EXPECT_GT(hits, count / 2);
+
+    std::vector<rayhit> streamed(count);
+    IntersectStream(bvh, rays.data(), streamed.data(), count);
+
+    for(uin32 i = 0; i < count; i++)
+    {
+        EXPECT_EQ(streamed[i].index, expected[i].index);
+        EXPECT_FLOAT_EQ(streamed[i].t, expected[i].t);
+    }
+
+    // A packet with holes leaves the inactive hits untouched
+    rayhit packet[8];
+    const uin32 found = IntersectPacket(bvh, rays.data() + 500, packet, 0x5Bu);
+
+    for(uin32 lane = 0; lane < 8; lane++)
+    {
+        const bln8 on = (0x5Bu >> lane) & 1u;
+
+        EXPECT_EQ((found >> lane) & 1u, on && expected[500 + lane].Hit() ? 1u : 0u);
+        EXPECT_EQ(packet[lane].index, on ? expected[500 + lane].index : rayhit::NoHit);
+    }
+
+    std::unique_ptr<bln8[]> occluded(new bln8[count]);
+    uin32 expectedOccluded = 0;
+
+    const uin32 occludedCount = IntersectAnyStream(bvh, rays.data(), tMax.data(), occluded.get(), count);
+
+    for(uin32 i = 0; i < count; i++)
+    {
+        const bln8 blocked = IntersectAny(bvh, rays[i], 0.0f, tMax[i]);
+
+        expectedOccluded += blocked;
+        EXPECT_EQ(occluded[i], blocked);
+    }
+
+    EXPECT_EQ(occludedCount, expectedOccluded);
+
+    LOG_D("Test Successful: ray Packet Stream");
+}
+
+TEST(bvh8, Packet_Stream)
+{
+    RayPacketStream();
+}
+
+void TransformHierarchy()
+{
+    uin32 state = 17u;
+    auto rotation = [&state]() { return Normalise(fquat(TestRandom(state, 2.0f), TestRandom(state, 2.0f), TestRandom(state, 2.0f), TestRandom(state, 2.0f))); };
+
+    const fvec3 p(1.0f, -2.0f, 0.5f), s(1.5f, 0.5f, 2.0f);
+    const fquat q = rotation();
+    const fmat4x4 trs = Scale(s) * ToRotationMatrix(q) * Translate(p);
+    EXPECT_MAT4_NEAR(Compose(p, q, s), trs, 1e-5f);
+
+    constexpr uin32 count = 3000;
+
+    transform_hierarchy hierarchy;
+    std::vector<uin32> parents(count);
+
+    // Mostly shallow and bushy, with a long chain so some levels are a single node
+    for(uin32 i = 0; i < count; i++)
+    {
+        parents[i] = i < 4 ? transform_hierarchy::None : i < 40 ? i - 1 : TestRandom(state) % i;
+
+        EXPECT_EQ(hierarchy.Add(parents[i], TestPoint(state, 2.0f), rotation(), fvec3(1.0f + TestRandom(state, 0.2f))), i);
+    }
+
+    auto check = [&]()
+    {
+        // Parents come before their children, so one pass in handle order is enough
+        std::vector<fmat4x4> expected(count);
+
+        for(uin32 i = 0; i < count; i++)
+        {
+            const uin32 slot = hierarchy.slots[i];
+            const fmat4x4 local = Compose(hierarchy.positions[slot], hierarchy.rotations[slot], hierarchy.scales[slot]);
+
+            expected[i] = parents[i] == transform_hierarchy::None ? local : local * expected[parents[i]];
+            EXPECT_MAT4_NEAR(hierarchy.World(i), expected[i], 1e-3f);
+        }
+    };
+
+    EXPECT_EQ(hierarchy.Update(), count);
+    check();
+
+    for(uin32 d = 0; d + 1 < hierarchy.levels.size(); d++)
+    {
+        for(uin32 s = hierarchy.levels[d]; s < hierarchy.levels[d + 1]; s++)
+        {
+            EXPECT_TRUE(d == 0 ? hierarchy.parents[s] == transform_hierarchy::None : hierarchy.parents[s] >= hierarchy.levels[d - 1] && hierarchy.parents[s] < hierarchy.levels[d]);
+        }
+    }
+
+    EXPECT_EQ(hierarchy.Update(), 0u);
+
+    // A few changed nodes, one inside the subtree of another, recompute exactly their subtrees
+    const uin32 changed[] = { 2000, 35, 37, 2999, 37 };
+    std::vector<uin8> affected(count, 0);
+
+    for(uin32 node : changed)
+    {
+        hierarchy.SetLocal(node, TestPoint(state, 2.0f), rotation(), fvec3(1.0f));
+        affected[node] = 1;
+    }
+
+    for(uin32 i = 0; i < count; i++)
+    {
+        affected[i] |= parents[i] != transform_hierarchy::None && affected[parents[i]];
+    }
+
+    EXPECT_EQ(hierarchy.Update(), static_cast<uin32>(std::count(affected.begin(), affected.end(), 1)));
+    check();
+
+    // Past a sixteenth of the nodes the changes are found by their flags instead of sorted
+    std::fill(affected.begin(), affected.end(), 0);
+
+    for(uin32 node = 7; node < count; node += 9)
+    {
+        hierarchy.SetLocal(node, TestPoint(state, 2.0f), rotation(), fvec3(1.0f));
+        affected[node] = 1;
+    }
+
+    for(uin32 i = 0; i < count; i++)
+    {
+        affected[i] |= parents[i] != transform_hierarchy::None && affected[parents[i]];
+    }
+
+    EXPECT_EQ(hierarchy.Update(), static_cast<uin32>(std::count(affected.begin(), affected.end(), 1)));
+    check();
+
+    // Every root changed turns into a full update from the first level
+    for(uin32 i = 0; i < 4; i++)
+    {
+        hierarchy.SetLocal(i, TestPoint(state, 2.0f), rotation(), fvec3(1.0f));
+    }
+
+    EXPECT_EQ(hierarchy.Update(), count);
+    check();
+
+    // Nodes added under existing ones reorder the slots and recompute everything once
+    parents.push_back(12);
+    hierarchy.Add(12, fvec3(1.0f), fquat(1.0f, 0.0f, 0.0f, 0.0f), fvec3(1.0f));
+    parents.push_back(count);
+    hierarchy.Add(count, fvec3(0.0f, 1.0f, 0.0f), rotation(), fvec3(2.0f));
+    hierarchy.SetLocal(5, fvec3(0.5f), rotation(), fvec3(1.0f));
+
+    EXPECT_EQ(hierarchy.Update(), count + 2);
+
+    for(uin32 i = 0; i < count + 2; i++)
+    {
+        const uin32 slot = hierarchy.slots[i];
+        const fmat4x4 local = Compose(hierarchy.positions[slot], hierarchy.rotations[slot], hierarchy.scales[slot]);
+        const fmat4x4 expected = parents[i] == transform_hierarchy::None ? local : local * hierarchy.World(parents[i]);
+
+        EXPECT_MAT4_NEAR(hierarchy.World(i), expected, 1e-3f);
+    }
+
+    EXPECT_EQ(transform_hierarchy().Update(), 0u);
+
+    LOG_D("Test Successful: transform_hierarchy Update");
+}
+
+void TransformHierarchyParallel()
+{
+    // Two roots over two levels of 40000 nodes, so a single changed root still lists more than two grains per level
+    constexpr uin32 width = 40000;
+    constexpr uin32 count = 2 + 2 * width;
+
+    uin32 state = 23u;
+    transform_hierarchy threaded, serial;
+
+    for(uin32 i = 0; i < count; i++)
+    {
+        const uin32 parent = i < 2 ? transform_hierarchy::None : i < 2 + width ? i % 2 : 2 + TestRandom(state) % width;
+        const fvec3 position = TestPoint(state, 2.0f);
+        const fquat rotation = Normalise(fquat(TestRandom(state, 2.0f), TestRandom(state, 2.0f), TestRandom(state, 2.0f), TestRandom(state, 2.0f)));
+
+        threaded.Add(parent, position, rotation, fvec3(1.0f));
+        serial.Add(parent, position, rotation, fvec3(1.0f));
+    }
+
+    // The same update on both, with the level splits forced on one of them, must give the same matrices
+    auto update = [&]()
+    {
+        SetThreadCount(4);
+        EXPECT_GT(TaskCount(width / 2, transform_hierarchy::UpdateGrain), 1u);
+        const uin32 computed = threaded.Update();
+        SetThreadCount(1);
+        EXPECT_EQ(serial.Update(), computed);
+        SetThreadCount(0);
+
+        uin32 mismatches = 0;
+
+        for(uin32 i = 0; i < count; i++)
+        {
+            const fmat4x4 a = threaded.World(i), b = serial.World(i);
+            mismatches += std::memcmp(&a, &b, sizeof(fmat4x4)) != 0;
+        }
+
+        EXPECT_EQ(mismatches, 0u);
+
+        return computed;
+    };
+
+    auto set = [&](uin32 node)
+    {
+        const fvec3 position = TestPoint(state, 2.0f);
+        const fquat rotation = Normalise(fquat(TestRandom(state, 2.0f), TestRandom(state, 2.0f), TestRandom(state, 2.0f), TestRandom(state, 2.0f)));
+
+        threaded.SetLocal(node, position, rotation, fvec3(1.0f));
+        serial.SetLocal(node, position, rotation, fvec3(1.0f));
+    };
+
+    // Full update
+    EXPECT_EQ(update(), count);
+
+    // Sparse: one root, its subtree listed level by level
+    set(0);
+    const uin32 sparse = update();
+    EXPECT_GT(sparse, 2 * transform_hierarchy::UpdateGrain);
+    EXPECT_LT(sparse, count);
+
+    // Flagged: more than a sixteenth of the nodes changed
+    for(uin32 node = 3; node < count; node += 9)
+    {
+        set(node);
+    }
+
+    const uin32 flagged = update();
+    EXPECT_GT(flagged, count / 16);
+    EXPECT_LT(flagged, count);
+
+    LOG_D("Test Successful: transform_hierarchy Parallel Update");
+}
+
+TEST(transform_hierarchy, Update)
+{
+    TransformHierarchy();
+}
+
+TEST(transform_hierarchy, Parallel_Update)
+{
+    TransformHierarchyParallel();
+}
@@ -1,6 +1,9 @@
 #include "enma.hpp"
 #include "gtest/gtest.h"
 #include <cmath>
+#include <cstring>
+#include <type_traits>
+#include <vector>
 
 #define EXPECT_VEC2_EQ(v1, v2)              \
 do                                          \
@@ -408,6 +411,16 @@ void Vec4Lerp()
     EXPECT_VEC4_EQ(v2, Lerp(v1, v2, 1.0f));
 }
 
+void Vec4Normalise()
+{
+    // Divides by the length, not the squared length
+    EXPECT_VEC4_EQ(Normalise(vec4(2, 4, 4, 0)), vec4(1.0f / 3.0f, 2.0f / 3.0f, 2.0f / 3.0f, 0.0f));
+
+    vec4 v(0, 0, 3, 4);
+    v.Normalise();
+    EXPECT_VEC4_EQ(v, vec4(0.0f, 0.0f, 0.6f, 0.8f));
+}
+
 void Vec4ArithmeticTests()
 {
     Vec4Add();
@@ -452,6 +465,500 @@ TEST(vec4, Linear_Interpolation)
     Vec4Lerp();
 }
 
+TEST(vec4, Normalisation)
+{
+    Vec4Normalise();
+}
+
+void Vec3SoaArithmetic()
+{
+    vec3 a[11], b[11];
+
+    for(int32 i = 0; i < 11; i++)
+    {
+        a[i] = vec3(i, 2 * i + 1, 3 - i);
+        b[i] = vec3(4 - i, i, 2 * i + 2);
+    }
+
+    fvec3_soa sa(a, 11);
+    fvec3_soa sb(b, 11);
+    fvec3_soa sr(11);
+
+    Add(sa, sb, sr);
+    for(int32 i = 0; i < 11; i++) EXPECT_VEC3_EQ(sr[i], (a[i] + b[i]));
+
+    Sub(sa, sb, sr);
+    for(int32 i = 0; i < 11; i++) EXPECT_VEC3_EQ(sr[i], (a[i] - b[i]));
+
+    Fma(sa, sb, sb, sr);
+    for(int32 i = 0; i < 11; i++) EXPECT_VEC3_EQ(sr[i], (a[i] * b[i] + b[i]));
+
+    Cross(sa, sb, sr);
+    for(int32 i = 0; i < 11; i++) EXPECT_VEC3_EQ(sr[i], Cross(a[i], b[i]));
+
+    Lerp(sa, sb, 0.5f, sr);
+    for(int32 i = 0; i < 11; i++) EXPECT_VEC3_EQ(sr[i], Lerp(a[i], b[i], 0.5f));
+
+    // Sized to the count plus one guard element, nothing past the count may be written
+    flt32 dots[12];
+    dots[11] = -1.0f;
+    Dot(sa, sb, dots);
+    for(int32 i = 0; i < 11; i++) EXPECT_FLOAT_EQ(dots[i], Dot(a[i], b[i]));
+    EXPECT_EQ(dots[11], -1.0f);
+
+    Distance(sa, sb, dots);
+    for(int32 i = 0; i < 11; i++) EXPECT_FLOAT_EQ(dots[i], Distance(a[i], b[i]));
+    EXPECT_EQ(dots[11], -1.0f);
+
+    LOG_D("Test Successful: vec3 SoA Arithmetic");
+}
+
+void Vec3SoaNormalise()
+{
+    vec3 a[9];
+
+    for(int32 i = 0; i < 9; i++)
+    {
+        a[i] = vec3(i + 1, 2, -i);
+    }
+
+    fvec3_soa sa(a, 9);
+    sa.Normalise();
+
+    flt32 dist[16];
+    fvec3_soa zero(9);
+    Distance(sa, zero, dist);
+
+    for(int32 i = 0; i < 9; i++)
+    {
+        EXPECT_VEC3_EQ(sa[i], Normalise(a[i]));
+        EXPECT_NEAR(dist[i], 1.0f, 1e-6f);
+    }
+
+    // A zero-length vector and the padding lanes normalise to zero, not NaN
+    sa.Set(4, vec3(0.0f));
+    sa.Normalise();
+    EXPECT_VEC3_EQ(sa[4], vec3(0.0f));
+
+    for(uin32 i = 9; i < sa.capacity; i++)
+    {
+        EXPECT_EQ(sa.x[i], 0.0f);
+        EXPECT_EQ(sa.y[i], 0.0f);
+        EXPECT_EQ(sa.z[i], 0.0f);
+    }
+
+    LOG_D("Test Successful: vec3 SoA Normalise");
+}
+
+TEST(vec3_soa, Arithmetic)
+{
+    Vec3SoaArithmetic();
+}
+
+TEST(vec3_soa, Normalise)
+{
+    Vec3SoaNormalise();
+}
+
+void SinCosAccuracy()
+{
+    alignas(32) flt32 angles[8];
+
+    for(flt32 base = -200.0f; base < 200.0f; base += 0.37f)
+    {
+        for(int32 i = 0; i < 8; i++)
+            angles[i] = base + i * 0.041f;
+
+        flt32 s, c;
+        SinCos(angles[0], s, c);
+        EXPECT_NEAR(s, std::sin(angles[0]), 1e-6f);
+        EXPECT_NEAR(c, std::cos(angles[0]), 1e-6f);
+
+        SinCos(angles[0], s, c, SinCosPrecision::Fast);
+        EXPECT_NEAR(s, std::sin(angles[0]), 1.5e-5f);
+        EXPECT_NEAR(c, std::cos(angles[0]), 1.5e-5f);
+
+        fvec4 vs, vc;
+        SinCos(fvec4(angles[0], angles[1], angles[2], angles[3]), vs, vc);
+        EXPECT_NEAR(vs.y, std::sin(angles[1]), 1e-6f);
+        EXPECT_NEAR(vc.w, std::cos(angles[3]), 1e-6f);
+
+        #ifdef USE_SIMD
+        // The 8-wide overload is built for AVX2 whatever the compile flags, so the host decides whether it runs.
+        // The registers are filled with memcpy since this function itself may not be compiled for AVX
+        if(GetSimdLevel() >= SimdLevel::AVX2)
+        {
+            alignas(32) flt32 sines[8], cosines[8];
+            __m256 wa, ws, wc;
+            std::memcpy(&wa, angles, sizeof(wa));
+            SinCos(wa, ws, wc);
+            std::memcpy(sines, &ws, sizeof(ws));
+            std::memcpy(cosines, &wc, sizeof(wc));
+
+            for(int32 i = 0; i < 8; i++)
+            {
+                EXPECT_NEAR(sines[i], std::sin(angles[i]), 1e-6f);
+                EXPECT_NEAR(cosines[i], std::cos(angles[i]), 1e-6f);
+            }
+        }
+        #endif
+    }
+
+    LOG_D("Test Successful: SinCos Accuracy");
+}
+
+TEST(sincos, Accuracy)
+{
+    SinCosAccuracy();
+}
+
+// Distance of `value` from the exact `reference` in units of the last place of the rounded reference
+flt64 UlpError(flt32 value, flt64 reference)
+{
+    const flt32 rounded = std::abs(static_cast<flt32>(reference));
+
+    return std::abs(value - reference) / (std::nextafter(rounded, INFINITY) - rounded);
+}
+
+// Near a multiple of PI/2 one of the results is tiny, so any error left by the range reduction shows up as many ULP
+void SinCosNearMultiples()
+{
+    for(int32 k = -40; k <= 40; k++)
+    {
+        const flt32 multiple = static_cast<flt32>(k * 1.57079632679489661923);
+        flt32 below = multiple, above = multiple;
+
+        for(int32 i = 0; i < 64; i++)
+        {
+            for(const flt32 x : { below, above })
+            {
+                flt32 s, c;
+                SinCos(x, s, c);
+                EXPECT_LE(UlpError(s, std::sin(static_cast<flt64>(x))), 1.5) << x;
+                EXPECT_LE(UlpError(c, std::cos(static_cast<flt64>(x))), 1.5) << x;
+
+                fvec4 vs, vc;
+                SinCos(fvec4(x), vs, vc);
+                EXPECT_LE(UlpError(vs.z, std::sin(static_cast<flt64>(x))), 1.5) << x;
+                EXPECT_LE(UlpError(vc.z, std::cos(static_cast<flt64>(x))), 1.5) << x;
+            }
+
+            below = std::nextafter(below, -INFINITY);
+            above = std::nextafter(above, INFINITY);
+        }
+    }
+
+    LOG_D("Test Successful: SinCos Near Multiples");
+}
+
+TEST(sincos, Near_Multiples)
+{
+    SinCosNearMultiples();
+}
+
+static_assert(std::is_trivially_copyable_v<vec2> && std::is_trivially_copyable_v<vec3> && std::is_trivially_copyable_v<vec4>);
+static_assert(std::is_trivially_copyable_v<ivec2> && std::is_trivially_copyable_v<ivec3> && std::is_trivially_copyable_v<ivec4>);
+static_assert(std::is_trivially_copyable_v<uvec2> && std::is_trivially_copyable_v<uvec3> && std::is_trivially_copyable_v<uvec4>);
+static_assert(std::is_trivially_copyable_v<bvec2> && std::is_trivially_copyable_v<bvec3> && std::is_trivially_copyable_v<bvec4>);
+static_assert(std::is_trivially_copyable_v<quat> && std::is_trivially_copyable_v<mat3x4> && std::is_trivially_copyable_v<mat4>);
+
+static_assert(vec3::forward.z == 1.0f && vec4::one.w == 1.0f && ivec2::left.x == -1);
+static_assert(mat4::identity.m44 == 1.0f && mat4::zero.m11 == 0.0f && mat3x4::identity.m33 == 1.0f);
+
+void TrivialCopy()
+{
+    constexpr vec3 a(1.0f, 2.0f, 3.0f);
+    constexpr vec4 b(a, 4.0f);
+    constexpr quat q(1.0f, vec3::up);
+
+    std::vector<vec4> src(33, b);
+    std::vector<vec4> dst(src.size());
+    std::memcpy(dst.data(), src.data(), src.size() * sizeof(vec4));
+
+    src.resize(257, vec4::neg);
+    EXPECT_VEC4_EQ(src[32], b);
+    EXPECT_VEC4_EQ(src[256], vec4::neg);
+    EXPECT_VEC4_EQ(dst[17], b);
+
+    quat qc = q;
+    EXPECT_FLOAT_EQ(qc.w, 1.0f);
+    EXPECT_FLOAT_EQ(qc.y, 1.0f);
+
+    LOG_D("Test Successful: Trivial Copy");
+}
+
+TEST(vec4, Trivial_Copy)
+{
+    TrivialCopy();
+}
+
+void IntVecArithmetic()
+{
+    const ivec4 a(7, -3, 12, -20);
+    const ivec4 b(2, 5, -4, 3);
+
+    const ivec4 sum = a + b;
+    const ivec4 prod = a * b;
+    const ivec4 shl = a << 2;
+    const ivec4 shr = a >> 1;
+
+    EXPECT_EQ(sum.x, 9);
+    EXPECT_EQ(sum.w, -17);
+    EXPECT_EQ(prod.z, -48);
+    EXPECT_EQ(prod.y, -15);
+    EXPECT_EQ(shl.y, -12);
+    EXPECT_EQ(shr.w, -10);
+    EXPECT_EQ((a & b).x, 7 & 2);
+    EXPECT_EQ((a ^ b).z, 12 ^ -4);
+    EXPECT_EQ((~a).y, ~-3);
+    EXPECT_EQ((a / b).z, -3);
+
+    EXPECT_EQ(Min(a, b).w, -20);
+    EXPECT_EQ(Max(a, b).y, 5);
+    EXPECT_EQ(Abs(a).w, 20);
+    EXPECT_EQ(Clamp(a, ivec4(-5), ivec4(5)).z, 5);
+    EXPECT_EQ(Clamp(a, ivec4(-5), ivec4(5)).w, -5);
+
+    ivec3 c(1, -2, 3);
+    c *= 3;
+    c -= ivec3(1, 1, 1);
+    EXPECT_EQ(c.x, 2);
+    EXPECT_EQ(c.y, -7);
+    EXPECT_EQ(c.z, 8);
+    EXPECT_EQ(Abs(c).y, 7);
+
+    const uvec4 u(0xFFFFFFF0u, 1u, 8u, 0x80000000u);
+    EXPECT_EQ(Min(u, uvec4(2u)).x, 2u);
+    EXPECT_EQ(Max(u, uvec4(2u)).w, 0x80000000u);
+    EXPECT_EQ((u >> 4).x, 0x0FFFFFFFu);
+    EXPECT_EQ((u + uvec4(16u)).x, 0u);
+
+    LOG_D("Test Successful: Integer Vector Arithmetic");
+}
+
+void IVec3SoaArithmetic()
+{
+    ivec3 a[13], b[13];
+
+    for(int32 i = 0; i < 13; i++)
+    {
+        a[i] = ivec3(i, -3 * i, 7 - i);
+        b[i] = ivec3(2 - i, i + 1, -i);
+    }
+
+    ivec3_soa sa(a, 13);
+    ivec3_soa sb(b, 13);
+    ivec3_soa sr(13);
+
+    Add(sa, sb, sr);
+    for(int32 i = 0; i < 13; i++) EXPECT_EQ(sr[i].y, (a[i] + b[i]).y);
+
+    Mul(sa, sb, sr);
+    for(int32 i = 0; i < 13; i++) EXPECT_EQ(sr[i].z, (a[i] * b[i]).z);
+
+    Min(sa, sb, sr);
+    for(int32 i = 0; i < 13; i++) EXPECT_EQ(sr[i].x, Min(a[i], b[i]).x);
+
+    Abs(sa, sr);
+    for(int32 i = 0; i < 13; i++) EXPECT_EQ(sr[i].y, 3 * i);
+
+    Clamp(sa, ivec3(-4), ivec3(4), sr);
+    for(int32 i = 0; i < 13; i++) EXPECT_EQ(sr[i].z, Clamp(a[i], ivec3(-4), ivec3(4)).z);
+
+    // A box that excludes zero must leave the padding lanes zero
+    Clamp(sa, ivec3(1), ivec3(5), sr);
+    for(int32 i = 0; i < 13; i++) EXPECT_EQ(sr[i].x, Clamp(a[i], ivec3(1), ivec3(5)).x);
+    for(uin32 i = 13; i < sr.capacity; i++)
+    {
+        EXPECT_EQ(sr[i].x, 0);
+        EXPECT_EQ(sr[i].y, 0);
+        EXPECT_EQ(sr[i].z, 0);
+    }
+
+    sa <<= 3;
+    sa >>= 1;
+    sa -= sb;
+    for(int32 i = 0; i < 13; i++) EXPECT_EQ(sa[i].x, a[i].x * 4 - b[i].x);
+
+    LOG_D("Test Successful: ivec3 SoA Arithmetic");
+}
+
+TEST(ivec4, Arithmetic)
+{
+    IntVecArithmetic();
+}
+
+TEST(ivec3_soa, Arithmetic)
+{
+    IVec3SoaArithmetic();
+}
+
+void DividerScalar()
+{
+    const int32 divisors[] = { 1, -1, 2, 3, 7, 16, -16, 48, 641, -1000, 0x40000000, -0x7FFFFFFF, INT32_MIN };
+    const int32 values[] = { 0, 1, -1, 15, -15, 16, -16, 17, -17, 47, -49, 12345, -12345, INT32_MAX, INT32_MIN + 1 };
+
+    for(const int32 dv : divisors)
+    {
+        const ivec_divider d(dv);
+
+        for(const int32 n : values)
+        {
+            const int32 q = n / dv;
+            const int32 r = n % dv;
+            const bool adjust = r != 0 && ((r < 0) != (dv < 0));
+
+            EXPECT_EQ(n / d, q);
+            EXPECT_EQ(n % d, r);
+            EXPECT_EQ(FloorDiv(n, d), adjust ? q - 1 : q);
+            EXPECT_EQ(FloorMod(n, d), adjust ? r + dv : r);
+        }
+    }
+
+    const uin32 udivisors[] = { 1, 2, 3, 7, 16, 48, 641, 0x80000000u, 0xFFFFFFFFu };
+    const uin32 uvalues[] = { 0, 1, 15, 16, 17, 12345, 0x7FFFFFFFu, 0x80000001u, 0xFFFFFFFFu };
+
+    for(const uin32 dv : udivisors)
+    {
+        const uvec_divider d(dv);
+
+        for(const uin32 n : uvalues)
+        {
+            EXPECT_EQ(n / d, n / dv);
+            EXPECT_EQ(n % d, n % dv);
+        }
+    }
+
+    LOG_D("Test Successful: Divider Scalar");
+}
+
+void DividerVector()
+{
+    const ivec_divider chunk(16);
+
+    const ivec4 cells(-33, -16, -1, 47);
+    const ivec4 q = FloorDiv(cells, chunk);
+    const ivec4 r = FloorMod(cells, chunk);
+    const ivec4 t = cells / chunk;
+
+    EXPECT_EQ(q.x, -3);
+    EXPECT_EQ(q.y, -1);
+    EXPECT_EQ(q.z, -1);
+    EXPECT_EQ(q.w, 2);
+    EXPECT_EQ(r.x, 15);
+    EXPECT_EQ(r.y, 0);
+    EXPECT_EQ(r.z, 15);
+    EXPECT_EQ(r.w, 15);
+    EXPECT_EQ(t.x, -2);
+    EXPECT_EQ(t.z, 0);
+    EXPECT_EQ((cells % chunk).x, -1);
+
+    const ivec3 c = FloorDiv(ivec3(-100, 100, -48), ivec_divider(48));
+    EXPECT_EQ(c.x, -3);
+    EXPECT_EQ(c.y, 2);
+    EXPECT_EQ(c.z, -1);
+
+    const uvec3 u = uvec3(100u, 7u, 0xFFFFFFFFu) / uvec_divider(7u);
+    EXPECT_EQ(u.x, 14u);
+    EXPECT_EQ(u.y, 1u);
+    EXPECT_EQ(u.z, 0xFFFFFFFFu / 7u);
+    EXPECT_EQ((uvec2(100u, 48u) % uvec_divider(48u)).x, 4u);
+
+    int32 in[21], out[21];
+    for(int32 i = 0; i < 21; i++)
+    {
+        in[i] = (i - 10) * 37;
+    }
+
+    const ivec_divider tile(-32);
+    FloorDiv(in, out, 21, tile);
+    for(int32 i = 0; i < 21; i++) EXPECT_EQ(out[i], FloorDiv(in[i], tile));
+
+    FloorMod(in, out, 21, tile);
+    for(int32 i = 0; i < 21; i++) EXPECT_EQ(out[i], FloorMod(in[i], tile));
+
+    Divide(in, out, 21, tile);
+    for(int32 i = 0; i < 21; i++) EXPECT_EQ(out[i], in[i] / -32);
+
+    ivec3 a[11];
+    for(int32 i = 0; i < 11; i++)
+    {
+        a[i] = ivec3(i * 13 - 70, -i * 5, i * 29);
+    }
+
+    ivec3_soa sa(a, 11);
+    ivec3_soa sr(11);
+    FloorDiv(sa, chunk, sr);
+    for(int32 i = 0; i < 11; i++) EXPECT_EQ(sr[i].x, FloorDiv(a[i].x, chunk));
+
+    FloorMod(sa, chunk, sr);
+    for(int32 i = 0; i < 11; i++) EXPECT_EQ(sr[i].y, FloorMod(a[i].y, chunk));
+
+    LOG_D("Test Successful: Divider Vector");
+}
+
+TEST(divider, Scalar)
+{
+    DividerScalar();
+}
+
+TEST(divider, Vector)
+{
+    DividerVector();
+}
+
+static_assert(All(pbvec(bvec3(true, true, true))) && !All(pbvec(0x7, 4)) && pbvec(bvec4(false, true, false, true)).bits == 0xA);
+
+void CompareMasks()
+{
+    const vec3 a(1.0f, -2.0f, 3.0f);
+    const vec3 b(1.0f, 2.0f, -3.0f);
+
+    EXPECT_EQ(Movemask(a == b), 0x1u);
+    EXPECT_EQ(Movemask(a < b), 0x2u);
+    EXPECT_EQ(Movemask(a <= b), 0x3u);
+    EXPECT_EQ(Movemask(a != b), 0x6u);
+    EXPECT_TRUE(Any(a > b));
+    EXPECT_FALSE(All(a >= b));
+    EXPECT_TRUE(None(a < vec3(-5.0f)));
+    EXPECT_TRUE(All(ApproxEqual(a, a + vec3(1e-6f), 1e-5f)));
+
+    const bvec3 lt = a < b;
+    EXPECT_FALSE(lt.x);
+    EXPECT_TRUE(lt.y);
+    EXPECT_FALSE(lt.z);
+
+    const vec3 lo = Select(a < b, a, b);
+    EXPECT_VEC3_EQ(lo, vec3(1.0f, -2.0f, -3.0f));
+
+    const vec4 c(0.0f, 5.0f, -1.0f, 2.0f);
+    const vec4 clamped = Select(c > vec4(1.0f), vec4(1.0f), c);
+    EXPECT_VEC4_EQ(clamped, vec4(0.0f, 1.0f, -1.0f, 1.0f));
+    EXPECT_EQ(Movemask((c > vec4(0.0f)) & (c < vec4(3.0f))), 0x8u);
+    EXPECT_EQ(Movemask(~(c == c)), 0x0u);
+
+    const ivec2 i(-4, 7);
+    EXPECT_EQ(Movemask(i < ivec2(0)), 0x1u);
+    EXPECT_EQ(Movemask(i >= ivec2(-4, 8)), 0x1u);
+    EXPECT_EQ(Select(i < ivec2(0), -i, i).x, 4);
+
+    const uvec4 u(0xFFFFFFFFu, 1u, 0x80000000u, 5u);
+    EXPECT_EQ(Movemask(u > uvec4(2u)), 0xDu);
+    EXPECT_EQ(Movemask(u <= uvec4(5u)), 0xAu);
+
+    const pbvec packed = u > uvec4(2u);
+    EXPECT_TRUE(packed[2]);
+    EXPECT_FALSE(packed[1]);
+    EXPECT_TRUE(Any(packed));
+
+    LOG_D("Test Successful: Comparison Masks");
+}
+
+TEST(vmask, Compare_Select)
+{
+    CompareMasks();
+}
+
 void AllTests()
 {
     Vec2Tests();